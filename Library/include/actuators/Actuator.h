@@ -31,7 +31,7 @@
 
 namespace sf
 {
-    struct Renderable;
+    class RenderSnapshot;
     
     //! An enum designating a type of the actuator.
     enum class ActuatorType {MOTOR, SERVO, PROPELLER, THRUSTER, VBS, LIGHT, RUDDER};
@@ -56,7 +56,10 @@ namespace sf
         virtual void Update(Scalar dt) = 0;
         
         //! A method implementing the rendering of the actuator.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method used to set display mode used for the actuator.
         /*!
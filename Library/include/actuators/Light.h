@@ -95,7 +95,10 @@ namespace sf
         void UpdateTransform();
         
         //! A method implementing the rendering of the light dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
 		//! A method returning actuator frame in the world frame.
 		Transform getActuatorFrame() const;
@@ -50,7 +50,10 @@ namespace sf
         virtual void AttachToSolid(SolidEntity* body, const Transform& origin);
         
 		//! A method implementing the rendering of the actuator.
-        virtual std::vector<Renderable> Render();
+/*!
+ \param snapshot a reference to the snapshot the renderables are written to
+ */
+virtual void Render(RenderSnapshot& snapshot);
 		
         //! A method used to set the actuator origin frame.
         /*!
@@ -57,7 +57,10 @@ namespace sf
         void Update(Scalar dt);
         
         //! A method implementing the rendering of the thruster.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method setting the new value of the thruster speed setpoint.
         /*!
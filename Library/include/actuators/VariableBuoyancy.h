@@ -50,7 +50,10 @@ namespace sf
         void Update(Scalar dt);
         
         //! A method implementing the rendering of the VBS.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method used to set the desired flow rate setpoint.
         /*!
@@ -31,6 +31,8 @@
 
 namespace sf
 {
+    class SimulationManager;
+    
     struct AcousticDataFrame : public CommDataFrame
     {
         Vector3 txPosition;
@@ -75,7 +77,10 @@ namespace sf
         void UpdatePosition(Vector3 pos, bool absolute, std::string referenceFrame = std::string(""));
         
         //! A method implementing the rendering of the comm device.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method to set if occlusion test should be enabled.
         /*!
@@ -99,7 +104,7 @@ namespace sf
     protected:
         virtual void ProcessMessages();
         
-        static AcousticModem* getNode(uint64_t deviceId);
+        AcousticModem* getNode(uint64_t deviceId);
         
     private:
         bool isReceptionPossible(Vector3 dir, Scalar distance);
@@ -111,11 +116,13 @@ namespace sf
         std::string frame;
         bool occlusion;
         
-        static void addNode(AcousticModem* node);
-        static void removeNode(uint64_t deviceId);
-        static bool mutualContact(uint64_t device1Id, uint64_t device2Id);
+        void addNode(AcousticModem* node);
+        void removeNode(uint64_t deviceId);
+        bool mutualContact(uint64_t device1Id, uint64_t device2Id);
+        
+        std::map<uint64_t, AcousticModem*>* nodes; //Modems of the same world
         
-        static std::map<uint64_t, AcousticModem*> nodes;
+        static std::map<SimulationManager*, std::map<uint64_t, AcousticModem*>> networks;
     };
 }
     
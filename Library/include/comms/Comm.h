@@ -35,7 +35,7 @@ namespace sf
     //! An enum defining types of comms.
     enum class CommType {RADIO, ACOUSTIC, USBL, VLC};
     
-    struct Renderable;
+    class RenderSnapshot;
     class Entity;
     class StaticEntity;
     class MovingEntity;
@@ -102,7 +102,10 @@ namespace sf
         void AttachToSolid(MovingEntity* body, const Transform& origin);
         
         //! A method implementing the rendering of the comm device.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method that updates the comm state.
         /*!
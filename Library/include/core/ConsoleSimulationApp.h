@@ -51,6 +51,15 @@ namespace sf
         //! A method informing if the application is graphical.
         bool hasGraphics();
         
+        //! A method setting the stepping mode of the simulation.
+        /*!
+         \param enabled if true the simulation is stepped as fast as possible, otherwise it is synchronized with the real time
+         */
+        void setLockstep(bool enabled);
+        
+        //! A method informing if the simulation is stepped as fast as possible.
+        bool isLockstep();
+        
     protected:
         virtual void Loop();
         void StartSimulation();
@@ -61,6 +70,7 @@ namespace sf
         void Init();
         
         SDL_Thread* simulationThread;
+        bool lockstep;
         
         static int RunSimulation(void* data);
     };
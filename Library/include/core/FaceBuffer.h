@@ -0,0 +1,128 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  FaceBuffer.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_FaceBuffer__
+#define __Stonefish_FaceBuffer__
+
+#include "graphics/OpenGLDataStructs.h"
+
+//Number of faces the buffer is padded to (widest supported vector unit)
+#define FACE_BUFFER_PADDING 8
+
+namespace sf
+{
+    //! A class holding precomputed face data of a mesh, in a structure-of-arrays layout suitable for vectorized computation.
+    /*!
+     Centroids, normals and areas are stored in the mesh frame. The buffer is padded with zero-area faces,
+     which do not contribute to any of the integrated quantities. Vertices shared by faces are stored once,
+     also when the mesh duplicates them, so that per-vertex quantities can be evaluated only once.
+     */
+    class FaceBuffer
+    {
+    public:
+        //! A constructor.
+        FaceBuffer();
+
+        //! A method building the buffer from mesh data.
+        /*!
+         \param mesh a pointer to the mesh
+         */
+        void Build(const Mesh* mesh);
+
+        //! A method integrating the fluid damping forces over all faces (all quantities expressed in the mesh frame).
+        /*!
+         \param p the position of the reference point for torques
+         \param v the linear velocity of the body at the reference point
+         \param omega the angular velocity of the body
+         \param vf the fluid velocity, used when velocity at faces is not given
+         \param vfx x component of the fluid velocity at each face centroid (can be nullptr)
+         \param vfy y component of the fluid velocity at each face centroid (can be nullptr)
+         \param vfz z component of the fluid velocity at each face centroid (can be nullptr)
+         \param Fdl output of the damping force resulting from linear drag
+         \param Tdl output of the torque induced by linear drag
+         \param Fdq output of the damping force resulting from form drag
+         \param Tdq output of the torque induced by form drag
+         \param Fds output of the damping force resulting from skin friction
+         \param Tds output of the torque induced by skin friction
+         */
+        void ComputeDampingForces(const glm::vec3& p, const glm::vec3& v, const glm::vec3& omega,
+                                  const glm::vec3& vf, const GLfloat* vfx, const GLfloat* vfy, const GLfloat* vfz,
+                                  glm::vec3& Fdl, glm::vec3& Tdl, glm::vec3& Fdq, glm::vec3& Tdq, glm::vec3& Fds, glm::vec3& Tds) const;
+
+        //! A method returning the centroid of a face.
+        /*!
+         \param faceID the index of the face
+         \return the centroid of the face in the mesh frame
+         */
+        glm::vec3 getCentroid(size_t faceID) const;
+
+        //! A method returning the unit normal of a face.
+        /*!
+         \param faceID the index of the face
+         \return the normal of the face in the mesh frame (zero for degenerate faces)
+         */
+        glm::vec3 getNormal(size_t faceID) const;
+
+        //! A method returning the area of a face.
+        /*!
+         \param faceID the index of the face
+         \return the area of the face (zero for degenerate faces)
+         */
+        GLfloat getArea(size_t faceID) const;
+
+        //! A method returning the indices of the vertices of a face.
+        /*!
+         \param faceID the index of the face
+         \return a pointer to three indices of unique vertices
+         */
+        const GLuint* getFaceVertices(size_t faceID) const;
+
+        //! A method returning the position of a unique vertex.
+        /*!
+         \param vertexID the index of the vertex
+         \return the position of the vertex in the mesh frame
+         */
+        glm::vec3 getVertex(size_t vertexID) const;
+
+        //! A method returning the number of unique vertices of the mesh.
+        size_t getNumOfVertices() const;
+
+        //! A method returning the number of faces of the mesh.
+        size_t getNumOfFaces() const;
+
+        //! A method returning the length of the arrays, including padding.
+        size_t getBufferSize() const;
+
+        //! A method informing if the buffer was built.
+        bool isEmpty() const;
+
+    private:
+        size_t nFaces;
+        std::vector<GLfloat> cx, cy, cz; //Centroids
+        std::vector<GLfloat> nx, ny, nz; //Unit normals
+        std::vector<GLfloat> area; //Areas
+        std::vector<glm::vec3> vertices; //Unique vertex positions
+        std::vector<GLuint> faceVertices; //Indices of unique vertices (3 per face)
+    };
+}
+
+#endif
@@ -26,20 +26,33 @@
 #ifndef __Stonefish_FilteredCollisionDispatcher__
 #define __Stonefish_FilteredCollisionDispatcher__
 
+#include <SDL2/SDL_atomic.h>
+#include <vector>
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "StonefishCommon.h"
 
 namespace sf
 {
-    //! A class implementing a custom collision dispatcher object.
+    class SimulationManager;
+    class SolidEntity;
+    class ThreadPool;
+    
+    //! A class implementing a custom collision dispatcher object, filtering collisions between pairs of entities.
+    /*!
+     When a thread pool is assigned, the narrowphase collision detection is computed for many overlapping pairs in parallel.
+     The contact manifolds created and released during the dispatch are collected and merged into the manifold list afterwards,
+     in an order that does not depend on the scheduling of the threads. The same applies to the forces applied to the bodies by
+     the contact callbacks. Pairs involving soft bodies are always processed serially.
+     */
     class FilteredCollisionDispatcher : public btCollisionDispatcher
     {
     public:
         //! A constructor.
         /*!
          \param collisionConfiguration a pointer to the collision configuration structure
-         \param inclusiveMode a flag that selects the mode of collision detection
+         \param sm a pointer to the simulation manager holding the collision filtering settings
          */
-        FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, bool inclusiveMode);
+        FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, SimulationManager* sm);
         
         //! A method that informs if two collision objects can collide.
         /*!
@@ -49,6 +62,14 @@ namespace sf
          */
         bool needsCollision(const btCollisionObject* body0, const btCollisionObject* body1);
         
+        //! A method that informs if collision between the entities owning the collision objects is enabled.
+        /*!
+         \param body0 a pointer to the first collision object
+         \param body1 a pointer to the second collision object
+         \return is collision between the entities enabled?
+         */
+        bool isCollisionEnabled(const btCollisionObject* body0, const btCollisionObject* body1) const;
+        
         //! A method calling the collision computation algorithm.
         /*!
          \param collisionPair a reference to a collision pair info structure
@@ -57,8 +78,83 @@ namespace sf
          */
         static void myNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
         
+        //! A method computing the collisions for all overlapping pairs.
+        /*!
+         \param pairCache a pointer to the cache of the overlapping pairs
+         \param dispatchInfo a reference to the collision dispatcher info structure
+         \param dispatcher a pointer to the dispatcher passed to the pair cache
+         */
+        void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher);
+        
+        //! A method creating a new contact manifold.
+        /*!
+         \param body0 a pointer to the first collision object
+         \param body1 a pointer to the second collision object
+         \return a pointer to the new manifold
+         */
+        btPersistentManifold* getNewManifold(const btCollisionObject* body0, const btCollisionObject* body1);
+        
+        //! A method destroying a contact manifold.
+        /*!
+         \param manifold a pointer to the manifold
+         */
+        void releaseManifold(btPersistentManifold* manifold);
+        
+        //! A method allocating memory for a collision algorithm.
+        /*!
+         \param size the size of the algorithm object
+         \return a pointer to the allocated memory
+         */
+        void* allocateCollisionAlgorithm(int size);
+        
+        //! A method freeing the memory of a collision algorithm.
+        /*!
+         \param ptr a pointer to the memory
+         */
+        void freeCollisionAlgorithm(void* ptr);
+        
+        //! A method applying a force and a torque to a body, computed when a contact point is created.
+        /*!
+         During the parallel dispatch the contributions are collected and applied after it, in the order of the overlapping pairs.
+         \param solid a pointer to the body
+         \param F the force acting on the CG of the body [N]
+         \param T the torque acting on the body [Nm]
+         */
+        void ApplyContactForce(SolidEntity* solid, const Vector3& F, const Vector3& T);
+        
+        //! A method setting the thread pool used to compute collisions in parallel.
+        /*!
+         \param pool a pointer to the thread pool (nullptr = serial computation)
+         */
+        void setThreadPool(ThreadPool* pool);
+        
     private:
-        bool inclusive;
+        struct BatchManifold
+        {
+            btPersistentManifold* manifold;
+            int pairIndex;
+            int sequence;
+        };
+        
+        struct BatchForce
+        {
+            SolidEntity* solid;
+            Vector3 F;
+            Vector3 T;
+            int pairIndex;
+            int sequence;
+        };
+        
+        void DestroyManifold(btPersistentManifold* manifold);
+        void MergeBatch();
+        
+        SimulationManager* simManager;
+        ThreadPool* threadPool;
+        bool batchDispatch;
+        SDL_SpinLock batchLock;
+        std::vector<BatchManifold> batchManifolds;
+        std::vector<btPersistentManifold*> releasedManifolds;
+        std::vector<BatchForce> batchForces;
     };
 }
 
@@ -26,7 +26,6 @@
 #ifndef __Stonefish_MaterialManager__
 #define __Stonefish_MaterialManager__
 
-#include <unordered_map>
 #include "core/NameManager.h"
 
 namespace sf
@@ -34,6 +33,7 @@ namespace sf
     //! A structure holding material properties.
     struct Material
     {
+        int id; //Index in the material manager
         std::string name;
         Scalar density;
         Scalar restitution;
@@ -64,30 +64,6 @@ namespace sf
         Scalar fDynamic;
     };
     
-    //! A structure representing a pair of materials.
-    struct MaterialPair
-    {
-        int mat1Id;
-        int mat2Id;
-        
-        bool operator==(const MaterialPair& rhs) const
-        {
-            return (mat1Id == rhs.mat1Id && mat2Id == rhs.mat2Id)||(mat1Id == rhs.mat2Id && mat2Id == rhs.mat1Id);
-        }
-    };
-    
-    //! A hashing function for material interaction.
-    struct MaterialPairHash
-    {
-        std::size_t operator()(const MaterialPair& mp) const
-        {
-            if(mp.mat1Id <= mp.mat2Id)
-                return std::hash<int>()(mp.mat1Id) ^ (std::hash<int>()(mp.mat2Id) << 16);
-            else
-                return std::hash<int>()(mp.mat2Id) ^ (std::hash<int>()(mp.mat1Id) << 16);
-        }
-    };
-    
     class NameManager;
     
     //! A class implementing a physical material manager.
@@ -126,7 +102,7 @@ namespace sf
          \param mat2Index and id of the second material
          \return a structure containing friction coefficients
          */
-        Friction GetMaterialsInteraction(int mat1Index, int mat2Index);
+        Friction GetMaterialsInteraction(int mat1Index, int mat2Index) const;
         
         //! A method that returns friction information for a specified pair of materials.
         /*!
@@ -151,7 +127,7 @@ namespace sf
          \param index an id of the material
          \return a structure containing properties of the material
          */
-        Material getMaterial(int index);
+        const Material& getMaterial(int index) const;
         
         //! A method that creates a new fluid.
         /*!
@@ -184,7 +160,7 @@ namespace sf
         int getMaterialIndex(const std::string& name);
         
         std::vector<Material> materials;
-        std::unordered_map<MaterialPair, Friction, MaterialPairHash> interactions;
+        std::vector<Friction> interactions; //Dense symmetric matrix indexed by material ids
         std::vector<Fluid> fluids;
         
         NameManager materialNameManager;
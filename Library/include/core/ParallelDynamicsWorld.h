@@ -0,0 +1,98 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ParallelDynamicsWorld.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_ParallelDynamicsWorld__
+#define __Stonefish_ParallelDynamicsWorld__
+
+#include <vector>
+#include "BulletSoftBody/btSoftMultiBodyDynamicsWorld.h"
+
+class btMLCPSolverInterface;
+
+namespace sf
+{
+    class SimulationManager;
+    class ThreadPool;
+    
+    //! A class implementing a dynamics world which solves independent simulation islands in parallel.
+    /*!
+     When a thread pool is assigned, the islands are grouped into batches the same way as in the serial solution, and each batch
+     is solved by a separate instance of the multibody constraint solver. Batches referring to the same kinematic body or
+     multibody are merged, because the solver stores temporary indices in these objects.
+     */
+    class ParallelDynamicsWorld : public btSoftMultiBodyDynamicsWorld
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param dispatcher a pointer to the collision dispatcher
+         \param broadphase a pointer to the broadphase collision detection
+         \param solver a pointer to the multibody constraint solver
+         \param collisionConfiguration a pointer to the collision configuration structure
+         \param softBodySolver a pointer to the soft body solver
+         \param sm a pointer to the simulation manager creating the additional constraint solvers
+         */
+        ParallelDynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* broadphase, btMultiBodyConstraintSolver* solver,
+                              btCollisionConfiguration* collisionConfiguration, btSoftBodySolver* softBodySolver, SimulationManager* sm);
+        
+        //! A destructor.
+        ~ParallelDynamicsWorld();
+        
+        //! A method solving all constraints of the world.
+        /*!
+         \param solverInfo a reference to the solver settings
+         */
+        void solveConstraints(btContactSolverInfo& solverInfo);
+        
+        //! A method setting the thread pool used to solve the islands in parallel.
+        /*!
+         \param pool a pointer to the thread pool (nullptr = serial computation)
+         */
+        void setThreadPool(ThreadPool* pool);
+        
+    private:
+        struct IslandBatch
+        {
+            btAlignedObjectArray<btCollisionObject*> bodies;
+            btAlignedObjectArray<btPersistentManifold*> manifolds;
+            btAlignedObjectArray<btTypedConstraint*> constraints;
+            btAlignedObjectArray<btMultiBodyConstraint*> multiBodyConstraints;
+        };
+        
+        struct IslandCollector;
+        
+        void AddToBatch(MultiBodyInplaceSolverIslandCallback* islands);
+        void MergeSharedBatches();
+        void SolveBatches(const btContactSolverInfo& solverInfo);
+        
+        SimulationManager* simManager;
+        ThreadPool* threadPool;
+        bool collecting;
+        std::vector<IslandBatch> batches;
+        size_t numBatches;
+        std::vector<size_t> batchOrder;
+        std::vector<btMultiBodyConstraintSolver*> solvers;
+        std::vector<btMLCPSolverInterface*> mlcpSolvers;
+    };
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ReducedDragModel.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_ReducedDragModel__
+#define __Stonefish_ReducedDragModel__
+
+#include "core/FaceBuffer.h"
+
+namespace sf
+{
+    //! A class implementing a reduced-order model of the fluid damping forces acting on a fully submerged body.
+    /*!
+     The model is fitted from the face data of the body mesh and tabulates the damping forces and torques, for a unit relative
+     velocity of the fluid, over a cube map of directions. Quadratic and skin drag scale with the square of the speed, while
+     the linear drag is stored as a histogram over the incidence of the faces, so the forces are evaluated in constant time
+     for any speed. The model is valid for a fluid flow that is uniform over the hull and a body that is not rotating quickly.
+     */
+    class ReducedDragModel
+    {
+    public:
+        //! A constructor.
+        ReducedDragModel();
+
+        //! A method fitting the model to the face data of a mesh.
+        /*!
+         \param faces a reference to the face data
+         \param p the position of the reference point for torques, in the mesh frame
+         */
+        void Build(const FaceBuffer& faces, const glm::vec3& p);
+
+        //! A method checking if the model can replace the integration over faces.
+        /*!
+         \param vr the velocity of the fluid relative to the body, at the reference point
+         \param omega the angular velocity of the body
+         \param flowVariation the largest difference between the fluid velocity sampled over the hull and its mean
+         \return true if the model is accurate for the given conditions
+         */
+        bool isApplicable(const glm::vec3& vr, const glm::vec3& omega, GLfloat flowVariation) const;
+
+        //! A method computing the damping forces (all quantities expressed in the mesh frame).
+        /*!
+         \param vr the velocity of the fluid relative to the body, at the reference point
+         \param Fdl output of the damping force resulting from linear drag
+         \param Tdl output of the torque induced by linear drag
+         \param Fdq output of the damping force resulting from form drag
+         \param Tdq output of the torque induced by form drag
+         \param Fds output of the damping force resulting from skin friction
+         \param Tds output of the torque induced by skin friction
+         */
+        void ComputeDampingForces(const glm::vec3& vr, glm::vec3& Fdl, glm::vec3& Tdl, glm::vec3& Fdq, glm::vec3& Tdq, glm::vec3& Fds, glm::vec3& Tds) const;
+
+        //! A method returning the reference point of the model.
+        glm::vec3 getReferencePoint() const;
+
+        //! A method returning the distance from the reference point to the furthest vertex of the mesh.
+        GLfloat getRadius() const;
+
+        //! A method informing if the model was built.
+        bool isEmpty() const;
+
+    private:
+        size_t NodeIndex(unsigned int face, unsigned int i, unsigned int j) const;
+        glm::vec3 NodeDirection(unsigned int face, unsigned int i, unsigned int j) const;
+
+        glm::vec3 refPoint;
+        GLfloat radius;
+        std::vector<glm::vec3> nodes; //Tabulated data of each direction, stored consecutively
+    };
+}
+
+#endif
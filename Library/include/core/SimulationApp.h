@@ -85,9 +85,27 @@ namespace sf
         Console* getConsole();
         
         //! A static method returning the pointer to the currently running application.
+        /*!
+         \return a pointer to the application bound to the calling thread or, if none, to the global application
+         */
         static SimulationApp* getApp();
         
+        //! A static method binding an application to the calling thread.
+        /*!
+         \param app a pointer to the application (nullptr to use the global application)
+         */
+        static void setThreadApp(SimulationApp* app);
+        
     protected:
+        //! A constructor used by applications hosting one of many worlds, which does not replace the global application.
+        /*!
+         \param name a name for the application
+         \param dataDirPath a path to the directory containing simulation data
+         \param sim a pointer to the simulation manager
+         \param sharedConsole a pointer to a console shared between applications
+         */
+        SimulationApp(std::string name, std::string dataDirPath, SimulationManager* sim, Console* sharedConsole);
+        
         virtual void Init() = 0;
         virtual void Loop() = 0;
         virtual void CleanUp();
@@ -109,6 +127,7 @@ namespace sf
         double physicsTime;
         
         static SimulationApp* handle;
+        static thread_local SimulationApp* threadHandle;
     };
 }
 
@@ -0,0 +1,111 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SimulationBatch.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_SimulationBatch__
+#define __Stonefish_SimulationBatch__
+
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    class SimulationManager;
+    class SimulationApp;
+    class ThreadPool;
+    class Console;
+
+    //! A class implementing a set of independent console mode simulations, run in a single process.
+    /*!
+     Each world is hosted by a lightweight application, which is bound to the thread building or stepping the world,
+     so that all objects of the world resolve their simulation manager through the usual application handle.
+     The worlds are built one after another and stepped in parallel, in the lockstep mode. They share the console
+     and the data directory, and should not share a thread pool with the batch.
+     */
+    class SimulationBatch
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param dataDirPath a path to the directory containing the simulation data
+         \param numThreads the number of threads used to step the worlds (0 = number of CPU cores)
+         */
+        SimulationBatch(std::string dataDirPath, unsigned int numThreads = 0);
+
+        //! A destructor.
+        ~SimulationBatch();
+
+        //! A method adding a world to the batch.
+        /*!
+         \param sim a pointer to the simulation manager of the world (owned by the batch)
+         \return the index of the world
+         */
+        unsigned int AddWorld(SimulationManager* sim);
+
+        //! A method building the scenarios of all worlds and solving their initial conditions problems.
+        /*!
+         \return success
+         */
+        bool Start();
+
+        //! A method rebuilding the scenario of a single world and solving its initial conditions problem.
+        /*!
+         \param id the index of the world
+         \return success
+         */
+        bool Restart(unsigned int id);
+
+        //! A method advancing all worlds by a fixed number of steps.
+        /*!
+         \param n the number of steps
+         */
+        void Step(unsigned int n = 1);
+
+        //! A method binding a world to the calling thread, to access its objects between the steps.
+        /*!
+         \param id the index of the world (-1 to unbind)
+         */
+        void setCurrentWorld(int id);
+
+        //! A method returning the number of worlds.
+        unsigned int getNumOfWorlds() const;
+
+        //! A method returning a pointer to the simulation manager of a world.
+        /*!
+         \param id the index of the world
+         \return a pointer to the simulation manager
+         */
+        SimulationManager* getWorld(unsigned int id);
+
+        //! A method returning a pointer to the console shared by the worlds.
+        Console* getConsole();
+
+    private:
+        class World;
+
+        std::string dataPath;
+        std::vector<World*> worlds;
+        ThreadPool* pool;
+        Console* console;
+        int current;
+    };
+}
+
+#endif
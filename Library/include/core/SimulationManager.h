@@ -27,11 +27,19 @@
 #define __Stonefish_SimulationManager__
 
 #include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_atomic.h>
+#include <unordered_set>
+#include <unordered_map>
+#include <functional>
+#include <random>
 #include "StonefishCommon.h"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
 #include "entities/SolidEntity.h"
 
+class btMLCPSolverInterface;
+class btPoolAllocator;
+
 namespace sf
 {
     class NameManager;
@@ -49,8 +57,12 @@ namespace sf
     class Sensor;
     class Comm;
     class Contact;
+    struct ContactInfo;
     class OpenGLTrackball;
     class OpenGLDebugDrawer;
+    class ThreadPool;
+    class SensorLogger;
+    class SensorScheduler;
     
     //! An enum designating the type of solver used for physics computation
     typedef enum {SOLVER_SI, SOLVER_DANTZIG, SOLVER_PGS, SOLVER_LEMKE, SOLVER_NNCG} SolverType;
@@ -58,11 +70,57 @@ namespace sf
     //! An enum designating the approach to collision detection
     typedef enum {COLLISION_INCLUSIVE, COLLISION_EXCLUSIVE} CollisionFilteringType;
     
-    //! A structure used to define collision pairs
+    //! A structure used to define collision pairs (unordered)
     struct Collision
     {
         Entity* A;
         Entity* B;
+        
+        //! A constructor.
+        /*!
+         \param entA a pointer to the first entity
+         \param entB a pointer to the second entity
+         */
+        Collision(const Entity* entA, const Entity* entB)
+        {
+            //Store in canonical order so that (A,B) == (B,A)
+            bool swap = std::less<const Entity*>()(entB, entA);
+            A = const_cast<Entity*>(swap ? entB : entA);
+            B = const_cast<Entity*>(swap ? entA : entB);
+        }
+        
+        friend bool operator==(const Collision& lhs, const Collision& rhs)
+        {
+            return lhs.A == rhs.A && lhs.B == rhs.B;
+        }
+    };
+    
+    //! A structure implementing the hash function of a collision pair.
+    struct CollisionHash
+    {
+        size_t operator()(const Collision& c) const
+        {
+            size_t h = std::hash<Entity*>()(c.A);
+            return h ^ (std::hash<Entity*>()(c.B) + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
+    };
+    
+    //! A structure representing a ray used in batched ray casting.
+    struct RayQuery
+    {
+        Vector3 from; //!< Start point of the ray in the world frame
+        Vector3 to; //!< End point of the ray in the world frame
+        int group; //!< Collision filter group of the ray
+        int mask; //!< Collision filter mask of the ray
+    };
+    
+    //! A structure representing the result of casting a single ray.
+    struct RayHit
+    {
+        const btCollisionObject* object; //!< A pointer to the hit collision object (nullptr if nothing was hit)
+        Scalar fraction; //!< Fraction of the ray length at which the closest hit occured (1 if nothing was hit)
+        Vector3 point; //!< Hit point in the world frame
+        Vector3 normal; //!< Surface normal at the hit point in the world frame
     };
     
     //! An abstract class managing the simulation world, the solver settings and implementing custom physics callbacks.
@@ -122,6 +180,12 @@ namespace sf
         //! A method computing the next simulation step.
         void AdvanceSimulation();
         
+        //! A method computing a fixed number of simulation steps as fast as possible (lockstep mode).
+        /*!
+         \param n the number of steps of length 1/stepsPerSecond
+         */
+        void StepSimulation(unsigned int n = 1);
+        
         //! A method updating the drawing queue (thread safe)
         void UpdateDrawingQueue();
         
@@ -213,9 +277,9 @@ namespace sf
         /*!
          \param entA a pointer to the first entity
          \param entB a pointer to the second entity
-         \return
+         \return true if the entities can collide, false otherwise
          */
-        int CheckCollision(const Entity* entA, const Entity* entB);
+        bool CheckCollision(const Entity* entA, const Entity* entB) const;
         
         //! A method used to enable ocean simulation.
         /*!
@@ -227,6 +291,17 @@ namespace sf
         //! A method used to enable atmosphere simulation.
         void EnableAtmosphere();
         
+        //! A method starting the streaming of all scalar sensor measurements to a binary log.
+        /*!
+         \param path a path to the output file
+         \param compress a flag deciding if the data should be compressed
+         \return success
+         */
+        bool StartLogging(const std::string& path, bool compress = false);
+        
+        //! A method stopping the streaming of sensor measurements and closing the log.
+        void StopLogging();
+        
         //! A method used to pick an entity by shooting a camera ray.
         /*!
          \param eye the position of the camera eye in the world frame
@@ -235,6 +310,16 @@ namespace sf
          */
         Entity* PickEntity(Vector3 eye, Vector3 ray);
         
+        //! A method casting a batch of rays and finding the closest hit of each ray.
+        /*!
+         Each ray traverses the bounding volume trees of the broadphase, using a stack preallocated for each thread.
+         Consecutive rays are grouped in packets, which are processed in parallel by the thread pool.
+         \param rays a pointer to an array of rays
+         \param hits a pointer to an array to be filled with the results
+         \param n the number of rays
+         */
+        void CastRays(const RayQuery* rays, RayHit* hits, size_t n);
+        
         //! A method that sets new valve for the amount of simulation steps in a second.
         /*!
          \param steps number steps of simulation per second
@@ -247,6 +332,18 @@ namespace sf
          */
         void setRealtimeFactor(Scalar f);
         
+        //! A method that sets the number of threads used for parallel computations (e.g. hydrodynamics).
+        /*!
+         \param n number of threads (1 = serial computation, 0 = number of CPU cores)
+         */
+        void setNumOfThreads(unsigned int n);
+        
+        //! A method enabling the parallel computation of collisions and constraints, using the thread pool.
+        /*!
+         \param enabled a flag deciding if the physics should be computed in parallel
+         */
+        void setParallelPhysics(bool enabled);
+        
         //! A method used to setup the initial conditions solver.
         /*!
          \param useGravity specifies if gravity should be enabled during IC solving
@@ -280,6 +377,18 @@ namespace sf
         //! A method returning the current number of steps per second used.
         Scalar getStepsPerSecond();
         
+        //! A method returning the number of threads used for parallel computations.
+        unsigned int getNumOfThreads();
+        
+        //! A method returning a pointer to the thread pool (nullptr when computation is serial).
+        ThreadPool* getThreadPool();
+        
+        //! A method returning a pointer to the scheduler of sensor updates.
+        SensorScheduler* getSensorScheduler();
+        
+        //! A method informing if the physics is computed in parallel.
+        bool isParallelPhysicsEnabled();
+        
         //! A method returning the axis-aligned bounding box of the simulation world.
         /*!
          \param min a position of the minimum corner
@@ -292,6 +401,13 @@ namespace sf
         
         //! A method returning the type of solver used.
         SolverType getSolverType();
+        
+        //! A method creating a new multibody constraint solver of the type used in the simulation.
+        /*!
+         \param mlcp a reference to a pointer set to the created MLCP solver, if the type requires one (owned by the caller)
+         \return a pointer to the created constraint solver (owned by the caller)
+         */
+        btMultiBodyConstraintSolver* CreateConstraintSolver(btMLCPSolverInterface*& mlcp) const;
 
         //! A method returning soft body world information.
         btSoftBodyWorldInfo& getSoftBodyWorldInfo();
@@ -405,6 +521,9 @@ namespace sf
         //! A method returning a pointer to the NED object.
         NED* getNED();
         
+        //! A method returning a pointer to the sensor logger (nullptr when not logging).
+        SensorLogger* getSensorLogger();
+        
         //! A method returning a pointer to the ocean object.
         Ocean* getOcean();
         
@@ -423,6 +542,21 @@ namespace sf
         //! A method informing about the relation between the simulated time and real time.
         Scalar getRealtimeFactor();
         
+        //! A method returning the number of steps per second achieved in the lockstep mode.
+        Scalar getAchievedStepsPerSecond();
+        
+        //! A method returning the ratio of the simulated time to the real time achieved in the lockstep mode.
+        Scalar getAchievedRealtimeFactor();
+        
+        //! A method setting the seed of the random number generator used to simulate noise.
+        /*!
+         \param seed the seed applied every time the simulation is started
+         */
+        void setRandomSeed(uint32_t seed);
+        
+        //! A method returning a reference to the random number generator of the world, seeding the noise of sensors and shared by comms.
+        std::mt19937& getRandomGenerator();
+        
         //! A method returning a pointer to the material manager.
         MaterialManager* getMaterialManager();
         
@@ -480,12 +614,15 @@ namespace sf
         static void SolveICTickCallback(btDynamicsWorld* world, Scalar timeStep);
         static void SimulationTickCallback(btDynamicsWorld* world, Scalar timeStep);
         static void SimulationPostTickCallback(btDynamicsWorld* world, Scalar timeStep);
+        ContactInfo* AllocateContactInfo();
+        static void FreeContactInfo(ContactInfo* cInfo);
         static bool CustomMaterialCombinerCallback(btManifoldPoint& cp,	const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1);
         static bool ContactInfoUpdateCallback(btManifoldPoint& cp, void* body0, void* body1);
         static bool ContactInfoDestroyCallback(void* userPersistentData);
 
         btSoftMultiBodyDynamicsWorld* dynamicsWorld;
         btMultiBodyConstraintSolver* mbSolver;
+        btMLCPSolverInterface* mlcpSolver;
         btSoftBodySolver* sbSolver;
         btSoftBodyWorldInfo sbInfo;
         btCollisionDispatcher* dwDispatcher;
@@ -498,6 +635,8 @@ namespace sf
         void RenderBulletDebug();
         void InitializeSolver();
         void InitializeScenario();
+        void UpdateSolverInfo();
+        void UpdatePhysicsThreads();
         
         SolverType solver;
         CollisionFilteringType collisionFilter;
@@ -513,6 +652,8 @@ namespace sf
         Scalar simulationTime;
         uint64_t currentTime;
         uint64_t physicsTime;
+        uint64_t lockstepSteps;
+        uint64_t lockstepTime;
         uint64_t ssus;
         bool icUseGravity;
         Scalar icTimeStep;
@@ -521,6 +662,9 @@ namespace sf
         Scalar icLinTolerance;
         Scalar icAngTolerance;
         unsigned int mlcpFallbacks;
+        std::mt19937 randomGenerator;
+        uint32_t randomSeed;
+        bool seeded;
         bool icProblemSolved;
         bool simulationFresh;
         
@@ -532,7 +676,21 @@ namespace sf
         std::vector<Actuator*> actuators;
         std::vector<Comm*> comms;
         std::vector<Contact*> contacts;
-        std::vector<Collision> collisions;
+        std::unordered_set<Collision, CollisionHash> collisions;
+        std::unordered_map<Collision, Contact*, CollisionHash> contactIndex;
+        std::unordered_map<std::string, Robot*> robotIndex;
+        std::unordered_map<std::string, Entity*> entityIndex;
+        std::unordered_map<std::string, Joint*> jointIndex;
+        std::unordered_map<std::string, Sensor*> sensorIndex;
+        std::unordered_map<std::string, Actuator*> actuatorIndex;
+        std::unordered_map<std::string, Comm*> commIndex;
+        std::vector<SolidEntity*> hydroBodies;
+        ThreadPool* threadPool;
+        bool parallelPhysics;
+        SensorLogger* logger;
+        SensorScheduler* sensorScheduler;
+        btPoolAllocator* contactInfoPool;
+        SDL_SpinLock contactInfoLock;
         NED* ned;
         Ocean* ocean;
         Atmosphere* atmosphere;
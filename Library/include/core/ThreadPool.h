@@ -0,0 +1,76 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ThreadPool.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_ThreadPool__
+#define __Stonefish_ThreadPool__
+
+#include <SDL2/SDL_thread.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace sf
+{
+    class SimulationApp;
+    
+    //! A class implementing a pool of worker threads used to run independent computations in parallel.
+    class ThreadPool
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param numThreads total number of threads used for computation, including the calling thread (0 = number of CPU cores)
+         */
+        ThreadPool(unsigned int numThreads = 0);
+
+        //! A destructor.
+        ~ThreadPool();
+
+        //! A method running a task for each index in range [0, count) and waiting for all of them to finish (serially when called from a task of the same pool).
+        /*!
+         \param count number of task invocations
+         \param task a function called with the index of the item to process
+         */
+        void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+        //! A method returning the total number of threads used for computation.
+        unsigned int getNumOfThreads() const;
+
+    private:
+        void RunTasks();
+        static int WorkerLoop(void* data);
+
+        std::vector<SDL_Thread*> workers;
+        SDL_mutex* poolMutex;
+        SDL_cond* workCond;
+        SDL_cond* doneCond;
+        const std::function<void(size_t)>* job;
+        SimulationApp* jobApp;
+        size_t jobSize;
+        std::atomic<size_t> jobNext;
+        unsigned int jobId;
+        unsigned int busy;
+        bool quit;
+    };
+}
+
+#endif
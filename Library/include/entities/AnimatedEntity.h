@@ -150,7 +150,10 @@ namespace sf
         void Update(Scalar dt);
         
         //! A method returning the elements that should be rendered.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method returning the type of the entity.
         EntityType getType() const;
@@ -50,7 +50,7 @@ namespace sf
     //! An enum defining how the body is displayed.
     enum class DisplayMode {GRAPHICAL, PHYSICAL};
     
-    struct Renderable;
+    class RenderSnapshot;
     class SimulationManager;
     
     //! An abstract class representing a simulation entity.
@@ -78,11 +78,23 @@ namespace sf
         //! A method returning the name of the entity.
         std::string getName() const;
         
+        //! A method used to mark the entity as monitored by contact sensors.
+        /*!
+         \param monitored a flag informing if contacts of the entity should be monitored
+         */
+        void setContactMonitored(bool monitored);
+        
+        //! A method informing if the entity is monitored by any contact sensor.
+        bool isContactMonitored() const;
+        
         //! A method returning the type of the entity.
         virtual EntityType getType() const = 0;
         
         //! A method implementing rendering of the entity.
-        virtual std::vector<Renderable> Render() = 0;
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot) = 0;
         
         //! A method used to add the entity to the simulation.
         /*!
@@ -99,6 +111,7 @@ namespace sf
         
     private:
         bool renderable;
+        bool contactMonitored;
         std::string name;
     };
 }
@@ -198,6 +198,9 @@ namespace sf
          */
         void AddLinkTorque(unsigned int index, const Vector3& tau);
         
+        //! A method used to compute velocities of all links in a single pass over the tree (cached until the multibody state changes).
+        void UpdateKinematics();
+        
         //! A method used to compute accelerations of the links.
         /*!
          \param dt a step time of the simulation [s]
@@ -369,7 +372,10 @@ namespace sf
         void AddToSimulation(SimulationManager* sm, const Transform& origin);
         
         //! A method implementing the rendering of the multibody.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method returning the extents of the body axis alligned bounding box.
         /*!
@@ -381,10 +387,23 @@ namespace sf
         //! A method returning the type of the entity.
         EntityType getType() const;
         
+        //! A method computing the velocity of a link based on the velocity of its parent.
+        /*!
+         \param mb a pointer to the multibody
+         \param link the index of the link in the multibody
+         \param linkToWorld the rotation from the link frame to the world frame
+         \param linVelocity the linear velocity of the parent, replaced with the linear velocity of the link
+         \param angVelocity the angular velocity of the parent, replaced with the angular velocity of the link
+         */
+        static void PropagateLinkVelocity(const btMultiBody* mb, int link, const Quaternion& linkToWorld, Vector3& linVelocity, Vector3& angVelocity);
+        
     private:
+        void InvalidateKinematics();
+        
         btMultiBody* multiBody;
         std::vector<FeatherstoneLink> links;
         std::vector<FeatherstoneJoint> joints;
+        std::vector<Quaternion> linkRotations; //Link to world rotations computed by UpdateKinematics
         bool baseRenderable;
     };
 }
@@ -54,7 +54,10 @@ namespace sf
         void AddToSimulation(SimulationManager* sm);
         
         //! A method implementing the rendering of the force field.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method returning the extents of the force field axis alligned bounding box.
         /*!
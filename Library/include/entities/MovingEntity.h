@@ -61,7 +61,10 @@ namespace sf
         virtual void AddToSimulation(SimulationManager* sm, const Transform& origin) = 0;
         
         //! A method returning the elements that should be rendered.
-        virtual std::vector<Renderable> Render() = 0;
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot) = 0;
 
         //! A method returning the type of the entity.
         virtual EntityType getType() const = 0;
@@ -107,7 +110,7 @@ namespace sf
         virtual void getAABB(Vector3& min, Vector3& max) = 0;
         
         //! A method returning the material of the body.
-        Material getMaterial() const;
+        const Material& getMaterial() const;
         
         //! A method used to change the rendering style of the object.
         /*!
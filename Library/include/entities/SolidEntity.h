@@ -28,6 +28,8 @@
 
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "core/MaterialManager.h"
+#include "core/FaceBuffer.h"
+#include "core/ReducedDragModel.h"
 #include "entities/MovingEntity.h"
 #include "graphics/OpenGLDataStructs.h"
 
@@ -128,7 +130,7 @@ namespace sf
         //! A static method that computes fluid dynamics when a body is crossing the fluid surface.
         /*!
          \param settings a reference to a structure holding settings of the fluid dynamics computation
-         \param mesh a pointer to the body physics mesh data
+         \param faces a pointer to the precomputed face data of the body physics mesh
          \param liquid a pointer to the fluid entity generating forces (currently only Ocean supported)
          \param T_CG a transform from the world frame to the body CG frame
          \param T_C a transform from the world frame to the physics frame
@@ -143,12 +145,12 @@ namespace sf
          \param _Fds output of the damping force resulting from skin friction
          \param _Tds output of the torque induced by skin friction
         */
-        static void ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const Mesh* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
-                                                     const Vector3& linearV, const Vector3& angularV, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds, Renderable& debug);
+        static void ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const FaceBuffer* faces, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
+                                                     const Vector3& linearV, const Vector3& angularV, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds, std::vector<glm::vec3>& debug);
         
         //! A static method that computes fluid dynamics when a body is completely submerged.
         /*!
-         \param mesh a pointer to the body physics mesh data
+         \param faces a pointer to the precomputed face data of the body physics mesh
          \param liquid a pointer to the fluid entity generating forces
          \param T_CG a transform from the world frame to the body CG frame
          \param T_C a transform from the world frame to the body physics frame
@@ -160,9 +162,11 @@ namespace sf
          \param _Tdq output of the torque induced by form drag
          \param _Fds output of the damping force resulting from skin friction
          \param _Tds output of the torque induced by skin friction
+         \param model a pointer to the reduced-order damping model of the body (nullptr = always integrate over faces)
         */
-        static void ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
-                                                       const Vector3& linearV, const Vector3& angularV, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds);
+        static void ComputeHydrodynamicForcesSubmerged(const FaceBuffer* faces, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
+                                                       const Vector3& linearV, const Vector3& angularV, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds,
+                                                       ReducedDragModel* model = nullptr);
         
         //! A method that computes aerodynamics.
         /*!
@@ -328,6 +332,12 @@ namespace sf
         
         //! A method returning a pointer to the physics mesh.
         const Mesh* getPhysicsMesh();
+        
+        //! A method returning a pointer to the precomputed face data of the physics mesh (built on first use).
+        const FaceBuffer* getPhysicsFaces();
+        
+        //! A method returning a pointer to the reduced-order damping model of the body (built on first use).
+        ReducedDragModel* getDragModel();
 
         //! A method that returns a copy of all physics mesh vertices in body origin frame.
         virtual std::vector<Vector3>* getMeshVertices() const;
@@ -343,7 +353,10 @@ namespace sf
         virtual void BuildGraphicalObject();
         
         //! A method returning the elements that should be rendered.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method returning the extents of the body axis alligned bounding box.
         /*!
@@ -368,11 +381,17 @@ namespace sf
         Scalar LambKFactor(Scalar r1, Scalar r2);
         virtual void BuildRigidBody();
         void BuildMultibodyLinkCollider(btMultiBody* mb, unsigned int child, btMultiBodyDynamicsWorld* world);
+        void ComputeMultibodyVelocity(Vector3& linVelocity, Vector3& angVelocity) const;
         
         //Body
         btMultiBodyLinkCollider* multibodyCollider;
+        Vector3 mbLinVelocity; //Multibody link velocities cached by the owning multibody
+        Vector3 mbAngVelocity;
+        bool mbVelocityCached;
         
         Mesh* phyMesh; //Mesh used for physics calculation
+        FaceBuffer phyFaces; //Face data of the physics mesh
+        ReducedDragModel dragModel; //Reduced-order damping model fitted from the face data
         Scalar thick;
         Scalar volume;
         
@@ -416,7 +435,7 @@ namespace sf
         
         //Display
         int phyObjectId;
-        Renderable submerged;
+        std::vector<glm::vec3> submerged;
         
     private:
         friend class FeatherstoneEntity;
@@ -52,7 +52,10 @@ namespace sf
         virtual ~StaticEntity();
         
         //! A method implementing the rendering of the entity.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method used to add the static entity to the simulation.
         /*!
@@ -84,7 +87,7 @@ namespace sf
         Transform getTransform();
         
         //! A method returning the material of the entity.
-        Material getMaterial() const;
+        const Material& getMaterial() const;
         
         //! A method returning the rigid body associated with the entity.
         btRigidBody* getRigidBody();
@@ -59,7 +59,10 @@ namespace sf
         virtual void Interpolate();
 
         //! A method returning the elements that should be rendered.
-        Renderable Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
     };
 }
 
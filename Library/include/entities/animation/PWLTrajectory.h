@@ -64,11 +64,14 @@ namespace sf
         virtual void BuildGraphicalPath();
 
         //! A method returning the elements that should be rendered.
-        Renderable Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
 
     protected:
         std::vector<KeyPoint> points;
-        Renderable path;
+        std::vector<glm::vec3> path;
     };
 }
 
@@ -57,7 +57,10 @@ namespace sf
         virtual void Interpolate() = 0;
 
         //! A method returning the elements that should be rendered.
-        virtual Renderable Render() = 0;
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot) = 0;
 
         //! A method returning the current interpolated transform.
         Transform getInterpolatedTransform() const;
@@ -38,10 +38,13 @@ namespace sf
     {
         bool dampingForces;
         bool reallisticBuoyancy;
+        bool reducedOrderDamping;
     };
     
     class VelocityField;
     class Actuator;
+    class SolidEntity;
+    class OceanWaves;
     
     //! A class implementing an ocean.
     class Ocean : public ForcefieldEntity
@@ -78,6 +81,19 @@ namespace sf
          */
         void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute);
         
+        //! A method returning the body which should be affected by the hydrodynamic forces.
+        /*!
+         \param co a pointer to the collision object overlapping with the ocean
+         \return a pointer to the solid entity or nullptr if no forces should be applied
+         */
+        SolidEntity* getFluidForcesBody(btCollisionObject* co) const;
+        
+        //! A method computing the hydrodynamic forces acting on a body (thread safe for different bodies).
+        /*!
+         \param solid a pointer to the solid entity
+         */
+        void ComputeFluidForces(SolidEntity* solid);
+        
         //! A method returning the water velocity.
         /*!
          \param point the point in the ocean where the velocity should be measured [m]
@@ -108,12 +124,32 @@ namespace sf
         Scalar GetDepth(const Vector3& point);
         GLfloat GetDepth(const glm::vec3& point);
         
+        //! A method returning the depth of the ocean at multiple points.
+        /*!
+         \param points a pointer to an array of measurement points [m]
+         \param depths a pointer to an array to be filled with the distances from the points to the surface of fluid [m]
+         \param n the number of points
+         */
+        void GetDepths(const glm::vec3* points, GLfloat* depths, size_t n);
+        
+        //! A method informing if any of the currents is active (fluid velocity not uniform).
+        bool hasCurrents() const;
+        
         //! A method to enable all defined currents.
         void EnableCurrents();
         
         //! A method to disable all defined currents.
         void DisableCurrents();
 
+        //! A method setting if the damping forces of fully submerged bodies are computed with reduced-order models.
+        /*!
+         \param enabled a flag enabling the reduced-order models (the integration over faces is used when the flow is not uniform over the hull)
+         */
+        void setReducedOrderDamping(bool enabled);
+        
+        //! A method informing if the damping forces of fully submerged bodies are computed with reduced-order models.
+        bool isReducedOrderDamping() const;
+        
         //! A method updating the currents data in the OpenGL ocean.
         void UpdateCurrentsData();
         
@@ -128,6 +164,9 @@ namespace sf
         
         //! A method returning a pointer to the OpenGL object implementing the ocean.
         OpenGLOcean* getOpenGLOcean();
+        
+        //! A method returning a pointer to the CPU implementation of the waves (nullptr if not initialized).
+        OceanWaves* getOceanWaves();
 
         //! A method giving direct access to the currents.
         /*!
@@ -145,22 +184,44 @@ namespace sf
          */
         void InitGraphics(SDL_mutex* hydrodynamics);
         
+        //! A method initializing the simulation of waves on the CPU.
+        /*!
+         When initialized, the CPU waves are used to compute the depth, also in the graphical simulation.
+         This makes wave-affected hydrodynamics available without graphics and allows for cross-checking the GPU results.
+         */
+        void InitWaves();
+        
+        //! A method updating the CPU simulation of waves.
+        /*!
+         \param time the simulation time [s]
+         */
+        void UpdateWaves(Scalar time);
+        
         //! A method implementing the rendering of the force field.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
 
         //! A method implementing the rendering of the ocean force field.
-        std::vector<Renderable> Render(const std::vector<Actuator*>& act);
+        /*!
+         \param act a list of actuators affecting the ocean currents
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(const std::vector<Actuator*>& act, RenderSnapshot& snapshot);
         
     private:
         Fluid liquid;
         std::vector<VelocityField*> currents;
         OpenGLOcean* glOcean;
+        OceanWaves* cpuWaves;
         OceanCurrentsUBO glOceanCurrentsUBOData;
         Scalar depth;
         Scalar waterType;
         Scalar oceanState;
         bool currentsEnabled;
-        Renderable wavesDebug;
+        bool reducedOrderDamping;
+        std::vector<glm::vec3> wavesDebug;
     };
 }
 
@@ -0,0 +1,133 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OceanWaves.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_OceanWaves__
+#define __Stonefish_OceanWaves__
+
+#include "graphics/OpenGLOcean.h"
+
+namespace sf
+{
+    //! A class implementing the simulation of ocean waves on the CPU.
+    /*!
+     The waves are generated from the same spectrum and on the same nested grids as in the OpenGL implementation.
+     The height field is obtained with an inverse FFT and stored in the same layout as the data read back from the GPU,
+     which makes it possible to run wave-affected hydrodynamics without graphics or to cross-check the GPU results.
+     */
+    class OceanWaves
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param state the state of the ocean (>0)
+         */
+        OceanWaves(GLfloat state);
+
+        //! A method computing the wave field at the specified time.
+        /*!
+         \param time the simulation time [s]
+         */
+        void Update(GLfloat time);
+
+        //! A method to get wave height at a specified coordinate.
+        /*!
+         \param x the x coordinate in world frame [m]
+         \param y the y coordinate in world frame [m]
+         \return wave height [m]
+         */
+        GLfloat ComputeWaveHeight(GLfloat x, GLfloat y) const;
+
+        //! A method to get wave heights at multiple coordinates.
+        /*!
+         \param points a pointer to an array of points in world frame (only x and y coordinates are used) [m]
+         \param heights a pointer to an array to be filled with wave heights [m]
+         \param n the number of points
+         */
+        void ComputeWaveHeights(const glm::vec3* points, GLfloat* heights, size_t n) const;
+
+        //! A method returning the time for which the wave field was computed.
+        GLfloat getTime() const;
+
+        //! A method returning the parameters of the wave generation.
+        const OceanParams& getParams() const;
+
+        //! A method returning the wave data (4 channels, one per grid).
+        const GLfloat* getWaveData() const;
+
+        //! A method generating the wave spectrum for the four nested grids.
+        /*!
+         \param params the parameters of the waves
+         \param spectrum12 an array of fftSize^2*4 values to be filled with the spectrum of the first and second grid
+         \param spectrum34 an array of fftSize^2*4 values to be filled with the spectrum of the third and fourth grid
+         */
+        static void GenerateSpectrum(const OceanParams& params, GLfloat* spectrum12, GLfloat* spectrum34);
+
+        //! A method computing the spectrum of the waves.
+        /*!
+         \param params the parameters of the waves
+         \param kx the x component of the wave number [1/m]
+         \param ky the y component of the wave number [1/m]
+         \param omnispectrum a flag deciding if the omnidirectional spectrum should be returned
+         \return the value of the spectrum
+         */
+        static GLfloat Spectrum(const OceanParams& params, GLfloat kx, GLfloat ky, bool omnispectrum = false);
+
+        //! A method sampling the wave data with bilinear interpolation, following the OpenGL specification.
+        /*!
+         \param data a pointer to the wave data
+         \param fftSize the size of the wave data grid
+         \param x the x texture coordinate
+         \param y the y texture coordinate
+         \param channel the channel of the data (grid id)
+         \return the interpolated value
+         */
+        static GLfloat InterpolateWaveData(const GLfloat* data, int fftSize, GLfloat x, GLfloat y, GLuint channel);
+
+        //! A method computing wave heights at multiple coordinates, based on the wave data of the two largest grids.
+        /*!
+         \param data a pointer to the wave data
+         \param params the parameters of the waves
+         \param points a pointer to an array of points in world frame (only x and y coordinates are used) [m]
+         \param heights a pointer to an array to be filled with wave heights [m]
+         \param n the number of points
+         */
+        static void SampleWaveHeights(const GLfloat* data, const OceanParams& params, const glm::vec3* points, GLfloat* heights, size_t n);
+
+    private:
+        void InitializeRows(size_t row0, size_t row1);
+        void TransformRows(size_t row0, size_t row1);
+        void TransformColumns(size_t col0, size_t col1);
+        static GLfloat Omega(const OceanParams& params, GLfloat k);
+
+        OceanParams params;
+        std::vector<glm::vec4> h0[4]; //Combined initial spectrum h0(k) and its conjugate h0(-k), for each grid
+        std::vector<GLfloat> omegaK[4]; //Angular frequency of each wave, for each grid
+        std::vector<GLfloat> hRe[2]; //Two packed complex transforms (grids 1+2 and 3+4)
+        std::vector<GLfloat> hIm[2];
+        std::vector<GLfloat> twRe; //Twiddle factors
+        std::vector<GLfloat> twIm;
+        std::vector<unsigned int> bitRev;
+        std::vector<GLfloat> waveData;
+    };
+}
+
+#endif
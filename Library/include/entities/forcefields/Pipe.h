@@ -58,7 +58,11 @@ namespace sf
         Vector3 GetVelocityAtPoint(const Vector3& p) const;
         
         //! A method implementing the rendering of the pipe.
-        std::vector<Renderable> Render(VelocityFieldUBO& ubo);
+        /*!
+         \param ubo a reference to the uniform buffer data of the velocity field
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(VelocityFieldUBO& ubo, RenderSnapshot& snapshot);
 
          //! A method returning the type of the velocity field.
         VelocityFieldType getType() const;
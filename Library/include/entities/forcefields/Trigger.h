@@ -79,7 +79,10 @@ namespace sf
         void Clear();
         
         //! A method implementing the rendering of the trigger.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method returning the activity status.
         bool isActive();
@@ -52,7 +52,11 @@ namespace sf
         virtual Vector3 GetVelocityAtPoint(const Vector3& p) const = 0;
         
         //! A method implementing the rendering of the velocity field.
-        virtual std::vector<Renderable> Render(VelocityFieldUBO& ubo) = 0;
+        /*!
+         \param ubo a reference to the uniform buffer data of the velocity field
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(VelocityFieldUBO& ubo, RenderSnapshot& snapshot) = 0;
 
         //! A method to enable/disable the velocity field.
         void setEnabled(bool en);
@@ -94,7 +94,7 @@ namespace sf
         Vector3 getAugmentedInertia() const;
         
         //! A method returning the material of the body.
-        Material getMaterial(size_t partId) const;
+        const Material& getMaterial(size_t partId) const;
         
         //! A method returning the part id for the collision shape id
         size_t getPartId(size_t collisionShapeId) const;
@@ -115,7 +115,10 @@ namespace sf
         void BuildGraphicalObject();
         
         //! A method that returns elements that have to be rendered for the body.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
     private:
         std::vector<CompoundPart> parts; //Parts of the compound solid
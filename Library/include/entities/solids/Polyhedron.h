@@ -72,6 +72,16 @@ namespace sf
         //! A destructor.
         ~Polyhedron();
         
+        //! A method setting up the generation of the collision geometry.
+        /*!
+         The collision shape is the convex hull of the physics mesh, or an approximate convex decomposition of it,
+         optionally with a bounded number of vertices. By default, the exact convex hull is used. The result is stored in the geometry cache. It has to be called before the body is added to the simulation.
+         \param maxVertices the maximum number of vertices of each convex hull (0 = no limit)
+         \param maxParts the maximum number of convex parts (1 = single convex hull)
+         \param maxConcavity the allowed depth of the concavities of the parts, relative to the size of the mesh
+         */
+        void setCollisionGeometry(unsigned int maxVertices, unsigned int maxParts = 1, Scalar maxConcavity = Scalar(0.02));
+        
         //! A method that returns the type of solid.
         SolidType getSolidType();
         
@@ -83,6 +93,10 @@ namespace sf
         
     private:
         Mesh *graMesh; //Mesh used for rendering
+        std::string phyKey; //Geometry cache key of the physics mesh
+        unsigned int hullVertices;
+        unsigned int hullParts;
+        Scalar hullConcavity;
     };
 }
 
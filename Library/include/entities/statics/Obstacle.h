@@ -100,7 +100,10 @@ namespace sf
         ~Obstacle();
         
         //! A method implementing the rendering of the entity.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method that returns the static body type.
         StaticEntityType getStaticType();
@@ -42,6 +42,15 @@ namespace sf
         GLint location;
     };
     
+    //! A structure representing a handle to a GLSL uniform, resolved once after the shader is built.
+    struct GLSLUniformHandle
+    {
+        GLint location;
+        ParameterType type;
+
+        GLSLUniformHandle() : location(-1), type(FLOAT) {}
+    };
+    
     //! A structure containing information about a GLSL attribute.
     struct GLSLAttribute
     {
@@ -98,7 +107,7 @@ namespace sf
          \param type the type of the attribute
          \return success
          */
-        bool AddAttribute(std::string name, ParameterType type);
+        bool AddAttribute(const std::string& name, ParameterType type);
         
         //! A method to define a GLSL uniform.
         /*!
@@ -106,7 +115,7 @@ namespace sf
          \param type the type of the uniform
          \return success
          */
-        bool AddUniform(std::string name, ParameterType type);
+        bool AddUniform(const std::string& name, ParameterType type);
         
         //! A method used to set a GLSL attribute.
         /*!
@@ -114,7 +123,7 @@ namespace sf
          \param x the value of the attribute
          \return success
          */
-        bool SetAttribute(std::string name, GLfloat x);
+        bool SetAttribute(const std::string& name, GLfloat x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -122,7 +131,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, bool x);
+        bool SetUniform(const std::string& name, bool x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -130,7 +139,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, GLfloat x);
+        bool SetUniform(const std::string& name, GLfloat x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -138,7 +147,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::vec2 x);
+        bool SetUniform(const std::string& name, glm::vec2 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -146,7 +155,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::vec3 x);
+        bool SetUniform(const std::string& name, glm::vec3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -154,7 +163,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::vec4 x);
+        bool SetUniform(const std::string& name, glm::vec4 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -162,7 +171,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, GLuint x);
+        bool SetUniform(const std::string& name, GLuint x);
 
         //! A method used to set a GLSL uniform.
         /*!
@@ -170,7 +179,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, GLint x);
+        bool SetUniform(const std::string& name, GLint x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -178,7 +187,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::ivec2 x);
+        bool SetUniform(const std::string& name, glm::ivec2 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -186,7 +195,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::ivec3 x);
+        bool SetUniform(const std::string& name, glm::ivec3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -194,7 +203,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::ivec4 x);
+        bool SetUniform(const std::string& name, glm::ivec4 x);
 
         //! A method used to set a GLSL uniform.
         /*!
@@ -202,7 +211,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::uvec2 x);
+        bool SetUniform(const std::string& name, glm::uvec2 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -210,7 +219,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::uvec3 x);
+        bool SetUniform(const std::string& name, glm::uvec3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -218,7 +227,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::uvec4 x);
+        bool SetUniform(const std::string& name, glm::uvec4 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -226,7 +235,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::mat3 x);
+        bool SetUniform(const std::string& name, glm::mat3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -234,21 +243,134 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::mat4 x);
+        bool SetUniform(const std::string& name, glm::mat4 x);
 
         //! A method used to bind a GLSL uniform block.
         /*!
          \param name the name of the uniform block
          \param bindingPoint the index of the binding point
          */
-        bool BindUniformBlock(std::string name, GLuint bindingPoint);
+        bool BindUniformBlock(const std::string& name, GLuint bindingPoint);
 
         //! A method used to bind a GLSL shader storage block.
         /*!
          \param name the name of the shader storage block
          \param bindingPoint the index of the binding point
          */
-        bool BindShaderStorageBlock(std::string name, GLuint bindingPoint);
+        bool BindShaderStorageBlock(const std::string& name, GLuint bindingPoint);
+
+        //! A method returning a handle to a GLSL uniform, to be used when setting the uniform often.
+        /*!
+         \param name the name of the uniform
+         \param type the type of the uniform
+         \return a handle to the uniform (invalid if the uniform was not added or has a different type)
+         */
+        GLSLUniformHandle getUniformHandle(const std::string& name, ParameterType type) const;
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, bool x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, GLfloat x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::vec2 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::vec3 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::vec4 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, GLuint x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, GLint x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::ivec2 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::ivec3 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::ivec4 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::uvec2 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::uvec3 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, glm::uvec4 x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, const glm::mat3& x);
+        
+        //! A method used to set a GLSL uniform through a handle.
+        /*!
+         \param uniform a handle to the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle& uniform, const glm::mat4& x);
 
         //! A method to check if the shader is valid.
         bool isValid();
@@ -279,8 +401,8 @@ namespace sf
         static GLuint LoadShader(GLenum shaderType, const std::string& filename, const std::string& header, GLint* shaderCompiled);
         
     private:
-        bool GetAttribute(std::string name, ParameterType type, GLint& index);
-        bool GetUniform(std::string name, ParameterType type, GLint& location);
+        bool GetAttribute(const std::string& name, ParameterType type, GLint& index);
+        bool GetUniform(const std::string& name, ParameterType type, GLint& location) const;
         
         std::vector<GLSLAttribute> attributes;
         std::vector<GLSLUniform> uniforms;
@@ -72,11 +72,24 @@ namespace sf
     };
     #pragma pack(0)
 
+    //! A structure holding the handles of the uniforms set for every drawn object.
+    struct ObjectUniforms
+    {
+        GLSLUniformHandle MVP;
+        GLSLUniformHandle M;
+        GLSLUniformHandle N;
+        GLSLUniformHandle MV;
+        GLSLUniformHandle FC;
+        GLSLUniformHandle eyePos;
+        GLSLUniformHandle viewDir;
+    };
+
     //! A structure representing a material shader collection.
     struct MaterialShader
     {
         std::string shadingAlgorithm;
         GLSLShader* shaders[6];
+        ObjectUniforms uniforms[6];
 
         MaterialShader()
         {
@@ -87,7 +100,10 @@ namespace sf
         {
             shadingAlgorithm = obj.shadingAlgorithm;
             for(size_t i=0; i<6; ++i)
+            {
                 shaders[i] = obj.shaders[i];
+                uniforms[i] = obj.uniforms[i];
+            }
         }
     };
 
@@ -129,6 +145,9 @@ namespace sf
         //! A method returning the view matrix.
         glm::mat4 GetViewMatrix();
         
+        //! A method returning the view-projection matrix.
+        glm::mat4 GetViewProjectionMatrix();
+        
         //! A method to set the current drawing mode.
         /*!
          \param m drawing mode
@@ -215,6 +234,16 @@ namespace sf
          */
         void DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& vertices, glm::vec4 color, glm::mat4 M = glm::mat4(1.f));
         
+        //! A method to draw primitives.
+        /*!
+         \param type the type of the primitive
+         \param vertices a pointer to the array of vertices of the primitives
+         \param count the number of vertices
+         \param color the color to be used when drawing
+         \param M the model matrix
+         */
+        void DrawPrimitives(PrimitiveType type, const glm::vec3* vertices, size_t count, glm::vec4 color, glm::mat4 M = glm::mat4(1.f));
+        
         //! A method to draw an object.
         /*!
          \param objectId the id of the graphical object
@@ -372,9 +401,10 @@ namespace sf
          \param filename a path to the model file
          \param scale the scale of the model
          \param smooth a flag to decide if model normals should be smoothed after loading
-         \return a pointer to the allocated mesh structure
+         \param refineThreshold the relative face area above which the faces are subdivided (0 = no refinement)
+         \return a pointer to the allocated mesh structure (a copy of the mesh stored in the geometry cache)
          */
-        static Mesh* LoadMesh(std::string filename, GLfloat scale, bool smooth);
+        static Mesh* LoadMesh(std::string filename, GLfloat scale, bool smooth, GLfloat refineThreshold = 0.f);
         
         //! A static method to build a graphical plane object.
         /*!
@@ -534,7 +564,11 @@ namespace sf
         GLuint viewUBO;
         
         //Shaders
-        std::map<std::string, GLSLShader*> basicShaders;
+        enum BasicShader {HELPER_SHADER = 0, TEX_SAQ_SHADER, TEX_QUAD_SHADER, TEX_LAYER_QUAD_SHADER, TEX_LEVEL_QUAD_SHADER, TEX_CUBE_SHADER, FLAT_SHADER, SHADOW_SHADER, BASIC_SHADER_COUNT};
+        GLSLShader* basicShaders[BASIC_SHADER_COUNT];
+        GLSLUniformHandle helperUniforms[2]; //MVP, scale
+        GLSLUniformHandle flatUniforms[2]; //MVP, FC
+        GLSLUniformHandle shadowMVP;
         std::vector<MaterialShader> materialShaders;
         GLSLShader* lightSourceShader[2];
         
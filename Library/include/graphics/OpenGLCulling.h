@@ -0,0 +1,87 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OpenGLCulling.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_OpenGLCulling__
+#define __Stonefish_OpenGLCulling__
+
+#include "graphics/OpenGLDataStructs.h"
+
+namespace sf
+{
+    class OpenGLContent;
+
+    //! A class implementing the visibility culling of the solid renderables of a snapshot.
+    /*!
+     The world-space bounding spheres of all solid renderables are computed once per frame and stored in a structure of arrays,
+     padded to a multiple of four, so that the visibility tests process four spheres at a time. Each pass produces its own list
+     of visible spheres. The near plane is never tested, because the main views render with depth clamping enabled.
+     */
+    class OpenGLCulling
+    {
+    public:
+        //! A constructor.
+        OpenGLCulling();
+
+        //! A method computing the world-space bounding spheres of the solid renderables of a snapshot.
+        /*!
+         \param objects a reference to the snapshot
+         \param content a pointer to the OpenGL content manager
+         */
+        void Update(const RenderSnapshot& objects, OpenGLContent* content);
+
+        //! A method finding the spheres intersecting a view frustum.
+        /*!
+         \param VP the view-projection matrix of the view
+         \param visible a reference to the output list of sphere indices
+         */
+        void CullFrustum(const glm::mat4& VP, std::vector<GLuint>& visible) const;
+
+        //! A method finding the spheres intersecting a cone, e.g., the volume lit by a spot light.
+        /*!
+         \param apex the position of the cone apex
+         \param axis the unit direction of the cone axis
+         \param halfAngle the half angle of the cone [rad]
+         \param range the length of the cone
+         \param visible a reference to the output list of sphere indices
+         */
+        void CullCone(const glm::vec3& apex, const glm::vec3& axis, GLfloat halfAngle, GLfloat range, std::vector<GLuint>& visible) const;
+
+        //! A method returning the number of spheres.
+        size_t getCount() const;
+
+        //! A method returning the index of the renderable corresponding to a sphere.
+        /*!
+         \param id the index of the sphere
+         \return the index of the renderable in the snapshot
+         */
+        size_t getItem(GLuint id) const;
+
+    private:
+        std::vector<size_t> items;
+        std::vector<GLfloat> x;
+        std::vector<GLfloat> y;
+        std::vector<GLfloat> z;
+        std::vector<GLfloat> r;
+    };
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include <glm/ext.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <vector>
+#include <algorithm>
 
 #define Max(a, b)   (((a) > (b)) ? (a) : (b))
 
@@ -320,6 +321,8 @@ namespace sf
         GLuint vboIndex;
         GLsizei faceCount;
         bool texturable;
+        glm::vec3 bsCenter; //Center of the bounding sphere in the mesh frame
+        GLfloat bsRadius; //Radius of the bounding sphere
     };
     
     //! An enum representing the type of look of an object.
@@ -474,9 +477,10 @@ namespace sf
         RenderableType type;
         int lookId;
         int objectId;
-        std::string materialName;
+        int materialId; //Index of the physical material (-1 = none)
         glm::mat4 model;
-        std::vector<glm::vec3> points;
+        GLuint firstPoint; //Index of the first point in the point pool of the snapshot
+        GLuint numPoints;
 		
 		static bool SortByMaterial(const Renderable& r1, const Renderable& r2) 
 		{
@@ -484,6 +488,130 @@ namespace sf
 		}
     };
     
+    //! A class representing a snapshot of all objects to be rendered in a frame.
+    /*!
+     The renderables and their points are stored in flat arrays, which are cleared but not freed between frames,
+     so that filling the snapshot does not allocate memory in the steady state. The points of all renderables
+     are stored in a single pool and each renderable refers to a range of it.
+     */
+    class RenderSnapshot
+    {
+    public:
+        //! A method adding a new renderable to the snapshot.
+        /*!
+         The returned reference is valid until the next renderable is added.
+         \param type the type of the renderable
+         \param model the model matrix of the renderable
+         \return a reference to the new renderable
+         */
+        Renderable& Add(RenderableType type, const glm::mat4& model = glm::mat4(1.f))
+        {
+            items.emplace_back();
+            Renderable& r = items.back();
+            r.type = type;
+            r.lookId = -1;
+            r.objectId = -1;
+            r.materialId = -1;
+            r.model = model;
+            r.firstPoint = (GLuint)points.size();
+            r.numPoints = 0;
+            return r;
+        }
+        
+        //! A method adding a copy of the most recently added renderable, sharing its points.
+        /*!
+         \param model the model matrix of the copy
+         \return a reference to the new renderable
+         */
+        Renderable& AddInstance(const glm::mat4& model)
+        {
+            items.push_back(items.back());
+            items.back().model = model;
+            return items.back();
+        }
+        
+        //! A method appending a point to the most recently added renderable.
+        /*!
+         \param p the point
+         */
+        void AddPoint(const glm::vec3& p)
+        {
+            points.push_back(p);
+            ++items.back().numPoints;
+        }
+        
+        //! A method appending a list of points to the most recently added renderable.
+        /*!
+         \param p a list of points
+         */
+        void AddPoints(const std::vector<glm::vec3>& p)
+        {
+            points.insert(points.end(), p.begin(), p.end());
+            items.back().numPoints += (GLuint)p.size();
+        }
+        
+        //! A method removing all renderables, without releasing the memory.
+        void Clear()
+        {
+            items.clear();
+            points.clear();
+        }
+        
+        //! A method exchanging the contents of two snapshots, without copying.
+        /*!
+         \param other a reference to the other snapshot
+         */
+        void Swap(RenderSnapshot& other)
+        {
+            items.swap(other.items);
+            points.swap(other.points);
+        }
+        
+        //! A method sorting the renderables by look, to reduce uniform/texture switching.
+        void SortByMaterial()
+        {
+            std::sort(items.begin(), items.end(), Renderable::SortByMaterial);
+        }
+        
+        //! A method returning the points of a renderable.
+        /*!
+         \param r a reference to a renderable stored in the snapshot
+         \return a pointer to the first point
+         */
+        const glm::vec3* getPoints(const Renderable& r) const
+        {
+            return points.data() + r.firstPoint;
+        }
+        
+        //! An operator returning a renderable.
+        Renderable& operator[](size_t id)
+        {
+            return items[id];
+        }
+        
+        //! An operator returning a renderable.
+        const Renderable& operator[](size_t id) const
+        {
+            return items[id];
+        }
+        
+        //! A method returning the number of renderables.
+        size_t size() const
+        {
+            return items.size();
+        }
+        
+        //! A method checking if the snapshot is empty.
+        bool empty() const
+        {
+            return items.empty();
+        }
+        
+    private:
+        std::vector<Renderable> items;
+        std::vector<glm::vec3> points;
+    };
+    
     //! An enum used to designate rendering quality.
     enum class RenderQuality {DISABLED, LOW, MEDIUM, HIGH};
     
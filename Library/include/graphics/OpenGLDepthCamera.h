@@ -34,6 +34,7 @@ namespace sf
     class GLSLShader;
     class Camera;
     class SolidEntity;
+    class OpenGLReadback;
     
     //! A class representing a depth camera.
     class OpenGLDepthCamera : public OpenGLView
@@ -65,9 +66,9 @@ namespace sf
         
         //! A method that computes simulated depth data.
         /*
-         \param objects a reference to a vector of renderable objects
+         \param objects a reference to the snapshot of renderable objects
          */
-        void ComputeOutput(std::vector<Renderable>& objects);
+        void ComputeOutput(RenderSnapshot& objects);
 
         //! A method to render the low dynamic range (final) image to the screen.
         /*!
@@ -151,7 +152,6 @@ namespace sf
         glm::vec3 tempUp;
         glm::mat4 projection;
         bool _needsUpdate;
-        bool newData;
         glm::vec2 range;
         GLfloat noiseDepth;
         std::default_random_engine randGen;
@@ -160,7 +160,8 @@ namespace sf
         GLuint renderDepthTex;
         GLuint linearDepthTex;
         GLuint linearDepthFBO;
-        GLuint linearDepthPBO;
+        OpenGLReadback* readback;
+        std::vector<GLuint> visibleObjects;
         static GLSLShader** depthCameraOutputShader;
         static GLSLShader* depthVisualizeShader;
     };
@@ -173,6 +173,14 @@ namespace sf
          */
         virtual GLfloat ComputeWaveHeight(GLfloat x, GLfloat y);
 
+        //! A method to get wave heights at multiple coordinates.
+        /*!
+         \param points a pointer to an array of points in world frame (only x and y coordinates are used) [m]
+         \param heights a pointer to an array to be filled with wave heights [m]
+         \param n the number of points
+         */
+        virtual void ComputeWaveHeights(const glm::vec3* points, GLfloat* heights, size_t n);
+
         //! A method returning the id of the wave texture.
         GLuint getWaveTexture();
 
@@ -210,9 +218,7 @@ namespace sf
         float ComputeSlopeVariance();
         float GetSlopeVariance(float kx, float ky, float *spectrumSample);
         void GenerateWavesSpectrum();
-        void GetSpectrumSample(int i, int j, float lengthScale, float kMin, float *result);
         float spectrum(float kx, float ky, bool omnispectrum = false);
-        float omega(float k);
 
         int oceanBoxObj;
         bool particlesEnabled;
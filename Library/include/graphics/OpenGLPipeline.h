@@ -36,6 +36,7 @@ namespace sf
     class SimulationManager;
     class OpenGLContent;
     class OpenGLCamera;
+    class OpenGLCulling;
 
     //! A class implementing the OpenGL rendering pipeline.
     class OpenGLPipeline
@@ -57,26 +58,20 @@ namespace sf
          */
         void Render(SimulationManager* sim);
         
-        //! A method to add renderable objects to the rendering queue.
-        /*!
-         \param r a renderable object
-         */
-        void AddToDrawingQueue(const Renderable& r);
-		
-		//! A method to add multiple renderable objects to the rendering queue.
-		/*!
-		 \param r a vector of renderable objects
-		 */
-        void AddToDrawingQueue(const std::vector<Renderable>& r);
+        //! A method returning a reference to the snapshot filled with the objects to render.
+        RenderSnapshot& getDrawingQueue();
 
-        //! A method to add multiple renderable objects to the selected objects rendering queue.
-		/*!
-		 \param r a vector of renderable objects
-		 */
-        void AddToSelectedDrawingQueue(const std::vector<Renderable>& r);
+        //! A method returning a reference to the snapshot filled with the selected objects.
+        RenderSnapshot& getSelectedDrawingQueue();
 		
-        //! A method that draws all normal objects.
+        //! A method that draws the normal objects visible in the current view.
         void DrawObjects();
+        
+        //! A method that draws a list of normal objects.
+        /*!
+         \param visible a list of sphere indices produced by the culling
+         */
+        void DrawObjects(const std::vector<GLuint>& visible);
 		
 		//! A method that draws all lights.
 		void DrawLights();
@@ -108,21 +103,28 @@ namespace sf
         //! A method returning a pointer to the OpenGL content manager.
         OpenGLContent* getContent();
         
+        //! A method returning a pointer to the culling of the current drawing queue.
+        OpenGLCulling* getCulling();
+        
     private:
         void PerformDrawingQueueCopy(SimulationManager* sim);
         void DrawHelpers();
         
         RenderSettings rSettings;
         HelperSettings hSettings;
-        std::vector<Renderable> drawingQueue;
-        std::vector<Renderable> drawingQueueCopy;
-        std::vector<Renderable> selectedDrawingQueue;
-        std::vector<Renderable> selectedDrawingQueueCopy;
+        RenderSnapshot drawingQueue;
+        RenderSnapshot drawingQueueCopy;
+        RenderSnapshot selectedDrawingQueue;
+        RenderSnapshot selectedDrawingQueueCopy;
         SDL_mutex* drawingQueueMutex;
         std::deque<unsigned int> viewsQueue;
         GLuint screenFBO;
         GLuint screenTex;
         OpenGLContent* content;
+        OpenGLCulling* culling;
+        std::vector<GLuint> visibleObjects;
+        glm::mat4 visibleVP;
+        bool visibleValid;
         Scalar lastSimTime;
     };
 }
@@ -0,0 +1,128 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OpenGLReadback.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_OpenGLReadback__
+#define __Stonefish_OpenGLReadback__
+
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+#include <atomic>
+#include "graphics/OpenGLDataStructs.h"
+
+#define READBACK_NUM_SLOTS 3 //Number of frames of a sensor that can be in flight at the same time
+#define READBACK_QUEUE_SIZE 256 //Capacity of the queue of completed frames (power of 2)
+
+namespace sf
+{
+    class Camera;
+
+    //! A class implementing the asynchronous transfer of the images generated by a vision sensor from the GPU.
+    /*!
+     The images are copied to a ring of pixel buffers, each guarded by a fence. The buffers are mapped persistently when
+     supported by the driver. Completed frames are passed through a lock-free queue to a consumer thread, shared by all
+     sensors, which runs the sensor callbacks. The rendering thread never waits for the transfers nor for the callbacks.
+     When all buffers are in use the new frame is dropped.
+     */
+    class OpenGLReadback
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param sensor a pointer to the sensor receiving the data
+         \param sizes a list of sizes of the images forming a single frame [B]
+         \param firstIndex the index passed to the sensor with the first image of the frame
+         */
+        OpenGLReadback(Camera* sensor, const std::vector<GLsizeiptr>& sizes, unsigned int firstIndex = 0);
+
+        //! A destructor.
+        ~OpenGLReadback();
+
+        //! A method starting the transfer of a new frame.
+        /*!
+         \return true if a buffer was available, false if the frame has to be dropped
+         */
+        bool BeginFrame();
+
+        //! A method copying the texture bound to the active texture unit to the buffer of an image.
+        /*!
+         \param image the index of the image in the frame
+         \param target the target of the texture
+         \param format the format of the pixel data
+         \param type the data type of the pixel data
+         */
+        void ReadTexture(unsigned int image, GLenum target, GLenum format, GLenum type);
+
+        //! A method finishing the transfer of a frame.
+        void EndFrame();
+
+        //! A method passing the completed frames to the consumer thread and recycling the consumed buffers.
+        void Poll();
+        
+        //! A static method waiting until the consumer thread processes all frames passed to it.
+        static void Drain();
+
+    private:
+        enum SlotState : unsigned int {FREE, RECORDING, PENDING, QUEUED, CONSUMED};
+
+        struct Slot
+        {
+            std::vector<GLuint> pbos;
+            std::vector<void*> data;
+            GLsync fence;
+            std::atomic<unsigned int> state;
+        };
+
+        struct Frame
+        {
+            OpenGLReadback* readback;
+            Slot* slot;
+        };
+
+        void Consume(Slot* slot);
+
+        static bool Enqueue(const Frame& frame);
+        static void StartConsumer();
+        static void StopConsumer();
+        static int ConsumerLoop(void* data);
+
+        Camera* sensor;
+        std::vector<GLsizeiptr> sizes;
+        unsigned int firstIndex;
+        bool persistent;
+        std::vector<Slot> slots;
+        unsigned int head; //Oldest frame in flight
+        unsigned int tail; //Next slot to record
+        std::atomic<unsigned int> inFlight;
+        std::atomic<bool> cancelled;
+
+        static Frame queue[READBACK_QUEUE_SIZE];
+        static std::atomic<size_t> queueHead;
+        static std::atomic<size_t> queueTail;
+        static std::atomic<size_t> queueDone;
+        static SDL_Thread* consumer;
+        static SDL_sem* consumerSem;
+        static std::atomic<bool> consumerQuit;
+        static unsigned int numOfReadbacks;
+    };
+}
+
+#endif
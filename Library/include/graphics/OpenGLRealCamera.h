@@ -31,6 +31,7 @@
 namespace sf
 {
     class ColorCamera;
+    class OpenGLReadback;
  
     //! A class implementing a real camera in OpenGL.
     class OpenGLRealCamera : public OpenGLCamera
@@ -108,7 +109,7 @@ namespace sf
         ColorCamera* camera;
         GLuint cameraFBO;
         GLuint cameraColorTex[2];
-        GLuint cameraPBO;
+        OpenGLReadback* readback;
         
         glm::mat4 cameraTransform;
         glm::vec3 eye;
@@ -118,7 +119,6 @@ namespace sf
         glm::vec3 tempDir;
         glm::vec3 tempUp;
         bool _needsUpdate;
-        bool newData;
     };
 }
 
@@ -94,6 +94,14 @@ namespace sf
          */
         GLfloat ComputeWaveHeight(GLfloat x, GLfloat y);
 
+        //! A method to get wave heights at multiple coordinates.
+        /*!
+         \param points a pointer to an array of points in world frame (only x and y coordinates are used) [m]
+         \param heights a pointer to an array to be filled with wave heights [m]
+         \param n the number of points
+         */
+        void ComputeWaveHeights(const glm::vec3* points, GLfloat* heights, size_t n);
+
         //! A method do enable wireframe rendering.
         /*!
          \param enabled a flag to indicating if wireframe should be enabled
@@ -59,9 +59,9 @@ namespace sf
         
         //! A method that computes simulated sonar data.
         /*!
-         \param objects a reference to a vector of renderable objects
+         \param objects a reference to the snapshot of renderable objects
          */
-        void ComputeOutput(std::vector<Renderable>& objects);
+        void ComputeOutput(RenderSnapshot& objects);
         
         //! A method to render the low dynamic range (final) image to the screen.
         /*!
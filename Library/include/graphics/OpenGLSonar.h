@@ -32,6 +32,18 @@
 namespace sf
 {
     class GLSLShader;
+    struct GLSLUniformHandle;
+    class OpenGLReadback;
+    
+    //! A structure holding the data of an object drawn into the sonar input, shared by all sonar views.
+    struct SonarInputObject
+    {
+        int objectId;
+        GLuint normalTexture; //0 = no normal mapping
+        glm::mat4 M;
+        glm::mat3 N;
+        GLfloat restitution;
+    };
     
     //! An abstract class representing a sonar view.
     class OpenGLSonar : public OpenGLView
@@ -51,7 +63,7 @@ namespace sf
         virtual ~OpenGLSonar();
         
         //! A method that computes simulated sonar data.
-        virtual void ComputeOutput(std::vector<Renderable>& objects) = 0;
+        virtual void ComputeOutput(RenderSnapshot& objects) = 0;
         
         //! A method to render the low dynamic range (final) image to the screen.
         /*!
@@ -114,6 +126,19 @@ namespace sf
         static void Destroy();
         
     protected:
+        //! A method that computes the data of the objects drawn into the sonar input, once per frame.
+        /*!
+         The input objects are stored in the order of the bounding spheres of the pipeline culling.
+         \param objects a reference to the snapshot of renderable objects
+         */
+        void PrepareInputObjects(const RenderSnapshot& objects);
+        
+        //! A method that draws the objects visible in a single sonar view into the sonar input.
+        /*!
+         \param VP the view-projection matrix of the sonar view
+         */
+        void DrawInputObjects(const glm::mat4& VP);
+        
         //Sonar specific
         glm::mat4 sonarTransform;
         glm::vec3 eye;
@@ -130,19 +155,20 @@ namespace sf
         ColorMap cMap;
         bool settingsUpdated;
         bool _needsUpdate;
-        bool newData;
         
         //OpenGL
         GLuint inputRangeIntensityTex;
         GLuint inputDepthRBO;
-        GLuint outputPBO;
         GLuint displayTex;
         GLuint displayFBO;
-        GLuint displayPBO;
+        OpenGLReadback* readback; //Display image (index 0) and sonar data (index 1)
         GLuint displayVAO;
         GLuint displayVBO;
+        std::vector<SonarInputObject> inputObjects;
+        std::vector<GLuint> visibleObjects;
         
         static GLSLShader* sonarInputShader[2];
+        static GLSLUniformHandle sonarInputUniforms[2][4]; //MVP, M, N, restitution
         static GLSLShader* sonarVisualizeShader;
     };
 }
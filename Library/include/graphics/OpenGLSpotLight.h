@@ -120,6 +120,7 @@ namespace sf
         GLfloat zFar;
         glm::mat4 clipSpace;
         GLuint shadowFBO;
+        std::vector<GLuint> visibleObjects;
     };
 }
 
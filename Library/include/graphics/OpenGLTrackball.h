@@ -105,9 +105,9 @@ namespace sf
 
         //! A method drawing a selection outline.
         /*!
-         \param r a reference to a vector of renderable objects
+         \param r a reference to the snapshot of selected objects
          */
-        void DrawSelection(const std::vector<Renderable>& r, GLuint destinationFBO);
+        void DrawSelection(const RenderSnapshot& r, GLuint destinationFBO);
         
         //! A method returning the view matrix.
         glm::mat4 GetViewMatrix() const;
@@ -57,7 +57,10 @@ namespace sf
         void ApplyDamping();
         
         //! A method implementing the rendering of the joint.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method to set the damping characteristics of the joint.
         /*!
@@ -74,7 +74,10 @@ namespace sf
         bool SolvePositionIC(Scalar linearTolerance, Scalar angularTolerance);
         
         //! A method implementing the rendering of the joint.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method to set the damping characteristics of the joint.
         /*!
@@ -56,14 +56,17 @@ namespace sf
         Vector3 normalForceA;
     };
 
+    class SimulationManager;
+    
     //! A structure containing the internal data attached to a contact point.
     struct ContactInfo
     {
         Scalar totalAppliedImpulse;
         Vector3 slip;
+        SimulationManager* owner; //Manager whose pool holds the structure (nullptr = heap)
     };
     
-    struct Renderable;
+    class RenderSnapshot;
     class Entity;
     
     //! A class implementing a sensor measuring the contact between two entities.
@@ -113,7 +116,10 @@ namespace sf
         void SaveContactDataToOctaveFile(const std::string& path, bool includeTime = true);
         
         //! A method that implements rendering of the contact.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method to set the display style of the contact.
         /*!
@@ -43,6 +43,15 @@ namespace sf
          */
         Sample(unsigned short nDimensions, Scalar* values, bool invalid = false, uint64_t index = 0);
         
+        //! A constructor.
+        /*!
+         \param t the timestamp of the sample [s]
+         \param nDimensions the number of dimensions of the measurement
+         \param values a pointer to the data
+         \param index a number specifying the id of the sample
+         */
+        Sample(Scalar t, unsigned short nDimensions, const Scalar* values, uint64_t index);
+        
         //! A copy constructor.
         /*!
          \param other a reference to a sample object
@@ -0,0 +1,142 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SampleBuffer.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_SampleBuffer__
+#define __Stonefish_SampleBuffer__
+
+#include <atomic>
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    //! A structure representing a contiguous range of samples stored in a sample buffer (no data is copied).
+    struct SampleSpan
+    {
+        const Scalar* values; //!< Values of the samples (one sample after another, channels interleaved)
+        const Scalar* timestamps; //!< Timestamps of the samples
+        const uint64_t* ids; //!< Ids of the samples
+        size_t length; //!< Number of samples in the range
+    };
+
+    //! A class implementing a contiguous ring buffer of sensor samples.
+    /*!
+     Values, timestamps and ids of the samples are stored in preallocated arrays, so that no memory is allocated
+     when samples are added. A buffer of fixed capacity supports a lock-free read path for a single consumer,
+     running in parallel to the single producer. A buffer of unlimited capacity grows when full and has to be
+     read under the same lock as used by the producer.
+     */
+    class SampleBuffer
+    {
+    public:
+        //! A constructor.
+        SampleBuffer();
+
+        //! A method allocating the memory of the buffer and removing all samples.
+        /*!
+         \param nChannels the number of channels of a single sample
+         \param capacity the maximum number of samples stored (0 = unlimited)
+         */
+        void Allocate(unsigned short nChannels, size_t capacity);
+
+        //! A method removing all samples from the buffer.
+        void Clear();
+
+        //! A method returning a pointer to the memory of the next sample, to be filled by the producer.
+        Scalar* Reserve();
+
+        //! A method publishing the sample written to the memory returned by the Reserve method.
+        /*!
+         \param timestamp the timestamp of the sample [s]
+         \param id the id of the sample
+         */
+        void Commit(Scalar timestamp, uint64_t id);
+
+        //! A method copying samples, which were not read yet, without locking (single consumer only).
+        /*!
+         Samples that were overwritten before being read are skipped.
+         \param cursor the index of the next sample to read, updated by the method (start with 0)
+         \param values a pointer to an array for the values (maxSamples x number of channels)
+         \param timestamps a pointer to an array for the timestamps (can be nullptr)
+         \param ids a pointer to an array for the ids (can be nullptr)
+         \param maxSamples the maximum number of samples to copy
+         \return the number of copied samples
+         */
+        size_t Read(uint64_t& cursor, Scalar* values, Scalar* timestamps, uint64_t* ids, size_t maxSamples) const;
+
+        //! A method returning views of the most recent samples (valid until the next sample is added).
+        /*!
+         \param count the number of requested samples
+         \param spans an array of two ranges, filled with the samples from the oldest to the newest
+         \return the number of filled ranges (0-2)
+         */
+        unsigned int getSpans(size_t count, SampleSpan spans[2]) const;
+
+        //! A method returning the values of a sample.
+        /*!
+         \param index the index of the sample (0 = oldest)
+         \return a pointer to the values of the sample
+         */
+        const Scalar* getValues(size_t index) const;
+
+        //! A method returning the timestamp of a sample.
+        /*!
+         \param index the index of the sample (0 = oldest)
+         \return the timestamp of the sample [s]
+         */
+        Scalar getTimestamp(size_t index) const;
+
+        //! A method returning the id of a sample.
+        /*!
+         \param index the index of the sample (0 = oldest)
+         \return the id of the sample
+         */
+        uint64_t getId(size_t index) const;
+
+        //! A method returning the number of samples stored in the buffer.
+        size_t getSize() const;
+
+        //! A method returning the maximum number of samples that can be stored without growing.
+        size_t getCapacity() const;
+
+        //! A method returning the total number of samples added to the buffer (the cursor of the newest sample + 1).
+        uint64_t getWriteCount() const;
+
+        //! A method returning the number of channels of a single sample.
+        unsigned short getNumOfChannels() const;
+
+    private:
+        void Grow();
+        uint64_t getFirst() const;
+
+        unsigned short nCh;
+        size_t cap;
+        size_t slots; //Number of allocated slots (one more than the capacity for a fixed capacity)
+        bool unlimited;
+        std::vector<Scalar> values;
+        std::vector<Scalar> timestamps;
+        std::vector<uint64_t> ids;
+        std::atomic<uint64_t> start; //Index of the first sample after clearing
+        std::atomic<uint64_t> written; //Total number of committed samples
+    };
+}
+
+#endif
@@ -26,8 +26,8 @@
 #ifndef __Stonefish_ScalarSensor__
 #define __Stonefish_ScalarSensor__
 
-#include <deque>
 #include "sensors/Sensor.h"
+#include "sensors/SampleBuffer.h"
 
 namespace sf
 {
@@ -135,9 +135,39 @@ namespace sf
         //! A method returning the last sample.
         Sample getLastSample();
         
+        //! A method returning the total number of measurements made since the sensor was created.
+        uint64_t getSampleCount();
+        
         //! A method returing a pointer to a copy of the history of sensor measurements.
         const std::vector<Sample>* getHistory();
         
+        //! A method returning views of the most recent measurements, without copying.
+        /*!
+         The views are valid until the next update of the sensor, so the method should be used from the simulation thread.
+         \param count the number of requested measurements
+         \param spans an array of two ranges, filled with the measurements from the oldest to the newest
+         \return the number of filled ranges (0-2)
+         */
+        unsigned int getRecentSamples(size_t count, SampleSpan spans[2]);
+        
+        //! A method copying measurements that were not read yet (single consumer, lock-free for history of limited length).
+        /*!
+         \param cursor the index of the next measurement to read, updated by the method (start with 0)
+         \param values a pointer to an array for the values (maxSamples x number of channels)
+         \param timestamps a pointer to an array for the timestamps (can be nullptr)
+         \param ids a pointer to an array for the ids of the measurements (can be nullptr)
+         \param maxSamples the maximum number of measurements to copy
+         \return the number of copied measurements
+         */
+        size_t ReadSamples(uint64_t& cursor, Scalar* values, Scalar* timestamps, uint64_t* ids, size_t maxSamples);
+        
+        //! A method copying the history of a single channel to a vector (no allocation when the vector is big enough).
+        /*!
+         \param channel the index of the channel
+         \param values a reference to the output vector
+         */
+        void getHistoryValues(unsigned int channel, std::vector<Scalar>& values);
+        
         //! A method returning the value of the measurement.
         /*!
          \param index the index of the history
@@ -168,7 +198,7 @@ namespace sf
         
     protected:
         void AddSampleToHistory(const Sample& s);
-        std::deque<Sample*> history;
+        SampleBuffer history;
         std::vector<SensorChannel> channels;
         uint64_t sampleCount;
         
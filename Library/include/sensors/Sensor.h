@@ -35,7 +35,7 @@ namespace sf
     //! An enum defining types of sensors.
     enum class SensorType {JOINT, LINK, VISION, OTHER};
     
-    struct Renderable;
+    class RenderSnapshot;
     
     //! An abstract class representing a sensor.
     class Sensor
@@ -55,7 +55,10 @@ namespace sf
         virtual void Reset();
         
         //! A method implementing the rendering of the sensor.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method that updates the sensor readings.
         /*!
@@ -63,6 +66,18 @@ namespace sf
          */
         void Update(Scalar dt);
         
+        //! A method that updates the sensor readings when the sensor is due, without checking the sampling rate.
+        /*!
+         \param dt the time since the last update of the sensor [s]
+         */
+        void ScheduledUpdate(Scalar dt);
+        
+        //! A method resolving the sensors, whose measurements are used by this sensor.
+        /*!
+         \return a list of sensors that have to be updated before this one, in the same simulation step
+         */
+        virtual std::vector<Sensor*> ResolveDependencies();
+        
         //! A method used to mark data as old.
         void MarkDataOld();
         
@@ -106,8 +121,7 @@ namespace sf
         Scalar freq;
         SDL_mutex* updateMutex;
         
-        static std::random_device randomDevice;
-        static std::mt19937 randomGenerator;
+        std::mt19937 randomGenerator; //Own noise sequence, so that sensors can be updated in parallel
         
     private:
         std::string name;
@@ -0,0 +1,157 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorLogReader.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_SensorLogReader__
+#define __Stonefish_SensorLogReader__
+
+#include "sensors/SensorLogger.h"
+#include "sensors/ScalarSensor.h"
+
+namespace sf
+{
+    //! A structure describing a channel stored in the sensor log.
+    struct SensorLogChannel
+    {
+        std::string name;
+        QuantityType type;
+        Scalar stdDev;
+        Scalar rangeMin;
+        Scalar rangeMax;
+    };
+
+    //! A structure describing a sensor stored in the sensor log.
+    struct SensorLogSensor
+    {
+        std::string name;
+        ScalarSensorType type;
+        std::vector<SensorLogChannel> channels;
+    };
+
+    //! A structure representing the columns of a single chunk of the sensor log.
+    struct SensorLogColumns
+    {
+        size_t length; //!< Number of samples in the chunk
+        uint64_t dropped; //!< Number of samples lost while the chunk was filled
+        const Scalar* timestamps; //!< Timestamps of the samples
+        const uint64_t* ids; //!< Ids of the samples
+        std::vector<const Scalar*> channels; //!< Values of each channel
+    };
+
+    //! A class implementing a reader of the logs written by the sensor logger.
+    /*!
+     The file is memory-mapped and the columns of uncompressed chunks are accessed in place, without copying.
+     Compressed chunks are decoded once, when the log is opened. The reader does not depend on a running
+     simulation, so that it can be used in post-processing tools.
+     */
+    class SensorLogReader
+    {
+    public:
+        //! A constructor.
+        SensorLogReader();
+
+        //! A destructor.
+        ~SensorLogReader();
+
+        //! A method opening a sensor log.
+        /*!
+         \param path a path to the log file
+         \return success
+         */
+        bool Open(const std::string& path);
+
+        //! A method closing the log.
+        void Close();
+
+        //! A method returning the number of sensors stored in the log.
+        unsigned int getNumOfSensors() const;
+
+        //! A method returning the description of a sensor.
+        /*!
+         \param sensorId the index of the sensor
+         \return a reference to the description of the sensor
+         */
+        const SensorLogSensor& getSensor(unsigned int sensorId) const;
+
+        //! A method returning the index of a sensor.
+        /*!
+         \param name the name of the sensor
+         \return the index of the sensor or -1 if not found
+         */
+        int getSensorId(const std::string& name) const;
+
+        //! A method returning the number of samples of a sensor.
+        /*!
+         \param sensorId the index of the sensor
+         \return the number of samples
+         */
+        size_t getNumOfSamples(unsigned int sensorId) const;
+
+        //! A method returning the number of samples of a sensor lost during logging.
+        /*!
+         \param sensorId the index of the sensor
+         \return the number of lost samples
+         */
+        uint64_t getNumOfDroppedSamples(unsigned int sensorId) const;
+
+        //! A method returning the number of chunks of a sensor.
+        /*!
+         \param sensorId the index of the sensor
+         \return the number of chunks
+         */
+        size_t getNumOfChunks(unsigned int sensorId) const;
+
+        //! A method returning the columns of a chunk (valid until the log is closed).
+        /*!
+         \param sensorId the index of the sensor
+         \param chunkId the index of the chunk
+         \return a reference to the columns of the chunk
+         */
+        const SensorLogColumns& getChunk(unsigned int sensorId, size_t chunkId) const;
+
+        //! A method copying the timestamps of all samples of a sensor to a continuous array.
+        /*!
+         \param sensorId the index of the sensor
+         \param timestamps a reference to the output vector
+         */
+        void getTimestamps(unsigned int sensorId, std::vector<Scalar>& timestamps) const;
+
+        //! A method copying the values of a channel of all samples of a sensor to a continuous array.
+        /*!
+         \param sensorId the index of the sensor
+         \param channel the index of the channel
+         \param values a reference to the output vector
+         */
+        void getChannel(unsigned int sensorId, unsigned int channel, std::vector<Scalar>& values) const;
+
+    private:
+        bool ParseHeader(size_t& offset);
+        bool ParseChunk(size_t& offset);
+
+        const uint8_t* data;
+        size_t size;
+        std::vector<SensorLogSensor> sensors;
+        std::vector<std::vector<SensorLogColumns>> chunks;
+        std::vector<std::vector<uint8_t>> decoded;
+    };
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorLogger.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_SensorLogger__
+#define __Stonefish_SensorLogger__
+
+#include <SDL2/SDL_thread.h>
+#include <deque>
+#include "StonefishCommon.h"
+
+#define SENSOR_LOG_MAGIC "SFSENLOG"
+#define SENSOR_LOG_VERSION 1
+#define SENSOR_LOG_CHUNK_MAGIC 0x4B4E4843 //"CHNK"
+
+namespace sf
+{
+    class ScalarSensor;
+
+    //! An enum defining the encoding of the data chunks in the sensor log.
+    enum class SensorLogEncoding : uint32_t {RAW = 0, DELTA_RLE = 1};
+
+    //! A structure representing the header of a data chunk stored in the sensor log.
+    /*!
+     The header is followed by the columns of the chunk: timestamps, ids and the values of each channel.
+     Each column is padded to 8 bytes. Encoded chunks store each column as XOR-delta, byte-shuffled and
+     zero-run-length encoded data, preceded by its encoded length (uint64_t).
+     */
+    struct SensorLogChunkHeader
+    {
+        uint32_t magic; //!< Chunk marker
+        uint32_t sensorId; //!< Index of the sensor in the log header
+        uint32_t length; //!< Number of samples in the chunk
+        uint32_t encoding; //!< Encoding of the columns
+        uint64_t dataSize; //!< Number of bytes following the header
+        uint64_t dropped; //!< Number of samples of the sensor lost while the chunk was filled
+    };
+
+    //! A class implementing a streaming recorder of scalar sensor measurements.
+    /*!
+     The measurements are gathered on the simulation thread, transposed to columnar chunks and written to a binary
+     file by a background thread. The number of chunks in flight is bounded, so that the memory usage does not grow
+     with the length of the simulation run. The log starts with a self-describing header, built from the channel
+     descriptions of the logged sensors. The measurements are read through a cursor kept for each sensor, so the history
+     of a sensor has to hold all samples produced between two logger updates. Samples lost otherwise are counted in
+     the chunk headers.
+     */
+    class SensorLogger
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param path a path to the output file
+         \param compress a flag deciding if the chunks should be compressed
+         \param chunkLength the number of samples of a single sensor stored in one chunk
+         \param maxQueuedChunks the maximum number of chunks waiting to be written
+         */
+        SensorLogger(const std::string& path, bool compress = false, unsigned int chunkLength = 1024, unsigned int maxQueuedChunks = 32);
+
+        //! A destructor.
+        ~SensorLogger();
+
+        //! A method adding a sensor to the log (before the logging is started).
+        /*!
+         \param sens a pointer to a scalar sensor
+         */
+        void AddSensor(ScalarSensor* sens);
+
+        //! A method opening the file, writing the header and starting the writer thread.
+        /*!
+         \return success
+         */
+        bool Start();
+
+        //! A method copying new measurements of all sensors to the log (called after sensor update).
+        void Update();
+
+        //! A method writing all remaining measurements, stopping the writer thread and closing the file.
+        void Stop();
+
+        //! A method informing if the logger is running.
+        bool isRunning() const;
+
+        //! A method returning the number of logged samples.
+        uint64_t getNumOfSamples() const;
+
+        //! A method returning the number of samples lost, because they were overwritten before being logged.
+        uint64_t getNumOfDroppedSamples() const;
+
+        //! A method returning the number of bytes written to the file.
+        uint64_t getNumOfBytesWritten();
+
+        //! A method encoding a column of data.
+        /*!
+         \param data a pointer to the data
+         \param elementSize the size of a single element in bytes
+         \param n the number of elements
+         \param out a reference to the output buffer (encoded data is appended)
+         */
+        static void EncodeColumn(const void* data, size_t elementSize, size_t n, std::vector<uint8_t>& out);
+
+        //! A method decoding a column of data.
+        /*!
+         \param in a pointer to the encoded data
+         \param inSize the size of the encoded data in bytes
+         \param elementSize the size of a single element in bytes
+         \param n the number of elements
+         \param data a pointer to the output array
+         \return success
+         */
+        static bool DecodeColumn(const uint8_t* in, size_t inSize, size_t elementSize, size_t n, void* data);
+
+    private:
+        struct Chunk
+        {
+            uint32_t sensorId;
+            uint32_t length;
+            uint64_t dropped;
+            std::vector<Scalar> timestamps;
+            std::vector<uint64_t> ids;
+            std::vector<Scalar> values; //Columnar, channel after channel
+            std::vector<uint8_t> encoded;
+        };
+
+        struct LoggedSensor
+        {
+            ScalarSensor* sensor;
+            unsigned short nChannels;
+            uint64_t cursor;
+            uint64_t dropped;
+            Chunk* chunk;
+        };
+
+        Chunk* AcquireChunk(uint32_t sensorId);
+        void SubmitChunk(LoggedSensor& ls);
+        bool WriteHeader();
+        void WriteChunk(Chunk* c);
+        static int WriterLoop(void* data);
+
+        std::string path;
+        bool compress;
+        unsigned int chunkLen;
+        unsigned int maxQueued;
+        std::vector<LoggedSensor> logged;
+        std::vector<Chunk*> chunks;
+        std::vector<Chunk*> freeChunks;
+        std::deque<Chunk*> queue;
+        std::vector<Scalar> readValues;
+        FILE* file;
+        SDL_Thread* writer;
+        SDL_mutex* queueMutex;
+        SDL_cond* queueCond;
+        SDL_cond* freeCond;
+        uint64_t nSamples;
+        uint64_t nDropped;
+        uint64_t nBytes;
+        bool running;
+        bool quit;
+    };
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorScheduler.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_SensorScheduler__
+#define __Stonefish_SensorScheduler__
+
+#include <functional>
+#include <queue>
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    class Sensor;
+    class ThreadPool;
+
+    //! A class implementing the multi-rate scheduling of sensor updates.
+    /*!
+     The sensors with a fixed sampling rate are kept in a queue ordered by the time of the next update, so that only
+     the sensors that are due are touched in each simulation step. The sensors using measurements of other sensors are
+     assigned to later stages than their dependencies. The sensors due in the same stage are updated in parallel.
+     The new data callbacks of the sensors are postponed until the end of the stage and called on the thread running the scheduler.
+     */
+    class SensorScheduler
+    {
+    public:
+        //! A constructor.
+        SensorScheduler();
+
+        //! A method building the schedule.
+        /*!
+         The sensors already present in the schedule keep the time of their next update.
+         \param sensors a list of all sensors of the simulation
+         */
+        void Build(const std::vector<Sensor*>& sensors);
+
+        //! A method updating all sensors that are due.
+        /*!
+         \param dt the time step of the simulation [s]
+         \param pool a pointer to the thread pool used to update the sensors (nullptr = serial update)
+         */
+        void Update(Scalar dt, ThreadPool* pool);
+
+        //! A method marking the schedule as outdated, to be rebuilt before the next update.
+        void Invalidate();
+
+        //! A method removing all sensors from the schedule and restarting its clock.
+        void Reset();
+
+        //! A method informing if the schedule is up to date.
+        bool isValid() const;
+
+        //! A method calling a new data callback of a sensor on the thread running the scheduler.
+        /*!
+         When called during the update of a sensor by the scheduler, the call is postponed until the stage finishes and made
+         in the order of the sensors in the stage. Otherwise, the callback is called immediately.
+         \param callback a function calling the user callback
+         */
+        static void Notify(const std::function<void()>& callback);
+
+    private:
+        struct Entry
+        {
+            Sensor* sensor;
+            Scalar due;
+            unsigned int stage;
+        };
+
+        struct DueSensor
+        {
+            Sensor* sensor;
+            Scalar dt;
+        };
+
+        typedef std::pair<Scalar, size_t> QueueItem;
+
+        unsigned int ComputeStage(size_t id, const std::vector<std::vector<size_t>>& deps, std::vector<int>& stages);
+
+        std::vector<Entry> entries;
+        std::vector<size_t> everyStep; //Sensors updated in every simulation step
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue; //Sensors with a fixed rate, by the time of the next update
+        std::vector<std::vector<DueSensor>> stages;
+        std::vector<std::vector<std::function<void()>>> callbacks; //Callbacks postponed by each sensor of a stage
+        Scalar time;
+        bool valid;
+    };
+}
+
+#endif
@@ -88,7 +88,10 @@ namespace sf
         Scalar getBeamAngle() const;
 
         //! A method resetting the state of the sensor.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method returning the type of the scalar sensor.
         ScalarSensorType getScalarSensorType();
@@ -76,7 +76,10 @@ namespace sf
         void setNoise(Scalar forceStdDev, Scalar torqueStdDev);
         
         //! A method that implements rendering of the sensor.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method returning the current sensor frame in world.
         Transform getSensorFrame() const;
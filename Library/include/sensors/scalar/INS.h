@@ -53,6 +53,12 @@ namespace sf
 
         //! A method that resets the sensor.
         void Reset();
+        
+        //! A method resolving the connected sensors.
+        /*!
+         \return a list of the connected sensors found in the simulation
+         */
+        std::vector<Sensor*> ResolveDependencies();
 
         //! A method used to connect a GPS to the INS.
         /*!
@@ -96,6 +102,8 @@ namespace sf
         ScalarSensorType getScalarSensorType();
 
         private:
+            void ConnectionChanged();
+            
             Scalar latitude, longitude, altitude;
             Vector3 ned;
             Vector3 velocity;
@@ -103,6 +111,9 @@ namespace sf
             std::string gpsName;
             std::string dvlName;
             std::string pressName;
+            GPS* gps;
+            DVL* dvl;
+            Pressure* press;
             std::normal_distribution<Scalar> accNoiseX;
             std::normal_distribution<Scalar> accNoiseY;
             std::normal_distribution<Scalar> accNoiseZ;
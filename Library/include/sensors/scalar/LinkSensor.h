@@ -55,7 +55,10 @@ namespace sf
         virtual void InternalUpdate(Scalar dt) = 0;
         
         //! A method implementing the rendering of the sensor.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
       
         //! A method used to attach the sensor to a rigid body.
         /*!
@@ -72,7 +72,10 @@ namespace sf
         virtual void UpdateTransform();
         
         //! A method implementing the rendering of the camera dummy.
-        virtual std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        virtual void Render(RenderSnapshot& snapshot);
         
         //! A method to set if the camera image should be displayed in the main window.
         /*!
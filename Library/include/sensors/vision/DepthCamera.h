@@ -33,6 +33,7 @@
 namespace sf
 {
     class OpenGLDepthCamera;
+    class RaycastImager;
     
     //! A class representing a depth camera.
     class DepthCamera : public Camera
@@ -101,8 +102,13 @@ namespace sf
         
     private:
         void InitGraphics();
+        void InitRaycasting();
+        void UpdateRaycasting();
         
         OpenGLDepthCamera* glCamera;
+        RaycastImager* rcCamera;
+        std::vector<GLfloat> rcDepth;
+        std::vector<GLfloat> rcData;
         GLfloat* imageData;
         glm::vec2 depthRange;
         GLfloat noiseStdDev;
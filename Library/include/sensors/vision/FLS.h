@@ -33,6 +33,7 @@
 namespace sf
 {
     class OpenGLFLS;
+    class RaycastImager;
     
     //! A class representing a forward looking sonar.
     class FLS : public Camera
@@ -83,7 +84,10 @@ namespace sf
         void InstallNewDataHandler(std::function<void(FLS*)> callback);
         
         //! A method implementing the rendering of the sonar dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
 
         //! A method setting the minimum range of the sonar.
         /*!
@@ -141,8 +145,14 @@ namespace sf
         
     private:
         void InitGraphics();
+        void InitRaycasting();
+        void UpdateRaycasting();
         
         OpenGLFLS* glFLS;
+        RaycastImager* rcFLS;
+        unsigned int nBeamSamples;
+        std::vector<GLfloat> rcOutput;
+        std::vector<GLubyte> rcData;
         GLubyte* sonarData;
         GLubyte* displayData;
         glm::vec2 range;
@@ -33,6 +33,7 @@
 namespace sf
 {
     class OpenGLMSIS;
+    class RaycastImager;
     
     //! A class representing a mechanical scanning imaging sonar.
     class MSIS : public Camera
@@ -85,7 +86,10 @@ namespace sf
         void InstallNewDataHandler(std::function<void(MSIS*)> callback);
         
         //! A method implementing the rendering of the sonar dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
 
         //! A method setting the limits of the sonar head rotation.
         /*!
@@ -163,8 +167,14 @@ namespace sf
         
     private:
         void InitGraphics();
+        void InitRaycasting();
+        void UpdateRaycasting();
         
         OpenGLMSIS* glMSIS;
+        RaycastImager* rcMSIS;
+        glm::uvec2 nBeamSamples;
+        glm::vec2 rcRange;
+        std::vector<GLubyte> rcData;
         GLubyte* sonarData;
         GLubyte* displayData;
         int currentStep;
@@ -35,6 +35,7 @@
 namespace sf
 {
     class OpenGLDepthCamera;
+    class RaycastImager;
     
     //! A structure holding information about a single OpenGL camera.
     struct CamData
@@ -105,7 +106,10 @@ namespace sf
         void InstallNewDataHandler(std::function<void(Multibeam2*)> callback);
         
         //! A method implementing the rendering of the multibeam dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method that returns the limits of measured range.
         glm::vec2 getRangeLimits();
@@ -128,8 +132,12 @@ namespace sf
         
     private:
         void InitGraphics();
+        void InitRaycasting();
+        void UpdateRaycasting();
         
         std::vector<CamData> cameras;
+        RaycastImager* rcMultibeam;
+        std::vector<GLfloat> rcDepth;
         GLfloat* imageData;
         GLfloat* rangeData;
         Scalar fovV;
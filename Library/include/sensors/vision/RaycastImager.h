@@ -0,0 +1,125 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  RaycastImager.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_RaycastImager__
+#define __Stonefish_RaycastImager__
+
+#include <functional>
+#include <random>
+#include "core/SimulationManager.h"
+#include "graphics/OpenGLDataStructs.h"
+
+namespace sf
+{
+    //! A class implementing the generation of range and echo intensity images on the CPU.
+    /*!
+     The images are generated by casting a fixed set of rays against the collision geometry of the world, using the bounding volume
+     hierarchies of the broadphase and of the triangle mesh shapes. It is used by the vision sensors when the simulation runs
+     without graphics. The echo intensity of each ray is computed the same way as in the sonar input shader.
+     */
+    class RaycastImager
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param generator a reference to the random number generator used to simulate noise
+         */
+        RaycastImager(std::mt19937& generator);
+
+        //! A method setting the directions of the rays.
+        /*!
+         \param directions a list of unit vectors defined in the sensor frame
+         */
+        void setRays(const std::vector<Vector3>& directions);
+
+        //! A method casting all rays from the origin of the sensor frame.
+        /*!
+         \param sensorFrame the transformation from the world frame to the sensor frame
+         \param minRange the distance at which the rays start [m]
+         \param maxRange the maximum length of the rays [m]
+         */
+        void Cast(const Transform& sensorFrame, GLfloat minRange, GLfloat maxRange);
+
+        //! A method drawing a sample from the normal distribution.
+        /*!
+         \param mean the mean of the distribution
+         \param stdDev the standard deviation of the distribution
+         \return the drawn sample
+         */
+        GLfloat Gaussian(GLfloat mean, GLfloat stdDev);
+
+        //! A method returning the number of rays.
+        size_t getNumOfRays() const;
+
+        //! A method returning the measured ranges (0 where nothing was hit) [m].
+        const GLfloat* getRanges() const;
+
+        //! A method returning the measured echo intensities.
+        const GLfloat* getIntensities() const;
+
+        //! A method running a task for a range of indices, in parallel if a thread pool is available.
+        /*!
+         \param count the number of indices
+         \param task a function called for each index
+         */
+        static void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+        //! A method applying the 5x5 Gaussian blur of the sonar postprocessing shader and quantizing the result.
+        /*!
+         \param in a pointer to the input image
+         \param width the width of the image [pix]
+         \param height the height of the image [pix]
+         \param out a pointer to the output image
+         */
+        static void Blur(const GLfloat* in, unsigned int width, unsigned int height, GLubyte* out);
+
+        //! A method sampling an image with bilinear filtering.
+        /*!
+         \param data a pointer to the image
+         \param width the width of the image [pix]
+         \param height the height of the image [pix]
+         \param u the horizontal texture coordinate
+         \param v the vertical texture coordinate
+         \return the interpolated value in range 0-1
+         */
+        static GLfloat Sample(const GLubyte* data, unsigned int width, unsigned int height, GLfloat u, GLfloat v);
+
+        //! A method converting a value to a color, the same way as the sonar visualization shader.
+        /*!
+         \param value the value in range 0-1
+         \param cm the color map
+         \param rgb a pointer to the output color
+         */
+        static void MapColor(GLfloat value, ColorMap cm, GLubyte* rgb);
+
+    private:
+        std::vector<Vector3> dirs;
+        std::vector<RayQuery> rays;
+        std::vector<RayHit> hits;
+        std::vector<GLfloat> ranges;
+        std::vector<GLfloat> intensities;
+        std::mt19937& randGen;
+        std::normal_distribution<GLfloat> randNormal;
+    };
+}
+
+#endif
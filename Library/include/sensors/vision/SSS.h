@@ -33,6 +33,7 @@
 namespace sf
 {
     class OpenGLSSS;
+    class RaycastImager;
     
     //! A class representing a side-scan sonar.
     class SSS : public Camera
@@ -85,7 +86,10 @@ namespace sf
         void InstallNewDataHandler(std::function<void(SSS*)> callback);
         
         //! A method implementing the rendering of the sonar dummy.
-        std::vector<Renderable> Render();
+        /*!
+         \param snapshot a reference to the snapshot the renderables are written to
+         */
+        void Render(RenderSnapshot& snapshot);
         
         //! A method setting the minimum range of the sonar.
         /*!
@@ -143,8 +147,14 @@ namespace sf
         
     private:
         void InitGraphics();
+        void InitRaycasting();
+        void UpdateRaycasting();
         
         OpenGLSSS* glSSS;
+        RaycastImager* rcSSS;
+        glm::uvec2 nBeamSamples;
+        std::vector<glm::vec2> rcHist;
+        std::vector<GLubyte> rcData;
         GLubyte* sonarData;
         GLubyte* displayData;
         glm::vec2 range;
@@ -0,0 +1,140 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  GeometryCache.h
+//  Stonefish
+//
+
+#ifndef __Stonefish_GeometryCache__
+#define __Stonefish_GeometryCache__
+
+#include <SDL2/SDL_mutex.h>
+#include <unordered_map>
+#include "utils/GeometryFileUtil.h"
+
+namespace sf
+{
+    //! A structure holding the properties derived from a mesh, stored in the geometry cache.
+    struct DerivedMeshProperties
+    {
+        MeshProperties physical; //!< Mass properties
+        unsigned int approxType; //!< Type of the fluid dynamics approximation
+        std::vector<Scalar> approxParams; //!< Parameters of the fluid dynamics approximation
+        Transform T_CG2H; //!< Transformation from the CG frame to the frame of the approximation
+        Vector3 addedMass; //!< Hydrodynamic added mass
+        Vector3 addedInertia; //!< Hydrodynamic added inertia
+    };
+
+    //! A class implementing a process-wide cache of the geometry loaded from files and of the data derived from it.
+    /*!
+     The entries are identified by content keys, built from the canonical path, modification time and size of the file,
+     and from all parameters affecting the result. Each mesh is loaded and processed only once, and every request returns
+     a private copy of the cached mesh. All entries are also stored in a binary form in the cache directory, so that
+     subsequent runs do not parse the geometry files nor recompute the derived data.
+     */
+    class GeometryCache
+    {
+    public:
+        //! A method returning a copy of a mesh loaded from a file.
+        /*!
+         \param path a path to the geometry file
+         \param scale a scale to apply to the data
+         \param smooth a flag deciding if the normals should be smoothed
+         \param refineThreshold the relative face area above which the faces are subdivided (0 = no refinement)
+         \return a pointer to an allocated mesh or nullptr if the file could not be loaded
+         */
+        static Mesh* LoadMesh(const std::string& path, GLfloat scale, bool smooth, GLfloat refineThreshold = 0.f);
+
+        //! A method returning the key of a mesh.
+        /*!
+         \param path a path to the geometry file
+         \param scale a scale to apply to the data
+         \param smooth a flag deciding if the normals should be smoothed
+         \param refineThreshold the relative face area above which the faces are subdivided (0 = no refinement)
+         \return the key of the mesh or an empty string if the file does not exist
+         */
+        static std::string getMeshKey(const std::string& path, GLfloat scale, bool smooth, GLfloat refineThreshold = 0.f);
+
+        //! A method building the key of derived data.
+        /*!
+         \param meshKey the key of the mesh the data is derived from
+         \param params a list of all parameters the derived data depends on
+         \return the key of the derived data or an empty string if the mesh key is empty
+         */
+        static std::string MakeKey(const std::string& meshKey, const std::vector<Scalar>& params);
+
+        //! A method looking up the properties derived from a mesh.
+        /*!
+         \param key the key of the derived data
+         \param props a reference to the output structure
+         \return true if the properties were found in the cache
+         */
+        static bool getProperties(const std::string& key, DerivedMeshProperties& props);
+
+        //! A method storing the properties derived from a mesh.
+        /*!
+         \param key the key of the derived data
+         \param props a reference to the properties
+         */
+        static void setProperties(const std::string& key, const DerivedMeshProperties& props);
+
+        //! A method looking up the convex hulls derived from a mesh.
+        /*!
+         \param key the key of the derived data
+         \param hulls a reference to the output list of hull vertex sets
+         \return true if the hulls were found in the cache
+         */
+        static bool getHulls(const std::string& key, std::vector<std::vector<Vector3>>& hulls);
+
+        //! A method storing the convex hulls derived from a mesh.
+        /*!
+         \param key the key of the derived data
+         \param hulls a reference to the list of hull vertex sets
+         */
+        static void setHulls(const std::string& key, const std::vector<std::vector<Vector3>>& hulls);
+
+        //! A method setting the directory of the on-disk cache.
+        /*!
+         \param path a path to the directory (empty string disables the on-disk cache)
+         */
+        static void setDirectory(const std::string& path);
+
+        //! A method returning the directory of the on-disk cache.
+        static std::string getDirectory();
+
+        //! A method removing all entries from memory.
+        static void Clear();
+
+    private:
+        static std::string FilePath(const std::string& key, const char* extension);
+        static bool ReadFile(const std::string& key, const char* extension, uint32_t kind, std::vector<uint8_t>& payload);
+        static void WriteFile(const std::string& key, const char* extension, uint32_t kind, const std::vector<uint8_t>& payload);
+        static Mesh* ReadMesh(const std::string& key);
+        static void WriteMesh(const std::string& key, const Mesh* mesh);
+        static Mesh* CopyMesh(const Mesh* mesh);
+        static SDL_mutex* getMutex();
+
+        static std::unordered_map<std::string, Mesh*> meshes;
+        static std::unordered_map<std::string, DerivedMeshProperties> properties;
+        static std::unordered_map<std::string, std::vector<std::vector<Vector3>>> hulls;
+        static std::string directory;
+        static bool directoryInitialized;
+    };
+}
+
+#endif
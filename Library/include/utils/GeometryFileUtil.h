@@ -93,6 +93,28 @@ namespace sf
      \return versor of the inertial axis
      */
     Vector3 FindInertialAxis(Matrix3 I, Scalar value);
+    
+    //! A function to compute the convex hull of a set of points, with a limited number of vertices.
+    /*!
+     If the exact hull has more vertices than allowed, the hull is rebuilt from the extreme vertices, adding
+     one at a time the vertex lying farthest outside, which yields the closest inner approximation for the budget.
+     \param points a list of points
+     \param maxVertices the maximum number of vertices of the hull (0 = no limit)
+     \return a list of vertices of the hull
+     */
+    std::vector<Vector3> ComputeConvexHull(const std::vector<Vector3>& points, unsigned int maxVertices);
+    
+    //! A function to compute an approximate convex decomposition of a mesh.
+    /*!
+     The mesh is recursively cut by axis-aligned planes, always splitting the part whose surface lies deepest below
+     its convex hull (measured along the face normals), and choosing the cut which minimizes the total volume of the hulls of the halves.
+     \param mesh a pointer to the mesh structure
+     \param maxParts the maximum number of convex parts
+     \param maxConcavity the allowed depth of the surface below the hull of a part, relative to the size of the mesh
+     \param maxVertices the maximum number of vertices of each hull (0 = no limit)
+     \return a list of vertex sets of the convex parts
+     */
+    std::vector<std::vector<Vector3>> ComputeConvexDecomposition(const Mesh* mesh, unsigned int maxParts, Scalar maxConcavity, unsigned int maxVertices);
 }
 
 #endif
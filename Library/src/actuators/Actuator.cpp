@@ -54,10 +54,8 @@ std::string Actuator::getName()
     return name;
 }
 
-std::vector<Renderable> Actuator::Render()
+void Actuator::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    return items;
 }
 
 }
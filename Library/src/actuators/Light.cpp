@@ -149,13 +149,9 @@ void Light::UpdateTransform()
     }
 }
     
-std::vector<Renderable> Light::Render()
+void Light::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
-    Renderable item;
-    item.model = glMatrixFromTransform(getActuatorFrame());
-    item.type = RenderableType::ACTUATOR_LINES;
+    snapshot.Add(RenderableType::ACTUATOR_LINES, glMatrixFromTransform(getActuatorFrame()));
     
     GLfloat iconSize = 1.f;
     unsigned int div = 24;
@@ -168,18 +164,18 @@ std::vector<Renderable> Light::Render()
         {
             GLfloat angle1 = (GLfloat)i/(GLfloat)div * 2.f * M_PI;
             GLfloat angle2 = (GLfloat)(i+1)/(GLfloat)div * 2.f * M_PI;
-            item.points.push_back(glm::vec3(r * cosf(angle1), r * sinf(angle1), iconSize));
-            item.points.push_back(glm::vec3(r * cosf(angle2), r * sinf(angle2), iconSize));
+            snapshot.AddPoint(glm::vec3(r * cosf(angle1), r * sinf(angle1), iconSize));
+            snapshot.AddPoint(glm::vec3(r * cosf(angle2), r * sinf(angle2), iconSize));
         }
         
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(r, 0, iconSize));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-r, 0, iconSize));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(0, r, iconSize));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(0, -r, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(r, 0, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(-r, 0, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(0, r, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(0, -r, iconSize));
     }
     else
     {
@@ -187,18 +183,14 @@ std::vector<Renderable> Light::Render()
         {
             GLfloat angle1 = (GLfloat)i/(GLfloat)div * 2.f * M_PI;
             GLfloat angle2 = (GLfloat)(i+1)/(GLfloat)div * 2.f * M_PI;
-            item.points.push_back(glm::vec3(0.5f * iconSize * cosf(angle1), 0.5f * iconSize * sinf(angle1), 0));
-            item.points.push_back(glm::vec3(0.5f * iconSize * cosf(angle2), 0.5f * iconSize * sinf(angle2), 0));
-            item.points.push_back(glm::vec3(0.5f * iconSize * cosf(angle1), 0, 0.5f * iconSize * sinf(angle1)));
-            item.points.push_back(glm::vec3(0.5f * iconSize * cosf(angle2), 0, 0.5f * iconSize * sinf(angle2)));
-            item.points.push_back(glm::vec3(0, 0.5f * iconSize * cosf(angle1), 0.5f * iconSize * sinf(angle1)));
-            item.points.push_back(glm::vec3(0, 0.5f * iconSize * cosf(angle2), 0.5f * iconSize * sinf(angle2)));
+            snapshot.AddPoint(glm::vec3(0.5f * iconSize * cosf(angle1), 0.5f * iconSize * sinf(angle1), 0));
+            snapshot.AddPoint(glm::vec3(0.5f * iconSize * cosf(angle2), 0.5f * iconSize * sinf(angle2), 0));
+            snapshot.AddPoint(glm::vec3(0.5f * iconSize * cosf(angle1), 0, 0.5f * iconSize * sinf(angle1)));
+            snapshot.AddPoint(glm::vec3(0.5f * iconSize * cosf(angle2), 0, 0.5f * iconSize * sinf(angle2)));
+            snapshot.AddPoint(glm::vec3(0, 0.5f * iconSize * cosf(angle1), 0.5f * iconSize * sinf(angle1)));
+            snapshot.AddPoint(glm::vec3(0, 0.5f * iconSize * cosf(angle2), 0.5f * iconSize * sinf(angle2)));
         }
     }
-    
-    items.push_back(item);
-    
-    return items;
 }
 
 }
@@ -58,16 +58,9 @@ void LinkActuator::AttachToSolid(SolidEntity* body, const Transform& origin)
     }
 }
 
-std::vector<Renderable> LinkActuator::Render()
+void LinkActuator::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-
-    Renderable item;
-    item.type = RenderableType::SENSOR_CS;
-    item.model = glMatrixFromTransform(getActuatorFrame());
-    items.push_back(item);
-
-    return items;
+    snapshot.Add(RenderableType::SENSOR_CS, glMatrixFromTransform(getActuatorFrame()));
 }
     
 }
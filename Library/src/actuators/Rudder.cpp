@@ -159,34 +159,26 @@ void Rudder::Update(Scalar dt)
     }
 }
 
-std::vector<Renderable> Rudder::Render()
+void Rudder::Render(RenderSnapshot& snapshot)
 {
     Transform rudderTrans = Transform::getIdentity();
     if(attach != NULL)
         rudderTrans = attach->getOTransform() * o2a;
-    else
-        LinkActuator::Render();
     
     //Rotate rudder
     rudderTrans *= Transform(Quaternion(theta, 0, 0)) * rudder->getO2GTransform();
     
     //Add renderable
-    std::vector<Renderable> items(0);
-    Renderable item;
-    item.type = RenderableType::SOLID;
-    item.materialName = rudder->getMaterial().name;
+    glm::mat4 model = glMatrixFromTransform(rudderTrans);
+    Renderable& item = snapshot.Add(RenderableType::SOLID, model);
+    item.materialId = rudder->getMaterial().id;
     item.objectId = rudder->getGraphicalObject();
     item.lookId = dm == DisplayMode::GRAPHICAL ? rudder->getLook() : -1;
-	item.model = glMatrixFromTransform(rudderTrans);
-    items.push_back(item);
     
-    item.type = RenderableType::ACTUATOR_LINES;
-    item.points.push_back(glm::vec3(0,0,0));
+    snapshot.Add(RenderableType::ACTUATOR_LINES, model);
+    snapshot.AddPoint(glm::vec3(0,0,0));
     Vector3 VG = .1*(rudder->getO2GTransform().inverse().getBasis()*(liftV + dragV));
-    item.points.push_back(glm::vec3(VG.getX(),VG.getY(),VG.getZ()));
-    items.push_back(item);
-    
-    return items;
+    snapshot.AddPoint(glm::vec3(VG.getX(),VG.getY(),VG.getZ()));
 }
     
 }
@@ -170,33 +170,25 @@ void Thruster::Update(Scalar dt)
     }
 }
 
-std::vector<Renderable> Thruster::Render()
+void Thruster::Render(RenderSnapshot& snapshot)
 {
     Transform thrustTrans = Transform::getIdentity();
     if(attach != NULL)
         thrustTrans = attach->getOTransform() * o2a;
-    else
-        LinkActuator::Render();
     
     //Rotate propeller
     thrustTrans *= Transform(Quaternion(0, 0, theta), Vector3(0,0,0));
     
     //Add renderable
-    std::vector<Renderable> items(0);
-    Renderable item;
-    item.type = RenderableType::SOLID;
-    item.materialName = prop->getMaterial().name;
+    glm::mat4 model = glMatrixFromTransform(thrustTrans);
+    Renderable& item = snapshot.Add(RenderableType::SOLID, model);
+    item.materialId = prop->getMaterial().id;
     item.objectId = prop->getGraphicalObject();
     item.lookId = dm == DisplayMode::GRAPHICAL ? prop->getLook() : -1;
-	item.model = glMatrixFromTransform(thrustTrans);
-    items.push_back(item);
     
-    item.type = RenderableType::ACTUATOR_LINES;
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(glm::vec3(0.1f*thrust,0,0));
-    items.push_back(item);
-    
-    return items;
+    snapshot.Add(RenderableType::ACTUATOR_LINES, model);
+    snapshot.AddPoint(glm::vec3(0,0,0));
+    snapshot.AddPoint(glm::vec3(0.1f*thrust,0,0));
 }
     
 }
@@ -142,24 +142,16 @@ void VariableBuoyancy::Update(Scalar dt)
     }
 }
 
-std::vector<Renderable> VariableBuoyancy::Render()
+void VariableBuoyancy::Render(RenderSnapshot& snapshot)
 {
     Transform vbsTrans = Transform::getIdentity();
     if(attach != NULL)
         vbsTrans.setOrigin(attach->getOTransform() * o2a * CG);
-    else
-        LinkActuator::Render();
     
     //Add renderable
-    std::vector<Renderable> items(0);
-    Renderable item;
-    item.type = RenderableType::ACTUATOR_LINES;
-    item.model = glMatrixFromTransform(vbsTrans);
-    item.points.push_back(glm::vec3(0,0,0));
-    item.points.push_back(0.1f * glm::vec3((GLfloat)force.x(), (GLfloat)force.y(), (GLfloat)force.z()));
-    items.push_back(item);
-    
-    return items;
+    snapshot.Add(RenderableType::ACTUATOR_LINES, glMatrixFromTransform(vbsTrans));
+    snapshot.AddPoint(glm::vec3(0,0,0));
+    snapshot.AddPoint(0.1f * glm::vec3((GLfloat)force.x(), (GLfloat)force.y(), (GLfloat)force.z()));
 }
     
     
@@ -34,7 +34,7 @@ namespace sf
 {
  
 //Static
-std::map<uint64_t, AcousticModem*> AcousticModem::nodes; 
+std::map<SimulationManager*, std::map<uint64_t, AcousticModem*>> AcousticModem::networks;
 
 void AcousticModem::addNode(AcousticModem* node)
 {
@@ -44,10 +44,10 @@ void AcousticModem::addNode(AcousticModem* node)
         return;
     }
         
-    if(nodes.find(node->getDeviceId()) != nodes.end())
+    if(nodes->find(node->getDeviceId()) != nodes->end())
         cError("Modem node with ID=%d already exists!", node->getDeviceId());
     else
-        nodes[node->getDeviceId()] = node;
+        (*nodes)[node->getDeviceId()] = node;
 }
 
 void AcousticModem::removeNode(uint64_t deviceId)
@@ -55,9 +55,9 @@ void AcousticModem::removeNode(uint64_t deviceId)
     if(deviceId == 0)
         return;
         
-    std::map<uint64_t, AcousticModem*>::iterator it = nodes.find(deviceId);
-    if(it != nodes.end())
-        nodes.erase(it);
+    std::map<uint64_t, AcousticModem*>::iterator it = nodes->find(deviceId);
+    if(it != nodes->end() && it->second == this)
+        nodes->erase(it);
 }
 
 AcousticModem* AcousticModem::getNode(uint64_t deviceId)
@@ -67,7 +67,7 @@ AcousticModem* AcousticModem::getNode(uint64_t deviceId)
     
     try
     {
-        return nodes.at(deviceId);
+        return nodes->at(deviceId);
     }
     catch(const std::out_of_range& oor)
     {
@@ -93,11 +93,14 @@ bool AcousticModem::mutualContact(uint64_t device1Id, uint64_t device2Id)
         
     if(node1->getOcclusionTest() || node2->getOcclusionTest())
     {
-        btCollisionWorld::ClosestRayResultCallback closest(pos1, pos2);
-        closest.m_collisionFilterGroup = MASK_DYNAMIC;
-        closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-        SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(pos1, pos2, closest);
-        return !closest.hasHit();
+        RayQuery ray;
+        ray.from = pos1;
+        ray.to = pos2;
+        ray.group = MASK_DYNAMIC;
+        ray.mask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
+        RayHit hit;
+        SimulationApp::getApp()->getSimulationManager()->CastRays(&ray, &hit, 1);
+        return hit.object == nullptr;
     }
     else
         return true;
@@ -115,12 +118,24 @@ AcousticModem::AcousticModem(std::string uniqueName, uint64_t deviceId, Scalar m
     position = V0();
     frame = std::string("");
     occlusion = true;
+    nodes = &networks[SimulationApp::getApp()->getSimulationManager()];
     addNode(this);
 }
 
 AcousticModem::~AcousticModem()
 {
     removeNode(this->getDeviceId());
+    
+    //The network of a world is removed together with its last modem (when the world is destroyed)
+    if(nodes->empty())
+    {
+        for(auto it = networks.begin(); it != networks.end(); ++it)
+            if(&it->second == nodes)
+            {
+                networks.erase(it);
+                break;
+            }
+    }
 }
 
 bool AcousticModem::isReceptionPossible(Vector3 worldDir, Scalar distance)
@@ -245,14 +260,11 @@ void AcousticModem::UpdatePosition(Vector3 pos, bool absolute, std::string refer
     newDataAvailable = true;
 }
 
-std::vector<Renderable> AcousticModem::Render()
+void AcousticModem::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     //Fov indicator
-    Renderable item;
-    item.model = glMatrixFromTransform(getDeviceFrame());
-    item.type = RenderableType::SENSOR_LINES;
+    glm::mat4 model = glMatrixFromTransform(getDeviceFrame());
+    snapshot.Add(RenderableType::SENSOR_LINES, model);
     GLfloat iconSize = 0.25f;
     int div = 24;
     //Upper circle
@@ -263,9 +275,10 @@ std::vector<Renderable> AcousticModem::Render()
         for(int i=0; i<=div; ++i)
         {
             GLfloat angle = (GLfloat)i/(GLfloat)div * 2.f * M_PI;
-            item.points.push_back(glm::vec3(glm::cos(angle)*r, glm::sin(angle)*r, -h));
+            glm::vec3 v(glm::cos(angle)*r, glm::sin(angle)*r, -h);
+            snapshot.AddPoint(v);
             if(i > 0 && i < div)
-                item.points.push_back(item.points.back());
+                snapshot.AddPoint(v);
         }
     }
     //Lower circle
@@ -276,9 +289,10 @@ std::vector<Renderable> AcousticModem::Render()
         for(int i=0; i<=div; ++i)
         {
             GLfloat angle = (GLfloat)i/(GLfloat)div * 2.f * M_PI;
-            item.points.push_back(glm::vec3(glm::cos(angle)*r, glm::sin(angle)*r, -h));
+            glm::vec3 v(glm::cos(angle)*r, glm::sin(angle)*r, -h);
+            snapshot.AddPoint(v);
             if(i > 0 && i < div)
-                item.points.push_back(item.points.back());
+                snapshot.AddPoint(v);
         }
     }
     //4 bars
@@ -293,42 +307,36 @@ std::vector<Renderable> AcousticModem::Render()
             for(int h=0; h<=div; ++h)
             {
                 GLfloat angle = (GLfloat)h/(GLfloat)div * (maxFov2-minFov2) + minFov2;
-                item.points.push_back(glm::vec3(glm::sin(angle)*x, glm::sin(angle)*y, -glm::cos(angle)*iconSize));
+                glm::vec3 v(glm::sin(angle)*x, glm::sin(angle)*y, -glm::cos(angle)*iconSize);
+                snapshot.AddPoint(v);
                 if(h == 0 && minFov2 > Scalar(0))
                 {
-                    glm::vec3 v = item.points.back();
-                    item.points.push_back(glm::vec3(0.f,0.f,0.f));
-                    item.points.push_back(v);
+                    snapshot.AddPoint(glm::vec3(0.f,0.f,0.f));
+                    snapshot.AddPoint(v);
                 }
                 else if(h == div && maxFov2 < Scalar(M_PI))
                 {
-                    item.points.push_back(item.points.back());
-                    item.points.push_back(glm::vec3(0.f,0.f,0.f));
+                    snapshot.AddPoint(v);
+                    snapshot.AddPoint(glm::vec3(0.f,0.f,0.f));
                 }
                 else if(h > 0 && h < div)
-                    item.points.push_back(item.points.back());
+                    snapshot.AddPoint(v);
             }
         }
     }
-    items.push_back(item);
 
     //Axes
-    item.type = RenderableType::SENSOR_CS;
-    items.push_back(item);
+    snapshot.Add(RenderableType::SENSOR_CS, model);
 
 #ifdef DEBUG
-    item.type = RenderableType::SENSOR_POINTS;
-    item.model = glm::mat4(1.f);
+    snapshot.Add(RenderableType::SENSOR_POINTS);
     std::map<AcousticDataFrame*, Vector3>::iterator mIt;
     for(mIt = propagating.begin(); mIt != propagating.end(); ++mIt)
     {
         Vector3 mPos = mIt->second;
-        item.points.push_back(glm::vec3((GLfloat)mPos.getX(), (GLfloat)mPos.getY(), (GLfloat)mPos.getZ()));
+        snapshot.AddPoint(glm::vec3((GLfloat)mPos.getX(), (GLfloat)mPos.getY(), (GLfloat)mPos.getZ()));
     }
-    items.push_back(item);
 #endif
-
-    return items;
 }
 
 }
\ No newline at end of file
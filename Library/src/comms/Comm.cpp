@@ -164,16 +164,9 @@ void Comm::Update(Scalar dt)
     SDL_UnlockMutex(updateMutex);
 }
 
-std::vector<Renderable> Comm::Render()
+void Comm::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
-    Renderable item;
-    item.type = RenderableType::SENSOR_CS;
-    item.model = glMatrixFromTransform(getDeviceFrame());
-    items.push_back(item);
-    
-    return items;
+    snapshot.Add(RenderableType::SENSOR_CS, glMatrixFromTransform(getDeviceFrame()));
 }
     
 }
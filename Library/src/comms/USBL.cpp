@@ -25,14 +25,15 @@
 
 #include "comms/USBL.h"
 
+#include "core/SimulationApp.h"
+#include "core/SimulationManager.h"
+
 namespace sf
 {
     
-std::random_device USBL::randomDevice;
-std::mt19937 USBL::randomGenerator(randomDevice());
-    
 USBL::USBL(std::string uniqueName, uint64_t deviceId, Scalar minVerticalFOVDeg, Scalar maxVerticalFOVDeg, Scalar operatingRange)
-           : AcousticModem(uniqueName, deviceId, minVerticalFOVDeg, maxVerticalFOVDeg, operatingRange)
+           : AcousticModem(uniqueName, deviceId, minVerticalFOVDeg, maxVerticalFOVDeg, operatingRange),
+             randomGenerator(SimulationApp::getApp()->getSimulationManager()->getRandomGenerator())
 {
     ping = false;
     noise = false;
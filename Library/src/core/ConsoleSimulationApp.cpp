@@ -37,6 +37,7 @@ ConsoleSimulationApp::ConsoleSimulationApp(std::string name, std::string dataDir
 : SimulationApp(name, dataDirPath, sim)
 {
     simulationThread = NULL;
+    lockstep = true;
 }
 
 ConsoleSimulationApp::~ConsoleSimulationApp()
@@ -49,6 +50,16 @@ bool ConsoleSimulationApp::hasGraphics()
     return false;
 }
 
+void ConsoleSimulationApp::setLockstep(bool enabled)
+{
+    lockstep = enabled;
+}
+
+bool ConsoleSimulationApp::isLockstep()
+{
+    return lockstep;
+}
+
 void ConsoleSimulationApp::Init()
 {
     //Initialization
@@ -88,6 +99,13 @@ void ConsoleSimulationApp::StopSimulation()
     int status;
     SDL_WaitThread(simulationThread, &status);
     simulationThread = NULL;
+    
+    if(lockstep)
+    {
+        SimulationManager* sim = getSimulationManager();
+        cInfo("Simulated %1.3lf s at %1.1lf steps/s (%1.2lfx real time).", sim->getSimulationTime(),
+              sim->getAchievedStepsPerSecond(), sim->getAchievedRealtimeFactor());
+    }
 }
 
 //Static
@@ -96,8 +114,16 @@ int ConsoleSimulationApp::RunSimulation(void* data)
     ConsoleSimulationThreadData* stdata = (ConsoleSimulationThreadData*)data;
     SimulationManager* sim = stdata->app->getSimulationManager();
     
-    while(stdata->app->isRunning())
-        sim->AdvanceSimulation();
+    if(((ConsoleSimulationApp*)stdata->app)->lockstep)
+    {
+        while(stdata->app->isRunning())
+            sim->StepSimulation(1);
+    }
+    else
+    {
+        while(stdata->app->isRunning())
+            sim->AdvanceSimulation();
+    }
 
     return 0;
 }
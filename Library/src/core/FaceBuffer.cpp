@@ -0,0 +1,353 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  FaceBuffer.cpp
+//  Stonefish
+//
+
+#include "core/FaceBuffer.h"
+
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+//Selection of the vector unit used by the kernels
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMD_WIDTH 4
+#else
+#define SIMD_WIDTH 1
+#endif
+
+namespace sf
+{
+
+#if SIMD_WIDTH == 8
+typedef __m256 vfloat;
+typedef __m256 vmask;
+
+static inline vfloat vLoad(const GLfloat* p) { return _mm256_loadu_ps(p); }
+static inline vfloat vSet(GLfloat a) { return _mm256_set1_ps(a); }
+static inline vfloat vAdd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat vSub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat vMul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat vMax(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+static inline vfloat vSqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+static inline vfloat vAbs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+static inline vmask vLess(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vmask vGreater(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline vfloat vSelect(vmask m, vfloat a) { return _mm256_and_ps(m, a); }
+static inline vfloat vPow2(vfloat n)
+{
+    __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+}
+static inline vfloat vRound(vfloat a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline GLfloat vSum(vfloat a)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+#elif SIMD_WIDTH == 4
+typedef __m128 vfloat;
+typedef __m128 vmask;
+
+static inline vfloat vLoad(const GLfloat* p) { return _mm_loadu_ps(p); }
+static inline vfloat vSet(GLfloat a) { return _mm_set1_ps(a); }
+static inline vfloat vAdd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vSub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vMul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vMax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+static inline vfloat vSqrt(vfloat a) { return _mm_sqrt_ps(a); }
+static inline vfloat vAbs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+static inline vmask vLess(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+static inline vmask vGreater(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+static inline vfloat vSelect(vmask m, vfloat a) { return _mm_and_ps(m, a); }
+static inline vfloat vPow2(vfloat n)
+{
+    __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+    return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+}
+static inline vfloat vRound(vfloat a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+static inline GLfloat vSum(vfloat a)
+{
+    __m128 s = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+#else
+typedef GLfloat vfloat;
+typedef bool vmask;
+
+static inline vfloat vLoad(const GLfloat* p) { return *p; }
+static inline vfloat vSet(GLfloat a) { return a; }
+static inline vfloat vAdd(vfloat a, vfloat b) { return a + b; }
+static inline vfloat vSub(vfloat a, vfloat b) { return a - b; }
+static inline vfloat vMul(vfloat a, vfloat b) { return a * b; }
+static inline vfloat vSqrt(vfloat a) { return sqrtf(a); }
+static inline vfloat vAbs(vfloat a) { return fabsf(a); }
+static inline vmask vLess(vfloat a, vfloat b) { return a < b; }
+static inline vmask vGreater(vfloat a, vfloat b) { return a > b; }
+static inline vfloat vSelect(vmask m, vfloat a) { return m ? a : 0.f; }
+static inline GLfloat vSum(vfloat a) { return a; }
+#endif
+
+#if SIMD_WIDTH > 1
+//Exponential function for non-positive arguments (Cephes polynomial, relative error < 2e-7)
+static inline vfloat vExp(vfloat x)
+{
+    x = vMax(x, vSet(-87.f));
+    vfloat n = vRound(vMul(x, vSet(1.44269504088896341f)));
+    x = vSub(x, vMul(n, vSet(0.693359375f)));
+    x = vAdd(x, vMul(n, vSet(2.12194440e-4f)));
+    vfloat y = vSet(1.9875691500e-4f);
+    y = vAdd(vMul(y, x), vSet(1.3981999507e-3f));
+    y = vAdd(vMul(y, x), vSet(8.3334519073e-3f));
+    y = vAdd(vMul(y, x), vSet(4.1665795894e-2f));
+    y = vAdd(vMul(y, x), vSet(1.6666665459e-1f));
+    y = vAdd(vMul(y, x), vSet(5.0000001201e-1f));
+    y = vAdd(vAdd(vMul(vMul(y, x), x), x), vSet(1.f));
+    return vMul(y, vPow2(n));
+}
+#else
+static inline vfloat vExp(vfloat x) { return expf(x); }
+#endif
+
+//Hash of the exact vertex position, used to find vertices shared by faces
+struct VertexPositionHash
+{
+    size_t operator()(const glm::vec3& p) const
+    {
+        uint32_t b[3];
+        memcpy(b, &p.x, sizeof(uint32_t));
+        memcpy(b+1, &p.y, sizeof(uint32_t));
+        memcpy(b+2, &p.z, sizeof(uint32_t));
+        size_t h = b[0];
+        h = h * 73856093u ^ b[1];
+        h = h * 19349663u ^ b[2];
+        return h;
+    }
+};
+
+FaceBuffer::FaceBuffer() : nFaces(0)
+{
+}
+
+void FaceBuffer::Build(const Mesh* mesh)
+{
+    nFaces = mesh->faces.size();
+    size_t size = (nFaces + FACE_BUFFER_PADDING - 1)/FACE_BUFFER_PADDING * FACE_BUFFER_PADDING;
+
+    //Padding faces have zero area and normal
+    cx.assign(size, 0.f);
+    cy.assign(size, 0.f);
+    cz.assign(size, 0.f);
+    nx.assign(size, 0.f);
+    ny.assign(size, 0.f);
+    nz.assign(size, 0.f);
+    area.assign(size, 0.f);
+    vertices.clear();
+    faceVertices.resize(nFaces * 3);
+
+    std::unordered_map<glm::vec3, GLuint, VertexPositionHash> vertexIndex;
+    for(size_t i=0; i<nFaces; ++i)
+    {
+        for(unsigned short h=0; h<3; ++h)
+        {
+            glm::vec3 pos = mesh->getVertexPos(i, h);
+            auto it = vertexIndex.find(pos);
+            if(it == vertexIndex.end())
+            {
+                it = vertexIndex.emplace(pos, (GLuint)vertices.size()).first;
+                vertices.push_back(pos);
+            }
+            faceVertices[i * 3 + h] = it->second;
+        }
+    }
+
+    for(size_t i=0; i<nFaces; ++i)
+    {
+        glm::vec3 p1 = mesh->getVertexPos(i, 0);
+        glm::vec3 p2 = mesh->getVertexPos(i, 1);
+        glm::vec3 p3 = mesh->getVertexPos(i, 2);
+        glm::vec3 fc = (p1+p2+p3)/3.f; //Face centroid
+        cx[i] = fc.x;
+        cy[i] = fc.y;
+        cz[i] = fc.z;
+
+        glm::vec3 fn = glm::cross(p2-p1, p3-p1); //Normal of the face (length != 1)
+        GLfloat len = glm::length2(fn);
+        if(len < 1e-12f) continue; //Degenerate faces are kept with zero area
+        len = glm::sqrt(len);
+        nx[i] = fn.x/len;
+        ny[i] = fn.y/len;
+        nz[i] = fn.z/len;
+        area[i] = len/2.f;
+    }
+}
+
+void FaceBuffer::ComputeDampingForces(const glm::vec3& p, const glm::vec3& v, const glm::vec3& omega,
+                                      const glm::vec3& vf, const GLfloat* vfx, const GLfloat* vfy, const GLfloat* vfz,
+                                      glm::vec3& Fdl, glm::vec3& Tdl, glm::vec3& Fdq, glm::vec3& Tdq, glm::vec3& Fds, glm::vec3& Tds) const
+{
+    bool uniformFluid = (vfx == nullptr || vfy == nullptr || vfz == nullptr);
+
+    //Constants
+    const vfloat px = vSet(p.x), py = vSet(p.y), pz = vSet(p.z);
+    const vfloat vx = vSet(v.x), vy = vSet(v.y), vz = vSet(v.z);
+    const vfloat wx = vSet(omega.x), wy = vSet(omega.y), wz = vSet(omega.z);
+    const vfloat zero = vSet(0.f);
+    const vfloat normalThreshold = vSet(-1e-12f);
+    const vfloat tangentThreshold = vSet(1e-3f);
+    const vfloat minusHalf = vSet(-0.5f);
+    vfloat ufx = vSet(vf.x), ufy = vSet(vf.y), ufz = vSet(vf.z);
+
+    //Accumulators
+    vfloat Fdlx = zero, Fdly = zero, Fdlz = zero, Tdlx = zero, Tdly = zero, Tdlz = zero;
+    vfloat Fdqx = zero, Fdqy = zero, Fdqz = zero, Tdqx = zero, Tdqy = zero, Tdqz = zero;
+    vfloat Fdsx = zero, Fdsy = zero, Fdsz = zero, Tdsx = zero, Tdsy = zero, Tdsz = zero;
+
+    size_t size = getBufferSize();
+    for(size_t i=0; i<size; i+=SIMD_WIDTH)
+    {
+        vfloat A = vLoad(&area[i]);
+        vfloat fnx = vLoad(&nx[i]);
+        vfloat fny = vLoad(&ny[i]);
+        vfloat fnz = vLoad(&nz[i]);
+
+        //Lever arm
+        vfloat rx = vSub(vLoad(&cx[i]), px);
+        vfloat ry = vSub(vLoad(&cy[i]), py);
+        vfloat rz = vSub(vLoad(&cz[i]), pz);
+
+        //Fluid velocity relative to the face
+        if(!uniformFluid)
+        {
+            ufx = vLoad(&vfx[i]);
+            ufy = vLoad(&vfy[i]);
+            ufz = vLoad(&vfz[i]);
+        }
+        vfloat vcx = vSub(ufx, vAdd(vx, vSub(vMul(wy, rz), vMul(wz, ry))));
+        vfloat vcy = vSub(ufy, vAdd(vy, vSub(vMul(wz, rx), vMul(wx, rz))));
+        vfloat vcz = vSub(ufz, vAdd(vz, vSub(vMul(wx, ry), vMul(wy, rx))));
+
+        //Normal velocity magnitude and tangent velocity
+        vfloat vn = vAdd(vAdd(vMul(vcx, fnx), vMul(vcy, fny)), vMul(vcz, fnz));
+        vfloat vtx = vSub(vcx, vMul(vn, fnx));
+        vfloat vty = vSub(vcy, vMul(vn, fny));
+        vfloat vtz = vSub(vcz, vMul(vn, fnz));
+
+        //Torque arm of the normal direction (forces along the normal share it)
+        vfloat rnx = vSub(vMul(ry, fnz), vMul(rz, fny));
+        vfloat rny = vSub(vMul(rz, fnx), vMul(rx, fnz));
+        vfloat rnz = vSub(vMul(rx, fny), vMul(ry, fnx));
+
+        //Pressure drag (only faces moving against the fluid)
+        vmask front = vLess(vn, normalThreshold);
+        vfloat vnA = vMul(vn, A);
+        vfloat vmag2 = vMul(vn, vn);
+        vfloat kl = vSelect(front, vMul(vnA, vExp(vMul(minusHalf, vmag2))));
+        vfloat kq = vSelect(front, vMul(vnA, vAbs(vn)));
+
+        Fdlx = vAdd(Fdlx, vMul(fnx, kl));
+        Fdly = vAdd(Fdly, vMul(fny, kl));
+        Fdlz = vAdd(Fdlz, vMul(fnz, kl));
+        Tdlx = vAdd(Tdlx, vMul(rnx, kl));
+        Tdly = vAdd(Tdly, vMul(rny, kl));
+        Tdlz = vAdd(Tdlz, vMul(rnz, kl));
+        Fdqx = vAdd(Fdqx, vMul(fnx, kq));
+        Fdqy = vAdd(Fdqy, vMul(fny, kq));
+        Fdqz = vAdd(Fdqz, vMul(fnz, kq));
+        Tdqx = vAdd(Tdqx, vMul(rnx, kq));
+        Tdqy = vAdd(Tdqy, vMul(rny, kq));
+        Tdqz = vAdd(Tdqz, vMul(rnz, kq));
+
+        //Skin friction
+        vfloat vt2 = vAdd(vAdd(vMul(vtx, vtx), vMul(vty, vty)), vMul(vtz, vtz));
+        vfloat ks = vSelect(vGreater(vt2, tangentThreshold), vMul(vSqrt(vt2), A));
+        vfloat sx = vMul(vtx, ks);
+        vfloat sy = vMul(vty, ks);
+        vfloat sz = vMul(vtz, ks);
+
+        Fdsx = vAdd(Fdsx, sx);
+        Fdsy = vAdd(Fdsy, sy);
+        Fdsz = vAdd(Fdsz, sz);
+        Tdsx = vAdd(Tdsx, vSub(vMul(ry, sz), vMul(rz, sy)));
+        Tdsy = vAdd(Tdsy, vSub(vMul(rz, sx), vMul(rx, sz)));
+        Tdsz = vAdd(Tdsz, vSub(vMul(rx, sy), vMul(ry, sx)));
+    }
+
+    Fdl = glm::vec3(vSum(Fdlx), vSum(Fdly), vSum(Fdlz));
+    Tdl = glm::vec3(vSum(Tdlx), vSum(Tdly), vSum(Tdlz));
+    Fdq = glm::vec3(vSum(Fdqx), vSum(Fdqy), vSum(Fdqz));
+    Tdq = glm::vec3(vSum(Tdqx), vSum(Tdqy), vSum(Tdqz));
+    Fds = glm::vec3(vSum(Fdsx), vSum(Fdsy), vSum(Fdsz));
+    Tds = glm::vec3(vSum(Tdsx), vSum(Tdsy), vSum(Tdsz));
+}
+
+glm::vec3 FaceBuffer::getCentroid(size_t faceID) const
+{
+    return glm::vec3(cx[faceID], cy[faceID], cz[faceID]);
+}
+
+glm::vec3 FaceBuffer::getNormal(size_t faceID) const
+{
+    return glm::vec3(nx[faceID], ny[faceID], nz[faceID]);
+}
+
+GLfloat FaceBuffer::getArea(size_t faceID) const
+{
+    return area[faceID];
+}
+
+const GLuint* FaceBuffer::getFaceVertices(size_t faceID) const
+{
+    return &faceVertices[faceID * 3];
+}
+
+glm::vec3 FaceBuffer::getVertex(size_t vertexID) const
+{
+    return vertices[vertexID];
+}
+
+size_t FaceBuffer::getNumOfVertices() const
+{
+    return vertices.size();
+}
+
+size_t FaceBuffer::getNumOfFaces() const
+{
+    return nFaces;
+}
+
+size_t FaceBuffer::getBufferSize() const
+{
+    return area.size();
+}
+
+bool FaceBuffer::isEmpty() const
+{
+    return area.size() == 0;
+}
+
+}
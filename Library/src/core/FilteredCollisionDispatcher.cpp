@@ -25,39 +25,61 @@
 
 #include "core/FilteredCollisionDispatcher.h"
 
+#include <algorithm>
 #include "BulletDynamics/Dynamics/btRigidBody.h"
-#include "core/SimulationApp.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "LinearMath/btPoolAllocator.h"
 #include "core/SimulationManager.h"
+#include "core/ThreadPool.h"
 #include "entities/SolidEntity.h"
 #include "sensors/Contact.h"
 
+#define DISPATCH_GRAIN_SIZE 32 //Number of overlapping pairs processed by a single task
+
 namespace sf
 {
 
-FilteredCollisionDispatcher::FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, bool inclusiveMode) : btCollisionDispatcher(collisionConfiguration)
+//Overlapping pair processed by the current thread, used to order the manifolds created during parallel dispatch
+static thread_local int dispatchPairIndex = 0;
+static thread_local int dispatchSequence = 0;
+
+static inline bool isSoftBodyPair(const btBroadphasePair& pair)
+{
+    return (((btCollisionObject*)pair.m_pProxy0->m_clientObject)->getInternalType() & btCollisionObject::CO_SOFT_BODY)
+            || (((btCollisionObject*)pair.m_pProxy1->m_clientObject)->getInternalType() & btCollisionObject::CO_SOFT_BODY);
+}
+
+FilteredCollisionDispatcher::FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, SimulationManager* sm) : btCollisionDispatcher(collisionConfiguration)
+{
+    simManager = sm;
+    threadPool = nullptr;
+    batchDispatch = false;
+    batchLock = 0;
+    setNearCallback(myNearCallback);
+}
+
+void FilteredCollisionDispatcher::setThreadPool(ThreadPool* pool)
 {
-    inclusive = inclusiveMode;
-    //setNearCallback(myNearCallback);
+    threadPool = pool;
 }
 
 bool FilteredCollisionDispatcher::needsCollision(const btCollisionObject* body0, const btCollisionObject* body1)
 {
-    bool needs = btCollisionDispatcher::needsCollision(body0, body1);
-    if(!needs)
-        return false;
-    
+    return btCollisionDispatcher::needsCollision(body0, body1) && isCollisionEnabled(body0, body1);
+}
+
+bool FilteredCollisionDispatcher::isCollisionEnabled(const btCollisionObject* body0, const btCollisionObject* body1) const
+{
+    //Objects not owned by entities (e.g. ghosts) do not need contacts
     Entity* ent0 = (Entity*)body0->getUserPointer();
-    if(ent0 == NULL)
+    if(ent0 == nullptr)
         return false;
         
     Entity* ent1 = (Entity*)body1->getUserPointer();
-    if(ent1 == NULL)
+    if(ent1 == nullptr)
         return false;
     
-    if(inclusive)
-        return SimulationApp::getApp()->getSimulationManager()->CheckCollision(ent0, ent1) > -1;
-    else //exclusive
-        return SimulationApp::getApp()->getSimulationManager()->CheckCollision(ent0, ent1) == -1;
+    return simManager->CheckCollision(ent0, ent1);
 }
 
 void FilteredCollisionDispatcher::myNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo)
@@ -65,7 +87,19 @@ void FilteredCollisionDispatcher::myNearCallback(btBroadphasePair& collisionPair
     btCollisionObject* colObj0 = (btCollisionObject*)collisionPair.m_pProxy0->m_clientObject;
     btCollisionObject* colObj1 = (btCollisionObject*)collisionPair.m_pProxy1->m_clientObject;
     
-    if(dispatcher.needsCollision(colObj0,colObj1))
+    //Pair excluded by filtering --> release algorithm (and its contact manifold) if collision was disabled after it was created
+    if(!((FilteredCollisionDispatcher&)dispatcher).isCollisionEnabled(colObj0, colObj1))
+    {
+        if(collisionPair.m_algorithm)
+        {
+            collisionPair.m_algorithm->~btCollisionAlgorithm();
+            dispatcher.freeCollisionAlgorithm(collisionPair.m_algorithm);
+            collisionPair.m_algorithm = nullptr;
+        }
+        return;
+    }
+    
+    if(dispatcher.btCollisionDispatcher::needsCollision(colObj0,colObj1))
     {
         btCollisionObjectWrapper obj0Wrap(0, colObj0->getCollisionShape(), colObj0, colObj0->getWorldTransform(), -1, -1);
         btCollisionObjectWrapper obj1Wrap(0, colObj1->getCollisionShape(), colObj1, colObj1->getWorldTransform(), -1, -1);
@@ -94,4 +128,194 @@ void FilteredCollisionDispatcher::myNearCallback(btBroadphasePair& collisionPair
     }
 }
 
+void FilteredCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher)
+{
+    int numPairs = pairCache->getNumOverlappingPairs();
+    
+    //Time of impact queries modify the shared dispatcher info
+    if(threadPool == nullptr || numPairs <= DISPATCH_GRAIN_SIZE || dispatchInfo.m_dispatchFunc != btDispatcherInfo::DISPATCH_DISCRETE)
+    {
+        btCollisionDispatcher::dispatchAllCollisionPairs(pairCache, dispatchInfo, dispatcher);
+        return;
+    }
+    
+    btBroadphasePair* pairs = pairCache->getOverlappingPairArrayPtr();
+    btNearCallback callback = getNearCallback();
+    
+    batchDispatch = true;
+    
+    threadPool->ParallelFor((numPairs + DISPATCH_GRAIN_SIZE - 1)/DISPATCH_GRAIN_SIZE, [&](size_t task)
+    {
+        int end = btMin(((int)task + 1) * DISPATCH_GRAIN_SIZE, numPairs);
+        for(int i = (int)task * DISPATCH_GRAIN_SIZE; i < end; ++i)
+        {
+            if(isSoftBodyPair(pairs[i]))
+                continue;
+            
+            dispatchPairIndex = i;
+            dispatchSequence = 0;
+            callback(pairs[i], *this, dispatchInfo);
+        }
+    });
+    
+    //Soft body algorithms append contacts to the bodies --> serial computation
+    for(int i = 0; i < numPairs; ++i)
+    {
+        if(!isSoftBodyPair(pairs[i]))
+            continue;
+        
+        dispatchPairIndex = i;
+        dispatchSequence = 0;
+        callback(pairs[i], *this, dispatchInfo);
+    }
+    
+    batchDispatch = false;
+    MergeBatch();
+}
+
+btPersistentManifold* FilteredCollisionDispatcher::getNewManifold(const btCollisionObject* body0, const btCollisionObject* body1)
+{
+    if(!batchDispatch)
+        return btCollisionDispatcher::getNewManifold(body0, body1);
+    
+    Scalar breakingThreshold = (m_dispatcherFlags & CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD)
+                                ? btMin(body0->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold), 
+                                        body1->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold))
+                                : gContactBreakingThreshold;
+    Scalar processingThreshold = btMin(body0->getContactProcessingThreshold(), body1->getContactProcessingThreshold());
+    
+    //Same bookkeeping as btCollisionDispatcher::getNewManifold (the vendored Bullet keeps no global manifold counter),
+    //except that the manifold is added to the list after the dispatch
+    SDL_AtomicLock(&batchLock);
+    void* mem = m_persistentManifoldPoolAllocator->allocate(sizeof(btPersistentManifold));
+    SDL_AtomicUnlock(&batchLock);
+    if(mem == nullptr) //Pool exhausted
+    {
+        if(m_dispatcherFlags & CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION)
+        {
+            btAssert(0);
+            return nullptr;
+        }
+        mem = btAlignedAlloc(sizeof(btPersistentManifold), 16);
+    }
+    
+    btPersistentManifold* manifold = new(mem) btPersistentManifold(body0, body1, 0, breakingThreshold, processingThreshold);
+    
+    SDL_AtomicLock(&batchLock);
+    batchManifolds.push_back(BatchManifold{manifold, dispatchPairIndex, dispatchSequence++});
+    SDL_AtomicUnlock(&batchLock);
+    return manifold;
+}
+
+void FilteredCollisionDispatcher::releaseManifold(btPersistentManifold* manifold)
+{
+    if(!batchDispatch)
+    {
+        btCollisionDispatcher::releaseManifold(manifold);
+        return;
+    }
+    
+    //Manifold is removed from the list and destroyed after the dispatch
+    clearManifold(manifold);
+    SDL_AtomicLock(&batchLock);
+    releasedManifolds.push_back(manifold);
+    SDL_AtomicUnlock(&batchLock);
+}
+
+void* FilteredCollisionDispatcher::allocateCollisionAlgorithm(int size)
+{
+    if(!batchDispatch)
+        return btCollisionDispatcher::allocateCollisionAlgorithm(size);
+    
+    SDL_AtomicLock(&batchLock);
+    void* mem = btCollisionDispatcher::allocateCollisionAlgorithm(size);
+    SDL_AtomicUnlock(&batchLock);
+    return mem;
+}
+
+void FilteredCollisionDispatcher::freeCollisionAlgorithm(void* ptr)
+{
+    if(!batchDispatch)
+    {
+        btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+        return;
+    }
+    
+    SDL_AtomicLock(&batchLock);
+    btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+    SDL_AtomicUnlock(&batchLock);
+}
+
+void FilteredCollisionDispatcher::ApplyContactForce(SolidEntity* solid, const Vector3& F, const Vector3& T)
+{
+    if(!batchDispatch)
+    {
+        solid->ApplyCentralForce(F);
+        solid->ApplyTorque(T);
+        return;
+    }
+    
+    BatchForce bf{solid, F, T, dispatchPairIndex, dispatchSequence++};
+    SDL_AtomicLock(&batchLock);
+    batchForces.push_back(bf);
+    SDL_AtomicUnlock(&batchLock);
+}
+
+void FilteredCollisionDispatcher::MergeBatch()
+{
+    //Remove released manifolds, keeping the order of the remaining ones
+    if(releasedManifolds.size() > 0)
+    {
+        for(size_t i=0; i<releasedManifolds.size(); ++i)
+            releasedManifolds[i]->m_index1a = -1;
+        
+        int n = 0;
+        for(int i=0; i<m_manifoldsPtr.size(); ++i)
+            if(m_manifoldsPtr[i]->m_index1a >= 0)
+                m_manifoldsPtr[n++] = m_manifoldsPtr[i];
+        m_manifoldsPtr.resizeNoInitialize(n);
+    }
+    
+    //Append new manifolds in the order of the overlapping pairs, as in serial dispatch
+    std::sort(batchManifolds.begin(), batchManifolds.end(), [](const BatchManifold& a, const BatchManifold& b)
+    {
+        return a.pairIndex < b.pairIndex || (a.pairIndex == b.pairIndex && a.sequence < b.sequence);
+    });
+    
+    for(size_t i=0; i<batchManifolds.size(); ++i)
+        if(batchManifolds[i].manifold->m_index1a >= 0)
+            m_manifoldsPtr.push_back(batchManifolds[i].manifold);
+    
+    for(int i=0; i<m_manifoldsPtr.size(); ++i)
+        m_manifoldsPtr[i]->m_index1a = i;
+    
+    for(size_t i=0; i<releasedManifolds.size(); ++i)
+        DestroyManifold(releasedManifolds[i]);
+    
+    //Apply contact forces in the order of the overlapping pairs, so that the sums do not depend on the threads
+    std::sort(batchForces.begin(), batchForces.end(), [](const BatchForce& a, const BatchForce& b)
+    {
+        return a.pairIndex < b.pairIndex || (a.pairIndex == b.pairIndex && a.sequence < b.sequence);
+    });
+    
+    for(size_t i=0; i<batchForces.size(); ++i)
+    {
+        batchForces[i].solid->ApplyCentralForce(batchForces[i].F);
+        batchForces[i].solid->ApplyTorque(batchForces[i].T);
+    }
+    
+    batchManifolds.clear();
+    releasedManifolds.clear();
+    batchForces.clear();
+}
+
+void FilteredCollisionDispatcher::DestroyManifold(btPersistentManifold* manifold)
+{
+    manifold->~btPersistentManifold();
+    if(m_persistentManifoldPoolAllocator->validPtr(manifold))
+        m_persistentManifoldPoolAllocator->freeMemory(manifold);
+    else
+        btAlignedFree(manifold);
+}
+
 }
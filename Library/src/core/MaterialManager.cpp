@@ -52,6 +52,7 @@ std::string MaterialManager::CreateMaterial(const std::string& uniqueName, Scala
 {
     //Create and add new material
     Material mat;
+    mat.id = (int)materials.size();
     mat.name = materialNameManager.AddName(uniqueName);
     mat.density = density;
     mat.restitution = restitution;
@@ -60,23 +61,17 @@ std::string MaterialManager::CreateMaterial(const std::string& uniqueName, Scala
     
     cInfo("Material %s (%d) created.", mat.name.c_str(), materials.size()-1);
     
-    //Set initial friction coefficients
+    //Grow interaction matrix and set initial friction coefficients
     Friction f;
     f.fStatic = Scalar(1);
     f.fDynamic = Scalar(1);
     
-    MaterialPair p;
-    p.mat1Id = (int)materials.size()-1;
-    
-    for(unsigned int i=0; i < materials.size(); ++i)
-    {
-        p.mat2Id = i;
-        interactions.insert({p,f});
-    }
-    
-    //Display interactions
-    //for(std::pair<MaterialPair, Friction> element : interactions)
-    //	std::cout << "(" << element.first.mat1Id << "," << element.first.mat2Id << ")" << std::endl;
+    size_t n = materials.size();
+    std::vector<Friction> grown(n*n, f);
+    for(size_t i=0; i<n-1; ++i)
+        for(size_t j=0; j<n-1; ++j)
+            grown[i*n+j] = interactions[i*(n-1)+j];
+    interactions.swap(grown);
 
     return mat.name;
 }
@@ -95,38 +90,30 @@ std::string MaterialManager::CreateFluid(const std::string& uniqueName, Scalar d
 
 bool MaterialManager::SetMaterialsInteraction(const std::string& firstMaterialName, const std::string& secondMaterialName, Scalar staticFricCoeff, Scalar dynamicFricCoeff)
 {
-    MaterialPair p;
-    p.mat1Id = getMaterialIndex(firstMaterialName);
-    p.mat2Id = getMaterialIndex(secondMaterialName);
+    int mat1Id = getMaterialIndex(firstMaterialName);
+    int mat2Id = getMaterialIndex(secondMaterialName);
     
-    Friction f;
-    f.fStatic = staticFricCoeff;
-    f.fDynamic = dynamicFricCoeff;
-    
-    try
-    {
-        interactions.at(p) = f;
-        return true;
-    }
-    catch(const std::out_of_range& e)
+    if(mat1Id < 0 || mat2Id < 0)
     {
         cError("Material pair (%s,%s) not found!", firstMaterialName.c_str(), secondMaterialName.c_str());
         return false;
     }
+    
+    Friction f;
+    f.fStatic = staticFricCoeff;
+    f.fDynamic = dynamicFricCoeff;
+    
+    size_t n = materials.size();
+    interactions[mat1Id*n + mat2Id] = f;
+    interactions[mat2Id*n + mat1Id] = f;
+    return true;
 }
 
-Friction MaterialManager::GetMaterialsInteraction(int mat1Index, int mat2Index)
+Friction MaterialManager::GetMaterialsInteraction(int mat1Index, int mat2Index) const
 {
-    MaterialPair p;
-    p.mat1Id = mat1Index;
-    p.mat2Id = mat2Index;
-        
-    try
-    {
-        Friction f = interactions.at(p);
-        return f;
-    }
-    catch(const std::out_of_range& e)
+    int n = (int)materials.size();
+    
+    if(mat1Index < 0 || mat1Index >= n || mat2Index < 0 || mat2Index >= n)
     {
         cError("Material pair (%d,%d) not found!", mat1Index, mat2Index);
         
@@ -136,6 +123,8 @@ Friction MaterialManager::GetMaterialsInteraction(int mat1Index, int mat2Index)
         
         return f;
     }
+    
+    return interactions[mat1Index*n + mat2Index];
 }
 
 Friction MaterialManager::GetMaterialsInteraction(const std::string& mat1Name, const std::string& mat2Name)
@@ -162,7 +151,7 @@ Material MaterialManager::getMaterial(const std::string& name)
     return materials[0];
 }
 
-Material MaterialManager::getMaterial(int index)
+const Material& MaterialManager::getMaterial(int index) const
 {
     if(index >= 0 && index < (int)materials.size())
         return materials[index];
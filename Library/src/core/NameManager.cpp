@@ -30,48 +30,40 @@ namespace sf
 
 NameManager::NameManager()
 {
-    names = std::vector<std::string>(0);
 }
 
 NameManager::~NameManager()
 {
-    names.clear();
+    ClearNames();
 }
 
 std::string NameManager::AddName(std::string proposedName)
 {
-    std::string goodName = proposedName;
-    int number = 1;
+    if(names.insert(proposedName).second)
+        return proposedName;
     
-checkname:
-    for(unsigned int i = 0; i < names.size(); i++)
+    //Continue numbering from the last suffix generated for this name
+    unsigned int& number = nextSuffix.emplace(proposedName, 1).first->second;
+    std::string goodName;
+    do
     {
-        if(goodName == names[i])
-        {
-            goodName = proposedName + std::to_string(number);
-            number++;
-            goto checkname;
-        }
+        goodName = proposedName + std::to_string(number);
+        ++number;
     }
+    while(!names.insert(goodName).second);
     
-    names.push_back(goodName);
     return goodName;
 }
 
 void NameManager::RemoveName(std::string name)
 {
-    std::vector<std::string>::iterator it;
-    for(it = names.begin(); it < names.end(); it++)
-        if(*it == name)
-        {
-            names.erase(it);
-            break;
-        }
+    names.erase(name);
 }
 
 void NameManager::ClearNames()
 {
     names.clear();
+    nextSuffix.clear();
 }
 
 }
@@ -0,0 +1,267 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ParallelDynamicsWorld.cpp
+//  Stonefish
+//
+
+#include "core/ParallelDynamicsWorld.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
+#include "BulletDynamics/Featherstone/btMultiBodyConstraint.h"
+#include "BulletDynamics/Featherstone/btMultiBodyMLCPConstraintSolver.h"
+#include "BulletDynamics/MLCPSolvers/btMLCPSolverInterface.h"
+#include "core/SimulationManager.h"
+#include "core/ThreadPool.h"
+
+namespace sf
+{
+
+//Island callback collecting the batches of islands instead of solving them in place
+struct ParallelDynamicsWorld::IslandCollector : public MultiBodyInplaceSolverIslandCallback
+{
+    IslandCollector(btMultiBodyConstraintSolver* solver, btDispatcher* dispatcher, ParallelDynamicsWorld* w)
+        : MultiBodyInplaceSolverIslandCallback(solver, dispatcher), world(w)
+    {
+    }
+    
+    void processConstraints(int islandId = -1)
+    {
+        if(world->collecting)
+            world->AddToBatch(this);
+        else
+            MultiBodyInplaceSolverIslandCallback::processConstraints(islandId);
+    }
+    
+    ParallelDynamicsWorld* world;
+};
+
+template<typename T> static void AppendArray(btAlignedObjectArray<T>& dst, const btAlignedObjectArray<T>& src)
+{
+    for(int i=0; i<src.size(); ++i)
+        dst.push_back(src[i]);
+}
+
+//Object storing solver data shared between islands (nullptr if the collision object belongs to a single island)
+static const void* SharedSolverObject(const btCollisionObject* co)
+{
+    const btMultiBodyLinkCollider* mblc = btMultiBodyLinkCollider::upcast(co);
+    if(mblc != nullptr)
+        return mblc->m_multiBody;
+    return co->isKinematicObject() ? co : nullptr;
+}
+
+ParallelDynamicsWorld::ParallelDynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* broadphase, btMultiBodyConstraintSolver* solver,
+                                             btCollisionConfiguration* collisionConfiguration, btSoftBodySolver* softBodySolver, SimulationManager* sm)
+    : btSoftMultiBodyDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration, softBodySolver)
+{
+    simManager = sm;
+    threadPool = nullptr;
+    collecting = false;
+    numBatches = 0;
+    
+    delete m_solverMultiBodyIslandCallback;
+    m_solverMultiBodyIslandCallback = new IslandCollector(solver, dispatcher, this);
+}
+
+ParallelDynamicsWorld::~ParallelDynamicsWorld()
+{
+    for(size_t i=0; i<solvers.size(); ++i)
+        delete solvers[i];
+    for(size_t i=0; i<mlcpSolvers.size(); ++i)
+        delete mlcpSolvers[i];
+}
+
+void ParallelDynamicsWorld::setThreadPool(ThreadPool* pool)
+{
+    threadPool = pool;
+}
+
+void ParallelDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
+{
+    if(threadPool == nullptr)
+    {
+        btSoftMultiBodyDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+    
+    solveExternalForces(solverInfo);
+    
+    collecting = true;
+    numBatches = 0;
+    buildIslands();
+    m_solverMultiBodyIslandCallback->processConstraints(); //Remaining islands
+    collecting = false;
+    
+    if(numBatches > 1)
+        MergeSharedBatches();
+    SolveBatches(solverInfo);
+    
+    solveInternalConstraints(solverInfo); //Nothing left to solve, only velocities are updated
+}
+
+void ParallelDynamicsWorld::AddToBatch(MultiBodyInplaceSolverIslandCallback* islands)
+{
+    if(islands->m_bodies.size() > 0 || islands->m_manifolds.size() > 0 
+       || islands->m_constraints.size() > 0 || islands->m_multiBodyConstraints.size() > 0)
+    {
+        if(numBatches == batches.size())
+            batches.resize(numBatches + 1);
+        
+        IslandBatch& batch = batches[numBatches++];
+        batch.bodies.copyFromArray(islands->m_bodies);
+        batch.manifolds.copyFromArray(islands->m_manifolds);
+        batch.constraints.copyFromArray(islands->m_constraints);
+        batch.multiBodyConstraints.copyFromArray(islands->m_multiBodyConstraints);
+    }
+    
+    islands->m_bodies.resize(0);
+    islands->m_softBodies.resize(0);
+    islands->m_manifolds.resize(0);
+    islands->m_constraints.resize(0);
+    islands->m_multiBodyConstraints.resize(0);
+}
+
+void ParallelDynamicsWorld::MergeSharedBatches()
+{
+    //Group batches referring to the same objects (union-find with the smallest index as root)
+    std::vector<size_t> parent(numBatches);
+    for(size_t i=0; i<numBatches; ++i)
+        parent[i] = i;
+    
+    auto root = [&parent](size_t i)
+    {
+        while(parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    
+    std::unordered_map<const void*, size_t> owners;
+    auto share = [&](const void* obj, size_t b)
+    {
+        if(obj == nullptr)
+            return;
+        auto it = owners.emplace(obj, b);
+        if(!it.second)
+        {
+            size_t r0 = root(it.first->second);
+            size_t r1 = root(b);
+            if(r0 != r1)
+                parent[std::max(r0, r1)] = std::min(r0, r1);
+        }
+    };
+    
+    for(size_t b=0; b<numBatches; ++b)
+    {
+        IslandBatch& batch = batches[b];
+        for(int i=0; i<batch.bodies.size(); ++i)
+            share(SharedSolverObject(batch.bodies[i]), b);
+        for(int i=0; i<batch.manifolds.size(); ++i)
+        {
+            share(SharedSolverObject(batch.manifolds[i]->getBody0()), b);
+            share(SharedSolverObject(batch.manifolds[i]->getBody1()), b);
+        }
+        for(int i=0; i<batch.constraints.size(); ++i)
+        {
+            share(SharedSolverObject(&batch.constraints[i]->getRigidBodyA()), b);
+            share(SharedSolverObject(&batch.constraints[i]->getRigidBodyB()), b);
+        }
+        for(int i=0; i<batch.multiBodyConstraints.size(); ++i)
+        {
+            share(batch.multiBodyConstraints[i]->getMultiBodyA(), b);
+            share(batch.multiBodyConstraints[i]->getMultiBodyB(), b);
+        }
+    }
+    
+    //Append grouped batches to the root and compact the list
+    std::vector<size_t> target(numBatches);
+    size_t n = 0;
+    for(size_t b=0; b<numBatches; ++b)
+    {
+        size_t r = root(b);
+        if(r == b)
+        {
+            if(n != b)
+                batches[n] = batches[b];
+            target[b] = n++;
+        }
+        else
+        {
+            IslandBatch& dst = batches[target[r]];
+            AppendArray(dst.bodies, batches[b].bodies);
+            AppendArray(dst.manifolds, batches[b].manifolds);
+            AppendArray(dst.constraints, batches[b].constraints);
+            AppendArray(dst.multiBodyConstraints, batches[b].multiBodyConstraints);
+        }
+    }
+    numBatches = n;
+}
+
+void ParallelDynamicsWorld::SolveBatches(const btContactSolverInfo& solverInfo)
+{
+    if(numBatches == 0)
+        return;
+    
+    //Main solver handles the first batch
+    while(solvers.size() + 1 < numBatches)
+    {
+        btMLCPSolverInterface* mlcp = nullptr;
+        solvers.push_back(simManager->CreateConstraintSolver(mlcp));
+        if(mlcp != nullptr)
+            mlcpSolvers.push_back(mlcp);
+    }
+    
+    //Largest batches are solved first to balance the load
+    batchOrder.resize(numBatches);
+    for(size_t i=0; i<numBatches; ++i)
+        batchOrder[i] = i;
+    std::stable_sort(batchOrder.begin(), batchOrder.end(), [this](size_t a, size_t b)
+    {
+        const IslandBatch& ba = batches[a];
+        const IslandBatch& bb = batches[b];
+        return ba.manifolds.size() + ba.constraints.size() + ba.multiBodyConstraints.size()
+                > bb.manifolds.size() + bb.constraints.size() + bb.multiBodyConstraints.size();
+    });
+    
+    threadPool->ParallelFor(numBatches, [&](size_t i)
+    {
+        IslandBatch& batch = batches[batchOrder[i]];
+        btMultiBodyConstraintSolver* solver = i == 0 ? m_multiBodyConstraintSolver : solvers[i-1];
+        solver->solveMultiBodyGroup(batch.bodies.size() ? &batch.bodies[0] : nullptr, batch.bodies.size(),
+                                    batch.manifolds.size() ? &batch.manifolds[0] : nullptr, batch.manifolds.size(),
+                                    batch.constraints.size() ? &batch.constraints[0] : nullptr, batch.constraints.size(),
+                                    batch.multiBodyConstraints.size() ? &batch.multiBodyConstraints[0] : nullptr, batch.multiBodyConstraints.size(),
+                                    solverInfo, m_debugDrawer, m_dispatcher1);
+    });
+    
+    //Failures of all MLCP solvers are reported by the main one
+    if(mlcpSolvers.size() > 0)
+    {
+        btMultiBodyMLCPConstraintSolver* mainSolver = (btMultiBodyMLCPConstraintSolver*)m_multiBodyConstraintSolver;
+        for(size_t i=0; i<solvers.size(); ++i)
+        {
+            btMultiBodyMLCPConstraintSolver* solver = (btMultiBodyMLCPConstraintSolver*)solvers[i];
+            mainSolver->setNumFallbacks(mainSolver->getNumFallbacks() + solver->getNumFallbacks());
+            solver->setNumFallbacks(0);
+        }
+    }
+}
+
+}
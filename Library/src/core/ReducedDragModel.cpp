@@ -0,0 +1,184 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ReducedDragModel.cpp
+//  Stonefish
+//
+
+#include "core/ReducedDragModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define DRAG_MODEL_RESOLUTION 8 //Number of cells along the side of each face of the direction cube map
+#define DRAG_MODEL_BINS 16 //Number of face incidence bins used to tabulate the linear drag
+#define DRAG_MODEL_STRIDE (4 + 2 * DRAG_MODEL_BINS) //Number of vectors stored for each direction
+#define DRAG_MODEL_MAX_ROTATION 0.05f //Maximum ratio of the rotation induced velocity at the hull to the relative flow speed
+#define DRAG_MODEL_MAX_FLOW_VARIATION 0.05f //Maximum ratio of the fluid velocity variation over the hull to the relative flow speed
+
+namespace sf
+{
+
+ReducedDragModel::ReducedDragModel() : refPoint(0.f), radius(0.f)
+{
+}
+
+void ReducedDragModel::Build(const FaceBuffer& faces, const glm::vec3& p)
+{
+    refPoint = p;
+    radius = 0.f;
+    for(size_t i=0; i<faces.getNumOfVertices(); ++i)
+        radius = std::max(radius, glm::length(faces.getVertex(i) - p));
+    
+    const unsigned int n = DRAG_MODEL_RESOLUTION + 1;
+    nodes.assign(6 * n * n * DRAG_MODEL_STRIDE, glm::vec3(0.f));
+    
+    for(unsigned int f=0; f<6; ++f)
+        for(unsigned int i=0; i<n; ++i)
+            for(unsigned int j=0; j<n; ++j)
+            {
+                glm::vec3 d = NodeDirection(f, i, j);
+                glm::vec3* node = &nodes[NodeIndex(f, i, j)];
+                
+                //Same formulas as the integration over faces, for a unit relative velocity of the fluid
+                for(size_t k=0; k<faces.getNumOfFaces(); ++k)
+                {
+                    GLfloat A = faces.getArea(k);
+                    if(A <= 0.f)
+                        continue;
+                    
+                    glm::vec3 fn = faces.getNormal(k);
+                    glm::vec3 r = faces.getCentroid(k) - p;
+                    glm::vec3 rn = glm::cross(r, fn);
+                    GLfloat c = glm::dot(d, fn);
+                    
+                    //Skin friction
+                    glm::vec3 vt = d - c * fn;
+                    glm::vec3 s = vt * glm::length(vt) * A;
+                    node[2] += s;
+                    node[3] += glm::cross(r, s);
+                    
+                    //Pressure drag (only faces moving against the fluid)
+                    if(c < 0.f)
+                    {
+                        GLfloat kq = -c * c * A;
+                        node[0] += fn * kq;
+                        node[1] += rn * kq;
+                        
+                        GLfloat kl = c * A;
+                        unsigned int b = std::min((unsigned int)(-c * DRAG_MODEL_BINS), (unsigned int)DRAG_MODEL_BINS - 1);
+                        node[4 + 2 * b] += fn * kl;
+                        node[5 + 2 * b] += rn * kl;
+                    }
+                }
+            }
+}
+
+bool ReducedDragModel::isApplicable(const glm::vec3& vr, const glm::vec3& omega, GLfloat flowVariation) const
+{
+    if(isEmpty())
+        return false;
+    
+    GLfloat speed = glm::length(vr);
+    return glm::length(omega) * radius <= DRAG_MODEL_MAX_ROTATION * speed
+            && flowVariation <= DRAG_MODEL_MAX_FLOW_VARIATION * speed;
+}
+
+void ReducedDragModel::ComputeDampingForces(const glm::vec3& vr, glm::vec3& Fdl, glm::vec3& Tdl, glm::vec3& Fdq, glm::vec3& Tdq, glm::vec3& Fds, glm::vec3& Tds) const
+{
+    Fdl = Tdl = Fdq = Tdq = Fds = Tds = glm::vec3(0.f);
+    
+    GLfloat speed2 = glm::dot(vr, vr);
+    if(isEmpty() || speed2 < 1e-12f)
+        return;
+    
+    GLfloat speed = glm::sqrt(speed2);
+    glm::vec3 d = vr/speed;
+    
+    //Face of the cube map and bilinear interpolation coordinates
+    glm::vec3 ad = glm::abs(d);
+    unsigned int axis = ad.x >= ad.y ? (ad.x >= ad.z ? 0 : 2) : (ad.y >= ad.z ? 1 : 2);
+    unsigned int face = 2 * axis + (d[axis] < 0.f ? 1 : 0);
+    GLfloat u = (d[(axis + 1) % 3]/ad[axis] + 1.f) * 0.5f * DRAG_MODEL_RESOLUTION;
+    GLfloat v = (d[(axis + 2) % 3]/ad[axis] + 1.f) * 0.5f * DRAG_MODEL_RESOLUTION;
+    unsigned int i = std::min((unsigned int)std::max(u, 0.f), (unsigned int)DRAG_MODEL_RESOLUTION - 1);
+    unsigned int j = std::min((unsigned int)std::max(v, 0.f), (unsigned int)DRAG_MODEL_RESOLUTION - 1);
+    GLfloat fu = u - i;
+    GLfloat fv = v - j;
+    
+    const glm::vec3* n00 = &nodes[NodeIndex(face, i, j)];
+    const glm::vec3* n10 = &nodes[NodeIndex(face, i + 1, j)];
+    const glm::vec3* n01 = &nodes[NodeIndex(face, i, j + 1)];
+    const glm::vec3* n11 = &nodes[NodeIndex(face, i + 1, j + 1)];
+    GLfloat w00 = (1.f - fu) * (1.f - fv);
+    GLfloat w10 = fu * (1.f - fv);
+    GLfloat w01 = (1.f - fu) * fv;
+    GLfloat w11 = fu * fv;
+    auto blend = [&](unsigned int k)
+    {
+        return n00[k] * w00 + n10[k] * w10 + n01[k] * w01 + n11[k] * w11;
+    };
+    
+    //Quadratic and skin drag scale with the square of the speed
+    Fdq = blend(0) * speed2;
+    Tdq = blend(1) * speed2;
+    Fds = blend(2) * speed2;
+    Tds = blend(3) * speed2;
+    
+    //Linear drag depends on the incidence of the faces through the exponential term
+    for(unsigned int b=0; b<DRAG_MODEL_BINS; ++b)
+    {
+        GLfloat c = (b + 0.5f)/DRAG_MODEL_BINS;
+        GLfloat e = speed * expf(-0.5f * speed2 * c * c);
+        Fdl += blend(4 + 2 * b) * e;
+        Tdl += blend(5 + 2 * b) * e;
+    }
+}
+
+glm::vec3 ReducedDragModel::getReferencePoint() const
+{
+    return refPoint;
+}
+
+GLfloat ReducedDragModel::getRadius() const
+{
+    return radius;
+}
+
+bool ReducedDragModel::isEmpty() const
+{
+    return nodes.empty();
+}
+
+size_t ReducedDragModel::NodeIndex(unsigned int face, unsigned int i, unsigned int j) const
+{
+    const size_t n = DRAG_MODEL_RESOLUTION + 1;
+    return ((face * n + i) * n + j) * DRAG_MODEL_STRIDE;
+}
+
+glm::vec3 ReducedDragModel::NodeDirection(unsigned int face, unsigned int i, unsigned int j) const
+{
+    unsigned int axis = face/2;
+    glm::vec3 d;
+    d[axis] = (face % 2) ? -1.f : 1.f;
+    d[(axis + 1) % 3] = -1.f + 2.f * i/DRAG_MODEL_RESOLUTION;
+    d[(axis + 2) % 3] = -1.f + 2.f * j/DRAG_MODEL_RESOLUTION;
+    return glm::normalize(d);
+}
+
+}
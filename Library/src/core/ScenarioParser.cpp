@@ -510,6 +510,11 @@ bool ScenarioParser::ParseEnvironment(XMLElement* element)
         sm->EnableOcean(wavesHeight, sm->getMaterialManager()->getFluid(waterName));
         sm->getOcean()->setWaterType(jerlov);
         
+        bool reducedOrder = false;
+        if((item = ocean->FirstChildElement("damping")) != nullptr
+            && item->QueryAttribute("reduced_order", &reducedOrder) == XML_SUCCESS)
+            sm->getOcean()->setReducedOrderDamping(reducedOrder);
+        
         //Currents
         if((item = ocean->FirstChildElement("current")) != nullptr)
         {
@@ -1696,6 +1701,7 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
                 log.Print(MessageType::ERROR, "Physical mesh of rigid body '%s' not properly defined!", solidName.c_str());
                 return false;
             }
+            XMLElement* hull = item->FirstChildElement("hull");
             
             if((item = element->FirstChildElement("visual")) != nullptr)
             {
@@ -1721,6 +1727,17 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             {
                 solid = new Polyhedron(solidName, phy, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), std::string(look), thickness); 
             }
+            
+            if(hull != nullptr)
+            {
+                unsigned int hullVertices = 0;
+                unsigned int hullParts = 1;
+                Scalar hullConcavity(0.02);
+                hull->QueryAttribute("vertices", &hullVertices);
+                hull->QueryAttribute("parts", &hullParts);
+                hull->QueryAttribute("concavity", &hullConcavity);
+                ((Polyhedron*)solid)->setCollisionGeometry(hullVertices, hullParts, hullConcavity);
+            }
         }
         else
         {
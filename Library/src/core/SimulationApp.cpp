@@ -47,6 +47,17 @@ SimulationApp::SimulationApp(std::string name, std::string dataDirPath, Simulati
         cInfo("Welcome to Stonefish %d.%d.", STONEFISH_VER_MAJOR, STONEFISH_VER_MINOR);
 }
 
+SimulationApp::SimulationApp(std::string name, std::string dataDirPath, SimulationManager* sim, Console* sharedConsole)
+{
+    appName = name;
+    dataPath = dataDirPath;
+    simulation = sim;
+    finished = false;
+    running = false;
+    physicsTime = 0.0;
+    console = sharedConsole;
+}
+
 SimulationApp::~SimulationApp()
 {
     if(SimulationApp::handle == this)
@@ -135,10 +146,16 @@ void SimulationApp::CleanUp()
 
 //Static
 SimulationApp* SimulationApp::handle = NULL;
+thread_local SimulationApp* SimulationApp::threadHandle = NULL;
 
 SimulationApp* SimulationApp::getApp()
 {
-    return SimulationApp::handle;
+    return SimulationApp::threadHandle != NULL ? SimulationApp::threadHandle : SimulationApp::handle;
+}
+
+void SimulationApp::setThreadApp(SimulationApp* app)
+{
+    SimulationApp::threadHandle = app;
 }
 
 }
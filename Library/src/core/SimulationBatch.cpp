@@ -0,0 +1,170 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SimulationBatch.cpp
+//  Stonefish
+//
+
+#include "core/SimulationBatch.h"
+
+#include <atomic>
+#include "core/SimulationApp.h"
+#include "core/SimulationManager.h"
+#include "core/ThreadPool.h"
+
+namespace sf
+{
+
+//Application hosting a single world of the batch
+class SimulationBatch::World : public SimulationApp
+{
+public:
+    World(std::string name, std::string dataDirPath, SimulationManager* sim, Console* sharedConsole)
+        : SimulationApp(name, dataDirPath, sim, sharedConsole)
+    {
+    }
+
+    bool hasGraphics()
+    {
+        return false;
+    }
+
+    void Build()
+    {
+        InitializeSimulation();
+    }
+
+protected:
+    void Init()
+    {
+    }
+
+    void Loop()
+    {
+    }
+};
+
+SimulationBatch::SimulationBatch(std::string dataDirPath, unsigned int numThreads)
+{
+    dataPath = dataDirPath;
+    console = new Console();
+    current = -1;
+    pool = new ThreadPool(numThreads);
+    if(pool->getNumOfThreads() == 1) //Single core machine
+    {
+        delete pool;
+        pool = nullptr;
+    }
+}
+
+SimulationBatch::~SimulationBatch()
+{
+    for(size_t i=0; i<worlds.size(); ++i)
+    {
+        SimulationApp::setThreadApp(worlds[i]); //Objects of the world are destroyed in its context
+        delete worlds[i]->getSimulationManager();
+        SimulationApp::setThreadApp(nullptr);
+        delete worlds[i];
+    }
+    worlds.clear();
+    if(pool != nullptr) delete pool;
+    delete console;
+}
+
+unsigned int SimulationBatch::AddWorld(SimulationManager* sim)
+{
+    worlds.push_back(new World("World " + std::to_string(worlds.size()), dataPath, sim, console));
+    return (unsigned int)worlds.size()-1;
+}
+
+bool SimulationBatch::Start()
+{
+    //Scenarios are built sequentially
+    for(size_t i=0; i<worlds.size(); ++i)
+    {
+        SimulationApp::setThreadApp(worlds[i]);
+        worlds[i]->Build();
+    }
+
+    //Initial conditions are solved in parallel
+    std::atomic<bool> success(true);
+    auto startWorld = [this, &success](size_t i)
+    {
+        SimulationApp::setThreadApp(worlds[i]);
+        if(!worlds[i]->getSimulationManager()->StartSimulation())
+            success = false;
+    };
+
+    if(pool != nullptr)
+        pool->ParallelFor(worlds.size(), startWorld);
+    else
+        for(size_t i=0; i<worlds.size(); ++i)
+            startWorld(i);
+
+    setCurrentWorld(current);
+    return success;
+}
+
+bool SimulationBatch::Restart(unsigned int id)
+{
+    SimulationApp::setThreadApp(worlds.at(id));
+    worlds[id]->Build();
+    bool success = worlds[id]->getSimulationManager()->StartSimulation();
+    setCurrentWorld(current);
+    return success;
+}
+
+void SimulationBatch::Step(unsigned int n)
+{
+    auto stepWorld = [this, n](size_t i)
+    {
+        SimulationApp::setThreadApp(worlds[i]);
+        worlds[i]->getSimulationManager()->StepSimulation(n);
+    };
+
+    if(pool != nullptr)
+        pool->ParallelFor(worlds.size(), stepWorld);
+    else
+        for(size_t i=0; i<worlds.size(); ++i)
+            stepWorld(i);
+
+    setCurrentWorld(current);
+}
+
+void SimulationBatch::setCurrentWorld(int id)
+{
+    current = id >= 0 && id < (int)worlds.size() ? id : -1;
+    SimulationApp::setThreadApp(current >= 0 ? worlds[current] : nullptr);
+}
+
+unsigned int SimulationBatch::getNumOfWorlds() const
+{
+    return (unsigned int)worlds.size();
+}
+
+SimulationManager* SimulationBatch::getWorld(unsigned int id)
+{
+    return worlds.at(id)->getSimulationManager();
+}
+
+Console* SimulationBatch::getConsole()
+{
+    return console;
+}
+
+}
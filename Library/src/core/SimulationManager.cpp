@@ -33,7 +33,9 @@
 #include "BulletDynamics/Featherstone/btMultiBodyMLCPConstraintSolver.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btDefaultSoftBodySolver.h"
+#include "LinearMath/btPoolAllocator.h"
 #include "tinyxml2.h"
+#include <SDL2/SDL_atomic.h>
 #include <chrono>
 #include <thread>
 #include <typeinfo>
@@ -43,11 +45,14 @@
 #include "core/MaterialManager.h"
 #include "core/Robot.h"
 #include "core/NED.h"
+#include "core/ParallelDynamicsWorld.h"
+#include "core/ThreadPool.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLTrackball.h"
 #include "graphics/OpenGLDebugDrawer.h"
+#include "graphics/OpenGLReadback.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/UnitSystem.h"
 #include "entities/Entity.h"
@@ -66,11 +71,16 @@
 #include "comms/Comm.h"
 #include "sensors/Contact.h"
 #include "sensors/VisionSensor.h"
+#include "sensors/SensorLogger.h"
+#include "sensors/SensorScheduler.h"
 
 extern ContactAddedCallback gContactAddedCallback;
 extern ContactProcessedCallback gContactProcessedCallback;
 extern ContactDestroyedCallback gContactDestroyedCallback;
 
+#define CONTACT_INFO_POOL_SIZE 4096 //Number of preallocated contact information structures
+#define RAY_PACKET_SIZE 32 //Number of rays cast by a single task
+
 namespace sf
 {
 
@@ -84,10 +94,16 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     fdCounter = 0;
     currentTime = 0;
     physicsTime = 0;
+    lockstepSteps = 0;
+    lockstepTime = 0;
     simulationTime = 0;
     mlcpFallbacks = 0;
+    randomGenerator.seed(std::random_device()());
+    randomSeed = 0;
+    seeded = false;
     dynamicsWorld = nullptr;
     mbSolver = nullptr;
+    mlcpSolver = nullptr;
     sbSolver = nullptr;
     dwBroadphase = nullptr;
     dwCollisionConfig = nullptr;
@@ -95,6 +111,9 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     ocean = nullptr;
     atmosphere = nullptr;
     trackball = nullptr;
+    threadPool = nullptr;
+    parallelPhysics = false;
+    logger = nullptr;
     sdm = DisplayMode::GRAPHICAL;
     simHydroMutex = SDL_CreateMutex();
     simSettingsMutex = SDL_CreateMutex();
@@ -110,18 +129,24 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, SolverType st, Colli
     nameManager = new NameManager();
     materialManager = new MaterialManager();
     ned = new NED();
+    sensorScheduler = new SensorScheduler();
+    contactInfoPool = new btPoolAllocator(sizeof(ContactInfo), CONTACT_INFO_POOL_SIZE);
+    contactInfoLock = 0;
 }
 
 SimulationManager::~SimulationManager()
 {
     DestroyScenario();
     if(atmosphere != nullptr) delete atmosphere;
+    if(threadPool != nullptr) delete threadPool;
     SDL_DestroyMutex(simSettingsMutex);
     SDL_DestroyMutex(simInfoMutex);
     SDL_DestroyMutex(simHydroMutex);
     delete materialManager;
     delete nameManager;
     delete ned;
+    delete sensorScheduler;
+    delete contactInfoPool; //After the dynamics world released all contact points
 }
 
 void SimulationManager::AddRobot(Robot* robot, const Transform& worldTransform)
@@ -129,6 +154,7 @@ void SimulationManager::AddRobot(Robot* robot, const Transform& worldTransform)
     if(robot != nullptr)
     {
         robots.push_back(robot);
+        robotIndex.emplace(robot->getName(), robot);
         robot->AddToSimulation(this, worldTransform);
     }
 }
@@ -138,6 +164,7 @@ void SimulationManager::AddEntity(Entity *ent)
     if(ent != nullptr)
     {
         entities.push_back(ent);
+        entityIndex.emplace(ent->getName(), ent);
         ent->AddToSimulation(this);
     }
 }
@@ -147,6 +174,7 @@ void SimulationManager::AddStaticEntity(StaticEntity* ent, const Transform& orig
     if(ent != nullptr)
     {
         entities.push_back(ent);
+        entityIndex.emplace(ent->getName(), ent);
         ent->AddToSimulation(this, origin);
     }
 }
@@ -156,6 +184,7 @@ void SimulationManager::AddAnimatedEntity(AnimatedEntity* ent)
     if(ent != nullptr)
     {
         entities.push_back(ent);
+        entityIndex.emplace(ent->getName(), ent);
         ent->AddToSimulation(this);
     }
 }
@@ -165,6 +194,7 @@ void SimulationManager::AddSolidEntity(SolidEntity* ent, const Transform& origin
     if(ent != nullptr)
     {
         entities.push_back(ent);
+        entityIndex.emplace(ent->getName(), ent);
         ent->AddToSimulation(this, origin);
     }
 }
@@ -174,6 +204,7 @@ void SimulationManager::AddSolidEntity(SolidEntity* ent, const Transform& origin
      if(ent != nullptr)
      {
          entities.push_back(ent);
+         entityIndex.emplace(ent->getName(), ent);
          ent->AddToSimulation(this, origin);
      }
  }
@@ -191,7 +222,7 @@ void SimulationManager::EnableOcean(Scalar waves, Fluid f)
     
     bool hasGraphics = SimulationApp::getApp()->hasGraphics();
 
-    ocean = new Ocean("Ocean", hasGraphics ? waves : 0.0, f);
+    ocean = new Ocean("Ocean", waves, f);
     ocean->AddToSimulation(this);
     
     if(hasGraphics)
@@ -199,6 +230,8 @@ void SimulationManager::EnableOcean(Scalar waves, Fluid f)
         ocean->InitGraphics(simHydroMutex);
         ocean->setRenderable(true);
     }
+    else
+        ocean->InitWaves(); //Waves computed on CPU
 }
     
 void SimulationManager::EnableAtmosphere()
@@ -219,16 +252,63 @@ void SimulationManager::EnableAtmosphere()
     }
 }
 
+bool SimulationManager::StartLogging(const std::string& path, bool compress)
+{
+    StopLogging();
+    
+    SensorLogger* sl = new SensorLogger(path, compress);
+    for(size_t i = 0; i < sensors.size(); ++i)
+        if(sensors[i]->getType() != SensorType::VISION)
+            sl->AddSensor((ScalarSensor*)sensors[i]);
+    
+    if(!sl->Start())
+    {
+        delete sl;
+        return false;
+    }
+    
+    SDL_LockMutex(simSettingsMutex); //Logger updated during simulation step
+    logger = sl;
+    SDL_UnlockMutex(simSettingsMutex);
+    return true;
+}
+
+void SimulationManager::StopLogging()
+{
+    SDL_LockMutex(simSettingsMutex);
+    SensorLogger* sl = logger;
+    logger = nullptr;
+    SDL_UnlockMutex(simSettingsMutex);
+    
+    if(sl != nullptr)
+    {
+        sl->Stop();
+        delete sl;
+    }
+}
+
+SensorLogger* SimulationManager::getSensorLogger()
+{
+    return logger;
+}
+
 void SimulationManager::AddSensor(Sensor* sens)
 {
     if(sens != nullptr)
+    {
         sensors.push_back(sens);
+        sensorIndex.emplace(sens->getName(), sens);
+        sensorScheduler->Invalidate();
+    }
 }
 
 void SimulationManager::AddComm(Comm* comm)
 {
     if(comm != nullptr)
+    {
         comms.push_back(comm);
+        commIndex.emplace(comm->getName(), comm);
+    }
 }
 
 void SimulationManager::AddJoint(Joint* jnt)
@@ -236,6 +316,7 @@ void SimulationManager::AddJoint(Joint* jnt)
     if(jnt != nullptr)
     {
         joints.push_back(jnt);
+        jointIndex.emplace(jnt->getName(), jnt);
         jnt->AddToSimulation(this);
     }
 }
@@ -243,7 +324,10 @@ void SimulationManager::AddJoint(Joint* jnt)
 void SimulationManager::AddActuator(Actuator *act)
 {
     if(act != nullptr)
+    {
         actuators.push_back(act);
+        actuatorIndex.emplace(act->getName(), act);
+    }
 }
 
 void SimulationManager::AddContact(Contact* cnt)
@@ -251,73 +335,40 @@ void SimulationManager::AddContact(Contact* cnt)
     if(cnt != nullptr)
     {
         contacts.push_back(cnt);
+        contactIndex.insert(std::make_pair(Collision(cnt->getEntityA(), cnt->getEntityB()), cnt));
+        const_cast<Entity*>(cnt->getEntityA())->setContactMonitored(true);
+        const_cast<Entity*>(cnt->getEntityB())->setContactMonitored(true);
         EnableCollision(cnt->getEntityA(), cnt->getEntityB());
     }
 }
 
-int SimulationManager::CheckCollision(const Entity *entA, const Entity *entB)
+bool SimulationManager::CheckCollision(const Entity *entA, const Entity *entB) const
 {
-    for(size_t i = 0; i < collisions.size(); ++i)
-    {
-        if((collisions[i].A == entA && collisions[i].B == entB) 
-            || (collisions[i].B == entA && collisions[i].A == entB))
-                return (int)i;
-    }
-    
-    return -1;
+    //Inclusive: listed pairs collide, exclusive: listed pairs do not collide
+    bool listed = !collisions.empty() && collisions.find(Collision(entA, entB)) != collisions.end();
+    return (collisionFilter == CollisionFilteringType::COLLISION_INCLUSIVE) == listed;
 }
 
 void SimulationManager::EnableCollision(const Entity* entA, const Entity* entB)
 {
-    int colId = CheckCollision(entA, entB);
-    
-    if(collisionFilter == CollisionFilteringType::COLLISION_INCLUSIVE && colId == -1)
-    {
-        Collision c;
-        c.A = const_cast<Entity*>(entA);
-        c.B = const_cast<Entity*>(entB);
-        collisions.push_back(c);
-    }
-    else if(collisionFilter == CollisionFilteringType::COLLISION_EXCLUSIVE && colId > -1)
-    {
-        collisions.erase(collisions.begin() + colId);
-    }
+    if(collisionFilter == CollisionFilteringType::COLLISION_INCLUSIVE)
+        collisions.insert(Collision(entA, entB));
+    else
+        collisions.erase(Collision(entA, entB));
 }
     
 void SimulationManager::DisableCollision(const Entity* entA, const Entity* entB)
 {
-    int colId = CheckCollision(entA, entB);
-    
-    if(collisionFilter == CollisionFilteringType::COLLISION_EXCLUSIVE && colId == -1)
-    {
-        Collision c;
-        c.A = const_cast<Entity*>(entA);
-        c.B = const_cast<Entity*>(entB);
-        collisions.push_back(c);
-    }
-    else if(collisionFilter == CollisionFilteringType::COLLISION_INCLUSIVE && colId > -1)
-    {
-        collisions.erase(collisions.begin() + colId);
-    }
+    if(collisionFilter == CollisionFilteringType::COLLISION_EXCLUSIVE)
+        collisions.insert(Collision(entA, entB));
+    else
+        collisions.erase(Collision(entA, entB));
 }
 
 Contact* SimulationManager::getContact(Entity* entA, Entity* entB)
 {
-    for(size_t i = 0; i < contacts.size(); ++i)
-    {
-        if(contacts[i]->getEntityA() == entA)
-        {
-            if(contacts[i]->getEntityB() == entB)
-                return contacts[i];
-        }
-        else if(contacts[i]->getEntityB() == entA)
-        {
-            if(contacts[i]->getEntityA() == entB)
-                return contacts[i];
-        }
-    }
-    
-    return nullptr;
+    auto it = contactIndex.find(Collision(entA, entB));
+    return it != contactIndex.end() ? it->second : nullptr;
 }
 
 Contact* SimulationManager::getContact(unsigned int index)
@@ -347,6 +398,33 @@ SolverType SimulationManager::getSolverType()
     return solver;
 }
 
+btMultiBodyConstraintSolver* SimulationManager::CreateConstraintSolver(btMLCPSolverInterface*& mlcp) const
+{
+    mlcp = nullptr;
+    
+    if(solver == SolverType::SOLVER_SI)
+        return new btMultiBodyConstraintSolver();
+    
+    switch(solver)
+    {
+        default:
+        case SolverType::SOLVER_DANTZIG:
+            mlcp = new btDantzigSolver();
+            break;
+        
+        case SolverType::SOLVER_PGS:
+            mlcp = new btSolveProjectedGaussSeidel();
+            break;
+        
+        case SolverType::SOLVER_LEMKE:
+            mlcp = new btLemkeSolver();
+            //((btLemkeSolver*)mlcp)->m_maxLoops = 10000;
+            break;
+    }
+    
+    return new btMultiBodyMLCPConstraintSolver(mlcp); //ResearchConstraintSolver(mlcp);
+}
+
 Robot* SimulationManager::getRobot(unsigned int index)
 {
     if(index < robots.size())
@@ -357,11 +435,8 @@ Robot* SimulationManager::getRobot(unsigned int index)
 
 Robot* SimulationManager::getRobot(const std::string& name)
 {
-    for(size_t i = 0; i < robots.size(); ++i)
-        if(robots[i]->getName() == name)
-            return robots[i];
-    
-    return nullptr;
+    auto it = robotIndex.find(name);
+    return it != robotIndex.end() ? it->second : nullptr;
 }
 
 Entity* SimulationManager::getEntity(unsigned int index)
@@ -374,11 +449,8 @@ Entity* SimulationManager::getEntity(unsigned int index)
 
 Entity* SimulationManager::getEntity(const std::string& name)
 {
-    for(size_t i = 0; i < entities.size(); ++i)
-        if(entities[i]->getName() == name)
-            return entities[i];
-    
-    return nullptr;
+    auto it = entityIndex.find(name);
+    return it != entityIndex.end() ? it->second : nullptr;
 }
 
 Joint* SimulationManager::getJoint(unsigned int index)
@@ -391,11 +463,8 @@ Joint* SimulationManager::getJoint(unsigned int index)
 
 Joint* SimulationManager::getJoint(const std::string& name)
 {
-    for(size_t i = 0; i < joints.size(); ++i)
-        if(joints[i]->getName() == name)
-            return joints[i];
-    
-    return nullptr;
+    auto it = jointIndex.find(name);
+    return it != jointIndex.end() ? it->second : nullptr;
 }
 
 Actuator* SimulationManager::getActuator(unsigned int index)
@@ -408,11 +477,8 @@ Actuator* SimulationManager::getActuator(unsigned int index)
 
 Actuator* SimulationManager::getActuator(const std::string& name)
 {
-    for(size_t i = 0; i < actuators.size(); ++i)
-        if(actuators[i]->getName() == name)
-            return actuators[i];
-    
-    return nullptr;
+    auto it = actuatorIndex.find(name);
+    return it != actuatorIndex.end() ? it->second : nullptr;
 }
 
 Sensor* SimulationManager::getSensor(unsigned int index)
@@ -425,11 +491,8 @@ Sensor* SimulationManager::getSensor(unsigned int index)
 
 Sensor* SimulationManager::getSensor(const std::string& name)
 {
-    for(size_t i = 0; i < sensors.size(); ++i)
-        if(sensors[i]->getName() == name)
-            return sensors[i];
-    
-    return nullptr;
+    auto it = sensorIndex.find(name);
+    return it != sensorIndex.end() ? it->second : nullptr;
 }
 
 Comm* SimulationManager::getComm(unsigned int index)
@@ -442,11 +505,8 @@ Comm* SimulationManager::getComm(unsigned int index)
 
 Comm* SimulationManager::getComm(const std::string& name)
 {
-    for(size_t i = 0; i < comms.size(); ++i)
-        if(comms[i]->getName() == name)
-            return comms[i];
-    
-    return nullptr;
+    auto it = commIndex.find(name);
+    return it != commIndex.end() ? it->second : nullptr;
 }
 
 NED* SimulationManager::getNED()
@@ -533,6 +593,66 @@ Scalar SimulationManager::getStepsPerSecond()
     return sps;
 }
 
+void SimulationManager::setNumOfThreads(unsigned int n)
+{
+    SDL_LockMutex(simSettingsMutex);
+    if(threadPool != nullptr)
+    {
+        delete threadPool;
+        threadPool = nullptr;
+    }
+    
+    if(n != 1)
+    {
+        threadPool = new ThreadPool(n);
+        if(threadPool->getNumOfThreads() == 1) //Single core machine
+        {
+            delete threadPool;
+            threadPool = nullptr;
+        }
+    }
+    UpdatePhysicsThreads();
+    SDL_UnlockMutex(simSettingsMutex);
+}
+
+void SimulationManager::setParallelPhysics(bool enabled)
+{
+    SDL_LockMutex(simSettingsMutex);
+    parallelPhysics = enabled;
+    UpdatePhysicsThreads();
+    SDL_UnlockMutex(simSettingsMutex);
+}
+
+void SimulationManager::UpdatePhysicsThreads()
+{
+    if(dynamicsWorld == nullptr)
+        return;
+    
+    ThreadPool* pool = parallelPhysics ? threadPool : nullptr;
+    ((FilteredCollisionDispatcher*)dwDispatcher)->setThreadPool(pool);
+    ((ParallelDynamicsWorld*)dynamicsWorld)->setThreadPool(pool);
+}
+
+unsigned int SimulationManager::getNumOfThreads()
+{
+    return threadPool != nullptr ? threadPool->getNumOfThreads() : 1;
+}
+
+ThreadPool* SimulationManager::getThreadPool()
+{
+    return threadPool;
+}
+
+SensorScheduler* SimulationManager::getSensorScheduler()
+{
+    return sensorScheduler;
+}
+
+bool SimulationManager::isParallelPhysicsEnabled()
+{
+    return parallelPhysics;
+}
+
 Scalar SimulationManager::getPhysicsTimeInMiliseconds()
 {
     SDL_LockMutex(simInfoMutex);
@@ -557,6 +677,30 @@ Scalar SimulationManager::getRealtimeFactor()
     return rf;
 }
 
+Scalar SimulationManager::getAchievedStepsPerSecond()
+{
+    SDL_LockMutex(simInfoMutex);
+    Scalar s = lockstepTime > 0 ? (Scalar)lockstepSteps/((Scalar)lockstepTime/Scalar(1e9)) : Scalar(0);
+    SDL_UnlockMutex(simInfoMutex);
+    return s;
+}
+
+Scalar SimulationManager::getAchievedRealtimeFactor()
+{
+    return getAchievedStepsPerSecond()/sps;
+}
+
+void SimulationManager::setRandomSeed(uint32_t seed)
+{
+    randomSeed = seed;
+    seeded = true;
+}
+
+std::mt19937& SimulationManager::getRandomGenerator()
+{
+    return randomGenerator;
+}
+
 void SimulationManager::getWorldAABB(Vector3& min, Vector3& max)
 {
     min.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
@@ -635,52 +779,16 @@ void SimulationManager::InitializeSolver()
     dwBroadphase = new btDbvtBroadphase(); //btAxisSweep3(Vector3(-50000.0, -50000.0, -10000.0), Vector3(50000.0, 50000.0, 10000.0));
     dwCollisionConfig = new btSoftBodyRigidBodyCollisionConfiguration();
 
-    //Choose collision dispatcher
-    /*switch(collisionFilter)
-    {
-        case CollisionFilteringType::COLLISION_INCLUSIVE:
-            dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, true);
-            break;
-
-        case CollisionFilteringType::COLLISION_EXCLUSIVE:
-            dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, false);
-            break;
-    }*/
-    dwDispatcher = new btCollisionDispatcher(dwCollisionConfig);
+    //Collision dispatcher filtering pairs of entities (inclusive or exclusive)
+    dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, this);
     
     //Choose constraint solver
-    if(solver == SolverType::SOLVER_SI)
-    {
-        mbSolver = new btMultiBodyConstraintSolver();
-    }
-    else
-    {
-        btMLCPSolverInterface* mlcp;
-    
-        switch(solver)
-        {
-            default:
-            case SolverType::SOLVER_DANTZIG:
-                mlcp = new btDantzigSolver();
-                break;
-            
-            case SolverType::SOLVER_PGS:
-                mlcp = new btSolveProjectedGaussSeidel();
-                break;
-            
-            case SolverType::SOLVER_LEMKE:
-                mlcp = new btLemkeSolver();
-                //((btLemkeSolver*)mlcp)->m_maxLoops = 10000;
-                break;
-        }
-        
-        mbSolver = new btMultiBodyMLCPConstraintSolver(mlcp); //ResearchConstraintSolver(mlcp);
-    }
-    
+    mbSolver = CreateConstraintSolver(mlcpSolver);
     sbSolver = new btDefaultSoftBodySolver();
 
-    //Create dynamics world
-    dynamicsWorld = new btSoftMultiBodyDynamicsWorld(dwDispatcher, dwBroadphase, mbSolver, dwCollisionConfig, sbSolver);
+    //Create dynamics world (islands solved in parallel when enabled)
+    dynamicsWorld = new ParallelDynamicsWorld(dwDispatcher, dwBroadphase, mbSolver, dwCollisionConfig, sbSolver, this);
+    UpdatePhysicsThreads();
     
     //Basic configuration
     dynamicsWorld->getSolverInfo().m_solverMode = SOLVER_USE_WARMSTARTING | SOLVER_SIMD | SOLVER_USE_2_FRICTION_DIRECTIONS; //SOLVER_RANDMIZE_ORDER | SOLVER_ENABLE_FRICTION_DIRECTION_CACHING;
@@ -775,6 +883,8 @@ void SimulationManager::RestartScenario()
 
 void SimulationManager::DestroyScenario()
 {
+    StopLogging();
+    
     if(dynamicsWorld != nullptr)
     {
         //remove objects from dynamic world
@@ -797,21 +907,26 @@ void SimulationManager::DestroyScenario()
     
         delete dynamicsWorld;
         delete mbSolver;
+        if(mlcpSolver != nullptr) delete mlcpSolver;
         delete sbSolver;
         delete dwBroadphase;
         delete dwDispatcher;
         delete dwCollisionConfig;
         delete debugDrawer;
+        dynamicsWorld = nullptr;
+        mlcpSolver = nullptr;
     }
     
     //remove sim manager objects
     for(size_t i=0; i<robots.size(); ++i)
         delete robots[i];
     robots.clear();
+    robotIndex.clear();
     
     for(size_t i=0; i<entities.size(); ++i)
         delete entities[i];
     entities.clear();
+    entityIndex.clear();
     
     if(ocean != nullptr)
     {
@@ -828,22 +943,33 @@ void SimulationManager::DestroyScenario()
     for(size_t i=0; i<joints.size(); ++i)
         delete joints[i];
     joints.clear();
+    jointIndex.clear();
     
     for(size_t i=0; i<contacts.size(); ++i)
         delete contacts[i];
     contacts.clear();
+    contactIndex.clear();
+    collisions.clear();
+    
+    //Callbacks of the vision sensors run on the readback thread
+    if(SimulationApp::getApp() != nullptr && SimulationApp::getApp()->hasGraphics())
+        OpenGLReadback::Drain();
     
     for(size_t i=0; i<sensors.size(); ++i)
         delete sensors[i];
     sensors.clear();
+    sensorIndex.clear();
+    sensorScheduler->Reset();
     
     for(size_t i=0; i<comms.size(); ++i)
         delete comms[i];
     comms.clear();
+    commIndex.clear();
     
     for(size_t i=0; i<actuators.size(); ++i)
         delete actuators[i];
     actuators.clear();
+    actuatorIndex.clear();
     
     if(nameManager != nullptr)
         nameManager->ClearNames();
@@ -863,10 +989,16 @@ bool SimulationManager::StartSimulation()
     simulationFresh = false;
     currentTime = 0;
     physicsTime = 0;
+    lockstepSteps = 0;
+    lockstepTime = 0;
     simulationTime = 0;
     mlcpFallbacks = 0;
     fdCounter = 0;
     
+    //Restart noise sequences
+    if(seeded)
+        randomGenerator.seed(randomSeed);
+    
     //Solve initial conditions problem
     if(!SolveICProblem())
         return false;
@@ -878,6 +1010,7 @@ bool SimulationManager::StartSimulation()
     //Reset sensors
     for(unsigned int i = 0; i < sensors.size(); i++)
         sensors[i]->Reset();
+    sensorScheduler->Reset();
     
     return true;
 }
@@ -989,7 +1122,36 @@ void SimulationManager::AdvanceSimulation()
     Scalar cpuUsageNow = (Scalar)physicsTime/Scalar(1000)/(Scalar)deltaTime * Scalar(100);
     Scalar filter(0.001);
     cpuUsage = filter * cpuUsageNow + (Scalar(1)-filter) * cpuUsage;   
+    UpdateSolverInfo();
+    SDL_UnlockMutex(simInfoMutex);
+}
+
+void SimulationManager::StepSimulation(unsigned int n)
+{
+    //Check if initial conditions solved
+    if(!icProblemSolved || n == 0)
+        return;
     
+    //Step simulation with a fixed time step, without synchronizing with the clock
+    Scalar dt = Scalar(1)/sps;
+    SDL_LockMutex(simSettingsMutex);
+    uint64_t physicsStart = GetTimeInNanoseconds();
+    for(unsigned int i=0; i<n; ++i)
+        dynamicsWorld->stepSimulation(dt, 0); //Exactly one internal step of length dt
+    uint64_t physicsEnd = GetTimeInNanoseconds();
+    SDL_UnlockMutex(simSettingsMutex);
+    
+    SDL_LockMutex(simInfoMutex);
+    physicsTime = (physicsEnd - physicsStart)/n;
+    lockstepSteps += n;
+    lockstepTime += physicsEnd - physicsStart;
+    cpuUsage = Scalar(100);
+    UpdateSolverInfo();
+    SDL_UnlockMutex(simInfoMutex);
+}
+
+void SimulationManager::UpdateSolverInfo()
+{
     //Inform about MLCP failures
     if(solver != SolverType::SOLVER_SI)
     {
@@ -1004,8 +1166,6 @@ void SimulationManager::AdvanceSimulation()
 #endif
         }
     }
-    
-    SDL_UnlockMutex(simInfoMutex);
 }
 
 void SimulationManager::SimulationStepCompleted(Scalar timeStep)
@@ -1020,23 +1180,24 @@ void SimulationManager::UpdateDrawingQueue()
 {
     //Build new drawing queue
     OpenGLPipeline* glPipeline = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline();
+    RenderSnapshot& queue = glPipeline->getDrawingQueue();
  
     //Solids, manipulators, systems....
     for(size_t i=0; i<entities.size(); ++i)
-        glPipeline->AddToDrawingQueue(entities[i]->Render());
+        entities[i]->Render(queue);
 
     Entity* selected = ((GraphicalSimulationApp*)SimulationApp::getApp())->getSelectedEntity();
     if(selected != nullptr)
-        glPipeline->AddToSelectedDrawingQueue(selected->Render());
+        selected->Render(glPipeline->getSelectedDrawingQueue());
 
     //Joints
     for(size_t i=0; i<joints.size(); ++i)
-        glPipeline->AddToDrawingQueue(joints[i]->Render());
+        joints[i]->Render(queue);
         
     //Actuators
     for(size_t i=0; i<actuators.size(); ++i)
     {
-        glPipeline->AddToDrawingQueue(actuators[i]->Render());
+        actuators[i]->Render(queue);
         if(actuators[i]->getType() == ActuatorType::LIGHT)
             ((Light*)actuators[i])->UpdateTransform();
     }
@@ -1044,14 +1205,14 @@ void SimulationManager::UpdateDrawingQueue()
     //Sensors
     for(size_t i=0; i<sensors.size(); ++i)
     {
-        glPipeline->AddToDrawingQueue(sensors[i]->Render());
+        sensors[i]->Render(queue);
         if(sensors[i]->getType() == SensorType::VISION)
             ((VisionSensor*)sensors[i])->UpdateTransform();
     }
     
     //Comms
     for(size_t i=0; i<comms.size(); ++i)
-        glPipeline->AddToDrawingQueue(comms[i]->Render());
+        comms[i]->Render(queue);
     
     //Trackball
     if(trackball != nullptr)
@@ -1059,11 +1220,11 @@ void SimulationManager::UpdateDrawingQueue()
     
     //Contacts
     for(size_t i=0; i<contacts.size(); ++i)
-        glPipeline->AddToDrawingQueue(contacts[i]->Render());
+        contacts[i]->Render(queue);
     
     //Ocean currents
     if(ocean != nullptr)
-        glPipeline->AddToDrawingQueue(ocean->Render(actuators));
+        ocean->Render(actuators, queue);
 }
 
 Entity* SimulationManager::PickEntity(Vector3 eye, Vector3 ray)
@@ -1083,6 +1244,92 @@ Entity* SimulationManager::PickEntity(Vector3 eye, Vector3 ray)
         return nullptr;
 }
 
+//Tests a ray against the objects of the broadphase tree leaves it passes through
+struct RayLeafTester : public btDbvt::ICollide
+{
+    btCollisionWorld::ClosestRayResultCallback* closest;
+    Transform rayFromTrans;
+    Transform rayToTrans;
+    
+    void Process(const btDbvtNode* leaf)
+    {
+        btBroadphaseProxy* proxy = (btBroadphaseProxy*)leaf->data;
+        if(!closest->needsCollision(proxy))
+            return;
+        
+        btCollisionObject* co = (btCollisionObject*)proxy->m_clientObject;
+        btCollisionWorld::rayTestSingle(rayFromTrans, rayToTrans, co, co->getCollisionShape(), co->getWorldTransform(), *closest);
+    }
+};
+
+void SimulationManager::CastRays(const RayQuery* rays, RayHit* hits, size_t n)
+{
+    if(n == 0)
+        return;
+    
+    size_t nPackets = (n + RAY_PACKET_SIZE - 1)/RAY_PACKET_SIZE;
+    btDbvtBroadphase* broadphase = (btDbvtBroadphase*)dwBroadphase;
+    
+    auto castPacket = [&](size_t p)
+    {
+        static thread_local btAlignedObjectArray<const btDbvtNode*> stack;
+        size_t r0 = p * RAY_PACKET_SIZE;
+        size_t r1 = std::min(r0 + RAY_PACKET_SIZE, n);
+        
+        for(size_t i = r0; i < r1; ++i)
+        {
+            const RayQuery& ray = rays[i];
+            btCollisionWorld::ClosestRayResultCallback closest(ray.from, ray.to);
+            closest.m_collisionFilterGroup = ray.group;
+            closest.m_collisionFilterMask = ray.mask;
+            
+            //Traversal of the broadphase trees along the ray (the tree stack is shared by the rays of a thread)
+            Vector3 dir = ray.to - ray.from;
+            Scalar length = dir.length();
+            if(length > SIMD_EPSILON)
+            {
+                dir /= length;
+                Vector3 dirInv;
+                unsigned int signs[3];
+                for(unsigned int h = 0; h < 3; ++h)
+                {
+                    dirInv[h] = dir[h] == Scalar(0) ? Scalar(BT_LARGE_FLOAT) : Scalar(1) / dir[h];
+                    signs[h] = dirInv[h] < Scalar(0);
+                }
+                
+                RayLeafTester tester;
+                tester.closest = &closest;
+                tester.rayFromTrans = Transform(IQ(), ray.from);
+                tester.rayToTrans = Transform(IQ(), ray.to);
+                for(unsigned int h = 0; h < 2; ++h)
+                    broadphase->m_sets[h].rayTestInternal(broadphase->m_sets[h].m_root, ray.from, ray.to, dirInv, signs, length, V0(), V0(), stack, tester);
+            }
+            
+            RayHit& hit = hits[i];
+            if(closest.hasHit())
+            {
+                hit.object = closest.m_collisionObject;
+                hit.fraction = closest.m_closestHitFraction;
+                hit.point = closest.m_hitPointWorld;
+                hit.normal = closest.m_hitNormalWorld;
+            }
+            else
+            {
+                hit.object = nullptr;
+                hit.fraction = Scalar(1);
+                hit.point = ray.to;
+                hit.normal = V0();
+            }
+        }
+    };
+    
+    if(threadPool != nullptr && nPackets > 1)
+        threadPool->ParallelFor(nPackets, castPacket);
+    else
+        for(size_t p = 0; p < nPackets; ++p)
+            castPacket(p);
+}
+
 void SimulationManager::RenderBulletDebug()
 {
     dynamicsWorld->debugDrawWorld();
@@ -1123,16 +1370,17 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     }
     
     //Get material and contact velocity information
-    MaterialManager* mm = SimulationApp::getApp()->getSimulationManager()->getMaterialManager();
+    SimulationManager* sm = SimulationApp::getApp()->getSimulationManager();
+    MaterialManager* mm = sm->getMaterialManager();
     
-    Material mat0;
+    const Material* mat0;
     Vector3 contactVelocity0;
     Scalar contactAngularVelocity0;
     
     if(ent0->getType() == EntityType::STATIC)
     {
         StaticEntity* sent0 = (StaticEntity*)ent0;
-        mat0 = sent0->getMaterial();
+        mat0 = &sent0->getMaterial();
         contactVelocity0.setZero();
         contactAngularVelocity0 = Scalar(0);
     }
@@ -1140,9 +1388,9 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     {
         SolidEntity* sent0 = (SolidEntity*)ent0;
         if(sent0->getSolidType() == SolidType::COMPOUND)
-            mat0 = ((Compound*)sent0)->getMaterial(((Compound*)sent0)->getPartId(index0));
+            mat0 = &((Compound*)sent0)->getMaterial(((Compound*)sent0)->getPartId(index0));
         else
-            mat0 = sent0->getMaterial();
+            mat0 = &sent0->getMaterial();
         //Vector3 localPoint0 = sent0->getTransform().getBasis() * cp.m_localPointA;
         Vector3 localPoint0 = sent0->getCGTransform().inverse() * cp.getPositionWorldOnA();
         contactVelocity0 = sent0->getLinearVelocityInLocalPoint(localPoint0);
@@ -1156,14 +1404,14 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
         return true;
     }
     
-    Material mat1;
+    const Material* mat1;
     Vector3 contactVelocity1;
     Scalar contactAngularVelocity1;
     
     if(ent1->getType() == EntityType::STATIC)
     {
         StaticEntity* sent1 = (StaticEntity*)ent1;
-        mat1 = sent1->getMaterial();
+        mat1 = &sent1->getMaterial();
         contactVelocity1.setZero();
         contactAngularVelocity1 = Scalar(0);
     }
@@ -1171,9 +1419,9 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     {
         SolidEntity* sent1 = (SolidEntity*)ent1;
         if(sent1->getSolidType() == SolidType::COMPOUND)
-            mat1 = ((Compound*)sent1)->getMaterial(((Compound*)sent1)->getPartId(index1));
+            mat1 = &((Compound*)sent1)->getMaterial(((Compound*)sent1)->getPartId(index1));
         else
-            mat1 = sent1->getMaterial();
+            mat1 = &sent1->getMaterial();
         //Vector3 localPoint1 = sent1->getTransform().getBasis() * cp.m_localPointB;
         Vector3 localPoint1 = sent1->getCGTransform().inverse() * cp.getPositionWorldOnB();
         contactVelocity1 = sent1->getLinearVelocityInLocalPoint(localPoint1);
@@ -1194,7 +1442,7 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     Vector3 slipVel = relLocalVel - normalVel;
     Scalar sigma = 1000;
     // f = (static - dynamic)/(sigma * v^2 + 1) + dynamic
-    Friction f = mm->GetMaterialsInteraction(mat0.name, mat1.name);
+    Friction f = mm->GetMaterialsInteraction(mat0->id, mat1->id);
     cp.m_combinedFriction = (f.fStatic - f.fDynamic)/(sigma * slipVel.length2() + Scalar(1)) + f.fDynamic;
     
     //Rolling friction not possible to generalize - needs special treatment
@@ -1202,7 +1450,7 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     cp.m_combinedSpinningFriction = Scalar(0);
     
     //Save user data
-    ContactInfo* cInfo = new ContactInfo();
+    ContactInfo* cInfo = sm->AllocateContactInfo();
     cInfo->totalAppliedImpulse = Scalar(0);
     cInfo->slip = slipVel;
     cp.m_userPersistentData = cInfo;
@@ -1213,39 +1461,38 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     Scalar relAngularVelocity10 = contactAngularVelocity1 - contactAngularVelocity0;
     
     //calculate contact normal force and friction torque
-    Scalar normalForce = cp.m_appliedImpulse * SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond();
+    Scalar normalForce = cp.m_appliedImpulse * sm->getStepsPerSecond();
     Scalar T = cp.m_combinedFriction * normalForce * 0.002;
 
-    //apply damping torque
+    //apply damping torque (contacts of one body may be created by many threads --> applied through the dispatcher)
+    FilteredCollisionDispatcher* dispatcher = (FilteredCollisionDispatcher*)sm->dwDispatcher;
     if(ent0->getType() == EntityType::SOLID && !btFuzzyZero(relAngularVelocity01))
-        ((SolidEntity*)ent0)->ApplyTorque(cp.m_normalWorldOnB * relAngularVelocity01/btFabs(relAngularVelocity01) * T);
+        dispatcher->ApplyContactForce((SolidEntity*)ent0, V0(), cp.m_normalWorldOnB * relAngularVelocity01/btFabs(relAngularVelocity01) * T);
     
     if(ent1->getType() == EntityType::SOLID && !btFuzzyZero(relAngularVelocity10))
-        ((SolidEntity*)ent1)->ApplyTorque(cp.m_normalWorldOnB * relAngularVelocity10/btFabs(relAngularVelocity10) * T);
+        dispatcher->ApplyContactForce((SolidEntity*)ent1, V0(), cp.m_normalWorldOnB * relAngularVelocity10/btFabs(relAngularVelocity10) * T);
     
     //Restitution
-    cp.m_combinedRestitution = mat0.restitution * mat1.restitution;
+    cp.m_combinedRestitution = mat0->restitution * mat1->restitution;
     
     //B. Magnetic attraction (only between magnet and ferromagnetic body, no magnet-magnet support)
-    if((mat0.magnetic < Scalar(0) && mat1.magnetic > Scalar(0))
-        || (mat0.magnetic > Scalar(0) && mat1.magnetic < Scalar(0)))
+    if((mat0->magnetic < Scalar(0) && mat1->magnetic > Scalar(0))
+        || (mat0->magnetic > Scalar(0) && mat1->magnetic < Scalar(0)))
     {
         Scalar d = btClamped(cp.getDistance(), Scalar(0.0001), BT_LARGE_FLOAT);
-        Scalar mag = (btFabs(mat0.magnetic) * btFabs(mat1.magnetic))/(d*d)/Scalar(1e4);
+        Scalar mag = (btFabs(mat0->magnetic) * btFabs(mat1->magnetic))/(d*d)/Scalar(1e4);
         btClamp(mag, Scalar(0), Scalar(10000)); //Arbitrary limit of 10kN
         Vector3 mForce = cp.m_normalWorldOnB * mag;
 
         if(ent0->getType() == EntityType::SOLID)
         {
             SolidEntity* sent0 = (SolidEntity*)ent0;
-            sent0->ApplyCentralForce(-mForce);
-            sent0->ApplyTorque((cp.m_positionWorldOnA - sent0->getCGTransform().getOrigin()).cross(-mForce));
+            dispatcher->ApplyContactForce(sent0, -mForce, (cp.m_positionWorldOnA - sent0->getCGTransform().getOrigin()).cross(-mForce));
         }
         if(ent1->getType() == EntityType::SOLID)
         {
             SolidEntity* sent1 = (SolidEntity*)ent1;
-            sent1->ApplyCentralForce(mForce);
-            sent1->ApplyTorque((cp.m_positionWorldOnB - sent1->getCGTransform().getOrigin()).cross(mForce));
+            dispatcher->ApplyContactForce(sent1, mForce, (cp.m_positionWorldOnB - sent1->getCGTransform().getOrigin()).cross(mForce));
         }
 
         cp.m_combinedRestitution = Scalar(0); //Allows sticking of bodies together
@@ -1366,6 +1613,11 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
         
     //Clear all forces to ensure that no summing occurs
     mbDynamicsWorld->clearForces(); //Includes clearing of multibody forces!
+    
+    //Compute link velocities of multibodies once, for all queries in this step
+    for(size_t i = 0; i < simManager->entities.size(); ++i)
+        if(simManager->entities[i]->getType() == EntityType::FEATHERSTONE)
+            ((FeatherstoneEntity*)simManager->entities[i])->UpdateKinematics();
         
     //loop through all actuators -> apply forces to bodies (free and connected by joints)
     for(size_t i = 0; i < simManager->actuators.size(); ++i)
@@ -1458,34 +1710,63 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
     //Hydrodynamic forces
     if(simManager->ocean != nullptr)
     {
-        if(recompute) SDL_LockMutex(simManager->simHydroMutex);
+        if(recompute)
+        {
+            SDL_LockMutex(simManager->simHydroMutex);
+            simManager->ocean->UpdateWaves(simManager->simulationTime);
+        }
         
         btBroadphasePairArray& pairArray = simManager->ocean->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
         int numPairs = pairArray.size();
         
-        if(numPairs > 0)
-        {   
+        //Collect bodies affected by the ocean (order of application is kept fixed for determinism)
+        std::vector<SolidEntity*>& bodies = simManager->hydroBodies;
+        bodies.clear();
+        
+        for(int h=0; h<numPairs; ++h)
+        {
+            const btBroadphasePair& pair = pairArray[h];
+            btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
+            if (!colPair)
+                continue;
+                
+            btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
+            btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
+            SolidEntity* solid = nullptr;
+            
+            if(co1 == simManager->ocean->getGhost())
+                solid = simManager->ocean->getFluidForcesBody(co2);
+            else if(co2 == simManager->ocean->getGhost())
+                solid = simManager->ocean->getFluidForcesBody(co1);
+            
+            if(solid != nullptr)
+                bodies.push_back(solid);
+        }
+        
+        //Compute forces (each body is independent)
+        if(recompute)
+        {
             //uint64_t s = GetTimeInMicroseconds();
-            for(int h=0; h<numPairs; ++h)
+#ifndef DEBUG_HYDRO
+            if(simManager->threadPool != nullptr && bodies.size() > 1)
             {
-                const btBroadphasePair& pair = pairArray[h];
-                btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
-                if (!colPair)
-                    continue;
-                    
-                btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
-                btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
-                
-                if(co1 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co2, recompute);
-                else if(co2 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co1, recompute);
+                Ocean* ocn = simManager->ocean;
+                simManager->threadPool->ParallelFor(bodies.size(), [ocn, &bodies](size_t i){ ocn->ComputeFluidForces(bodies[i]); });
+            }
+            else
+#endif
+            {
+                for(size_t i=0; i<bodies.size(); ++i)
+                    simManager->ocean->ComputeFluidForces(bodies[i]);
             }
             //uint64_t e = GetTimeInMicroseconds();
-            //if(recompute)
-            //    printf("Hydro compute time: %ld us\n", e-s);
+            //printf("Hydro compute time: %ld us\n", e-s);
         }
         
+        //Apply forces serially
+        for(size_t i=0; i<bodies.size(); ++i)
+            bodies[i]->ApplyHydrodynamicForces();
+        
         if(recompute) SDL_UnlockMutex(simManager->simHydroMutex);
     }
 }
@@ -1495,6 +1776,11 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
 {
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
     
+    //Refresh link velocities of multibodies after integration, for all queries until the next step
+    for(size_t i = 0; i < simManager->entities.size(); ++i)
+        if(simManager->entities[i]->getType() == EntityType::FEATHERSTONE)
+            ((FeatherstoneEntity*)simManager->entities[i])->UpdateKinematics();
+    
     //Update motion data
     for(size_t i = 0; i < simManager->entities.size(); ++i)
     {
@@ -1517,9 +1803,14 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
         }
     }
     
-    //Loop through all sensors -> update measurements
-    for(size_t i = 0; i < simManager->sensors.size(); ++i)
-        simManager->sensors[i]->Update(timeStep);
+    //Update sensors that are due
+    if(!simManager->sensorScheduler->isValid())
+        simManager->sensorScheduler->Build(simManager->sensors);
+    simManager->sensorScheduler->Update(timeStep, simManager->threadPool);
+    
+    //Stream new measurements to the log
+    if(simManager->logger != nullptr)
+        simManager->logger->Update();
         
     //Loop through all comms -> update state and measurements
     for(size_t i = 0; i < simManager->comms.size(); ++i)
@@ -1530,12 +1821,20 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
     for(int i=0; i<numManifolds; ++i)
     {
         btPersistentManifold* contactManifold = world->getDispatcher()->getManifoldByIndexInternal(i);
+        if(contactManifold->getNumContacts() == 0)
+            continue;
+        
         btCollisionObject* coA = (btCollisionObject*)contactManifold->getBody0();
         btCollisionObject* coB = (btCollisionObject*)contactManifold->getBody1();
         Entity* entA = (Entity*)coA->getUserPointer();
         Entity* entB = (Entity*)coB->getUserPointer();
+        
+        //Skip lookup if any of the bodies is not monitored by a contact sensor
+        if(entA == nullptr || entB == nullptr || !entA->isContactMonitored() || !entB->isContactMonitored())
+            continue;
+        
         Contact* contact = simManager->getContact(entA, entB);
-        if(contact != nullptr && contactManifold->getNumContacts() > 0)
+        if(contact != nullptr)
             contact->AddContactPoint(contactManifold, contact->getEntityA() != entA, timeStep);        
     }
 
@@ -1557,8 +1856,32 @@ bool SimulationManager::ContactInfoUpdateCallback(btManifoldPoint& cp, void* bod
 //Used to deallocate memory reserved for contact information structure
 bool SimulationManager::ContactInfoDestroyCallback(void* userPersistentData)
 {
-    delete ((ContactInfo*)userPersistentData);
+    FreeContactInfo((ContactInfo*)userPersistentData);
     return true;
 }
 
+//Contact information structures come from the pool of the world (fall back to heap when exhausted)
+ContactInfo* SimulationManager::AllocateContactInfo()
+{
+    SDL_AtomicLock(&contactInfoLock); //Contacts are created by many threads
+    void* mem = contactInfoPool->allocate(sizeof(ContactInfo));
+    SDL_AtomicUnlock(&contactInfoLock);
+    ContactInfo* cInfo = mem == nullptr ? new ContactInfo() : new(mem) ContactInfo();
+    cInfo->owner = mem == nullptr ? nullptr : this;
+    return cInfo;
+}
+
+void SimulationManager::FreeContactInfo(ContactInfo* cInfo)
+{
+    SimulationManager* owner = cInfo->owner;
+    if(owner != nullptr)
+    {
+        SDL_AtomicLock(&owner->contactInfoLock);
+        owner->contactInfoPool->freeMemory(cInfo); //Trivially destructible
+        SDL_AtomicUnlock(&owner->contactInfoLock);
+    }
+    else
+        delete cInfo;
+}
+
 }
@@ -0,0 +1,150 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ThreadPool.cpp
+//  Stonefish
+//
+
+#include "core/ThreadPool.h"
+
+#include <SDL2/SDL_cpuinfo.h>
+#include "core/SimulationApp.h"
+
+namespace sf
+{
+
+//Pool running the task executed by the current thread (nested loops are run serially)
+static thread_local ThreadPool* activePool = nullptr;
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+    if(numThreads == 0)
+        numThreads = (unsigned int)SDL_GetCPUCount();
+    if(numThreads == 0)
+        numThreads = 1;
+
+    poolMutex = SDL_CreateMutex();
+    workCond = SDL_CreateCond();
+    doneCond = SDL_CreateCond();
+    job = nullptr;
+    jobApp = nullptr;
+    jobSize = 0;
+    jobNext = 0;
+    jobId = 0;
+    busy = 0;
+    quit = false;
+
+    //Calling thread takes part in computation
+    for(unsigned int i=1; i<numThreads; ++i)
+        workers.push_back(SDL_CreateThread(ThreadPool::WorkerLoop, "workerThread", this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    SDL_LockMutex(poolMutex);
+    quit = true;
+    SDL_CondBroadcast(workCond);
+    SDL_UnlockMutex(poolMutex);
+
+    for(size_t i=0; i<workers.size(); ++i)
+    {
+        int status;
+        SDL_WaitThread(workers[i], &status);
+    }
+    workers.clear();
+
+    SDL_DestroyCond(doneCond);
+    SDL_DestroyCond(workCond);
+    SDL_DestroyMutex(poolMutex);
+}
+
+unsigned int ThreadPool::getNumOfThreads() const
+{
+    return (unsigned int)workers.size() + 1;
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    if(count == 0)
+        return;
+
+    if(workers.size() == 0 || count == 1 || activePool == this) //No need (or no way) to wake up workers
+    {
+        for(size_t i=0; i<count; ++i)
+            task(i);
+        return;
+    }
+
+    SDL_LockMutex(poolMutex);
+    job = &task;
+    jobApp = SimulationApp::getApp(); //Workers resolve the same world as the calling thread
+    jobSize = count;
+    jobNext = 0;
+    busy = (unsigned int)workers.size();
+    ++jobId;
+    SDL_CondBroadcast(workCond);
+    SDL_UnlockMutex(poolMutex);
+
+    RunTasks();
+
+    SDL_LockMutex(poolMutex);
+    while(busy > 0)
+        SDL_CondWait(doneCond, poolMutex);
+    job = nullptr;
+    jobSize = 0;
+    SDL_UnlockMutex(poolMutex);
+}
+
+void ThreadPool::RunTasks()
+{
+    ThreadPool* outerPool = activePool;
+    activePool = this;
+    size_t i;
+    while((i = jobNext.fetch_add(1)) < jobSize)
+        (*job)(i);
+    activePool = outerPool;
+}
+
+int ThreadPool::WorkerLoop(void* data)
+{
+    ThreadPool* pool = (ThreadPool*)data;
+    unsigned int lastJobId = 0;
+
+    SDL_LockMutex(pool->poolMutex);
+    while(true)
+    {
+        while(!pool->quit && pool->jobId == lastJobId)
+            SDL_CondWait(pool->workCond, pool->poolMutex);
+
+        if(pool->quit)
+            break;
+
+        lastJobId = pool->jobId;
+        SimulationApp::setThreadApp(pool->jobApp);
+        SDL_UnlockMutex(pool->poolMutex);
+        pool->RunTasks();
+        SDL_LockMutex(pool->poolMutex);
+
+        if(--pool->busy == 0)
+            SDL_CondSignal(pool->doneCond);
+    }
+    SDL_UnlockMutex(pool->poolMutex);
+    return 0;
+}
+
+}
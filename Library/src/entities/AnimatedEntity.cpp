@@ -295,30 +295,23 @@ void AnimatedEntity::Update(Scalar dt)
     rigidBody->setAngularVelocity(tr->getInterpolatedAngularVelocity());    
 }
 
-std::vector<Renderable> AnimatedEntity::Render()
+void AnimatedEntity::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     if(rigidBody != nullptr && isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SOLID_CS;
-        item.model = glMatrixFromTransform(getOTransform());
-        items.push_back(item);
+        glm::mat4 model = glMatrixFromTransform(getOTransform());
+        snapshot.Add(RenderableType::SOLID_CS, model);
 
         if(graObjectId >= 0)
         {
-            item.type = RenderableType::SOLID;
-            item.materialName = mat.name;
+            Renderable& item = snapshot.Add(RenderableType::SOLID, model);
+            item.materialId = mat.id;
             item.objectId = dm == DisplayMode::GRAPHICAL ? graObjectId : phyObjectId;
             item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
-            items.push_back(item);
         }
 
-        items.push_back(tr->Render());
+        tr->Render(snapshot);
     }
-
-    return items;
 }
 
 }
@@ -36,6 +36,7 @@ Entity::Entity(std::string uniqueName)
 {
     name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
     renderable = true;
+    contactMonitored = false;
 }
 
 Entity::~Entity(void)
@@ -58,5 +59,15 @@ std::string Entity::getName() const
 {
     return name;
 }
+
+void Entity::setContactMonitored(bool monitored)
+{
+    contactMonitored = monitored;
+}
+
+bool Entity::isContactMonitored() const
+{
+    return contactMonitored;
+}
         
 }
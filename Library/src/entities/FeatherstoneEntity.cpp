@@ -162,6 +162,8 @@ void FeatherstoneEntity::setBaseRenderable(bool render)
 
 void FeatherstoneEntity::setBaseTransform(const Transform& trans)
 {
+    InvalidateKinematics();
+    
     Transform T0 = trans * links[0].solid->getCG2CTransform().inverse();
     multiBody->getBaseCollider()->setWorldTransform(T0);
     multiBody->setBaseWorldTransform(T0);
@@ -178,6 +180,8 @@ void FeatherstoneEntity::setJointIC(unsigned int index, Scalar position, Scalar
     if(index >= joints.size())
         return;
     
+    InvalidateKinematics();
+    
     switch (joints[index].type)
     {
         case btMultibodyLink::eRevolute:
@@ -676,34 +680,80 @@ void FeatherstoneEntity::AddLinkTorque(unsigned int index, const Vector3& tau)
         multiBody->addLinkTorque(index-1, tau);
 }
 
+void FeatherstoneEntity::UpdateKinematics()
+{
+    //Base
+    SolidEntity* base = links[0].solid;
+    base->mbLinVelocity = multiBody->getBaseVel();
+    base->mbAngVelocity = multiBody->getBaseOmega();
+    base->mbVelocityCached = true;
+    
+    //Links (parents always have lower indices than children)
+    int numLinks = std::min(multiBody->getNumLinks(), (int)links.size() - 1);
+    linkRotations.resize(numLinks + 1);
+    linkRotations[0] = multiBody->getWorldToBaseRot().inverse();
+    
+    for(int i = 0; i < numLinks; ++i)
+    {
+        int parent = multiBody->getParent(i) + 1;
+        linkRotations[i + 1] = linkRotations[parent] * multiBody->getParentToLocalRot(i).inverse();
+        
+        Vector3 linVelocity = links[parent].solid->mbLinVelocity;
+        Vector3 angVelocity = links[parent].solid->mbAngVelocity;
+        PropagateLinkVelocity(multiBody, i, linkRotations[i + 1], linVelocity, angVelocity);
+        
+        SolidEntity* solid = links[i + 1].solid;
+        solid->mbLinVelocity = linVelocity;
+        solid->mbAngVelocity = angVelocity;
+        solid->mbVelocityCached = true;
+    }
+}
+
+void FeatherstoneEntity::InvalidateKinematics()
+{
+    for(size_t i = 0; i < links.size(); ++i)
+        links[i].solid->mbVelocityCached = false;
+}
+
+void FeatherstoneEntity::PropagateLinkVelocity(const btMultiBody* mb, int link, const Quaternion& linkToWorld, Vector3& linVelocity, Vector3& angVelocity)
+{
+    const btMultibodyLink& l = mb->getLink(link);
+    
+    //Add velocity resulting from rotation of the parent
+    linVelocity += angVelocity.cross(quatRotate(linkToWorld, mb->getRVector(link)));
+    
+    if(l.m_jointType == btMultibodyLink::ePrismatic) //Just add linear velocity
+    {
+        Vector3 vel = mb->getJointVel(link) * l.getAxisBottom(0); //Local velocity
+        linVelocity += quatRotate(linkToWorld, vel); //Global velocity
+    }
+    else if(l.m_jointType == btMultibodyLink::eRevolute) //Add linear velocity due to rotation
+    {
+        Vector3 aVel = mb->getJointVel(link) * l.getAxisTop(0); //Local angular velocity
+        Vector3 vel = aVel.cross(l.m_dVector); //Local velocity
+        linVelocity += quatRotate(linkToWorld, vel); //Global linear velocity
+        angVelocity += quatRotate(linkToWorld, aVel); //Global angular velocity
+    }
+}
+
 void FeatherstoneEntity::UpdateAcceleration(Scalar dt)
 {
     for(size_t i = 0; i<links.size(); ++i)
         links[i].solid->UpdateAcceleration(dt);
 }
 
-std::vector<Renderable> FeatherstoneEntity::Render()
+void FeatherstoneEntity::Render(RenderSnapshot& snapshot)
 {	
-    std::vector<Renderable> items(0);
-    
     //Draw base
     if(baseRenderable)
-    {
-        std::vector<Renderable> _base = links[0].solid->Render();
-        items.insert(items.end(), _base.begin(), _base.end());
-    }
+        links[0].solid->Render(snapshot);
     
     //Draw rest of links
     for(size_t i = 1; i < links.size(); ++i)
-    {
-        std::vector<Renderable> _link = links[i].solid->Render();
-        items.insert(items.end(), _link.begin(), _link.end());
-    }
+        links[i].solid->Render(snapshot);
     
     //Draw link axes
-    Renderable item;
-    item.type = RenderableType::MULTIBODY_AXIS;
-    item.model = glm::mat4(1.f);
+    snapshot.Add(RenderableType::MULTIBODY_AXIS);
     
     for(size_t i = 1; i < links.size(); ++i)
     {
@@ -722,13 +772,9 @@ std::vector<Renderable> FeatherstoneEntity::Render()
             axisEnd += axisInWorld * Scalar(0.3);
         }
         
-        item.points.push_back(glm::vec3((GLfloat)pivot.x(), (GLfloat)pivot.y(), (GLfloat)pivot.z()));
-        item.points.push_back(glm::vec3((GLfloat)axisEnd.x(), (GLfloat)axisEnd.y(), (GLfloat)axisEnd.z()));
+        snapshot.AddPoint(glm::vec3((GLfloat)pivot.x(), (GLfloat)pivot.y(), (GLfloat)pivot.z()));
+        snapshot.AddPoint(glm::vec3((GLfloat)axisEnd.x(), (GLfloat)axisEnd.y(), (GLfloat)axisEnd.z()));
     }
-    
-    items.push_back(item);
-    
-    return items;
 }
 
 }
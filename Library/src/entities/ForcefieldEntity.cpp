@@ -56,9 +56,8 @@ void ForcefieldEntity::AddToSimulation(SimulationManager* sm)
     sm->getDynamicsWorld()->addCollisionObject(ghost, MASK_GHOST, MASK_DYNAMIC);
 }
 
-std::vector<Renderable> ForcefieldEntity::Render()
+void ForcefieldEntity::Render(RenderSnapshot& snapshot)
 {
-    return std::vector<Renderable>(0);
 }
 
 void ForcefieldEntity::getAABB(Vector3& min, Vector3& max)
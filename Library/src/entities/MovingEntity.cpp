@@ -49,7 +49,7 @@ MovingEntity::~MovingEntity()
 {
 }
 
-Material MovingEntity::getMaterial() const
+const Material& MovingEntity::getMaterial() const
 {
     return mat;
 }
@@ -32,6 +32,7 @@
 #include "utils/SystemUtil.hpp"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
+#include "entities/FeatherstoneEntity.h"
 #include <iostream>
 #include <algorithm>
 
@@ -91,11 +92,13 @@ SolidEntity::SolidEntity(std::string uniqueName, BodyPhysicsSettings phy, std::s
     
     //Set pointers
     multibodyCollider = nullptr;
+    mbLinVelocity.setZero();
+    mbAngVelocity.setZero();
+    mbVelocityCached = false;
     phyMesh = nullptr;
     graObjectId = -1;
     phyObjectId = -1;
     dm = DisplayMode::GRAPHICAL;
-    submerged.type = RenderableType::HYDRO_LINES;
 }
 
 SolidEntity::~SolidEntity()
@@ -204,44 +207,33 @@ void SolidEntity::getAABB(Vector3& min, Vector3& max)
     }
 }
 
-std::vector<Renderable> SolidEntity::Render()
+void SolidEntity::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     if( (rigidBody != nullptr || multibodyCollider != nullptr)  && isRenderable() )
     {
-        Renderable item;
-        item.type = RenderableType::SOLID;
-        item.materialName = mat.name;
-        
         if(dm == DisplayMode::GRAPHICAL && graObjectId >= 0)
         {
+            Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(getGTransform()));
             item.objectId = graObjectId;
             item.lookId = lookId;
-            item.model = glMatrixFromTransform(getGTransform());
-            items.push_back(item);
+            item.materialId = mat.id;
         }
         else if(dm == DisplayMode::PHYSICAL && phyObjectId >= 0)
         {
+            Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(getCTransform()));
             item.objectId = phyObjectId;
-            item.lookId = -1;
-            item.model = glMatrixFromTransform(getCTransform());
-            items.push_back(item);
+            item.materialId = mat.id;
         }
         
-        item.type = RenderableType::SOLID_CS;
-        item.model = glMatrixFromTransform(getCGTransform());
-        items.push_back(item);
+        snapshot.Add(RenderableType::SOLID_CS, glMatrixFromTransform(getCGTransform()));
         
         //Hydrodynamics
         Vector3 cbWorld = getCGTransform() * P_CB;
-        item.type = RenderableType::HYDRO_CS;
-        item.model = glMatrixFromTransform(Transform(Quaternion::getIdentity(), cbWorld));
-        items.push_back(item);
+        snapshot.Add(RenderableType::HYDRO_CS, glMatrixFromTransform(Transform(Quaternion::getIdentity(), cbWorld)));
 
         //Surface crossing debug
-        //submerged.model = glMatrixFromTransform(sf::I4());
-        //items.push_back(submerged);
+        //snapshot.Add(RenderableType::HYDRO_LINES);
+        //snapshot.AddPoints(submerged);
 
         //Geometry approximation
         switch(fdApproxType)
@@ -250,50 +242,37 @@ std::vector<Renderable> SolidEntity::Render()
                 break;
                 
             case  GeometryApproxType::SPHERE:
-                item.type = RenderableType::HYDRO_ELLIPSOID;
-                item.model = glMatrixFromTransform(getHTransform());
-                item.points.push_back(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0]));
-                items.push_back(item);
+                snapshot.Add(RenderableType::HYDRO_ELLIPSOID, glMatrixFromTransform(getHTransform()));
+                snapshot.AddPoint(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0]));
                 break;
                 
             case  GeometryApproxType::CYLINDER:
-                item.type = RenderableType::HYDRO_CYLINDER;
-                item.model = glMatrixFromTransform(getHTransform());
-                item.points.push_back(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1]));
-                items.push_back(item);
+                snapshot.Add(RenderableType::HYDRO_CYLINDER, glMatrixFromTransform(getHTransform()));
+                snapshot.AddPoint(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1]));
                 break;
                 
             case  GeometryApproxType::ELLIPSOID:
-                item.type = RenderableType::HYDRO_ELLIPSOID;
-                item.model = glMatrixFromTransform(getHTransform());
-                item.points.push_back(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1], (GLfloat)fdApproxParams[2]));
-                items.push_back(item);
+                snapshot.Add(RenderableType::HYDRO_ELLIPSOID, glMatrixFromTransform(getHTransform()));
+                snapshot.AddPoint(glm::vec3((GLfloat)fdApproxParams[0], (GLfloat)fdApproxParams[1], (GLfloat)fdApproxParams[2]));
                 break;
         }
 
         //Forces
         Vector3 cg = getCGTransform().getOrigin();
         glm::vec3 cgv((GLfloat)cg.x(), (GLfloat)cg.y(), (GLfloat)cg.z());
-        item.points.clear();
-        item.points.push_back(cgv);
-        item.model = glm::mat4(1.f);
         
-        item.type = RenderableType::FORCE_BUOYANCY;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
-        items.push_back(item);
+        snapshot.Add(RenderableType::FORCE_BUOYANCY);
+        snapshot.AddPoint(cgv);
+        snapshot.AddPoint(cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
         
-        item.points.pop_back();
-        item.type = RenderableType::FORCE_LINEAR_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
-        items.push_back(item);
+        snapshot.Add(RenderableType::FORCE_LINEAR_DRAG);
+        snapshot.AddPoint(cgv);
+        snapshot.AddPoint(cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
         
-        item.points.pop_back();
-        item.type = RenderableType::FORCE_QUADRATIC_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
-        items.push_back(item);
+        snapshot.Add(RenderableType::FORCE_QUADRATIC_DRAG);
+        snapshot.AddPoint(cgv);
+        snapshot.AddPoint(cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
     }
-    
-    return items;
 }
     
 Transform SolidEntity::getCG2GTransform() const
@@ -387,43 +366,11 @@ Vector3 SolidEntity::getLinearVelocity() const
     }
     else if(multibodyCollider != nullptr)
     {
-        //Get multibody and link id
-        btMultiBody* multiBody = multibodyCollider->m_multiBody;
-        int index = multibodyCollider->m_link;
-        
-        //Start with base velocity
-        Vector3 linVelocity = multiBody->getBaseVel(); //Global
-        Vector3 angVelocity = multiBody->getBaseOmega(); //Global
-        
-        if(index >= 0) //If collider is not base
-        {
-            for(int i = 0; i <= index; ++i) //Accumulate velocity resulting from joints
-            {
-                //Add velocity resulting from rotation of previous links
-                linVelocity += angVelocity.cross(multiBody->localDirToWorld(i, multiBody->getRVector(i)));
-                
-                if(multiBody->getLink(i).m_jointType == btMultibodyLink::ePrismatic) //Just add linear velocity
-                {
-                    Vector3 axis = multiBody->getLink(i).getAxisBottom(0); //Local axis
-                    Vector3 vel = multiBody->getJointVel(i) * axis; //Local velocity
-                    Vector3 gvel = multiBody->localDirToWorld(i, vel); //Global velocity
-                    linVelocity += gvel;
-                }
-                else if(multiBody->getLink(i).m_jointType == btMultibodyLink::eRevolute) //Add linear velocity due to rotation
-                {
-                    //Vector3 axis = multiBody->getLink(i).getAxisBottom(0); //Local linear motion
-                    //Vector3 vel = multiBody->getJointVel(i) * axis; //Local velocity
-                    
-                    Vector3 axis = multiBody->getLink(i).getAxisTop(0); //Axis of joint
-                    Vector3 aVel = multiBody->getJointVel(i) * axis;
-                    Vector3 vel = aVel.cross(multiBody->getLink(i).m_dVector); //Local velocity
-                    Vector3 gvel = multiBody->localDirToWorld(i, vel); //Global linear velocity
-                    linVelocity += gvel;
-                    angVelocity += multiBody->localDirToWorld(i, aVel); //Global angular velocity
-                }
-            }
-        }
+        if(mbVelocityCached) //Computed once per step by the multibody
+            return mbLinVelocity;
         
+        Vector3 linVelocity, angVelocity;
+        ComputeMultibodyVelocity(linVelocity, angVelocity);
         return linVelocity;
     }
     else
@@ -438,31 +385,41 @@ Vector3 SolidEntity::getAngularVelocity() const
     }
     else if(multibodyCollider != nullptr)
     {
-        //Get multibody and link id
-        btMultiBody* multiBody = multibodyCollider->m_multiBody;
-        int index = multibodyCollider->m_link;
-        
-        //Start with base velocity
-        Vector3 angVelocity = multiBody->getBaseOmega(); //Global
-        
-        if(index >= 0)
-        {
-            for(int i = 0; i <= index; ++i) //Accumulate velocity resulting from joints
-                if(multiBody->getLink(i).m_jointType == btMultibodyLink::eRevolute) //Only revolute joints can change angular velocity
-                {
-                    Vector3 axis = multiBody->getLink(i).getAxisTop(0); //Local axis
-                    Vector3 vel = multiBody->getJointVel(i) * axis; //Local velocity
-                    Vector3 gvel = multiBody->localDirToWorld(i, vel); //Global velocity
-                    angVelocity += gvel;
-                }
-        }
+        if(mbVelocityCached) //Computed once per step by the multibody
+            return mbAngVelocity;
         
+        Vector3 linVelocity, angVelocity;
+        ComputeMultibodyVelocity(linVelocity, angVelocity);
         return angVelocity;
     }
     else
         return Vector3(0,0,0);
 }
 
+void SolidEntity::ComputeMultibodyVelocity(Vector3& linVelocity, Vector3& angVelocity) const
+{
+    //Get multibody and link id
+    btMultiBody* multiBody = multibodyCollider->m_multiBody;
+    int index = multibodyCollider->m_link;
+    
+    //Find the path from the base to the link
+    btAlignedObjectArray<int> path;
+    for(int i = index; i >= 0; i = multiBody->getParent(i))
+        path.push_back(i);
+    
+    //Start with base velocity
+    linVelocity = multiBody->getBaseVel(); //Global
+    angVelocity = multiBody->getBaseOmega(); //Global
+    Quaternion linkToWorld = multiBody->getWorldToBaseRot().inverse();
+    
+    //Accumulate velocity resulting from the joints of the ancestors
+    for(int h = path.size()-1; h >= 0; --h)
+    {
+        linkToWorld = linkToWorld * multiBody->getParentToLocalRot(path[h]).inverse();
+        FeatherstoneEntity::PropagateLinkVelocity(multiBody, path[h], linkToWorld, linVelocity, angVelocity);
+    }
+}
+
 Vector3 SolidEntity::getLinearVelocityInLocalPoint(const Vector3& relPos) const
 {
     if(rigidBody != nullptr)
@@ -559,6 +516,21 @@ const Mesh* SolidEntity::getPhysicsMesh()
     return phyMesh;
 }
 
+const FaceBuffer* SolidEntity::getPhysicsFaces()
+{
+    if(phyMesh == nullptr)
+        return nullptr;
+    
+    if(phyFaces.isEmpty())
+        phyFaces.Build(phyMesh);
+    return &phyFaces;
+}
+
+ReducedDragModel* SolidEntity::getDragModel()
+{
+    return getPhysicsFaces() != nullptr ? &dragModel : nullptr;
+}
+
 std::vector<Vector3>* SolidEntity::getMeshVertices() const
 {
     std::vector<Vector3>* vertices = new std::vector<Vector3>(0);
@@ -1187,10 +1159,10 @@ void SolidEntity::CorrectHydrodynamicForces(Ocean* ocn, Vector3& _Fdl, Vector3&
     _Tds *= 0.1 * 0.5 * ocn->getLiquid().density;
 }
 
-void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const Mesh* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
-                                            const Vector3& _v, const Vector3& _omega, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds, Renderable& debug)
+void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const FaceBuffer* faces, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
+                                            const Vector3& _v, const Vector3& _omega, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds, std::vector<glm::vec3>& debug)
 {
-    if(mesh == nullptr)
+    if(faces == nullptr)
     {
         if(settings.reallisticBuoyancy)
         {
@@ -1222,28 +1194,41 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     glm::vec3 Tds(0.f);
     glm::mat4 TCG = glMatrixFromTransform(T_CG);
     glm::mat4 TC = glMatrixFromTransform(T_C);
+    glm::mat3 R = glm::mat3(TC);
     glm::vec3 v = glVectorFromVector(_v);
     glm::vec3 omega = glVectorFromVector(_omega);
    
     //Calculate fluid dynamics forces and torques
     glm::vec3 p = glm::vec3(TCG[3]);
     
+    //Global coordinates and depths of unique vertices (evaluated once for all faces sharing them)
+    static thread_local std::vector<glm::vec3> vertices;
+    static thread_local std::vector<GLfloat> vertexDepths;
+    static thread_local std::vector<glm::vec3> centroids;
+    static thread_local std::vector<glm::vec3> areaNormals;
+    static thread_local std::vector<GLfloat> centroidDepths;
+    vertices.resize(faces->getNumOfVertices());
+    vertexDepths.resize(vertices.size());
+    centroids.clear();
+    areaNormals.clear();
+    
+    for(size_t i=0; i<vertices.size(); ++i)
+        vertices[i] = glm::vec3(TC * glm::vec4(faces->getVertex(i), 1.f));
+    ocn->GetDepths(vertices.data(), vertexDepths.data(), vertices.size());
+    
     //Loop through all faces...
-    for(size_t i=0; i<mesh->faces.size(); ++i)
+    for(size_t i=0; i<faces->getNumOfFaces(); ++i)
     {
-        //Global coordinates
-        glm::vec3 p1gl = mesh->getVertexPos(i, 0);
-        glm::vec3 p2gl = mesh->getVertexPos(i, 1);
-        glm::vec3 p3gl = mesh->getVertexPos(i, 2);
-        glm::vec3 p1 = glm::vec3(TC * glm::vec4(p1gl, 1.f));
-        glm::vec3 p2 = glm::vec3(TC * glm::vec4(p2gl, 1.f));
-        glm::vec3 p3 = glm::vec3(TC * glm::vec4(p3gl, 1.f));
+        const GLuint* fv = faces->getFaceVertices(i);
+        glm::vec3 p1 = vertices[fv[0]];
+        glm::vec3 p2 = vertices[fv[1]];
+        glm::vec3 p3 = vertices[fv[2]];
         
         //Check if face underwater
         GLfloat depth[3];
-        depth[0] = ocn->GetDepth(p1);
-        depth[1] = ocn->GetDepth(p2);
-        depth[2] = ocn->GetDepth(p3);
+        depth[0] = vertexDepths[fv[0]];
+        depth[1] = vertexDepths[fv[1]];
+        depth[2] = vertexDepths[fv[2]];
         
         if(depth[0] < 0.f && depth[1] < 0.f && depth[2] < 0.f)
             continue;
@@ -1274,12 +1259,12 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 fn1 = fn/len; //Normalised normal (length = 1)
                 A = len/2.f; //Area of the face (triangle)         
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif
             }
             else if(depth[2] < 0.f) //Two vertices above water (triangle)
@@ -1300,12 +1285,12 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 fn1 = fn/len; //Normalised normal (length = 1)
                 A = len/2.f; //Area of the face (triangle)         
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif
             }
             else //depth[1] >= 0 && depth[2] >= 0 --> Two vertices under water (quad = two triangles)
@@ -1331,14 +1316,14 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 A = (len + glm::length(glm::cross(fv3, fv4)))/2.f; //Quad
                 fn = fn1 * A;
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p4);
-                debug.points.push_back(p4);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p4);
+                debug.push_back(p4);
+                debug.push_back(p1);
 #endif  
             }
         }
@@ -1362,12 +1347,12 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 fn1 = fn/len; //Normalised normal (length = 1)
                 A = len/2.f; //Area of the face (triangle)
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif                
             }
             else
@@ -1392,14 +1377,14 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
                 A = (len + glm::length(glm::cross(fv3, fv4)))/2.f; //Quad
                 fn = fn1 * A;
 #ifdef DEBUG_HYDRO
-                debug.points.push_back(p1);
-                debug.points.push_back(p2);
-                debug.points.push_back(p2);
-                debug.points.push_back(p4);
-                debug.points.push_back(p4);
-                debug.points.push_back(p3);
-                debug.points.push_back(p3);
-                debug.points.push_back(p1);
+                debug.push_back(p1);
+                debug.push_back(p2);
+                debug.push_back(p2);
+                debug.push_back(p4);
+                debug.push_back(p4);
+                debug.push_back(p3);
+                debug.push_back(p3);
+                debug.push_back(p1);
 #endif                 
             }
         }
@@ -1425,47 +1410,38 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
             A = (len + glm::length(glm::cross(fv3, fv4)))/2.f; //Quad
             fn = fn1 * A;
 #ifdef DEBUG_HYDRO
-            debug.points.push_back(p1);
-            debug.points.push_back(p2);
-            debug.points.push_back(p2);
-            debug.points.push_back(p3);
-            debug.points.push_back(p3);
-            debug.points.push_back(p4);
-            debug.points.push_back(p4);
-            debug.points.push_back(p1);
+            debug.push_back(p1);
+            debug.push_back(p2);
+            debug.push_back(p2);
+            debug.push_back(p3);
+            debug.push_back(p3);
+            debug.push_back(p4);
+            debug.push_back(p4);
+            debug.push_back(p1);
 #endif             
         }
         else //All underwater
         {
-            //Face properties
-            glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
-            glm::vec3 fv2 = p3-p1; //Another side of the face (triangle)
-            fn = glm::cross(fv1, fv2); //Normal of the face (length != 1)
-            GLfloat len = glm::length2(fn);
-            if(len < 1e-12f) continue;
-            len = glm::sqrt(len);
-            fn1 = fn/len; //Normalised normal (length = 1)
-            A = len/2.f; //Area of the face (triangle)
+            //Face properties (precomputed, only rotated with the body)
+            A = faces->getArea(i); //Area of the face (triangle)
+            if(A == 0.f) continue; //Degenerate face
+            fn1 = R * faces->getNormal(i); //Normalised normal (length = 1)
             fc = (p1+p2+p3)/3.f; //Face centroid
 #ifdef DEBUG_HYDRO
-            debug.points.push_back(p1);
-            debug.points.push_back(p2);
-            debug.points.push_back(p2);
-            debug.points.push_back(p3);
-            debug.points.push_back(p3);
-            debug.points.push_back(p1);
+            debug.push_back(p1);
+            debug.push_back(p2);
+            debug.push_back(p2);
+            debug.push_back(p3);
+            debug.push_back(p3);
+            debug.push_back(p1);
 #endif             
         }
         
-        //Buoyancy force
+        //Buoyancy force (computed after the loop, when depths of all centroids are known)
         if(settings.reallisticBuoyancy)
         {
-            GLfloat depthc = ocn->GetDepth(fc);
-            glm::vec3 Fbi = -fn1 * A * depthc; //Buoyancy force per face (based on pressure)        
-            
-            //Accumulate
-            Fb += Fbi;
-            Tb += glm::cross(fc-p, Fbi);
+            centroids.push_back(fc);
+            areaNormals.push_back(fn1 * A);
         }
         
         //Damping force
@@ -1497,6 +1473,20 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
             }
         }
     }
+    
+    //Buoyancy forces per face (based on pressure at the centroid)
+    if(settings.reallisticBuoyancy)
+    {
+        centroidDepths.resize(centroids.size());
+        ocn->GetDepths(centroids.data(), centroidDepths.data(), centroids.size());
+        
+        for(size_t i=0; i<centroids.size(); ++i)
+        {
+            glm::vec3 Fbi = -areaNormals[i] * centroidDepths[i];
+            Fb += Fbi;
+            Tb += glm::cross(centroids[i]-p, Fbi);
+        }
+    }
 
     //Multiply by common factors
     //Buoyancy
@@ -1520,10 +1510,11 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     }
 }
 
-void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
-                                              const Vector3& _v, const Vector3& _omega, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds)
+void SolidEntity::ComputeHydrodynamicForcesSubmerged(const FaceBuffer* faces, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
+                                              const Vector3& _v, const Vector3& _omega, Vector3& _Fdl, Vector3& _Tdl, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fds, Vector3& _Tds,
+                                              ReducedDragModel* model)
 {
-    if(mesh == nullptr)
+    if(faces == nullptr)
     {
         _Fdl.setZero();
         _Tdl.setZero();
@@ -1535,68 +1526,98 @@ void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* oc
     }
 
     //Computation with floats (geometry has float precision)
-    glm::vec3 Fdl(0.f);
-    glm::vec3 Tdl(0.f);
-    glm::vec3 Fdq(0.f);
-    glm::vec3 Tdq(0.f);
-    glm::vec3 Fds(0.f);
-    glm::vec3 Tds(0.f);
+    glm::vec3 Fdl;
+    glm::vec3 Tdl;
+    glm::vec3 Fdq;
+    glm::vec3 Tdq;
+    glm::vec3 Fds;
+    glm::vec3 Tds;
     glm::mat4 TCG = glMatrixFromTransform(T_CG);
     glm::mat4 TC = glMatrixFromTransform(T_C);
+    glm::mat3 R = glm::mat3(TC);
+    glm::mat3 Rinv = glm::transpose(R);
+    glm::vec3 t = glm::vec3(TC[3]);
     glm::vec3 v = glVectorFromVector(_v);
     glm::vec3 omega = glVectorFromVector(_omega);
-    
-    //Calculate fluid dynamics forces and torques
     glm::vec3 p = glm::vec3(TCG[3]);
-
-    //Loop through all faces...
-    for(size_t i=0; i<mesh->faces.size(); ++i)
+    
+    //Rigid transform only rotates the face data --> integrate in the mesh frame
+    glm::vec3 pl = Rinv * (p - t);
+    glm::vec3 vl = Rinv * v;
+    glm::vec3 omegal = Rinv * omega;
+    
+    //Reduced-order model used when the flow is close to uniform over the hull
+    bool reduced = false;
+    if(model != nullptr)
     {
-        //Global coordinates
-        glm::vec3 p1gl = mesh->getVertexPos(i, 0);
-        glm::vec3 p2gl = mesh->getVertexPos(i, 1);
-        glm::vec3 p3gl = mesh->getVertexPos(i, 2);
-        glm::vec3 p1 = glm::vec3(TC * glm::vec4(p1gl, 1.f));
-        glm::vec3 p2 = glm::vec3(TC * glm::vec4(p2gl, 1.f));
-        glm::vec3 p3 = glm::vec3(TC * glm::vec4(p3gl, 1.f));
+        if(model->isEmpty()) //Built once, about the CG offset computed in the body frame with full precision
+            model->Build(*faces, glVectorFromVector(T_C.inverse() * T_CG.getOrigin()));
         
-        //Face properties
-        glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
-        glm::vec3 fv2 = p3-p1; //Another side of the face (triangle)
-        glm::vec3 fn = glm::cross(fv1, fv2); //Normal of the face (length != 1)
-        GLfloat len = glm::length2(fn);
-        if(len < 1e-12f) continue;
-        len = glm::sqrt(len);
-        glm::vec3 fn1 = fn/len; //Normalised normal (length = 1)
-        GLfloat A = len/2.f; //Area of the face (triangle)
-        glm::vec3 fc = (p1+p2+p3)/3.f; //Face centroid
-     
-        //Forces
-        glm::vec3 vc = ocn->GetFluidVelocity(fc) - (v + glm::cross(omega, fc-p));
-        glm::vec3 vn = glm::dot(vc, fn1) * fn1; //Normal velocity
-        glm::vec3 vt = vc - vn; //Tangent velocity
-            
-        if(glm::dot(fn1, vn) < -1e-12f)
+        glm::vec3 vfl;
+        GLfloat flowVariation = 0.f;
+        if(ocn->hasCurrents()) //Fluid velocity sampled at the reference point and at the extremes of the hull along the mesh axes
         {
-            GLfloat vmag2 = glm::length2(vn);
-            glm::vec3 linear = vn * expf(-0.5f*vmag2) * A; 
-            glm::vec3 quadratic = vn * sqrtf(vmag2) * A;
-                
-            Fdl += linear;
-            Tdl += glm::cross(fc - p, linear);
-            Fdq += quadratic;
-            Tdq += glm::cross(fc - p, quadratic);
+            glm::vec3 samples[7];
+            samples[0] = ocn->GetFluidVelocity(p);
+            for(unsigned int i=0; i<3; ++i)
+            {
+                samples[2*i+1] = ocn->GetFluidVelocity(p + R[i] * model->getRadius());
+                samples[2*i+2] = ocn->GetFluidVelocity(p - R[i] * model->getRadius());
+            }
+            glm::vec3 mean(0.f);
+            for(unsigned int i=0; i<7; ++i)
+                mean += samples[i];
+            mean /= 7.f;
+            for(unsigned int i=0; i<7; ++i)
+                flowVariation = glm::max(flowVariation, glm::length(samples[i] - mean));
+            vfl = Rinv * mean;
         }
-
-        GLfloat vmag2 = glm::length2(vt);
-        if(vmag2 > 1e-3f)
+        else
+            vfl = Rinv * ocn->GetFluidVelocity(t);
+        
+        glm::vec3 vr = vfl - vl;
+        if(model->isApplicable(vr, omegal, flowVariation))
         {
-            glm::vec3 skin = vt * sqrtf(vmag2) * A;
-
-            Fds += skin;
-            Tds += glm::cross(fc - p, skin);
+            model->ComputeDampingForces(vr, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+            //Shift torques from the reference point of the model to the CG
+            glm::vec3 d = model->getReferencePoint() - pl;
+            Tdl += glm::cross(d, Fdl);
+            Tdq += glm::cross(d, Fdq);
+            Tds += glm::cross(d, Fds);
+            reduced = true;
         }
     }
+    
+    if(!reduced && ocn->hasCurrents()) //Fluid velocity sampled at face centroids
+    {
+        static thread_local std::vector<GLfloat> fv;
+        size_t size = faces->getBufferSize();
+        fv.assign(3*size, 0.f);
+        
+        for(size_t i=0; i<faces->getNumOfFaces(); ++i)
+        {
+            glm::vec3 fc = R * faces->getCentroid(i) + t;
+            glm::vec3 vfl = Rinv * ocn->GetFluidVelocity(fc);
+            fv[i] = vfl.x;
+            fv[size + i] = vfl.y;
+            fv[2*size + i] = vfl.z;
+        }
+        
+        faces->ComputeDampingForces(pl, vl, omegal, glm::vec3(0.f), fv.data(), fv.data() + size, fv.data() + 2*size, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+    }
+    else if(!reduced) //Uniform fluid velocity
+    {
+        glm::vec3 vfl = Rinv * ocn->GetFluidVelocity(t);
+        faces->ComputeDampingForces(pl, vl, omegal, vfl, nullptr, nullptr, nullptr, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+    }
+    
+    //Back to the world frame
+    Fdl = R * Fdl;
+    Tdl = R * Tdl;
+    Fdq = R * Fdq;
+    Tdq = R * Tdq;
+    Fds = R * Fds;
+    Tds = R * Tds;
 
     _Fdl = Vector3(Fdl.x, Fdl.y, Fdl.z);
     _Tdl = Vector3(Tdl.x, Tdl.y, Tdl.z);
@@ -1611,7 +1632,7 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
     if(phy.mode != BodyPhysicsMode::FLOATING && phy.mode != BodyPhysicsMode::SUBMERGED) return;
     
 #ifdef DEBUG
-    submerged.points.clear();
+    submerged.clear();
 #endif
     
     BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
@@ -1645,12 +1666,13 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
         }
         
         if(settings.dampingForces)
-            ComputeHydrodynamicForcesSubmerged(getPhysicsMesh(), ocn, getCGTransform(), getCTransform(), v, omega, Fdl, Tdl, Fdq, Tdq, Fds, Tds);
+            ComputeHydrodynamicForcesSubmerged(getPhysicsFaces(), ocn, getCGTransform(), getCTransform(), v, omega, Fdl, Tdl, Fdq, Tdq, Fds, Tds,
+                                               settings.reducedOrderDamping ? getDragModel() : nullptr);
     }
     else //CROSSING_FLUID_SURFACE
     {
         if(!isBuoyant()) settings.reallisticBuoyancy = false;
-        ComputeHydrodynamicForcesSurface(settings, getPhysicsMesh(), ocn, getCGTransform(), getCTransform(), v, omega, Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds, submerged);
+        ComputeHydrodynamicForcesSurface(settings, getPhysicsFaces(), ocn, getCGTransform(), getCTransform(), v, omega, Fb, Tb, Fdl, Tdl, Fdq, Tdq, Fds, Tds, submerged);
     }
     
     if(settings.dampingForces)
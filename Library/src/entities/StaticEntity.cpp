@@ -56,7 +56,7 @@ EntityType StaticEntity::getType() const
     return EntityType::STATIC;
 }
 
-Material StaticEntity::getMaterial() const
+const Material& StaticEntity::getMaterial() const
 {
     return mat;
 }
@@ -98,25 +98,18 @@ void StaticEntity::setDisplayMode(DisplayMode m)
     dm = m;
 }
 
-std::vector<Renderable> StaticEntity::Render()
+void StaticEntity::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     if(rigidBody != NULL && phyObjectId >= 0 && isRenderable())
     {
         Transform trans;
         rigidBody->getMotionState()->getWorldTransform(trans);
         
-        Renderable item;
-        item.type = RenderableType::SOLID;
-        item.materialName = mat.name;
+        Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(trans));
+        item.materialId = mat.id;
         item.objectId = phyObjectId;
         item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
-        item.model = glMatrixFromTransform(trans);
-        items.push_back(item);
     }
-    
-    return items;
 }
 
 void StaticEntity::BuildGraphicalObject()
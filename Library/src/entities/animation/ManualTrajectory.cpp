@@ -56,12 +56,9 @@ void ManualTrajectory::Interpolate()
     return;
 }
 
-Renderable ManualTrajectory::Render()
+void ManualTrajectory::Render(RenderSnapshot& snapshot)
 {
-    Renderable frame;
-    frame.type = RenderableType::SENSOR_CS;
-    frame.model = glMatrixFromTransform(interpTrans);
-    return frame;
+    snapshot.Add(RenderableType::SENSOR_CS, glMatrixFromTransform(interpTrans));
 }
 
 }
\ No newline at end of file
@@ -69,9 +69,8 @@ Vector3 Jet::GetVelocityAtPoint(const Vector3& p) const
     return f*vmax;
 }
 
-std::vector<Renderable> Jet::Render(VelocityFieldUBO& ubo)
+void Jet::Render(VelocityFieldUBO& ubo, RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
     ubo.posR = glm::vec4((GLfloat)c.getX(), (GLfloat)c.getY(), (GLfloat)c.getZ(), (GLfloat)r);
     ubo.dirV = glm::vec4((GLfloat)n.getX(), (GLfloat)n.getY(), (GLfloat)n.getZ(), (GLfloat)vout);
     ubo.params = glm::vec3(0.f);
@@ -84,23 +83,19 @@ std::vector<Renderable> Jet::Render(VelocityFieldUBO& ubo)
     glm::mat4 model(glm::vec4(x_, 0.f), glm::vec4(y_, 0.f), glm::vec4(z_, 0.f), glm::vec4(c.x(), c.y(), c.z(), 1));    
     
     //Orifice
-    Renderable orifice;
-    orifice.type = RenderableType::HYDRO_LINE_STRIP;
-    orifice.model = model;
+    snapshot.Add(RenderableType::HYDRO_LINE_STRIP, model);
     
     for(unsigned int i=0; i<=12; ++i)
     {
         Scalar alpha = Scalar(i)/Scalar(12) * M_PI * Scalar(2);
         Vector3 v(btCos(alpha)*r, btSin(alpha)*r, 0);
-        orifice.points.push_back(glm::vec3(v.x(), v.y(), v.z()));
+        snapshot.AddPoint(glm::vec3(v.x(), v.y(), v.z()));
     }
     
     //Cone
-    Renderable cone;
-    cone.type = RenderableType::HYDRO_LINES;
-    cone.model = orifice.model;
-    cone.points.push_back(glm::vec3(0, 0, 0));
-    cone.points.push_back(glm::vec3(0, 0, vout));
+    snapshot.Add(RenderableType::HYDRO_LINES, model);
+    snapshot.AddPoint(glm::vec3(0, 0, 0));
+    snapshot.AddPoint(glm::vec3(0, 0, vout));
     
     Scalar r_ = Scalar(1)/Scalar(5)*(Scalar(10)*r + Scalar(5)*r);
     
@@ -109,15 +104,9 @@ std::vector<Renderable> Jet::Render(VelocityFieldUBO& ubo)
         Scalar alpha = Scalar(i)/Scalar(12) * M_PI * Scalar(2);
         Vector3 v1(btCos(alpha)*r, btSin(alpha)*r, 0);
         Vector3 v2(v1.x()*r_/r, v1.y()*r_/r, Scalar(10)*r);
-        cone.points.push_back(glm::vec3(v1.x(), v1.y(), v1.z()));
-        cone.points.push_back(glm::vec3(v2.x(), v2.y(), v2.z()));
+        snapshot.AddPoint(glm::vec3(v1.x(), v1.y(), v1.z()));
+        snapshot.AddPoint(glm::vec3(v2.x(), v2.y(), v2.z()));
     }
-    
-    //Build
-    items.push_back(orifice);
-    items.push_back(cone);
-
-    return items;
 }
 
 }
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include "utils/SystemUtil.hpp"
 #include "entities/forcefields/VelocityField.h"
+#include "entities/forcefields/OceanWaves.h"
 #include "entities/SolidEntity.h"
 #include "graphics/OpenGLFlatOcean.h"
 #include "graphics/OpenGLRealOcean.h"
@@ -51,12 +52,12 @@ Ocean::Ocean(std::string uniqueName, Scalar waves, Fluid l) : ForcefieldEntity(u
     
     currents = std::vector<VelocityField*>(0);
     currentsEnabled = false;
+    reducedOrderDamping = false;
     
     liquid = l;
-    wavesDebug.type = RenderableType::HYDRO_POINTS;
-    wavesDebug.model = glm::mat4(1.f);
     waterType = Scalar(0.0);
     glOcean = NULL;
+    cpuWaves = nullptr;
 }
 
 Ocean::~Ocean()
@@ -70,6 +71,9 @@ Ocean::~Ocean()
     
     if(glOcean != NULL)
         delete glOcean;
+    
+    if(cpuWaves != nullptr)
+        delete cpuWaves;
 }
 
 bool Ocean::hasWaves() const
@@ -87,6 +91,11 @@ OpenGLOcean* Ocean::getOpenGLOcean()
     return glOcean;
 }
 
+OceanWaves* Ocean::getOceanWaves()
+{
+    return cpuWaves;
+}
+
 ForcefieldType Ocean::getForcefieldType()
 {
     return ForcefieldType::OCEAN;
@@ -126,12 +135,12 @@ bool Ocean::IsInsideFluid(const Vector3& point)
 
 float Ocean::GetDepth(const glm::vec3& point)
 {
-    if(hasWaves()) //Geometric waves
+    if(hasWaves() && (cpuWaves != nullptr || glOcean != NULL)) //Geometric waves
     {
-        GLfloat waveHeight = glOcean->ComputeWaveHeight(point.x, point.y);
+        GLfloat waveHeight = cpuWaves != nullptr ? cpuWaves->ComputeWaveHeight(point.x, point.y) : glOcean->ComputeWaveHeight(point.x, point.y);
         glm::vec3 wavePoint(point.x, point.y, waveHeight);
 #ifdef DEBUG_HYDRO
-        wavesDebug.points.push_back(wavePoint);
+        wavesDebug.push_back(wavePoint);
 #endif
         return point.z - waveHeight;
     }
@@ -139,12 +148,41 @@ float Ocean::GetDepth(const glm::vec3& point)
     {
         glm::vec3 wavePoint(point.x, point.y, 0.f);
 #ifdef DEBUG_HYDRO  
-        wavesDebug.points.push_back(wavePoint);
+        wavesDebug.push_back(wavePoint);
 #endif
         return point.z;
     }
 }
 
+void Ocean::GetDepths(const glm::vec3* points, GLfloat* depths, size_t n)
+{
+    if(hasWaves() && (cpuWaves != nullptr || glOcean != NULL)) //Geometric waves
+    {
+        if(cpuWaves != nullptr)
+            cpuWaves->ComputeWaveHeights(points, depths, n);
+        else
+            glOcean->ComputeWaveHeights(points, depths, n);
+        
+        for(size_t i=0; i<n; ++i)
+        {
+#ifdef DEBUG_HYDRO
+            wavesDebug.push_back(glm::vec3(points[i].x, points[i].y, depths[i]));
+#endif
+            depths[i] = points[i].z - depths[i];
+        }
+    }
+    else //Flat surface
+    {
+        for(size_t i=0; i<n; ++i)
+        {
+#ifdef DEBUG_HYDRO
+            wavesDebug.push_back(glm::vec3(points[i].x, points[i].y, 0.f));
+#endif
+            depths[i] = points[i].z;
+        }
+    }
+}
+
 Scalar Ocean::GetDepth(const Vector3& point)
 {
     return Scalar(GetDepth(glm::vec3((GLfloat)point.getX(), (GLfloat)point.getY(), (GLfloat)point.getZ())));
@@ -178,6 +216,17 @@ glm::vec3 Ocean::GetFluidVelocity(const glm::vec3& point) const
     return glVectorFromVector(GetFluidVelocity(Vector3(point.x, point.y, point.z)));
 }
 
+bool Ocean::hasCurrents() const
+{
+    if(currentsEnabled)
+    {
+        for(size_t i=0; i<currents.size(); ++i)
+            if(currents[i]->isEnabled())
+                return true;
+    }
+    return false;
+}
+
 void Ocean::EnableCurrents()
 {
     currentsEnabled = true;
@@ -188,6 +237,16 @@ void Ocean::DisableCurrents()
     currentsEnabled = false;
 }
 
+void Ocean::setReducedOrderDamping(bool enabled)
+{
+    reducedOrderDamping = enabled;
+}
+
+bool Ocean::isReducedOrderDamping() const
+{
+    return reducedOrderDamping;
+}
+
 void Ocean::UpdateCurrentsData()
 {
     if(glOcean != NULL)
@@ -195,6 +254,18 @@ void Ocean::UpdateCurrentsData()
 }
 
 void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute)
+{
+    SolidEntity* solid = getFluidForcesBody(co);
+    if(solid == nullptr)
+        return;
+    
+    if(recompute)
+        ComputeFluidForces(solid);
+    
+    solid->ApplyHydrodynamicForces();
+}
+
+SolidEntity* Ocean::getFluidForcesBody(btCollisionObject* co) const
 {
     Entity* ent;
     btRigidBody* rb = btRigidBody::upcast(co);
@@ -203,33 +274,33 @@ void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool
     if(rb != 0)
     {
         if(rb->isStaticOrKinematicObject())
-            return;
+            return nullptr;
         else
             ent = (Entity*)rb->getUserPointer();
     }
     else if(mbl != 0)
     {
         if(mbl->isStaticOrKinematicObject())
-            return;
+            return nullptr;
         else
             ent = (Entity*)mbl->getUserPointer();
     }
     else
-        return;
-    
-    HydrodynamicsSettings settings;
+        return nullptr;
     
     if(ent->getType() == EntityType::SOLID)
-    {
-        if(recompute)
-        {
-            settings.dampingForces = true;
-            settings.reallisticBuoyancy = true;
-            ((SolidEntity*)ent)->ComputeHydrodynamicForces(settings, this);
-        }
-        
-        ((SolidEntity*)ent)->ApplyHydrodynamicForces();
-    }
+        return (SolidEntity*)ent;
+    else
+        return nullptr;
+}
+
+void Ocean::ComputeFluidForces(SolidEntity* solid)
+{
+    HydrodynamicsSettings settings;
+    settings.dampingForces = true;
+    settings.reallisticBuoyancy = true;
+    settings.reducedOrderDamping = reducedOrderDamping;
+    solid->ComputeHydrodynamicForces(settings, this);
 }
 
 void Ocean::InitGraphics(SDL_mutex* hydrodynamics)
@@ -241,16 +312,29 @@ void Ocean::InitGraphics(SDL_mutex* hydrodynamics)
     setWaterType(0.2);
 }
 
-std::vector<Renderable> Ocean::Render()
+void Ocean::InitWaves()
+{
+    if(!hasWaves() || cpuWaves != nullptr)
+        return;
+    
+    cpuWaves = new OceanWaves((GLfloat)oceanState);
+    cpuWaves->Update(0.f);
+}
+
+void Ocean::UpdateWaves(Scalar time)
+{
+    if(cpuWaves != nullptr)
+        cpuWaves->Update((GLfloat)time);
+}
+
+void Ocean::Render(RenderSnapshot& snapshot)
 {
     std::vector<Actuator*> act;
-    return Render(act);
+    Render(act, snapshot);
 }
 
-std::vector<Renderable> Ocean::Render(const std::vector<Actuator*>& act)
+void Ocean::Render(const std::vector<Actuator*>& act, RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     //Update currents data
     glOceanCurrentsUBOData.gravity = glm::vec3(0.f,0.f,9.81f);
     glOceanCurrentsUBOData.numCurrents = 0;
@@ -260,8 +344,7 @@ std::vector<Renderable> Ocean::Render(const std::vector<Actuator*>& act)
         for(size_t i=0; i<currents.size(); ++i)
             if(currents[i]->isEnabled())
             {
-                std::vector<Renderable> citems = currents[i]->Render(glOceanCurrentsUBOData.currents[glOceanCurrentsUBOData.numCurrents]);
-                items.insert(items.end(), citems.begin(), citems.end());
+                currents[i]->Render(glOceanCurrentsUBOData.currents[glOceanCurrentsUBOData.numCurrents], snapshot);
                 ++glOceanCurrentsUBOData.numCurrents;
             }
     }
@@ -287,13 +370,12 @@ std::vector<Renderable> Ocean::Render(const std::vector<Actuator*>& act)
             ++glOceanCurrentsUBOData.numCurrents;
         }
 
-    if(wavesDebug.points.size() > 0)
+    if(wavesDebug.size() > 0)
     {
-        items.push_back(wavesDebug);
-        wavesDebug.points.clear();
+        snapshot.Add(RenderableType::HYDRO_POINTS);
+        snapshot.AddPoints(wavesDebug);
+        wavesDebug.clear();
     }
-
-    return items;
 }
 
 }
@@ -0,0 +1,533 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OceanWaves.cpp
+//  Stonefish
+//
+
+/*
+    Spectrum based on "Real-time Animation and Rendering of Ocean Whitecaps"
+    by Jonathan Dupuy and Eric Bruneton.
+    https://github.com/jdupuy/whitecaps
+*/
+
+#include "entities/forcefields/OceanWaves.h"
+
+#include "core/SimulationApp.h"
+#include "core/SimulationManager.h"
+#include "core/ThreadPool.h"
+#include "utils/SystemUtil.hpp"
+
+//Number of rows/columns of the wave grid processed by a single task
+#define OCEAN_WAVES_BLOCK 16
+//Number of points processed together when sampling wave heights
+#define OCEAN_WAVES_SAMPLE_BLOCK 64
+
+namespace sf
+{
+
+OceanWaves::OceanWaves(GLfloat state)
+{
+    //Same parameters as in the OpenGL implementation
+    params.passes = 8;
+    params.slopeVarianceSize = 4;
+    params.fftSize = 1 << params.passes;
+    params.propagate = true;
+    params.km = 370.f;
+    params.cm = 0.23f;
+    params.t = 0.f;
+    params.gridSizes = glm::vec4(893.f, 101.f, 21.f, 11.f);
+    params.spectrum12 = NULL;
+    params.spectrum34 = NULL;
+    params.wind = state*5.f + 2.f;
+    params.A = 1.f;
+    params.omega = 5.f*expf(-state) + 0.2f;
+
+    size_t N = (size_t)params.fftSize;
+
+    //Generate spectrum
+    std::vector<GLfloat> spectrum12(N * N * 4);
+    std::vector<GLfloat> spectrum34(N * N * 4);
+    GenerateSpectrum(params, spectrum12.data(), spectrum34.data());
+
+    //Precompute time independent part of h(k,t)
+    for(unsigned int g = 0; g < 4; ++g)
+    {
+        h0[g].resize(N * N);
+        omegaK[g].resize(N * N);
+        const GLfloat* spectrum = g < 2 ? spectrum12.data() + 2 * g : spectrum34.data() + 2 * (g - 2);
+        GLfloat invGridSize = 2.f * M_PI / params.gridSizes[g];
+
+        for(size_t y = 0; y < N; ++y)
+        {
+            for(size_t x = 0; x < N; ++x)
+            {
+                size_t xc = (N - x) % N; //Index of -k
+                size_t yc = (N - y) % N;
+                const GLfloat* s0 = spectrum + 4 * (x + y * N);
+                const GLfloat* s0c = spectrum + 4 * (xc + yc * N);
+                h0[g][x + y * N] = glm::vec4(s0[0] + s0c[0], s0[1] + s0c[1], s0[0] - s0c[0], s0[1] - s0c[1]) * 1.414213562f;
+
+                GLfloat kx = (x >= N / 2 ? (GLfloat)x - (GLfloat)N : (GLfloat)x) * invGridSize;
+                GLfloat ky = (y >= N / 2 ? (GLfloat)y - (GLfloat)N : (GLfloat)y) * invGridSize;
+                omegaK[g][x + y * N] = Omega(params, sqrtf(kx * kx + ky * ky));
+            }
+        }
+    }
+
+    //FFT tables
+    twRe.resize(N / 2);
+    twIm.resize(N / 2);
+    for(size_t k = 0; k < N / 2; ++k)
+    {
+        twRe[k] = (GLfloat)cos(2.0 * M_PI * (double)k / (double)N);
+        twIm[k] = (GLfloat)sin(2.0 * M_PI * (double)k / (double)N);
+    }
+
+    bitRev.resize(N);
+    for(size_t i = 0; i < N; ++i)
+    {
+        unsigned int r = 0;
+        for(unsigned int b = 0; b < params.passes; ++b)
+            r |= ((i >> b) & 1) << (params.passes - 1 - b);
+        bitRev[i] = r;
+    }
+
+    for(unsigned int i = 0; i < 2; ++i)
+    {
+        hRe[i].resize(N * N);
+        hIm[i].resize(N * N);
+    }
+    waveData.resize(N * N * 4, 0.f);
+}
+
+GLfloat OceanWaves::getTime() const
+{
+    return params.t;
+}
+
+const OceanParams& OceanWaves::getParams() const
+{
+    return params;
+}
+
+const GLfloat* OceanWaves::getWaveData() const
+{
+    return waveData.data();
+}
+
+void OceanWaves::Update(GLfloat time)
+{
+    params.t = time;
+
+    size_t N = (size_t)params.fftSize;
+    size_t block = N < OCEAN_WAVES_BLOCK ? N : OCEAN_WAVES_BLOCK;
+    size_t nBlocks = N / block;
+
+    ThreadPool* pool = SimulationApp::getApp() != nullptr ? SimulationApp::getApp()->getSimulationManager()->getThreadPool() : nullptr;
+
+    //Rows are independent -> h(k,t) and the FFT along x are computed together
+    auto rowTask = [this, block](size_t i)
+    {
+        InitializeRows(i * block, (i + 1) * block);
+        TransformRows(i * block, (i + 1) * block);
+    };
+    //Columns are independent -> FFT along y is computed on blocks of neighbouring columns
+    auto columnTask = [this, block](size_t i)
+    {
+        TransformColumns(i * block, (i + 1) * block);
+    };
+
+    if(pool != nullptr)
+    {
+        pool->ParallelFor(nBlocks, rowTask);
+        pool->ParallelFor(nBlocks, columnTask);
+    }
+    else
+    {
+        for(size_t i = 0; i < nBlocks; ++i)
+            rowTask(i);
+        for(size_t i = 0; i < nBlocks; ++i)
+            columnTask(i);
+    }
+}
+
+void OceanWaves::InitializeRows(size_t row0, size_t row1)
+{
+    size_t N = (size_t)params.fftSize;
+    GLfloat hr[4];
+    GLfloat hi[4];
+
+    for(size_t id = row0 * N; id < row1 * N; ++id)
+    {
+        //h(k,t) for 4 grids
+        for(unsigned int g = 0; g < 4; ++g)
+        {
+            const glm::vec4& s = h0[g][id];
+            GLfloat wt = omegaK[g][id] * params.t;
+            GLfloat c = cosf(wt);
+            GLfloat sn = sinf(wt);
+            hr[g] = s.x * c - s.y * sn;
+            hi[g] = s.z * sn + s.w * c;
+        }
+
+        //Two grids packed in a single complex transform (results are real)
+        hRe[0][id] = hr[0] - hi[1];
+        hIm[0][id] = hi[0] + hr[1];
+        hRe[1][id] = hr[2] - hi[3];
+        hIm[1][id] = hi[2] + hr[3];
+    }
+}
+
+void OceanWaves::TransformRows(size_t row0, size_t row1)
+{
+    size_t N = (size_t)params.fftSize;
+
+    for(unsigned int i = 0; i < 2; ++i)
+    {
+        for(size_t r = row0; r < row1; ++r)
+        {
+            GLfloat* re = hRe[i].data() + r * N;
+            GLfloat* im = hIm[i].data() + r * N;
+
+            for(size_t j = 0; j < N; ++j)
+            {
+                size_t jr = bitRev[j];
+                if(jr > j)
+                {
+                    std::swap(re[j], re[jr]);
+                    std::swap(im[j], im[jr]);
+                }
+            }
+
+            for(size_t size = 2; size <= N; size *= 2)
+            {
+                size_t half = size / 2;
+                size_t step = N / size;
+                for(size_t start = 0; start < N; start += size)
+                {
+                    for(size_t k = 0; k < half; ++k)
+                    {
+                        GLfloat wr = twRe[k * step];
+                        GLfloat wi = twIm[k * step];
+                        size_t a = start + k;
+                        size_t b = a + half;
+                        GLfloat tr = wr * re[b] - wi * im[b];
+                        GLfloat ti = wr * im[b] + wi * re[b];
+                        re[b] = re[a] - tr;
+                        im[b] = im[a] - ti;
+                        re[a] += tr;
+                        im[a] += ti;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void OceanWaves::TransformColumns(size_t col0, size_t col1)
+{
+    size_t N = (size_t)params.fftSize;
+
+    for(unsigned int i = 0; i < 2; ++i)
+    {
+        GLfloat* re = hRe[i].data();
+        GLfloat* im = hIm[i].data();
+
+        for(size_t j = 0; j < N; ++j)
+        {
+            size_t jr = bitRev[j];
+            if(jr > j)
+            {
+                for(size_t c = col0; c < col1; ++c)
+                {
+                    std::swap(re[j * N + c], re[jr * N + c]);
+                    std::swap(im[j * N + c], im[jr * N + c]);
+                }
+            }
+        }
+
+        //Butterflies applied to contiguous spans of columns (vectorizable inner loop)
+        for(size_t size = 2; size <= N; size *= 2)
+        {
+            size_t half = size / 2;
+            size_t step = N / size;
+            for(size_t start = 0; start < N; start += size)
+            {
+                for(size_t k = 0; k < half; ++k)
+                {
+                    GLfloat wr = twRe[k * step];
+                    GLfloat wi = twIm[k * step];
+                    GLfloat* __restrict aRe = re + (start + k) * N;
+                    GLfloat* __restrict aIm = im + (start + k) * N;
+                    GLfloat* __restrict bRe = re + (start + k + half) * N;
+                    GLfloat* __restrict bIm = im + (start + k + half) * N;
+
+                    for(size_t c = col0; c < col1; ++c)
+                    {
+                        GLfloat tr = wr * bRe[c] - wi * bIm[c];
+                        GLfloat ti = wr * bIm[c] + wi * bRe[c];
+                        bRe[c] = aRe[c] - tr;
+                        bIm[c] = aIm[c] - ti;
+                        aRe[c] += tr;
+                        aIm[c] += ti;
+                    }
+                }
+            }
+        }
+
+        //Store in the layout of the GPU data (RGBA = grids 1,2,3,4)
+        for(size_t r = 0; r < N; ++r)
+            for(size_t c = col0; c < col1; ++c)
+            {
+                waveData[(r * N + c) * 4 + 2 * i] = re[r * N + c];
+                waveData[(r * N + c) * 4 + 2 * i + 1] = im[r * N + c];
+            }
+    }
+}
+
+GLfloat OceanWaves::ComputeWaveHeight(GLfloat x, GLfloat y) const
+{
+    //Only the two largest grids are used, as in the OpenGL implementation
+    GLfloat z = 0.f;
+    z -= InterpolateWaveData(waveData.data(), params.fftSize, x/params.gridSizes.x, y/params.gridSizes.x, 0);
+    z -= InterpolateWaveData(waveData.data(), params.fftSize, x/params.gridSizes.y, y/params.gridSizes.y, 1);
+    return z;
+}
+
+void OceanWaves::ComputeWaveHeights(const glm::vec3* points, GLfloat* heights, size_t n) const
+{
+    SampleWaveHeights(waveData.data(), params, points, heights, n);
+}
+
+void OceanWaves::SampleWaveHeights(const GLfloat* data, const OceanParams& params, const glm::vec3* points, GLfloat* heights, size_t n)
+{
+    //Same bilinear interpolation as in InterpolateWaveData, with the texel coordinates
+    //of both grids computed for a block of points at once (vectorizable)
+    const int N = params.fftSize;
+    const int mask = N - 1; //fftSize is a power of 2
+    const GLfloat scale0 = (GLfloat)N/params.gridSizes.x;
+    const GLfloat scale1 = (GLfloat)N/params.gridSizes.y;
+    GLfloat u0[OCEAN_WAVES_SAMPLE_BLOCK], v0[OCEAN_WAVES_SAMPLE_BLOCK];
+    GLfloat u1[OCEAN_WAVES_SAMPLE_BLOCK], v1[OCEAN_WAVES_SAMPLE_BLOCK];
+    GLfloat fu0[OCEAN_WAVES_SAMPLE_BLOCK], fv0[OCEAN_WAVES_SAMPLE_BLOCK];
+    GLfloat fu1[OCEAN_WAVES_SAMPLE_BLOCK], fv1[OCEAN_WAVES_SAMPLE_BLOCK];
+
+    for(size_t b = 0; b < n; b += OCEAN_WAVES_SAMPLE_BLOCK)
+    {
+        size_t m = std::min((size_t)OCEAN_WAVES_SAMPLE_BLOCK, n - b);
+        const glm::vec3* pts = points + b;
+
+        //Texel coordinates and interpolation weights
+        for(size_t i = 0; i < m; ++i)
+        {
+            u0[i] = pts[i].x * scale0 - 0.5f;
+            v0[i] = pts[i].y * scale0 - 0.5f;
+            u1[i] = pts[i].x * scale1 - 0.5f;
+            v1[i] = pts[i].y * scale1 - 0.5f;
+            fu0[i] = floorf(u0[i]);
+            fv0[i] = floorf(v0[i]);
+            fu1[i] = floorf(u1[i]);
+            fv1[i] = floorf(v1[i]);
+            u0[i] -= fu0[i];
+            v0[i] -= fv0[i];
+            u1[i] -= fu1[i];
+            v1[i] -= fv1[i];
+        }
+
+        //Texel fetch and interpolation (Z axis of the wave data pointing up)
+        for(size_t i = 0; i < m; ++i)
+        {
+            int i0 = (int)fu0[i] & mask;
+            int j0 = (int)fv0[i] & mask;
+            int i1 = (i0 + 1) & mask;
+            int j1 = (j0 + 1) & mask;
+            GLfloat h0 = (1.f - u0[i]) * (1.f - v0[i]) * data[(j0 * N + i0) * 4]
+                         + u0[i] * (1.f - v0[i]) * data[(j0 * N + i1) * 4]
+                         + (1.f - u0[i]) * v0[i] * data[(j1 * N + i0) * 4]
+                         + u0[i] * v0[i] * data[(j1 * N + i1) * 4];
+
+            i0 = (int)fu1[i] & mask;
+            j0 = (int)fv1[i] & mask;
+            i1 = (i0 + 1) & mask;
+            j1 = (j0 + 1) & mask;
+            GLfloat h1 = (1.f - u1[i]) * (1.f - v1[i]) * data[(j0 * N + i0) * 4 + 1]
+                         + u1[i] * (1.f - v1[i]) * data[(j0 * N + i1) * 4 + 1]
+                         + (1.f - u1[i]) * v1[i] * data[(j1 * N + i0) * 4 + 1]
+                         + u1[i] * v1[i] * data[(j1 * N + i1) * 4 + 1];
+
+            heights[b + i] = -h0 - h1;
+        }
+    }
+}
+
+GLfloat OceanWaves::InterpolateWaveData(const GLfloat* data, int fftSize, GLfloat x, GLfloat y, GLuint channel)
+{
+    //BILINEAR INTERPOLATION ACCORDING TO OPENGL SPECIFICATION (4.5)
+    //Calculate pixel cooridnates
+    //x and y are already divided by the phyiscal dimensions of the texture (represented area in [m])
+    //so they are directly texture coordinates
+    float tmp;
+
+    //First coordinate pair
+    float i0f = modff(x - 0.5f/(float)fftSize, &tmp);
+    float j0f = modff(y - 0.5f/(float)fftSize, &tmp);
+    if(i0f < 0.f) i0f = 1.f - fabsf(i0f);
+    if(j0f < 0.f) j0f = 1.f - fabsf(j0f);
+    int i0 = (int)truncf(i0f * (float)fftSize);
+    int j0 = (int)truncf(j0f * (float)fftSize);
+
+    //Second coordinate pair
+    float i1f = modff(x + 0.5f/(float)fftSize, &tmp);
+    float j1f = modff(y + 0.5f/(float)fftSize, &tmp);
+    if(i1f < 0.f) i1f = 1.f - fabsf(i1f);
+    if(j1f < 0.f) j1f = 1.f - fabsf(j1f);
+    int i1 = (int)truncf(i1f * (float)fftSize);
+    int j1 = (int)truncf(j1f * (float)fftSize);
+
+    //Calculate weigths
+    float alpha = modff(i0f * (float)fftSize, &tmp);
+    float beta = modff(j0f * (float)fftSize, &tmp);
+
+    //Get texel values
+    float t[4];
+    t[0] = data[(j0 * fftSize + i0) * 4 + channel];
+    t[1] = data[(j0 * fftSize + i1) * 4 + channel];
+    t[2] = data[(j1 * fftSize + i0) * 4 + channel];
+    t[3] = data[(j1 * fftSize + i1) * 4 + channel];
+
+    //Interpolate
+    float h = (1.f - alpha)*(1.f - beta)*t[0] + alpha*(1.f - beta)*t[1] + (1.f - alpha)*beta*t[2] + alpha*beta*t[3];
+
+    return h;
+}
+
+//Wave generation
+static inline float sqr(float x)
+{
+    return x * x;
+}
+
+GLfloat OceanWaves::Omega(const OceanParams& params, GLfloat k)
+{
+    return sqrt(9.81 * k * (1.0 + sqr(k / params.km))); // Eq 24
+}
+
+// 1/kx and 1/ky in meters
+GLfloat OceanWaves::Spectrum(const OceanParams& params, GLfloat kx, GLfloat ky, bool omnispectrum)
+{
+    float U10 = params.wind;
+    float Omega = params.omega;
+
+    // phase speed
+    float k = sqrt(kx * kx + ky * ky);
+    float c = OceanWaves::Omega(params, k) / k;
+
+    // spectral peak
+    float kp = 9.81 * sqr(Omega / U10); // after Eq 3
+    float cp = OceanWaves::Omega(params, kp) / kp;
+
+    // friction velocity
+    float z0 = 3.7e-5 * sqr(U10) / 9.81 * pow(U10 / cp, 0.9f); // Eq 66
+    float u_star = 0.41 * U10 / log(10.0 / z0); // Eq 60
+
+    float Lpm = exp(- 5.0 / 4.0 * sqr(kp / k)); // after Eq 3
+    float gamma = Omega < 1.0 ? 1.7 : 1.7 + 6.0 * log(Omega); // after Eq 3 // log10 or log??
+    float sigma = 0.08 * (1.0 + 4.0 / pow(Omega, 3.0f)); // after Eq 3
+    float Gamma = exp(-1.0 / (2.0 * sqr(sigma)) * sqr(sqrt(k / kp) - 1.0));
+    float Jp = pow(gamma, Gamma); // Eq 3
+    float Fp = Lpm * Jp * exp(- Omega / sqrt(10.0) * (sqrt(k / kp) - 1.0)); // Eq 32
+    float alphap = 0.006 * sqrt(Omega); // Eq 34
+    float Bl = 0.5 * alphap * cp / c * Fp; // Eq 31
+
+    float alpham = 0.01 * (u_star < params.cm ? 1.0 + log(u_star / params.cm) : 1.0 + 3.0 * log(u_star / params.cm)); // Eq 44
+    float Fm = exp(-0.25 * sqr(k / params.km - 1.0)); // Eq 41
+    float Bh = 0.5 * alpham * params.cm / c * Fm; // Eq 40
+
+    Bh *= Lpm;
+
+    if (omnispectrum)
+    {
+        return params.A * (Bl + Bh) / (k * sqr(k)); // Eq 30
+    }
+
+    float a0 = log(2.0) / 4.0;
+    float ap = 4.0;
+    float am = 0.13 * u_star / params.cm; // Eq 59
+    float Delta = tanh(a0 + ap * pow(c / cp, 2.5f) + am * pow(params.cm / c, 2.5f)); // Eq 57
+
+    float phi = atan2(ky, kx);
+
+    if(params.propagate)
+    {
+        if (kx < 0.0)
+        {
+            return 0.0;
+        }
+        else
+        {
+            Bl *= 2.0;
+            Bh *= 2.0;
+        }
+    }
+
+    return params.A * (Bl + Bh) * (1.0 + Delta * cos(2.0 * phi)) / (2.0 * M_PI * sqr(sqr(k))); // Eq 67
+}
+
+// generates the waves spectrum
+void OceanWaves::GenerateSpectrum(const OceanParams& params, GLfloat* spectrum12, GLfloat* spectrum34)
+{
+    //Seed restarted for each generation, to obtain the same waves in all implementations
+    long seed = 1234;
+
+    auto sample = [&params, &seed](int i, int j, float lengthScale, float kMin, float *result)
+    {
+        float dk = 2.0 * M_PI / lengthScale;
+        float kx = i * dk;
+        float ky = j * dk;
+        if(fabsf(kx) < kMin && fabsf(ky) < kMin)
+        {
+            result[0] = 0.0;
+            result[1] = 0.0;
+        }
+        else
+        {
+            float S = Spectrum(params, kx, ky);
+            float h = sqrtf(S / 2.0) * dk;
+            float phi = frandom(&seed) * 2.0 * M_PI;
+            result[0] = h * cos(phi);
+            result[1] = h * sin(phi);
+        }
+    };
+
+    for (int y = 0; y < params.fftSize; ++y)
+    {
+        for (int x = 0; x < params.fftSize; ++x)
+        {
+            int offset = 4 * (x + y * params.fftSize);
+            int i = x >= params.fftSize / 2 ? x - params.fftSize : x;
+            int j = y >= params.fftSize / 2 ? y - params.fftSize : y;
+            sample(i, j, params.gridSizes[0], M_PI / params.gridSizes[0], spectrum12 + offset);
+            sample(i, j, params.gridSizes[1], M_PI * params.fftSize / params.gridSizes[0], spectrum12 + offset + 2);
+            sample(i, j, params.gridSizes[2], M_PI * params.fftSize / params.gridSizes[1], spectrum34 + offset);
+            sample(i, j, params.gridSizes[3], M_PI * params.fftSize / params.gridSizes[2], spectrum34 + offset + 2);
+        }
+    }
+}
+
+}
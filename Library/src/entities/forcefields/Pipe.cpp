@@ -67,9 +67,8 @@ Vector3 Pipe::GetVelocityAtPoint(const Vector3& p) const
     return f*v;
 }
 
-std::vector<Renderable> Pipe::Render(VelocityFieldUBO& ubo)
+void Pipe::Render(VelocityFieldUBO& ubo, RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
     ubo.posR = glm::vec4((GLfloat)p1.getX(), (GLfloat)p1.getY(), (GLfloat)p1.getZ(), (GLfloat)r1);
     ubo.dirV = glm::vec4((GLfloat)n.getX(), (GLfloat)n.getY(), (GLfloat)n.getZ(), (GLfloat)vin);
     ubo.params = glm::vec3((GLfloat)l, (GLfloat)r2, (GLfloat)gamma);
@@ -82,39 +81,39 @@ std::vector<Renderable> Pipe::Render(VelocityFieldUBO& ubo)
     glm::mat4 model(glm::vec4(x_, 0.f), glm::vec4(y_, 0.f), glm::vec4(z_, 0.f), glm::vec4(p1.x(), p1.y(), p1.z(), 1));    
     
     //Inlet and outlet
-    Renderable inlet;
-    inlet.type = RenderableType::HYDRO_LINE_STRIP;
-    inlet.model = model;
-    
-    Renderable outlet;
-    outlet.type = RenderableType::HYDRO_LINE_STRIP;
-    outlet.model = model;
-
-    //Pipe
-    Renderable pipe;
-    pipe.type = RenderableType::HYDRO_LINES;
-    pipe.model = model;
-    pipe.points.push_back(glm::vec3(0, 0, 0));
-    pipe.points.push_back(glm::vec3(0, 0, l));
+    glm::vec3 inlet[13];
+    glm::vec3 outlet[13];
     
     for(unsigned int i=0; i<12; ++i)
     {
         Scalar alpha = Scalar(i)/Scalar(12) * M_PI * Scalar(2);
         Vector3 v1(btCos(alpha)*r1, btSin(alpha)*r1, 0);
         Vector3 v2(v1.x()*r2/r1, v1.y()*r2/r1, l);
-        pipe.points.push_back(glm::vec3(v1.x(), v1.y(), v1.z()));
-        inlet.points.push_back(pipe.points.back());
-        pipe.points.push_back(glm::vec3(v2.x(), v2.y(), v2.z()));
-        outlet.points.push_back(pipe.points.back());
+        inlet[i] = glm::vec3(v1.x(), v1.y(), v1.z());
+        outlet[i] = glm::vec3(v2.x(), v2.y(), v2.z());
     }
     
-    inlet.points.push_back(inlet.points.front());
-    outlet.points.push_back(outlet.points.front());
+    inlet[12] = inlet[0];
+    outlet[12] = outlet[0];
+    
+    snapshot.Add(RenderableType::HYDRO_LINE_STRIP, model);
+    for(unsigned int i=0; i<13; ++i)
+        snapshot.AddPoint(inlet[i]);
+    
+    snapshot.Add(RenderableType::HYDRO_LINE_STRIP, model);
+    for(unsigned int i=0; i<13; ++i)
+        snapshot.AddPoint(outlet[i]);
+
+    //Pipe
+    snapshot.Add(RenderableType::HYDRO_LINES, model);
+    snapshot.AddPoint(glm::vec3(0, 0, 0));
+    snapshot.AddPoint(glm::vec3(0, 0, l));
     
-    items.push_back(inlet);
-    items.push_back(outlet);
-    items.push_back(pipe);
-    return items;
+    for(unsigned int i=0; i<12; ++i)
+    {
+        snapshot.AddPoint(inlet[i]);
+        snapshot.AddPoint(outlet[i]);
+    }
 }
 
 }
@@ -154,22 +154,15 @@ bool Trigger::isActive()
     return active;
 }
 
-std::vector<Renderable> Trigger::Render()
+void Trigger::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     if(objectId >= 0 && isRenderable())
     {
         Transform trans = ghost->getWorldTransform();
-        Renderable item;
-        item.type = RenderableType::SOLID;
+        Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(trans));
         item.objectId = objectId;
         item.lookId = lookId;
-        item.model = glMatrixFromTransform(trans);
-        items.push_back(item);
     }
-    
-    return items;
 }
 
 }
@@ -72,12 +72,12 @@ Vector3 Compound::getAugmentedInertia() const
     return Ipri;
 }
     
-Material Compound::getMaterial(size_t partId) const
+const Material& Compound::getMaterial(size_t partId) const
 {
     if(partId < parts.size())
         return parts[partId].solid->getMaterial();
     else
-        return Material();
+        return mat;
 }
 
 size_t Compound::getPartId(size_t collisionShapeId) const
@@ -260,8 +260,21 @@ btCollisionShape* Compound::BuildCollisionShape()
         {
             Transform childTrans = parts[i].origin * parts[i].solid->getCG2OTransform().inverse() * parts[i].solid->getCG2CTransform();
             btCollisionShape* partColShape = parts[i].solid->BuildCollisionShape();
-            colShape->addChildShape(childTrans, partColShape);
-            collisionPartId.push_back(i);
+            if(partColShape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) //Decomposed parts are flattened to keep the child-to-part mapping
+            {
+                btCompoundShape* partCompound = (btCompoundShape*)partColShape;
+                for(int h=0; h<partCompound->getNumChildShapes(); ++h)
+                {
+                    colShape->addChildShape(childTrans * partCompound->getChildTransform(h), partCompound->getChildShape(h));
+                    collisionPartId.push_back(i);
+                }
+                delete partCompound;
+            }
+            else
+            {
+                colShape->addChildShape(childTrans, partColShape);
+                collisionPartId.push_back(i);
+            }
         }
     }
     return colShape;
@@ -273,7 +286,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
     
     BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
     
-    submerged.points.clear();
+    submerged.clear();
     
     //If completely outside fluid just set all torques and forces to 0
     if(bf == BodyFluidPosition::OUTSIDE)
@@ -324,7 +337,8 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
                 if(parts[i].isExternal) //Compute drag only for external parts
                 {
                     Transform T_C_part = getOTransform() * parts[i].origin * parts[i].solid->getO2CTransform();
-                    ComputeHydrodynamicForcesSubmerged(parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
+                    ComputeHydrodynamicForcesSubmerged(parts[i].solid->getPhysicsFaces(), ocn, getCGTransform(), T_C_part, v, omega, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp,
+                                                       settings.reducedOrderDamping ? parts[i].solid->getDragModel() : nullptr);
                     parts[i].solid->CorrectHydrodynamicForces(ocn, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
                     Fdl += Fdlp;
                     Tdl += Tdlp;
@@ -379,7 +393,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
                 
                 if(parts[i].isExternal) //Compute buoyancy and drag
                 {
-                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, submerged);
+                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsFaces(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, submerged);
                     parts[i].solid->CorrectHydrodynamicForces(ocn, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp);
                     Fb += Fbp;
                     Tb += Tbp;
@@ -393,7 +407,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
                 else if(pSettings.reallisticBuoyancy) //Compute only buoyancy
                 {
                     pSettings.dampingForces = false;
-                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, submerged);
+                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsFaces(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdlp, Tdlp, Fdqp, Tdqp, Fdsp, Tdsp, submerged);
                     Fb += Fbp;
                     Tb += Tbp;
                 }
@@ -435,23 +449,15 @@ void Compound::BuildGraphicalObject()
         parts[i].solid->BuildGraphicalObject();
 }
 
-std::vector<Renderable> Compound::Render()
+void Compound::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    
     if(isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SOLID_CS;
-        item.model = glMatrixFromTransform(getCGTransform());
-        items.push_back(item);
+        snapshot.Add(RenderableType::SOLID_CS, glMatrixFromTransform(getCGTransform()));
         
         Vector3 cbWorld = getCGTransform() * P_CB;
-        item.type = RenderableType::HYDRO_CS;
-        item.model = glMatrixFromTransform(Transform(Quaternion::getIdentity(), cbWorld));
-        item.points.push_back(glm::vec3(volume, volume, volume));
-        items.push_back(item);
-        item.points.clear();
+        snapshot.Add(RenderableType::HYDRO_CS, glMatrixFromTransform(Transform(Quaternion::getIdentity(), cbWorld)));
+        snapshot.AddPoint(glm::vec3(volume, volume, volume));
         
         Transform oCompoundTrans = getOTransform();
         
@@ -459,31 +465,27 @@ std::vector<Renderable> Compound::Render()
         {
             if((parts[i].isExternal && !displayInternals) || (!parts[i].isExternal && displayInternals))
             {
-                item.type = RenderableType::SOLID;
-                item.materialName = parts[i].solid->getMaterial().name;
-                
                 if(dm == DisplayMode::GRAPHICAL)
                 {
                     Transform oTrans = oCompoundTrans * parts[i].origin * parts[i].solid->getO2GTransform();
+                    Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(oTrans));
                     item.objectId = parts[i].solid->getGraphicalObject();
                     item.lookId = parts[i].solid->getLook();
-                    item.model = glMatrixFromTransform(oTrans);
-                    items.push_back(item);
+                    item.materialId = parts[i].solid->getMaterial().id;
                 }
                 else if(dm == DisplayMode::PHYSICAL)
                 {
                     Transform oTrans = oCompoundTrans * parts[i].origin * parts[i].solid->getO2CTransform();
+                    Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(oTrans));
                     item.objectId = parts[i].solid->getPhysicalObject();
-                    item.lookId = -1;
-                    item.model = glMatrixFromTransform(oTrans);
-                    items.push_back(item);
+                    item.materialId = parts[i].solid->getMaterial().id;
                 }
             }
             
             GeometryApproxType atype;
             std::vector<Scalar> aparams;
             parts[i].solid->getGeometryApprox(atype, aparams);
-            item.model = glMatrixFromTransform(oCompoundTrans * parts[i].origin * parts[i].solid->getO2HTransform());
+            glm::mat4 model = glMatrixFromTransform(oCompoundTrans * parts[i].origin * parts[i].solid->getO2HTransform());
             
             switch(atype)
             {
@@ -491,50 +493,38 @@ std::vector<Renderable> Compound::Render()
                     break;
                 
                 case  GeometryApproxType::SPHERE:
-                    item.type = RenderableType::HYDRO_ELLIPSOID;
-                    item.points.push_back(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[0]));
-                    items.push_back(item);
+                    snapshot.Add(RenderableType::HYDRO_ELLIPSOID, model);
+                    snapshot.AddPoint(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[0]));
                     break;
                 
                 case  GeometryApproxType::CYLINDER:
-                    item.type = RenderableType::HYDRO_CYLINDER;
-                    item.points.push_back(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[1]));
-                    items.push_back(item);
+                    snapshot.Add(RenderableType::HYDRO_CYLINDER, model);
+                    snapshot.AddPoint(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[0], (GLfloat)aparams[1]));
                     break;
                 
                 case  GeometryApproxType::ELLIPSOID:
-                    item.type = RenderableType::HYDRO_ELLIPSOID;
-                    item.points.push_back(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[1], (GLfloat)aparams[2]));
-                    items.push_back(item);
+                    snapshot.Add(RenderableType::HYDRO_ELLIPSOID, model);
+                    snapshot.AddPoint(glm::vec3((GLfloat)aparams[0], (GLfloat)aparams[1], (GLfloat)aparams[2]));
                     break;
             }
-            
-            item.points.clear();
         }
         
         //Forces
         Vector3 cg = getCGTransform().getOrigin();
         glm::vec3 cgv((GLfloat)cg.x(), (GLfloat)cg.y(), (GLfloat)cg.z());
-        item.points.clear();
-        item.points.push_back(cgv);
-        item.model = glm::mat4(1.f);
         
-        item.type = RenderableType::FORCE_BUOYANCY;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
-        items.push_back(item);
+        snapshot.Add(RenderableType::FORCE_BUOYANCY);
+        snapshot.AddPoint(cgv);
+        snapshot.AddPoint(cgv + glm::vec3((GLfloat)Fb.x(), (GLfloat)Fb.y(), (GLfloat)Fb.z())/1000.f);
         
-        item.points.pop_back();
-        item.type = RenderableType::FORCE_LINEAR_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
-        items.push_back(item);
+        snapshot.Add(RenderableType::FORCE_LINEAR_DRAG);
+        snapshot.AddPoint(cgv);
+        snapshot.AddPoint(cgv + glm::vec3((GLfloat)Fdl.x(), (GLfloat)Fdl.y(), (GLfloat)Fdl.z()));
         
-        item.points.pop_back();
-        item.type = RenderableType::FORCE_QUADRATIC_DRAG;
-        item.points.push_back(cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
-        items.push_back(item);
+        snapshot.Add(RenderableType::FORCE_QUADRATIC_DRAG);
+        snapshot.AddPoint(cgv);
+        snapshot.AddPoint(cgv + glm::vec3((GLfloat)Fdq.x(), (GLfloat)Fdq.y(), (GLfloat)Fdq.z()));
     }
-        
-    return items;
 }
 
 }
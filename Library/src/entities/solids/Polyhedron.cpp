@@ -25,10 +25,12 @@
 
 #include "entities/solids/Polyhedron.h"
 
+#include "core/SimulationManager.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
+#include "utils/GeometryCache.h"
 
 namespace sf
 {
@@ -39,32 +41,76 @@ Polyhedron::Polyhedron(std::string uniqueName, BodyPhysicsSettings phy,
                        std::string material, std::string look, Scalar thickness, GeometryApproxType approx)
                         : SolidEntity(uniqueName, phy, material, look, thickness)
 {
-    //1.Load geometry from file
-    graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
+    //1.Load geometry from file (physics mesh is refined)
+    const GLfloat refineThreshold = 3.f;
+    hullVertices = 0; //Exact convex hull by default
+    hullParts = 1;
+    hullConcavity = Scalar(0.02);
     T_O2G = graphicsOrigin;
     
     if(physicsFilename != "")
     {
-        phyMesh = OpenGLContent::LoadMesh(physicsFilename, physicsScale, false);
+        graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
+        phyMesh = OpenGLContent::LoadMesh(physicsFilename, physicsScale, false, refineThreshold);
+        phyKey = GeometryCache::getMeshKey(physicsFilename, physicsScale, false, refineThreshold);
         T_O2C = physicsOrigin;
     }
     else
     {
+        graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false, refineThreshold);
         phyMesh = graMesh;
+        phyKey = GeometryCache::getMeshKey(graphicsFilename, graphicsScale, false, refineThreshold);
         T_O2C = T_O2G;
     }
     
-    OpenGLContent::Refine(phyMesh, 3.f);
+    //Derived data depends on the material, the approximation type and the density of the fluid
+    Scalar rho = Scalar(1000);
+    Ocean* ocn;
+    if((ocn = SimulationApp::getApp()->getSimulationManager()->getOcean()) != nullptr)
+        rho = ocn->getLiquid().density;
+    std::string propsKey = GeometryCache::MakeKey(phyKey, {thickness, mat.density, Scalar((int)approx), rho});
+    DerivedMeshProperties props;
     
-    //2. Compute physical properties
-    Vector3 CG;
-    Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, Ipri, Irot);
-    T_CG2C.setOrigin(-CG); //Set CG position
-    T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
-    
-    //3.Calculate equivalent ellipsoid for hydrodynamic force computation
-    ComputeFluidDynamicsApprox(approx);
+    if(GeometryCache::getProperties(propsKey, props))
+    {
+        //2. Use cached physical properties
+        mass = props.physical.mass;
+        volume = props.physical.volume;
+        Ipri = props.physical.Ipri;
+        T_CG2C.setOrigin(-props.physical.CG);
+        T_CG2C = Transform(props.physical.Irot, Vector3(0,0,0)).inverse() * T_CG2C;
+        
+        //3. Use cached hydrodynamic approximation
+        fdApproxType = (GeometryApproxType)props.approxType;
+        fdApproxParams = props.approxParams;
+        T_CG2H = props.T_CG2H;
+        aMass = props.addedMass;
+        aI = props.addedInertia;
+    }
+    else
+    {
+        //2. Compute physical properties
+        Vector3 CG;
+        Matrix3 Irot;
+        ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, Ipri, Irot);
+        T_CG2C.setOrigin(-CG); //Set CG position
+        T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
+        
+        //3.Calculate equivalent ellipsoid for hydrodynamic force computation
+        ComputeFluidDynamicsApprox(approx);
+        
+        props.physical.mass = mass;
+        props.physical.CG = CG;
+        props.physical.volume = volume;
+        props.physical.Ipri = Ipri;
+        props.physical.Irot = Irot;
+        props.approxType = (unsigned int)fdApproxType;
+        props.approxParams = fdApproxParams;
+        props.T_CG2H = T_CG2H;
+        props.addedMass = aMass;
+        props.addedInertia = aI;
+        GeometryCache::setProperties(propsKey, props);
+    }
     
     //4. Compute missing transformations
     T_CG2O = T_CG2C * T_O2C.inverse();
@@ -94,18 +140,53 @@ SolidType Polyhedron::getSolidType()
     return SolidType::POLYHEDRON;
 }
 
+void Polyhedron::setCollisionGeometry(unsigned int maxVertices, unsigned int maxParts, Scalar maxConcavity)
+{
+    hullVertices = maxVertices;
+    hullParts = maxParts > 0 ? maxParts : 1;
+    hullConcavity = maxConcavity;
+}
+
 btCollisionShape* Polyhedron::BuildCollisionShape()
 {
-    btConvexHullShape* convex = new btConvexHullShape();
-    for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
+    //Hulls are computed once per mesh and set of parameters
+    std::string hullKey = GeometryCache::MakeKey(phyKey, {Scalar(hullVertices), Scalar(hullParts), hullParts > 1 ? hullConcavity : Scalar(0)});
+    std::vector<std::vector<Vector3>> hulls;
+    
+    if(!GeometryCache::getHulls(hullKey, hulls))
     {
-        glm::vec3 pos = phyMesh->getVertexPos(i);
-        Vector3 v(pos.x, pos.y, pos.z);
-        convex->addPoint(v);
+        if(hullParts > 1)
+            hulls = ComputeConvexDecomposition(phyMesh, hullParts, hullConcavity, hullVertices);
+        else
+        {
+            std::vector<Vector3> points(phyMesh->getNumOfVertices());
+            for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
+            {
+                glm::vec3 pos = phyMesh->getVertexPos(i);
+                points[i] = Vector3(pos.x, pos.y, pos.z);
+            }
+            hulls.push_back(ComputeConvexHull(points, hullVertices));
+        }
+        GeometryCache::setHulls(hullKey, hulls);
     }
-    //convex->optimizeConvexHull();
-    convex->setMargin(0);
-    return convex;
+    
+    std::vector<btConvexHullShape*> shapes;
+    for(size_t i=0; i<hulls.size(); ++i)
+    {
+        if(hulls[i].empty())
+            continue;
+        btConvexHullShape* convex = new btConvexHullShape(hulls[i][0].m_floats, (int)hulls[i].size(), sizeof(Vector3));
+        convex->setMargin(0);
+        shapes.push_back(convex);
+    }
+    
+    if(shapes.size() <= 1)
+        return shapes.empty() ? new btConvexHullShape() : shapes[0];
+    
+    btCompoundShape* compound = new btCompoundShape();
+    for(size_t i=0; i<shapes.size(); ++i)
+        compound->addChildShape(Transform::getIdentity(), shapes[i]);
+    return compound;
 }
 
 void Polyhedron::BuildGraphicalObject()
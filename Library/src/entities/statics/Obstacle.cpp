@@ -179,33 +179,24 @@ void Obstacle::BuildGraphicalObject()
     phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
 }
 
-std::vector<Renderable> Obstacle::Render()
+void Obstacle::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-	
     if(rigidBody != NULL && isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SOLID;
-        item.materialName = mat.name;
-        
         if(dm == DisplayMode::GRAPHICAL && graObjectId >= 0)
         { 
+            Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(getTransform()));
+            item.materialId = mat.id;
             item.objectId = graObjectId;
             item.lookId = lookId;
-            item.model = glMatrixFromTransform(getTransform());
-            items.push_back(item);
         }
         else if(dm == DisplayMode::PHYSICAL && phyObjectId >= 0)
         {
+            Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(getTransform()));
+            item.materialId = mat.id;
             item.objectId = phyObjectId;
-            item.lookId = -1;
-            item.model = glMatrixFromTransform(getTransform());
-            items.push_back(item);
         }
     }
-	
-	return items;
 }
 
 }
@@ -125,7 +125,7 @@ void GLSLShader::Use()
 #endif
 }
 
-bool GLSLShader::AddAttribute(std::string name, ParameterType type)
+bool GLSLShader::AddAttribute(const std::string& name, ParameterType type)
 {
     GLSLAttribute att;
     att.name = name;
@@ -142,7 +142,7 @@ bool GLSLShader::AddAttribute(std::string name, ParameterType type)
     return true;
 }
 
-bool GLSLShader::AddUniform(std::string name, ParameterType type)
+bool GLSLShader::AddUniform(const std::string& name, ParameterType type)
 {
     GLSLUniform uni;
     uni.name = name;
@@ -164,7 +164,7 @@ bool GLSLShader::AddUniform(std::string name, ParameterType type)
     return true;
 }
 
-bool GLSLShader::SetAttribute(std::string name, GLfloat x)
+bool GLSLShader::SetAttribute(const std::string& name, GLfloat x)
 {
     GLint index = 0;
     bool success = GetAttribute(name, FLOAT, index);
@@ -175,7 +175,7 @@ bool GLSLShader::SetAttribute(std::string name, GLfloat x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, bool x)
+bool GLSLShader::SetUniform(const std::string& name, bool x)
 {
     GLint location = 0;
     bool success = GetUniform(name, BOOLEAN, location);
@@ -186,7 +186,7 @@ bool GLSLShader::SetUniform(std::string name, bool x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, GLfloat x)
+bool GLSLShader::SetUniform(const std::string& name, GLfloat x)
 {
     GLint location = 0;
     bool success = GetUniform(name, FLOAT, location);
@@ -197,7 +197,7 @@ bool GLSLShader::SetUniform(std::string name, GLfloat x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::vec2 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::vec2 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, VEC2, location);
@@ -208,7 +208,7 @@ bool GLSLShader::SetUniform(std::string name, glm::vec2 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::vec3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::vec3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, VEC3, location);
@@ -219,7 +219,7 @@ bool GLSLShader::SetUniform(std::string name, glm::vec3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::vec4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::vec4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, VEC4, location);
@@ -230,7 +230,7 @@ bool GLSLShader::SetUniform(std::string name, glm::vec4 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, GLuint x)
+bool GLSLShader::SetUniform(const std::string& name, GLuint x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UINT, location);
@@ -241,7 +241,7 @@ bool GLSLShader::SetUniform(std::string name, GLuint x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, GLint x)
+bool GLSLShader::SetUniform(const std::string& name, GLint x)
 {
     GLint location = 0;
     bool success = GetUniform(name, INT, location);
@@ -252,7 +252,7 @@ bool GLSLShader::SetUniform(std::string name, GLint x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::ivec2 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::ivec2 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, IVEC2, location);
@@ -263,7 +263,7 @@ bool GLSLShader::SetUniform(std::string name, glm::ivec2 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::ivec3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::ivec3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, IVEC3, location);
@@ -274,7 +274,7 @@ bool GLSLShader::SetUniform(std::string name, glm::ivec3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::ivec4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::ivec4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, IVEC4, location);
@@ -285,7 +285,7 @@ bool GLSLShader::SetUniform(std::string name, glm::ivec4 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::uvec2 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::uvec2 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UVEC2, location);
@@ -296,7 +296,7 @@ bool GLSLShader::SetUniform(std::string name, glm::uvec2 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::uvec3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::uvec3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UVEC3, location);
@@ -307,7 +307,7 @@ bool GLSLShader::SetUniform(std::string name, glm::uvec3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::uvec4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::uvec4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UVEC4, location);
@@ -318,7 +318,7 @@ bool GLSLShader::SetUniform(std::string name, glm::uvec4 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::mat3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::mat3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, MAT3, location);
@@ -329,7 +329,7 @@ bool GLSLShader::SetUniform(std::string name, glm::mat3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::mat4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::mat4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, MAT4, location);
@@ -340,7 +340,157 @@ bool GLSLShader::SetUniform(std::string name, glm::mat4 x)
     return success;
 }
 
-bool GLSLShader::GetUniform(std::string name, ParameterType type, GLint& location)
+GLSLUniformHandle GLSLShader::getUniformHandle(const std::string& name, ParameterType type) const
+{
+    GLSLUniformHandle uniform;
+    if(GetUniform(name, type, uniform.location))
+        uniform.type = type;
+    else
+    {
+        uniform.location = -1;
+#ifdef DEBUG
+        cError("Uniform %s doesn't exist!", name.c_str());
+#endif
+    }
+    return uniform;
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, bool x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != BOOLEAN)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform1i(uniform.location, (GLint)x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, GLfloat x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != FLOAT)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform1f(uniform.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::vec2 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != VEC2)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform2fv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::vec3 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != VEC3)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform3fv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::vec4 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != VEC4)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform4fv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, GLuint x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != UINT)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform1ui(uniform.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, GLint x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != INT)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform1i(uniform.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::ivec2 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != IVEC2)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform2iv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::ivec3 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != IVEC3)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform3iv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::ivec4 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != IVEC4)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform4iv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::uvec2 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != UVEC2)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform2uiv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::uvec3 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != UVEC3)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform3uiv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, glm::uvec4 x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != UVEC4)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniform4uiv(uniform.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, const glm::mat3& x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != MAT3)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle& uniform, const glm::mat4& x)
+{
+#ifdef DEBUG
+    if(uniform.location >= 0 && uniform.type != MAT4)
+        cError("Uniform handle of mismatched type!");
+#endif
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(x));
+}
+
+bool GLSLShader::GetUniform(const std::string& name, ParameterType type, GLint& location) const
 {
     for(unsigned int i = 0; i < uniforms.size(); i++)
         if(uniforms[i].name == name)
@@ -363,7 +513,7 @@ bool GLSLShader::GetUniform(std::string name, ParameterType type, GLint& locatio
     return false;
 }
 
-bool GLSLShader::GetAttribute(std::string name, ParameterType type, GLint& index)
+bool GLSLShader::GetAttribute(const std::string& name, ParameterType type, GLint& index)
 {
     for(unsigned int i = 0; i < attributes.size(); i++)
         if(attributes[i].name == name)
@@ -380,7 +530,7 @@ bool GLSLShader::GetAttribute(std::string name, ParameterType type, GLint& index
     return false;
 }
 
-bool GLSLShader::BindUniformBlock(std::string name, GLuint bindingPoint)
+bool GLSLShader::BindUniformBlock(const std::string& name, GLuint bindingPoint)
 {
     GLuint blockIndex = glGetUniformBlockIndex(program, name.c_str());
     if(blockIndex != GL_INVALID_INDEX)
@@ -397,7 +547,7 @@ bool GLSLShader::BindUniformBlock(std::string name, GLuint bindingPoint)
     }
 }
 
-bool GLSLShader::BindShaderStorageBlock(std::string name, GLuint bindingPoint)
+bool GLSLShader::BindShaderStorageBlock(const std::string& name, GLuint bindingPoint)
 {
     GLuint blockIndex = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, name.c_str());
     if(blockIndex != GL_INVALID_INDEX)
@@ -835,10 +835,19 @@ bool IMGUI::DoTimePlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, Scala
     //Drawing
     DrawRoundedRect(x, y, w, h, theme[PLOT_COLOR]);
     
-    //data
-    const std::vector<Sample>* data = sens->getHistory();
+    //data (buffers reused between frames)
+    static std::vector<std::vector<Scalar>> data;
+    if(data.size() < dims.size())
+        data.resize(dims.size());
+    size_t dataCount = dims.size() > 0 ? SIZE_MAX : 0;
+    for(size_t n = 0; n < dims.size(); ++n)
+    {
+        sens->getHistoryValues(dims[n], data[n]);
+        if(data[n].size() < dataCount)
+            dataCount = data[n].size();
+    }
     
-    if(data->size() > 1)
+    if(dataCount > 1)
     {
         GLfloat minValue;
         GLfloat maxValue;
@@ -853,11 +862,11 @@ bool IMGUI::DoTimePlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, Scala
             minValue = 10e12;
             maxValue = -10e12;
         
-            for(size_t i = 0; i < data->size(); ++i)
+            for(size_t i = 0; i < dataCount; ++i)
             {
                 for(size_t n = 0; n < dims.size(); ++n)
                 {
-                    GLfloat value = (GLfloat)((*data)[i].getValue(dims[n]));
+                    GLfloat value = (GLfloat)data[n][i];
                     if(value > maxValue)
                         maxValue = value;
                     if(value < minValue)
@@ -875,7 +884,7 @@ bool IMGUI::DoTimePlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, Scala
         GLfloat dy = (pltH-2.f*pltMargin)/(maxValue-minValue);
         
         //autostretch
-        GLfloat dt = pltW/(GLfloat)(data->size()-1);
+        GLfloat dt = pltW/(GLfloat)(dataCount-1);
     
         //drawing
         for(size_t n = 0; n < dims.size(); ++n)
@@ -890,9 +899,9 @@ bool IMGUI::DoTimePlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, Scala
             
             //draw graph
             std::vector<glm::vec2> points;
-            for(size_t i = 0;  i < data->size(); ++i)
+            for(size_t i = 0;  i < dataCount; ++i)
             {
-                GLfloat value = (GLfloat)((*data)[i].getValue(dims[n]));
+                GLfloat value = (GLfloat)data[n][i];
                 points.push_back(glm::vec2(pltX + dt*i, pltY - pltH + pltMargin + (value-minValue) * dy));
             }
             
@@ -953,8 +962,6 @@ bool IMGUI::DoTimePlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, Scala
             DrawPlainText(x + backgroundMargin, y + backgroundMargin, theme[PLOT_TEXT_COLOR], buffer);
         }
     }
-    
-    delete data;
         
     //title
     glm::vec2 titleDim = PlainTextDimensions(title);
@@ -994,15 +1001,17 @@ bool IMGUI::DoXYPlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, ScalarS
     DrawRoundedRect(x, y, w, h, theme[PLOT_COLOR]);
     
     //data
-    const std::vector<Sample>* dataX = sensX->getHistory();
-    const std::vector<Sample>* dataY = sensY->getHistory();
+    static std::vector<Scalar> dataX;
+    static std::vector<Scalar> dataY;
+    sensX->getHistoryValues(dimX, dataX);
+    sensY->getHistoryValues(dimY, dataY);
     
-    if((dataX->size() > 1) && (dataY->size() > 1))
+    if((dataX.size() > 1) && (dataY.size() > 1))
     {
         //common sample count
-        unsigned long dataCount = dataX->size();
-        if(dataY->size() < dataCount)
-            dataCount = dataY->size();
+        unsigned long dataCount = dataX.size();
+        if(dataY.size() < dataCount)
+            dataCount = dataY.size();
         
         //autoscale X axis
         GLfloat minValueX = 10e12;
@@ -1010,7 +1019,7 @@ bool IMGUI::DoXYPlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, ScalarS
         
         for(size_t i = 0; i < dataCount; ++i)
         {
-            GLfloat value = (GLfloat)((*dataX)[i].getValue(dimX));
+            GLfloat value = (GLfloat)dataX[i];
             if(value > maxValueX)
                 maxValueX = value;
             if(value < minValueX)
@@ -1031,7 +1040,7 @@ bool IMGUI::DoXYPlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, ScalarS
         
         for(size_t i = 0; i < dataCount; ++i)
         {
-            GLfloat value = (GLfloat)((*dataY)[i].getValue(dimY));
+            GLfloat value = (GLfloat)dataY[i];
             if(value > maxValueY)
                 maxValueY = value;
             if(value < minValueY)
@@ -1051,8 +1060,8 @@ bool IMGUI::DoXYPlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, ScalarS
         
         for(size_t i = 0;  i < dataCount; ++i)
         {
-            GLfloat valueX = (GLfloat)((*dataX)[i].getValue(dimX));
-            GLfloat valueY = (GLfloat)((*dataY)[i].getValue(dimY));
+            GLfloat valueX = (GLfloat)dataX[i];
+            GLfloat valueY = (GLfloat)dataY[i];
             points.push_back(glm::vec2(pltX + (valueX - minValueX) * dx, pltY - pltH + (valueY - minValueY) * dy));
         }
         
@@ -1107,9 +1116,6 @@ bool IMGUI::DoXYPlot(Uid id, GLfloat x, GLfloat y, GLfloat w, GLfloat h, ScalarS
         }
     }
     
-    delete dataX;
-    delete dataY;
-    
     //title
     glm::vec2 titleDim = PlainTextDimensions(title);
     DrawPlainText(x + floorf((w - titleDim.x) / 2.f), y + backgroundMargin, theme[PLOT_TEXT_COLOR], title);
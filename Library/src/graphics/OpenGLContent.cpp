@@ -39,6 +39,7 @@
 #include "entities/forcefields/Atmosphere.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
+#include "utils/GeometryCache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -202,38 +203,44 @@ OpenGLContent::OpenGLContent()
     
     //Load shaders
     //-----BASIC-----
-    basicShaders["helper"] = new GLSLShader("helpers.frag","helpers.vert");
-    basicShaders["helper"]->AddUniform("MVP", ParameterType::MAT4);
-    basicShaders["helper"]->AddUniform("scale", ParameterType::VEC3);
+    basicShaders[HELPER_SHADER] = new GLSLShader("helpers.frag","helpers.vert");
+    basicShaders[HELPER_SHADER]->AddUniform("MVP", ParameterType::MAT4);
+    basicShaders[HELPER_SHADER]->AddUniform("scale", ParameterType::VEC3);
     
-    basicShaders["tex_saq"] = new GLSLShader("texQuad.frag");
-    basicShaders["tex_saq"]->AddUniform("tex", ParameterType::INT);
-    basicShaders["tex_saq"]->AddUniform("color", ParameterType::VEC4);
+    basicShaders[TEX_SAQ_SHADER] = new GLSLShader("texQuad.frag");
+    basicShaders[TEX_SAQ_SHADER]->AddUniform("tex", ParameterType::INT);
+    basicShaders[TEX_SAQ_SHADER]->AddUniform("color", ParameterType::VEC4);
     
-    basicShaders["tex_quad"] = new GLSLShader("texQuad.frag","texQuad.vert");
-    basicShaders["tex_quad"]->AddUniform("rect", ParameterType::VEC4);
-    basicShaders["tex_quad"]->AddUniform("tex", ParameterType::INT);
-    basicShaders["tex_quad"]->AddUniform("color", ParameterType::VEC4);
+    basicShaders[TEX_QUAD_SHADER] = new GLSLShader("texQuad.frag","texQuad.vert");
+    basicShaders[TEX_QUAD_SHADER]->AddUniform("rect", ParameterType::VEC4);
+    basicShaders[TEX_QUAD_SHADER]->AddUniform("tex", ParameterType::INT);
+    basicShaders[TEX_QUAD_SHADER]->AddUniform("color", ParameterType::VEC4);
     
-    basicShaders["tex_layer_quad"] = new GLSLShader("texLayerQuad.frag", "texQuad.vert");
-    basicShaders["tex_layer_quad"]->AddUniform("rect", ParameterType::VEC4);
-    basicShaders["tex_layer_quad"]->AddUniform("tex", ParameterType::INT);
-    basicShaders["tex_layer_quad"]->AddUniform("layer", ParameterType::INT);
+    basicShaders[TEX_LAYER_QUAD_SHADER] = new GLSLShader("texLayerQuad.frag", "texQuad.vert");
+    basicShaders[TEX_LAYER_QUAD_SHADER]->AddUniform("rect", ParameterType::VEC4);
+    basicShaders[TEX_LAYER_QUAD_SHADER]->AddUniform("tex", ParameterType::INT);
+    basicShaders[TEX_LAYER_QUAD_SHADER]->AddUniform("layer", ParameterType::INT);
     
-    basicShaders["tex_level_quad"] = new GLSLShader("texLevelQuad.frag", "texQuad.vert");
-    basicShaders["tex_level_quad"]->AddUniform("rect", ParameterType::VEC4);
-    basicShaders["tex_level_quad"]->AddUniform("tex", ParameterType::INT);
-    basicShaders["tex_level_quad"]->AddUniform("level", ParameterType::INT);
+    basicShaders[TEX_LEVEL_QUAD_SHADER] = new GLSLShader("texLevelQuad.frag", "texQuad.vert");
+    basicShaders[TEX_LEVEL_QUAD_SHADER]->AddUniform("rect", ParameterType::VEC4);
+    basicShaders[TEX_LEVEL_QUAD_SHADER]->AddUniform("tex", ParameterType::INT);
+    basicShaders[TEX_LEVEL_QUAD_SHADER]->AddUniform("level", ParameterType::INT);
     
-    basicShaders["tex_cube"] = new GLSLShader("texCube.frag", "texCube.vert");
-    basicShaders["tex_cube"]->AddUniform("tex", ParameterType::INT);
+    basicShaders[TEX_CUBE_SHADER] = new GLSLShader("texCube.frag", "texCube.vert");
+    basicShaders[TEX_CUBE_SHADER]->AddUniform("tex", ParameterType::INT);
     
-    basicShaders["flat"] = new GLSLShader("flat.frag", "flat.vert");
-    basicShaders["flat"]->AddUniform("MVP", ParameterType::MAT4);
-    basicShaders["flat"]->AddUniform("FC", ParameterType::FLOAT);
+    basicShaders[FLAT_SHADER] = new GLSLShader("flat.frag", "flat.vert");
+    basicShaders[FLAT_SHADER]->AddUniform("MVP", ParameterType::MAT4);
+    basicShaders[FLAT_SHADER]->AddUniform("FC", ParameterType::FLOAT);
 
-    basicShaders["shadow"] = new GLSLShader("shadow.frag", "shadow.vert");
-    basicShaders["shadow"]->AddUniform("MVP", ParameterType::MAT4);
+    basicShaders[SHADOW_SHADER] = new GLSLShader("shadow.frag", "shadow.vert");
+    basicShaders[SHADOW_SHADER]->AddUniform("MVP", ParameterType::MAT4);
+    
+    helperUniforms[0] = basicShaders[HELPER_SHADER]->getUniformHandle("MVP", ParameterType::MAT4);
+    helperUniforms[1] = basicShaders[HELPER_SHADER]->getUniformHandle("scale", ParameterType::VEC3);
+    flatUniforms[0] = basicShaders[FLAT_SHADER]->getUniformHandle("MVP", ParameterType::MAT4);
+    flatUniforms[1] = basicShaders[FLAT_SHADER]->getUniformHandle("FC", ParameterType::FLOAT);
+    shadowMVP = basicShaders[SHADOW_SHADER]->getUniformHandle("MVP", ParameterType::MAT4);
     
     //-----MATERIALS-----
     std::vector<std::string> shadingAlgorithms;
@@ -358,6 +365,15 @@ OpenGLContent::OpenGLContent()
                 ms.shaders[h]->SetUniform("texAlbedo", TEX_MAT_ALBEDO);
                 ms.shaders[h]->SetUniform("texNormal", TEX_MAT_NORMAL);
             }
+
+            
+            ms.uniforms[h].MVP = ms.shaders[h]->getUniformHandle("MVP", ParameterType::MAT4);
+            ms.uniforms[h].M = ms.shaders[h]->getUniformHandle("M", ParameterType::MAT4);
+            ms.uniforms[h].N = ms.shaders[h]->getUniformHandle("N", ParameterType::MAT3);
+            ms.uniforms[h].MV = ms.shaders[h]->getUniformHandle("MV", ParameterType::MAT3);
+            ms.uniforms[h].FC = ms.shaders[h]->getUniformHandle("FC", ParameterType::FLOAT);
+            ms.uniforms[h].eyePos = ms.shaders[h]->getUniformHandle("eyePos", ParameterType::VEC3);
+            ms.uniforms[h].viewDir = ms.shaders[h]->getUniformHandle("viewDir", ParameterType::VEC3);
         }
 
         materialShaders.push_back(ms);
@@ -464,14 +480,8 @@ OpenGLContent::~OpenGLContent()
     if(csBuf[0] != 0) glDeleteBuffers(2, csBuf);
     if(lightsUBO != 0) glDeleteBuffers(1, &lightsUBO);
     if(viewUBO != 0) glDeleteBuffers(1, &viewUBO);
-    delete basicShaders["helper"];
-    delete basicShaders["tex_saq"];
-    delete basicShaders["tex_quad"];
-    delete basicShaders["tex_layer_quad"];
-    delete basicShaders["tex_level_quad"];
-    delete basicShaders["tex_cube"];
-    delete basicShaders["flat"];
-    delete basicShaders["shadow"];
+    for(size_t i=0; i<BASIC_SHADER_COUNT; ++i)
+        delete basicShaders[i];
     if(lightSourceShader[0] != NULL) delete lightSourceShader[0];
     if(lightSourceShader[1] != NULL) delete lightSourceShader[1];
     
@@ -546,6 +556,11 @@ glm::mat4 OpenGLContent::GetViewMatrix()
     return view;
 }
 
+glm::mat4 OpenGLContent::GetViewProjectionMatrix()
+{
+    return viewProjection;
+}
+
 void OpenGLContent::SetCurrentView(OpenGLView* v)
 {
 	eyePos = v->GetEyePosition();
@@ -581,9 +596,9 @@ void OpenGLContent::DrawSAQ()
 void OpenGLContent::DrawTexturedSAQ(GLuint texture, glm::vec4 color)
 {
     OpenGLState::BindTexture(TEX_BASE, GL_TEXTURE_2D, texture);
-    basicShaders["tex_saq"]->Use();
-    basicShaders["tex_saq"]->SetUniform("tex", TEX_BASE);
-    basicShaders["tex_saq"]->SetUniform("color", color);
+    basicShaders[TEX_SAQ_SHADER]->Use();
+    basicShaders[TEX_SAQ_SHADER]->SetUniform("tex", TEX_BASE);
+    basicShaders[TEX_SAQ_SHADER]->SetUniform("color", color);
     
     OpenGLState::BindVertexArray(baseVertexArray);
     glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -597,10 +612,10 @@ void OpenGLContent::DrawTexturedQuad(GLfloat x, GLfloat y, GLfloat width, GLfloa
 {
     y = viewportSize.y-y-height;
     
-    basicShaders["tex_quad"]->Use();
-    basicShaders["tex_quad"]->SetUniform("rect", glm::vec4(x/viewportSize.x, y/viewportSize.y, width/viewportSize.x, height/viewportSize.y));
-    basicShaders["tex_quad"]->SetUniform("tex", TEX_BASE);
-    basicShaders["tex_quad"]->SetUniform("color", color);
+    basicShaders[TEX_QUAD_SHADER]->Use();
+    basicShaders[TEX_QUAD_SHADER]->SetUniform("rect", glm::vec4(x/viewportSize.x, y/viewportSize.y, width/viewportSize.x, height/viewportSize.y));
+    basicShaders[TEX_QUAD_SHADER]->SetUniform("tex", TEX_BASE);
+    basicShaders[TEX_QUAD_SHADER]->SetUniform("color", color);
     
     OpenGLState::BindTexture(TEX_BASE, GL_TEXTURE_2D, texture);
     OpenGLState::BindVertexArray(baseVertexArray);
@@ -616,17 +631,17 @@ void OpenGLContent::DrawTexturedQuad(GLfloat x, GLfloat y, GLfloat width, GLfloa
     
     if(array)
     {
-        basicShaders["tex_layer_quad"]->Use();
-        basicShaders["tex_layer_quad"]->SetUniform("rect", glm::vec4(x/viewportSize.x, y/viewportSize.y, width/viewportSize.x, height/viewportSize.y));
-        basicShaders["tex_layer_quad"]->SetUniform("tex", TEX_BASE);
-        basicShaders["tex_layer_quad"]->SetUniform("layer", z);
+        basicShaders[TEX_LAYER_QUAD_SHADER]->Use();
+        basicShaders[TEX_LAYER_QUAD_SHADER]->SetUniform("rect", glm::vec4(x/viewportSize.x, y/viewportSize.y, width/viewportSize.x, height/viewportSize.y));
+        basicShaders[TEX_LAYER_QUAD_SHADER]->SetUniform("tex", TEX_BASE);
+        basicShaders[TEX_LAYER_QUAD_SHADER]->SetUniform("layer", z);
     }
     else
     {
-        basicShaders["tex_level_quad"]->Use();
-        basicShaders["tex_level_quad"]->SetUniform("rect", glm::vec4(x/viewportSize.x, y/viewportSize.y, width/viewportSize.x, height/viewportSize.y));
-        basicShaders["tex_level_quad"]->SetUniform("tex", TEX_BASE);
-        basicShaders["tex_level_quad"]->SetUniform("level", z);
+        basicShaders[TEX_LEVEL_QUAD_SHADER]->Use();
+        basicShaders[TEX_LEVEL_QUAD_SHADER]->SetUniform("rect", glm::vec4(x/viewportSize.x, y/viewportSize.y, width/viewportSize.x, height/viewportSize.y));
+        basicShaders[TEX_LEVEL_QUAD_SHADER]->SetUniform("tex", TEX_BASE);
+        basicShaders[TEX_LEVEL_QUAD_SHADER]->SetUniform("level", z);
     }
     
     OpenGLState::BindTexture(TEX_BASE, array ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D, texture);
@@ -639,8 +654,8 @@ void OpenGLContent::DrawTexturedQuad(GLfloat x, GLfloat y, GLfloat width, GLfloa
 
 void OpenGLContent::DrawCubemapCross(GLuint texture)
 {
-    basicShaders["tex_cube"]->Use();
-    basicShaders["tex_cube"]->SetUniform("tex", TEX_BASE);
+    basicShaders[TEX_CUBE_SHADER]->Use();
+    basicShaders[TEX_CUBE_SHADER]->SetUniform("tex", TEX_BASE);
     
     OpenGLState::BindTexture(TEX_BASE, GL_TEXTURE_CUBE_MAP, texture);
     OpenGLState::BindVertexArray(baseVertexArray);
@@ -665,9 +680,9 @@ void OpenGLContent::DrawCubemapCross(GLuint texture)
 
 void OpenGLContent::DrawCoordSystem(glm::mat4 M, GLfloat size)
 {
-    basicShaders["helper"]->Use();
-    basicShaders["helper"]->SetUniform("MVP", viewProjection*M);
-    basicShaders["helper"]->SetUniform("scale", glm::vec3(size));
+    basicShaders[HELPER_SHADER]->Use();
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[0], viewProjection*M);
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[1], glm::vec3(size));
     
     OpenGLState::BindVertexArray(baseVertexArray);
     glEnableVertexAttribArray(0);
@@ -689,9 +704,9 @@ void OpenGLContent::DrawCoordSystem(glm::mat4 M, GLfloat size)
 
 void OpenGLContent::DrawCylinder(glm::mat4 M, glm::vec3 dims, glm::vec4 color)
 {
-    basicShaders["helper"]->Use();
-    basicShaders["helper"]->SetUniform("MVP", viewProjection*M);
-    basicShaders["helper"]->SetUniform("scale", dims);
+    basicShaders[HELPER_SHADER]->Use();
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[0], viewProjection*M);
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[1], dims);
     
     OpenGLState::BindVertexArray(cylinder.vao);
     glVertexAttrib4fv(1, &color.r);
@@ -702,9 +717,9 @@ void OpenGLContent::DrawCylinder(glm::mat4 M, glm::vec3 dims, glm::vec4 color)
 
 void OpenGLContent::DrawEllipsoid(glm::mat4 M, glm::vec3 radii, glm::vec4 color)
 {
-    basicShaders["helper"]->Use();
-    basicShaders["helper"]->SetUniform("MVP", viewProjection*M);
-    basicShaders["helper"]->SetUniform("scale", radii);
+    basicShaders[HELPER_SHADER]->Use();
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[0], viewProjection*M);
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[1], radii);
     
     OpenGLState::BindVertexArray(ellipsoid.vao);
     glVertexAttrib4fv(1, &color.r);
@@ -715,22 +730,27 @@ void OpenGLContent::DrawEllipsoid(glm::mat4 M, glm::vec3 radii, glm::vec4 color)
 
 void OpenGLContent::DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& vertices, glm::vec4 color, glm::mat4 M)
 {
-    if(vertices.size() == 0)
+    DrawPrimitives(type, vertices.data(), vertices.size(), color, M);
+}
+
+void OpenGLContent::DrawPrimitives(PrimitiveType type, const glm::vec3* vertices, size_t count, glm::vec4 color, glm::mat4 M)
+{
+    if(count == 0)
         return;
 
     GLuint vbo;
     glGenBuffers(1, &vbo);
     
-    basicShaders["helper"]->Use();
-    basicShaders["helper"]->SetUniform("MVP", viewProjection*M);
-    basicShaders["helper"]->SetUniform("scale", glm::vec3(1.f));
+    basicShaders[HELPER_SHADER]->Use();
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[0], viewProjection*M);
+    basicShaders[HELPER_SHADER]->SetUniform(helperUniforms[1], glm::vec3(1.f));
     
     OpenGLState::BindVertexArray(baseVertexArray);
     glEnableVertexAttribArray(0);
     glDisableVertexAttribArray(1);
     
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3)*vertices.size(), &vertices[0].x, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3)*count, &vertices[0].x, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(GLfloat), (void*)0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
@@ -739,16 +759,16 @@ void OpenGLContent::DrawPrimitives(PrimitiveType type, std::vector<glm::vec3>& v
     switch(type)
     {
         case PrimitiveType::LINES:
-            glDrawArrays(GL_LINES, 0, (GLsizei)vertices.size());
+            glDrawArrays(GL_LINES, 0, (GLsizei)count);
             break;
         
         case PrimitiveType::LINE_STRIP:
-            glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)vertices.size());
+            glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)count);
             break;
             
         case PrimitiveType::POINTS:
         default:
-            glDrawArrays(GL_POINTS, 0, (GLsizei)vertices.size());
+            glDrawArrays(GL_POINTS, 0, (GLsizei)count);
             break;
     }
     OpenGLState::BindVertexArray(0);
@@ -775,8 +795,8 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
 
         case DrawingMode::SHADOW:
         {
-            basicShaders["shadow"]->Use();
-            basicShaders["shadow"]->SetUniform("MVP", viewProjection*M);
+            basicShaders[SHADOW_SHADER]->Use();
+            basicShaders[SHADOW_SHADER]->SetUniform(shadowMVP, viewProjection*M);
             OpenGLState::BindVertexArray(objects[objectId].vao);
             glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
             OpenGLState::BindVertexArray(0);
@@ -785,9 +805,9 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
         
         case DrawingMode::FLAT:
         {
-            basicShaders["flat"]->Use();
-            basicShaders["flat"]->SetUniform("MVP", viewProjection*M);
-            basicShaders["flat"]->SetUniform("FC", FC);
+            basicShaders[FLAT_SHADER]->Use();
+            basicShaders[FLAT_SHADER]->SetUniform(flatUniforms[0], viewProjection*M);
+            basicShaders[FLAT_SHADER]->SetUniform(flatUniforms[1], FC);
             OpenGLState::BindVertexArray(objects[objectId].vao);
             glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
             OpenGLState::BindVertexArray(0);
@@ -890,15 +910,17 @@ void OpenGLContent::UseLook(unsigned int lookId, bool texturable, const glm::mat
     currentShaderMode = shaderMode;
 
     size_t shaderId = (currentTexturable ? 3 : 0) + (size_t)currentShaderMode;
-    GLSLShader* shader = materialShaders[l.type == LookType::SIMPLE ? 0 : 1].shaders[shaderId];
+    const MaterialShader& ms = materialShaders[l.type == LookType::SIMPLE ? 0 : 1];
+    GLSLShader* shader = ms.shaders[shaderId];
+    const ObjectUniforms& uniforms = ms.uniforms[shaderId];
     shader->Use();
-    shader->SetUniform("MVP", viewProjection*M);
-    shader->SetUniform("M", M);
-    shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
+    shader->SetUniform(uniforms.MVP, viewProjection*M);
+    shader->SetUniform(uniforms.M, M);
+    shader->SetUniform(uniforms.N, glm::mat3(glm::transpose(glm::inverse(M))));
+    shader->SetUniform(uniforms.MV, glm::mat3(glm::transpose(glm::inverse(view*M))));
+    shader->SetUniform(uniforms.FC, FC);
+    shader->SetUniform(uniforms.eyePos, eyePos);
+    shader->SetUniform(uniforms.viewDir, viewDir);
 
     if(updateMaterial)
     {
@@ -977,14 +999,15 @@ void OpenGLContent::UseStandardLook(const glm::mat4& M)
     currentShaderMode = shaderMode;
 
     GLSLShader* shader = materialShaders[1].shaders[(size_t)currentShaderMode];
+    const ObjectUniforms& uniforms = materialShaders[1].uniforms[(size_t)currentShaderMode];
     shader->Use();
-    shader->SetUniform("MVP", viewProjection*M);
-    shader->SetUniform("M", M);
-    shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
+    shader->SetUniform(uniforms.MVP, viewProjection*M);
+    shader->SetUniform(uniforms.M, M);
+    shader->SetUniform(uniforms.N, glm::mat3(glm::transpose(glm::inverse(M))));
+    shader->SetUniform(uniforms.MV, glm::mat3(glm::transpose(glm::inverse(view*M))));
+    shader->SetUniform(uniforms.FC, FC);
+    shader->SetUniform(uniforms.eyePos, eyePos);
+    shader->SetUniform(uniforms.viewDir, viewDir);
 
     if(updateMaterial)
     {
@@ -1018,6 +1041,7 @@ unsigned int OpenGLContent::BuildObject(Mesh* mesh)
     glGenBuffers(1, &obj.vboIndex);
     obj.faceCount = (GLsizei)mesh->faces.size();
     obj.texturable = false;
+    AABS(mesh, obj.bsRadius, obj.bsCenter);
     
     OpenGLState::BindVertexArray(obj.vao);	
     glEnableVertexAttribArray(0); //Position
@@ -2235,15 +2259,11 @@ Mesh* OpenGLContent::BuildTerrain(GLfloat* heightfield, int sizeX, int sizeY, GL
     return mesh;
 }
 
-Mesh* OpenGLContent::LoadMesh(std::string filename, GLfloat scale, bool smooth)
+Mesh* OpenGLContent::LoadMesh(std::string filename, GLfloat scale, bool smooth, GLfloat refineThreshold)
 {
-    Mesh* mesh = LoadGeometryFromFile(filename, scale);
+    Mesh* mesh = GeometryCache::LoadMesh(filename, scale, smooth, refineThreshold);
     if(mesh == nullptr)
         abort();
-    if(smooth)
-        SmoothNormals(mesh);
-    if(mesh->isTexturable())
-        ComputeTangents((TexturableMesh*)mesh);
     return mesh;
 }
 
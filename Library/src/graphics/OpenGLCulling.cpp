@@ -0,0 +1,139 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OpenGLCulling.cpp
+//  Stonefish
+//
+
+#include "graphics/OpenGLCulling.h"
+
+#include "graphics/OpenGLContent.h"
+
+namespace sf
+{
+
+OpenGLCulling::OpenGLCulling()
+{
+}
+
+void OpenGLCulling::Update(const RenderSnapshot& objects, OpenGLContent* content)
+{
+    items.clear();
+    x.clear();
+    y.clear();
+    z.clear();
+    r.clear();
+
+    for(size_t i=0; i<objects.size(); ++i)
+    {
+        if(objects[i].type != RenderableType::SOLID || objects[i].objectId < 0)
+            continue;
+
+        const Object& obj = content->getObject(objects[i].objectId);
+        const glm::mat4& M = objects[i].model;
+        glm::vec3 c = glm::vec3(M * glm::vec4(obj.bsCenter, 1.f));
+        GLfloat s2 = glm::max(glm::dot(glm::vec3(M[0]), glm::vec3(M[0])),
+                     glm::max(glm::dot(glm::vec3(M[1]), glm::vec3(M[1])), glm::dot(glm::vec3(M[2]), glm::vec3(M[2]))));
+        items.push_back(i);
+        x.push_back(c.x);
+        y.push_back(c.y);
+        z.push_back(c.z);
+        r.push_back(obj.bsRadius * glm::sqrt(s2));
+    }
+
+    //Pad to full batches of four spheres
+    while(x.size() % 4 != 0)
+    {
+        x.push_back(0.f);
+        y.push_back(0.f);
+        z.push_back(0.f);
+        r.push_back(0.f);
+    }
+}
+
+void OpenGLCulling::CullFrustum(const glm::mat4& VP, std::vector<GLuint>& visible) const
+{
+    //Left, right, bottom, top and far planes (rows of the view-projection matrix)
+    glm::mat4 VPt = glm::transpose(VP);
+    glm::vec4 planes[5];
+    planes[0] = VPt[3] + VPt[0];
+    planes[1] = VPt[3] - VPt[0];
+    planes[2] = VPt[3] + VPt[1];
+    planes[3] = VPt[3] - VPt[1];
+    planes[4] = VPt[3] - VPt[2];
+    for(size_t p=0; p<5; ++p)
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+
+    visible.clear();
+    for(size_t b=0; b<x.size(); b+=4)
+    {
+        glm::vec4 cx = glm::make_vec4(&x[b]);
+        glm::vec4 cy = glm::make_vec4(&y[b]);
+        glm::vec4 cz = glm::make_vec4(&z[b]);
+        glm::vec4 cr = glm::make_vec4(&r[b]);
+
+        //Signed distance to the closest plane, for four spheres at a time
+        glm::vec4 d(BT_LARGE_FLOAT);
+        for(size_t p=0; p<5; ++p)
+            d = glm::min(d, cx * planes[p].x + cy * planes[p].y + cz * planes[p].z + planes[p].w);
+        glm::bvec4 in = glm::greaterThanEqual(d, -cr);
+
+        for(size_t k=0; k<4 && b+k<items.size(); ++k)
+            if(in[k])
+                visible.push_back((GLuint)(b+k));
+    }
+}
+
+void OpenGLCulling::CullCone(const glm::vec3& apex, const glm::vec3& axis, GLfloat halfAngle, GLfloat range, std::vector<GLuint>& visible) const
+{
+    GLfloat cosA = glm::cos(halfAngle);
+    GLfloat sinA = glm::sin(halfAngle);
+
+    visible.clear();
+    for(size_t b=0; b<x.size(); b+=4)
+    {
+        glm::vec4 vx = glm::make_vec4(&x[b]) - apex.x;
+        glm::vec4 vy = glm::make_vec4(&y[b]) - apex.y;
+        glm::vec4 vz = glm::make_vec4(&z[b]) - apex.z;
+        glm::vec4 cr = glm::make_vec4(&r[b]);
+
+        //Distance along the axis and distance from the cone surface
+        glm::vec4 a = vx * axis.x + vy * axis.y + vz * axis.z;
+        glm::vec4 v2 = vx * vx + vy * vy + vz * vz;
+        glm::vec4 d = glm::sqrt(glm::max(v2 - a * a, glm::vec4(0.f))) * cosA - a * sinA;
+        glm::bvec4 in = glm::lessThanEqual(d, cr);
+        glm::bvec4 front = glm::greaterThanEqual(a, -cr);
+        glm::bvec4 back = glm::lessThanEqual(a, cr + range);
+
+        for(size_t k=0; k<4 && b+k<items.size(); ++k)
+            if(in[k] && front[k] && back[k])
+                visible.push_back((GLuint)(b+k));
+    }
+}
+
+size_t OpenGLCulling::getCount() const
+{
+    return items.size();
+}
+
+size_t OpenGLCulling::getItem(GLuint id) const
+{
+    return items[id];
+}
+
+}
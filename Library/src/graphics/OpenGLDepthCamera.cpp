@@ -32,6 +32,8 @@
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLCulling.h"
+#include "graphics/OpenGLReadback.h"
 
 namespace sf
 {
@@ -47,14 +49,13 @@ OpenGLDepthCamera::OpenGLDepthCamera(glm::vec3 eyePosition, glm::vec3 direction,
 {
     _needsUpdate = false;
     continuous = continuousUpdate;
-    newData = false;
     camera = NULL;
     noiseDepth = 0.f;
     idx = 0;
     range.x = minDepth;
     range.y = maxDepth;
     usesRanges = useRanges;
-    linearDepthPBO = 0;
+    readback = nullptr;
     
     SetupCamera(eyePosition, direction, cameraUp);
     UpdateTransform();
@@ -123,10 +124,8 @@ OpenGLDepthCamera::~OpenGLDepthCamera()
     glDeleteTextures(1, &linearDepthTex);
     glDeleteFramebuffers(1, &linearDepthFBO);
 
-    if(camera != NULL)
-    {
-        glDeleteBuffers(1, &linearDepthPBO);
-    }
+    if(readback != nullptr)
+        delete readback;
 }
 
 void OpenGLDepthCamera::SetupCamera(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -143,19 +142,9 @@ void OpenGLDepthCamera::UpdateTransform()
     up = tempUp;
     SetupCamera();
 
-    //Inform camera to run callback
-    if(newData)
-    {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, linearDepthPBO);
-        GLfloat* src = (GLfloat*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            camera->NewDataReady(src, idx);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
-    }
+    //Pass completed frames to the camera callback
+    if(readback != nullptr)
+        readback->Poll();
 }
 
 void OpenGLDepthCamera::SetupCamera()
@@ -214,10 +203,7 @@ void OpenGLDepthCamera::setCamera(Camera* cam, unsigned int index)
     camera = cam;
     idx = index;
 
-    glGenBuffers(1, &linearDepthPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, linearDepthPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * sizeof(GLfloat), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback = new OpenGLReadback(camera, std::vector<GLsizeiptr>(1, viewportWidth * viewportHeight * sizeof(GLfloat)), idx);
 }
 
 void OpenGLDepthCamera::setNoise(GLfloat depthStdDev)
@@ -230,20 +216,21 @@ ViewType OpenGLDepthCamera::getType()
     return ViewType::DEPTH_CAMERA;
 }
 
-void OpenGLDepthCamera::ComputeOutput(std::vector<Renderable>& objects)
+void OpenGLDepthCamera::ComputeOutput(RenderSnapshot& objects)
 {
     OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
+    OpenGLCulling* culling = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getCulling();
     content->SetCurrentView(this);
     content->SetDrawingMode(DrawingMode::SHADOW);
+    culling->CullFrustum(content->GetViewProjectionMatrix(), visibleObjects);
     OpenGLState::BindFramebuffer(renderFBO);
     OpenGLState::Viewport(0, 0, viewportWidth, viewportHeight);
     glClear(GL_DEPTH_BUFFER_BIT);
     glDisable(GL_DEPTH_CLAMP);
-    for(size_t h=0; h<objects.size(); ++h)
+    for(size_t h=0; h<visibleObjects.size(); ++h)
     {
-        if(objects[h].type != RenderableType::SOLID)
-            continue;
-        content->DrawObject(objects[h].objectId, -1, objects[h].model);
+        const Renderable& r = objects[culling->getItem(visibleObjects[h])];
+        content->DrawObject(r.objectId, -1, r.model);
     }
     glEnable(GL_DEPTH_CLAMP);
     OpenGLState::BindFramebuffer(0);
@@ -327,12 +314,13 @@ void OpenGLDepthCamera::DrawLDR(GLuint destinationFBO, bool updated)
             else LinearizeDepth();
         }
                 
-        OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, linearDepthTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, linearDepthPBO);
-        glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
-        newData = true;
+        if(readback->BeginFrame())
+        {
+            OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, linearDepthTex);
+            readback->ReadTexture(0, GL_TEXTURE_2D, GL_RED, GL_FLOAT);
+            readback->EndFrame();
+            OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
+        }
     }
 }
 
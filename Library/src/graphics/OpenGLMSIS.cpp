@@ -35,6 +35,7 @@
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLReadback.h"
 
 #define MSIS_RES_FACTOR 0.1f
 
@@ -240,27 +241,9 @@ void OpenGLMSIS::UpdateTransform()
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-    //Inform sonar to run callback
-    if(newData)
-    {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            sonar->NewDataReady(src, 0);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            sonar->NewDataReady(src, 1);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
-    }
+    //Pass completed frames to the sonar callback
+    if(readback != nullptr)
+        readback->Poll();
 
     //Update rotation
     currentStep = sonar->getCurrentRotationStep();
@@ -277,18 +260,13 @@ void OpenGLMSIS::setSonar(MSIS* s)
 {
     sonar = s;
 
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, nSteps * nBins, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glGenBuffers(1, &displayPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    std::vector<GLsizeiptr> sizes;
+    sizes.push_back(viewportWidth * viewportHeight * 3);
+    sizes.push_back(nSteps * nBins);
+    readback = new OpenGLReadback(sonar, sizes);
 }
 
-void OpenGLMSIS::ComputeOutput(std::vector<Renderable>& objects)
+void OpenGLMSIS::ComputeOutput(RenderSnapshot& objects)
 {  
     OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
     content->SetDrawingMode(DrawingMode::RAW);
@@ -302,30 +280,12 @@ void OpenGLMSIS::ComputeOutput(std::vector<Renderable>& objects)
     sonarInputShader[1]->SetUniform("eyePos", GetEyePosition());
     sonarInputShader[0]->Use();
     sonarInputShader[0]->SetUniform("eyePos", GetEyePosition());
-    GLSLShader* shader;
     
     //Calculate view transform
     glm::mat4 VP = GetProjectionMatrix() * beamRotation * GetViewMatrix();
     //Draw objects
-    for(size_t i=0; i<objects.size(); ++i)
-    {
-        if(objects[i].type != RenderableType::SOLID)
-            continue;
-        const Object& obj = content->getObject(objects[i].objectId);
-        const Look& look = content->getLook(objects[i].lookId);
-        glm::mat4 M = objects[i].model;
-        Material mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(objects[i].materialName);
-        bool normalMapping = obj.texturable && (look.normalTexture > 0);
-        shader = normalMapping ? sonarInputShader[1] : sonarInputShader[0];
-        shader->Use();
-        shader->SetUniform("MVP", VP * M);
-        shader->SetUniform("M", M);
-        shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-        shader->SetUniform("restitution", (GLfloat)mat.restitution);
-        if(normalMapping)
-            OpenGLState::BindTexture(TEX_MAT_NORMAL, GL_TEXTURE_2D, look.normalTexture);
-        content->DrawObject(objects[i].objectId, objects[i].lookId, objects[i].model);
-    }
+    PrepareInputObjects(objects);
+    DrawInputObjects(VP);
     glEnable(GL_DEPTH_CLAMP);
     OpenGLState::UnbindTexture(TEX_MAT_NORMAL);
     OpenGLState::BindFramebuffer(0);
@@ -403,16 +363,15 @@ void OpenGLMSIS::DrawLDR(GLuint destinationFBO, bool updated)
     //Copy texture to sonar buffer
     if(sonar != nullptr && updated)
     {
-        OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, outputTex[1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
-        newData = true;
+        if(readback->BeginFrame())
+        {
+            OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, outputTex[1]);
+            readback->ReadTexture(1, GL_TEXTURE_2D, GL_RED, GL_UNSIGNED_BYTE);
+            OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex);
+            readback->ReadTexture(0, GL_TEXTURE_2D, GL_RGB, GL_UNSIGNED_BYTE);
+            readback->EndFrame();
+            OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
+        }
     }
 }
 
@@ -42,6 +42,7 @@
 #include "entities/forcefields/Uniform.h"
 #include "entities/forcefields/Jet.h"
 #include "entities/forcefields/Pipe.h"
+#include "entities/forcefields/OceanWaves.h"
 #ifdef EMBEDDED_RESOURCES
 #include <sstream>
 #include "ResourceHandle.h"
@@ -385,6 +386,12 @@ GLfloat OpenGLOcean::ComputeWaveHeight(GLfloat x, GLfloat y)
     return 0.f;
 }
 
+void OpenGLOcean::ComputeWaveHeights(const glm::vec3* points, GLfloat* heights, size_t n)
+{
+    for(size_t i=0; i<n; ++i)
+        heights[i] = ComputeWaveHeight(points[i].x, points[i].y);
+}
+
 GLuint OpenGLOcean::getWaveTexture()
 {
     return oceanTextures[3];
@@ -888,94 +895,10 @@ float OpenGLOcean::sqr(float x)
     return x * x;
 }
 
-float OpenGLOcean::omega(float k)
-{
-    return sqrt(9.81 * k * (1.0 + sqr(k / params.km))); // Eq 24
-}
-
 // 1/kx and 1/ky in meters
 float OpenGLOcean::spectrum(float kx, float ky, bool omnispectrum)
 {
-    float U10 = params.wind;
-    float Omega = params.omega;
-
-    // phase speed
-    float k = sqrt(kx * kx + ky * ky);
-    float c = omega(k) / k;
-
-    // spectral peak
-    float kp = 9.81 * sqr(Omega / U10); // after Eq 3
-    float cp = omega(kp) / kp;
-
-    // friction velocity
-    float z0 = 3.7e-5 * sqr(U10) / 9.81 * pow(U10 / cp, 0.9f); // Eq 66
-    float u_star = 0.41 * U10 / log(10.0 / z0); // Eq 60
-
-    float Lpm = exp(- 5.0 / 4.0 * sqr(kp / k)); // after Eq 3
-    float gamma = Omega < 1.0 ? 1.7 : 1.7 + 6.0 * log(Omega); // after Eq 3 // log10 or log??
-    float sigma = 0.08 * (1.0 + 4.0 / pow(Omega, 3.0f)); // after Eq 3
-    float Gamma = exp(-1.0 / (2.0 * sqr(sigma)) * sqr(sqrt(k / kp) - 1.0));
-    float Jp = pow(gamma, Gamma); // Eq 3
-    float Fp = Lpm * Jp * exp(- Omega / sqrt(10.0) * (sqrt(k / kp) - 1.0)); // Eq 32
-    float alphap = 0.006 * sqrt(Omega); // Eq 34
-    float Bl = 0.5 * alphap * cp / c * Fp; // Eq 31
-
-    float alpham = 0.01 * (u_star < params.cm ? 1.0 + log(u_star / params.cm) : 1.0 + 3.0 * log(u_star / params.cm)); // Eq 44
-    float Fm = exp(-0.25 * sqr(k / params.km - 1.0)); // Eq 41
-    float Bh = 0.5 * alpham * params.cm / c * Fm; // Eq 40
-
-    Bh *= Lpm; 
-
-    if (omnispectrum)
-    {
-        return params.A * (Bl + Bh) / (k * sqr(k)); // Eq 30
-    }
-
-    float a0 = log(2.0) / 4.0;
-    float ap = 4.0;
-    float am = 0.13 * u_star / params.cm; // Eq 59
-    float Delta = tanh(a0 + ap * pow(c / cp, 2.5f) + am * pow(params.cm / c, 2.5f)); // Eq 57
-
-    float phi = atan2(ky, kx);
-
-    if(params.propagate)
-    {
-        if (kx < 0.0)
-        {
-            return 0.0;
-        }
-        else
-        {
-            Bl *= 2.0;
-            Bh *= 2.0;
-        }
-    }
-
-    // remove waves perpendicular to wind dir
-    float tweak = sqrtf( std::max( kx/sqrtf(kx*kx+ky*ky), 0.f) );
-    tweak = 1.0f;
-    return params.A * (Bl + Bh) * (1.0 + Delta * cos(2.0 * phi)) / (2.0 * M_PI * sqr(sqr(k))) * tweak; // Eq 67
-}
-
-void OpenGLOcean::GetSpectrumSample(int i, int j, float lengthScale, float kMin, float *result)
-{
-    static long seed = 1234;
-    float dk = 2.0 * M_PI / lengthScale;
-    float kx = i * dk;
-    float ky = j * dk;
-    if(fabsf(kx) < kMin && fabsf(ky) < kMin)
-    {
-        result[0] = 0.0;
-        result[1] = 0.0;
-    }
-    else
-    {
-        float S = spectrum(kx, ky);
-        float h = sqrtf(S / 2.0) * dk;
-        float phi = frandom(&seed) * 2.0 * M_PI;
-        result[0] = h * cos(phi);
-        result[1] = h * sin(phi);
-    }
+    return OceanWaves::Spectrum(params, kx, ky, omnispectrum);
 }
 
 // generates the waves spectrum
@@ -988,20 +911,7 @@ void OpenGLOcean::GenerateWavesSpectrum()
     }
     params.spectrum12 = new float[params.fftSize * params.fftSize * 4];
     params.spectrum34 = new float[params.fftSize * params.fftSize * 4];
-
-    for (int y = 0; y < params.fftSize; ++y)
-    {
-        for (int x = 0; x < params.fftSize; ++x)
-        {
-            int offset = 4 * (x + y * params.fftSize);
-            int i = x >= params.fftSize / 2 ? x - params.fftSize : x;
-            int j = y >= params.fftSize / 2 ? y - params.fftSize : y;
-            GetSpectrumSample(i, j, params.gridSizes[0], M_PI / params.gridSizes[0], params.spectrum12 + offset);
-            GetSpectrumSample(i, j, params.gridSizes[1], M_PI * params.fftSize / params.gridSizes[0], params.spectrum12 + offset + 2);
-            GetSpectrumSample(i, j, params.gridSizes[2], M_PI * params.fftSize / params.gridSizes[1], params.spectrum34 + offset);
-            GetSpectrumSample(i, j, params.gridSizes[3], M_PI * params.fftSize / params.gridSizes[2], params.spectrum34 + offset + 2);
-        }
-    }
+    OceanWaves::GenerateSpectrum(params, params.spectrum12, params.spectrum34);
 }
 
 float OpenGLOcean::GetSlopeVariance(float kx, float ky, float *spectrumSample)
@@ -30,6 +30,7 @@
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLCulling.h"
 #include "graphics/OpenGLOcean.h"
 #include "graphics/OpenGLTrackball.h"
 #include "graphics/OpenGLCamera.h"
@@ -62,6 +63,8 @@ OpenGLPipeline::OpenGLPipeline(RenderSettings s, HelperSettings h) : rSettings(s
     OpenGLSonar::Init();
     OpenGLOceanParticles::Init();
     content = new OpenGLContent();
+    culling = new OpenGLCulling();
+    visibleValid = false;
     
     //Create display framebuffer
     glGenFramebuffers(1, &screenFBO);
@@ -89,6 +92,7 @@ OpenGLPipeline::~OpenGLPipeline()
     OpenGLSonar::Destroy();
     OpenGLOceanParticles::Destroy();
     OpenGLLight::Destroy();
+    delete culling;
     delete content;
     
     glDeleteTextures(1, &screenTex);
@@ -121,29 +125,29 @@ OpenGLContent* OpenGLPipeline::getContent()
     return content;
 }
 
-void OpenGLPipeline::AddToDrawingQueue(const Renderable& r)
+OpenGLCulling* OpenGLPipeline::getCulling()
 {
-    drawingQueue.push_back(r);
+    return culling;
 }
 
-void OpenGLPipeline::AddToDrawingQueue(const std::vector<Renderable>& r)
+RenderSnapshot& OpenGLPipeline::getDrawingQueue()
 {
-    drawingQueue.insert(drawingQueue.end(), r.begin(), r.end());
+    return drawingQueue;
 }
 
-void OpenGLPipeline::AddToSelectedDrawingQueue(const std::vector<Renderable>& r)
+RenderSnapshot& OpenGLPipeline::getSelectedDrawingQueue()
 {
-    selectedDrawingQueue.insert(selectedDrawingQueue.end(), r.begin(), r.end());
+    return selectedDrawingQueue;
 }
 
 void OpenGLPipeline::PurgeDrawingQueue()
 {
-    drawingQueue.clear();
+    drawingQueue.Clear();
 }
 
 void OpenGLPipeline::PurgeSelectedDrawingQueue()
 {
-    selectedDrawingQueue.clear();
+    selectedDrawingQueue.Clear();
 }
 
 bool OpenGLPipeline::isDrawingQueueEmpty()
@@ -155,13 +159,10 @@ void OpenGLPipeline::PerformDrawingQueueCopy(SimulationManager* sim)
 {
     if(!drawingQueue.empty())
     {
-        drawingQueueCopy.clear();
-        selectedDrawingQueueCopy.clear();
-
         SDL_LockMutex(drawingQueueMutex);
-        //Double buffering
-        drawingQueueCopy.insert(drawingQueueCopy.end(), drawingQueue.begin(), drawingQueue.end());
-        selectedDrawingQueueCopy.insert(selectedDrawingQueueCopy.end(), selectedDrawingQueue.begin(), selectedDrawingQueue.end());
+        //Double buffering (the buffers are exchanged, so that the memory of both is reused)
+        drawingQueueCopy.Swap(drawingQueue);
+        selectedDrawingQueueCopy.Swap(selectedDrawingQueue);
 
         //Update vision sensor transforms and copy generated data to ensure consistency
         glMemoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT);
@@ -175,12 +176,16 @@ void OpenGLPipeline::PerformDrawingQueueCopy(SimulationManager* sim)
         if(ocean != NULL) ocean->UpdateCurrentsData();
 
         //Enable update of drawing queue by clearing old queue
-        drawingQueue.clear(); 
-        selectedDrawingQueue.clear();
+        drawingQueue.Clear(); 
+        selectedDrawingQueue.Clear();
         SDL_UnlockMutex(drawingQueueMutex);
 			
 		//Sort objects by material to reduce uniform/texture switching
-        std::sort(drawingQueueCopy.begin(), drawingQueueCopy.end(), Renderable::SortByMaterial);
+        drawingQueueCopy.SortByMaterial();
+        
+        //Compute bounding spheres for culling
+        culling->Update(drawingQueueCopy, content);
+        visibleValid = false;
     }
 }
 
@@ -193,10 +198,23 @@ void OpenGLPipeline::DrawDisplay()
 
 void OpenGLPipeline::DrawObjects()
 {
-    for(size_t i=0; i<drawingQueueCopy.size(); ++i)
+    //Visible list is reused by the consecutive passes of the same view
+    glm::mat4 VP = content->GetViewProjectionMatrix();
+    if(!visibleValid || VP != visibleVP)
+    {
+        culling->CullFrustum(VP, visibleObjects);
+        visibleVP = VP;
+        visibleValid = true;
+    }
+    DrawObjects(visibleObjects);
+}
+
+void OpenGLPipeline::DrawObjects(const std::vector<GLuint>& visible)
+{
+    for(size_t i=0; i<visible.size(); ++i)
     {
-		if(drawingQueueCopy[i].type == RenderableType::SOLID)
-			content->DrawObject(drawingQueueCopy[i].objectId, drawingQueueCopy[i].lookId, drawingQueueCopy[i].model);
+        const Renderable& r = drawingQueueCopy[culling->getItem(visible[i])];
+        content->DrawObject(r.objectId, r.lookId, r.model);
     }
 }
 
@@ -226,11 +244,11 @@ void OpenGLPipeline::DrawHelpers()
         for(size_t h=0; h<drawingQueueCopy.size(); ++h)
         {
             if(drawingQueueCopy[h].type == RenderableType::MULTIBODY_AXIS)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
             else if(drawingQueueCopy[h].type == RenderableType::JOINT_LINES)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
             else if(drawingQueueCopy[h].type == RenderableType::PATH_LINE_STRIP)
-                content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,0.5f,1.f,1.f), drawingQueueCopy[h].model);
         }
     }
     
@@ -242,11 +260,11 @@ void OpenGLPipeline::DrawHelpers()
             if(drawingQueueCopy[h].type == RenderableType::SENSOR_CS)
                 content->DrawCoordSystem(drawingQueueCopy[h].model, 0.25f);
             else if(drawingQueueCopy[h].type == RenderableType::SENSOR_POINTS)
-                content->DrawPrimitives(PrimitiveType::POINTS, drawingQueueCopy[h].points, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::POINTS, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
             else if(drawingQueueCopy[h].type == RenderableType::SENSOR_LINES)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
             else if(drawingQueueCopy[h].type == RenderableType::SENSOR_LINE_STRIP)
-                content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy[h].points, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,1.f,0,1.f), drawingQueueCopy[h].model);
         }
     }
     
@@ -256,7 +274,7 @@ void OpenGLPipeline::DrawHelpers()
         for(size_t h=0; h<drawingQueueCopy.size(); ++h)
         {
             if(drawingQueueCopy[h].type == RenderableType::ACTUATOR_LINES)
-                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.5f,0,1.f), drawingQueueCopy[h].model);
+                content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,0.5f,0,1.f), drawingQueueCopy[h].model);
         }
     }
     
@@ -272,23 +290,23 @@ void OpenGLPipeline::DrawHelpers()
                     break;
                     
                 case RenderableType::HYDRO_CYLINDER:
-                    content->DrawCylinder(drawingQueueCopy[h].model, drawingQueueCopy[h].points[0], glm::vec4(0.2f, 0.5f, 1.f, 1.f));
+                    content->DrawCylinder(drawingQueueCopy[h].model, drawingQueueCopy.getPoints(drawingQueueCopy[h])[0], glm::vec4(0.2f, 0.5f, 1.f, 1.f));
                     break;
                     
                 case RenderableType::HYDRO_ELLIPSOID:
-                    content->DrawEllipsoid(drawingQueueCopy[h].model, drawingQueueCopy[h].points[0], glm::vec4(0.2f, 0.5f, 1.f, 1.f));
+                    content->DrawEllipsoid(drawingQueueCopy[h].model, drawingQueueCopy.getPoints(drawingQueueCopy[h])[0], glm::vec4(0.2f, 0.5f, 1.f, 1.f));
                     break;
                     
                 case RenderableType::HYDRO_POINTS:
-                    content->DrawPrimitives(PrimitiveType::POINTS, drawingQueueCopy[h].points, glm::vec4(0.3f, 0.7f, 1.f, 1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::POINTS, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(0.3f, 0.7f, 1.f, 1.f), drawingQueueCopy[h].model);
                     break;
                     
                 case RenderableType::HYDRO_LINES:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(0.2f, 0.5f, 1.f, 1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(0.2f, 0.5f, 1.f, 1.f), drawingQueueCopy[h].model);
                     break;
                     
                 case RenderableType::HYDRO_LINE_STRIP:
-                    content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy[h].points, glm::vec4(0.2f, 0.5f, 1.f, 1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINE_STRIP, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(0.2f, 0.5f, 1.f, 1.f), drawingQueueCopy[h].model);
                     break;
                     
                 default:
@@ -305,15 +323,15 @@ void OpenGLPipeline::DrawHelpers()
             switch(drawingQueueCopy[h].type)
             {
                 case RenderableType::FORCE_BUOYANCY:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(0.f,0.f,1.f,1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(0.f,0.f,1.f,1.f), drawingQueueCopy[h].model);
                     break;
         
                 case RenderableType::FORCE_LINEAR_DRAG:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(0.f,1.f,1.f,1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(0.f,1.f,1.f,1.f), drawingQueueCopy[h].model);
                     break;
                     
                 case RenderableType::FORCE_QUADRATIC_DRAG:
-                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy[h].points, glm::vec4(1.f,0.f,1.f,1.f), drawingQueueCopy[h].model);
+                    content->DrawPrimitives(PrimitiveType::LINES, drawingQueueCopy.getPoints(drawingQueueCopy[h]), drawingQueueCopy[h].numPoints, glm::vec4(1.f,0.f,1.f,1.f), drawingQueueCopy[h].model);
                     break;
         
                 default:
@@ -0,0 +1,249 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OpenGLReadback.cpp
+//  Stonefish
+//
+
+#include "graphics/OpenGLReadback.h"
+
+#include <SDL2/SDL_timer.h>
+#include "sensors/vision/Camera.h"
+
+namespace sf
+{
+
+OpenGLReadback::Frame OpenGLReadback::queue[READBACK_QUEUE_SIZE];
+std::atomic<size_t> OpenGLReadback::queueHead(0);
+std::atomic<size_t> OpenGLReadback::queueTail(0);
+std::atomic<size_t> OpenGLReadback::queueDone(0);
+SDL_Thread* OpenGLReadback::consumer = nullptr;
+SDL_sem* OpenGLReadback::consumerSem = nullptr;
+std::atomic<bool> OpenGLReadback::consumerQuit(false);
+unsigned int OpenGLReadback::numOfReadbacks = 0;
+
+OpenGLReadback::OpenGLReadback(Camera* sensor, const std::vector<GLsizeiptr>& sizes, unsigned int firstIndex)
+    : sensor(sensor), sizes(sizes), firstIndex(firstIndex), slots(READBACK_NUM_SLOTS), head(0), tail(0), inFlight(0), cancelled(false)
+{
+    //Persistent mapping requires buffer storage (OpenGL 4.4)
+    persistent = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+    GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    
+    for(size_t h=0; h<slots.size(); ++h)
+    {
+        Slot& s = slots[h];
+        s.pbos.resize(sizes.size());
+        s.data.assign(sizes.size(), nullptr);
+        s.fence = NULL;
+        s.state = FREE;
+        
+        glGenBuffers((GLsizei)sizes.size(), s.pbos.data());
+        for(size_t i=0; i<sizes.size(); ++i)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbos[i]);
+            if(persistent)
+            {
+                glBufferStorage(GL_PIXEL_PACK_BUFFER, sizes[i], NULL, flags);
+                s.data[i] = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizes[i], flags);
+            }
+            else
+                glBufferData(GL_PIXEL_PACK_BUFFER, sizes[i], NULL, GL_STREAM_READ);
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    if(numOfReadbacks++ == 0)
+        StartConsumer();
+}
+
+OpenGLReadback::~OpenGLReadback()
+{
+    //Frames waiting in the queue are released without running the callbacks
+    cancelled = true;
+    while(inFlight > 0)
+        SDL_Delay(1);
+    
+    for(size_t h=0; h<slots.size(); ++h)
+    {
+        if(slots[h].fence != NULL)
+            glDeleteSync(slots[h].fence);
+        glDeleteBuffers((GLsizei)slots[h].pbos.size(), slots[h].pbos.data()); //Buffers are unmapped when deleted
+    }
+    
+    if(--numOfReadbacks == 0)
+        StopConsumer();
+}
+
+bool OpenGLReadback::BeginFrame()
+{
+    Slot& s = slots[tail];
+    if(s.state != FREE) //All buffers in flight
+        return false;
+    s.state = RECORDING;
+    return true;
+}
+
+void OpenGLReadback::ReadTexture(unsigned int image, GLenum target, GLenum format, GLenum type)
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[tail].pbos[image]);
+    glGetTexImage(target, 0, format, type, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void OpenGLReadback::EndFrame()
+{
+    Slot& s = slots[tail];
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s.state = PENDING;
+    tail = (tail + 1) % (unsigned int)slots.size();
+}
+
+void OpenGLReadback::Poll()
+{
+    unsigned int n = (unsigned int)slots.size();
+    
+    //Recycle the buffers released by the consumer (in order)
+    for(unsigned int i=0; i<n && slots[head].state == CONSUMED; ++i)
+    {
+        Slot& s = slots[head];
+        if(!persistent)
+        {
+            for(size_t h=0; h<s.pbos.size(); ++h)
+            {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbos[h]);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                s.data[h] = nullptr;
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+        s.state = FREE;
+        head = (head + 1) % n;
+    }
+    
+    //Pass the completed frames to the consumer (in order, without waiting for the GPU)
+    for(unsigned int i=0, k=head; i<n; ++i, k=(k+1)%n)
+    {
+        Slot& s = slots[k];
+        unsigned int state = s.state;
+        if(state == QUEUED || state == CONSUMED)
+            continue;
+        if(state != PENDING)
+            break;
+        
+        if(s.fence != NULL)
+        {
+            GLenum result = glClientWaitSync(s.fence, 0, 0);
+            if(result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                break;
+            glDeleteSync(s.fence);
+            s.fence = NULL;
+            
+            if(!persistent)
+            {
+                for(size_t h=0; h<s.pbos.size(); ++h)
+                {
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbos[h]);
+                    s.data[h] = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizes[h], GL_MAP_READ_BIT);
+                }
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            }
+        }
+        
+        s.state = QUEUED;
+        ++inFlight;
+        if(!Enqueue({this, &s})) //Queue full --> retry in the next frame
+        {
+            s.state = PENDING;
+            --inFlight;
+            break;
+        }
+    }
+}
+
+void OpenGLReadback::Consume(Slot* slot)
+{
+    if(!cancelled)
+        for(size_t i=0; i<slot->data.size(); ++i)
+            if(slot->data[i] != nullptr)
+                sensor->NewDataReady(slot->data[i], firstIndex + (unsigned int)i);
+    
+    slot->state = CONSUMED;
+    --inFlight; //The readback can be destroyed after this point
+}
+
+void OpenGLReadback::Drain()
+{
+    if(consumer == nullptr)
+        return;
+    while(queueDone.load() != queueTail.load())
+        SDL_Delay(1);
+}
+
+bool OpenGLReadback::Enqueue(const Frame& frame)
+{
+    //Single producer (rendering thread), single consumer
+    size_t t = queueTail.load(std::memory_order_relaxed);
+    if(t - queueHead.load(std::memory_order_acquire) >= READBACK_QUEUE_SIZE)
+        return false;
+    queue[t & (READBACK_QUEUE_SIZE - 1)] = frame;
+    queueTail.store(t + 1, std::memory_order_release);
+    SDL_SemPost(consumerSem);
+    return true;
+}
+
+void OpenGLReadback::StartConsumer()
+{
+    queueHead = 0;
+    queueTail = 0;
+    queueDone = 0;
+    consumerQuit = false;
+    consumerSem = SDL_CreateSemaphore(0);
+    consumer = SDL_CreateThread(OpenGLReadback::ConsumerLoop, "readbackThread", NULL);
+}
+
+void OpenGLReadback::StopConsumer()
+{
+    consumerQuit = true;
+    SDL_SemPost(consumerSem);
+    int status;
+    SDL_WaitThread(consumer, &status);
+    consumer = nullptr;
+    SDL_DestroySemaphore(consumerSem);
+    consumerSem = nullptr;
+}
+
+int OpenGLReadback::ConsumerLoop(void* data)
+{
+    while(true)
+    {
+        SDL_SemWait(consumerSem);
+        if(consumerQuit)
+            break;
+        
+        size_t h = queueHead.load(std::memory_order_relaxed);
+        if(h == queueTail.load(std::memory_order_acquire))
+            continue;
+        Frame frame = queue[h & (READBACK_QUEUE_SIZE - 1)];
+        queueHead.store(h + 1, std::memory_order_release);
+        frame.readback->Consume(frame.slot);
+        ++queueDone;
+    }
+    return 0;
+}
+
+}
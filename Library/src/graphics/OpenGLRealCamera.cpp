@@ -31,6 +31,7 @@
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLReadback.h"
 
 namespace sf
 {
@@ -41,7 +42,7 @@ OpenGLRealCamera::OpenGLRealCamera(glm::vec3 eyePosition, glm::vec3 direction, g
                                    : OpenGLCamera(x, y, width, height, range)
 {
     _needsUpdate = false;
-    newData = false;
+    readback = nullptr;
     continuous = continuousUpdate;
     camera = NULL;
     cameraFBO = 0;
@@ -61,7 +62,7 @@ OpenGLRealCamera::~OpenGLRealCamera()
     if(camera != NULL)
     {
         glDeleteFramebuffers(1, &cameraFBO);
-        glDeleteBuffers(1, &cameraPBO);
+        delete readback;
         glDeleteTextures(2, cameraColorTex);
     }
 }
@@ -102,10 +103,7 @@ void OpenGLRealCamera::setCamera(ColorCamera* cam)
     textures.push_back(FBOTexture(GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, cameraColorTex[1]));
     cameraFBO = OpenGLContent::GenerateFramebuffer(textures);
     
-    glGenBuffers(1, &cameraPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback = new OpenGLReadback(camera, std::vector<GLsizeiptr>(1, viewportWidth * viewportHeight * 3));
 }
 
 glm::vec3 OpenGLRealCamera::GetEyePosition() const
@@ -141,19 +139,9 @@ void OpenGLRealCamera::UpdateTransform()
     viewUBOData.eye = GetEyePosition();
     ExtractFrustumFromVP(viewUBOData.frustum, viewUBOData.VP);
 
-    //Inform camera to run callback
-    if(newData)
-    {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            camera->NewDataReady(src);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
-    }
+    //Pass completed frames to the camera callback
+    if(readback != nullptr)
+        readback->Poll();
 }
 
 void OpenGLRealCamera::SetupCamera()
@@ -202,12 +190,6 @@ void OpenGLRealCamera::DrawLDR(GLuint destinationFBO, bool updated)
                 ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->DrawSAQ();
                 OpenGLState::UseProgram(0);
                 OpenGLState::BindFramebuffer(0);
-
-                OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, cameraColorTex[1]);
-                glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-                glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-                OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
             }
             else
             {
@@ -230,12 +212,6 @@ void OpenGLRealCamera::DrawLDR(GLuint destinationFBO, bool updated)
                 ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->DrawSAQ();
                 OpenGLState::UseProgram(0);
                 OpenGLState::BindFramebuffer(0);
-
-                OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, cameraColorTex[1]);
-                glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-                glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-                OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
             }
         }
         else
@@ -250,15 +226,16 @@ void OpenGLRealCamera::DrawLDR(GLuint destinationFBO, bool updated)
             ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->DrawSAQ();
             OpenGLState::UseProgram(0);
             OpenGLState::BindFramebuffer(0);
-
+        }
+        
+        //Copy the final image to the readback buffer
+        if(readback->BeginFrame())
+        {
             OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, cameraColorTex[1]);
-            glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            readback->ReadTexture(0, GL_TEXTURE_2D, GL_RGB, GL_UNSIGNED_BYTE);
+            readback->EndFrame();
             OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         }
-        
-        newData = true;
     }
 }
 
@@ -33,6 +33,7 @@
 #include "graphics/OpenGLAtmosphere.h"
 #include "graphics/OpenGLConsole.h"
 #include "utils/SystemUtil.hpp"
+#include "entities/forcefields/OceanWaves.h"
 
 namespace sf
 {
@@ -245,43 +246,7 @@ void OpenGLRealOcean::InitializeSimulation()
 
 GLfloat OpenGLRealOcean::ComputeInterpolatedWaveData(GLfloat x, GLfloat y, GLuint channel)
 {
-    //BILINEAR INTERPOLATION ACCORDING TO OPENGL SPECIFICATION (4.5)
-    //Calculate pixel cooridnates
-    //x and y are already divided by the phyiscal dimensions of the texture (represented area in [m])
-    //so they are directly texture coordinates
-    float tmp;
-    
-    //First coordinate pair
-    float i0f = modff(x - 0.5f/(float)params.fftSize, &tmp);
-    float j0f = modff(y - 0.5f/(float)params.fftSize, &tmp);
-    if(i0f < 0.f) i0f = 1.f - fabsf(i0f);
-    if(j0f < 0.f) j0f = 1.f - fabsf(j0f);
-    int i0 = (int)truncf(i0f * (float)params.fftSize);
-    int j0 = (int)truncf(j0f * (float)params.fftSize);
-    
-    //Second coordinate pair
-    float i1f = modff(x + 0.5f/(float)params.fftSize, &tmp);
-    float j1f = modff(y + 0.5f/(float)params.fftSize, &tmp);
-    if(i1f < 0.f) i1f = 1.f - fabsf(i1f);
-    if(j1f < 0.f) j1f = 1.f - fabsf(j1f);
-    int i1 = (int)truncf(i1f * (float)params.fftSize);
-    int j1 = (int)truncf(j1f * (float)params.fftSize);
-    
-    //Calculate weigths
-    float alpha = modff(i0f * (float)params.fftSize, &tmp);
-    float beta = modff(j0f * (float)params.fftSize, &tmp);
-    
-    //Get texel values
-    float t[4];
-    t[0] = fftData[(j0 * params.fftSize + i0) * 4 + channel];
-    t[1] = fftData[(j0 * params.fftSize + i1) * 4 + channel];
-    t[2] = fftData[(j1 * params.fftSize + i0) * 4 + channel];
-    t[3] = fftData[(j1 * params.fftSize + i1) * 4 + channel];
-    
-    //Interpolate
-    float h = (1.f - alpha)*(1.f - beta)*t[0] + alpha*(1.f - beta)*t[1] + (1.f - alpha)*beta*t[2] + alpha*beta*t[3];
-    
-    return h;
+    return OceanWaves::InterpolateWaveData(fftData, params.fftSize, x, y, channel);
 }
     
 GLfloat OpenGLRealOcean::ComputeWaveHeight(GLfloat x, GLfloat y)
@@ -296,6 +261,11 @@ GLfloat OpenGLRealOcean::ComputeWaveHeight(GLfloat x, GLfloat y)
     return z;
 }
 
+void OpenGLRealOcean::ComputeWaveHeights(const glm::vec3* points, GLfloat* heights, size_t n)
+{
+    OceanWaves::SampleWaveHeights(fftData, params, points, heights, n);
+}
+
 void OpenGLRealOcean::Simulate(GLfloat dt)
 {
     if(SDL_TryLockMutex(hydroMutex) == 0)
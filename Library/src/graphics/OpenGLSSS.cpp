@@ -35,6 +35,7 @@
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLReadback.h"
 
 #define SSS_VRES_FACTOR 0.2f
 #define SSS_HRES_FACTOR 100.f
@@ -226,27 +227,9 @@ void OpenGLSSS::UpdateTransform()
         projection[3] = glm::vec4(0.f, 0.f, -2.f*far*near/(far-near), 0.f);
     }
 
-    //Inform sonar to run callback
-    if(newData)
-    {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            sonar->NewDataReady(src, 0);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            sonar->NewDataReady(src, 1);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
-    }
+    //Pass completed frames to the sonar callback
+    if(readback != nullptr)
+        readback->Poll();
 }
 
 void OpenGLSSS::setNoise(glm::vec2 signalStdDev)
@@ -258,18 +241,13 @@ void OpenGLSSS::setSonar(SSS* s)
 {
     sonar = s;
 
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glGenBuffers(1, &displayPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    std::vector<GLsizeiptr> sizes;
+    sizes.push_back(viewportWidth * viewportHeight * 3);
+    sizes.push_back(viewportWidth * viewportHeight);
+    readback = new OpenGLReadback(sonar, sizes);
 }
 
-void OpenGLSSS::ComputeOutput(std::vector<Renderable>& objects)
+void OpenGLSSS::ComputeOutput(RenderSnapshot& objects)
 {
     OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
     content->SetDrawingMode(DrawingMode::RAW);
@@ -281,7 +259,7 @@ void OpenGLSSS::ComputeOutput(std::vector<Renderable>& objects)
     sonarInputShader[1]->SetUniform("eyePos", GetEyePosition());
     sonarInputShader[0]->Use();
     sonarInputShader[0]->SetUniform("eyePos", GetEyePosition());
-    GLSLShader* shader;
+    PrepareInputObjects(objects);
     for(size_t i=0; i<2; ++i) //For each of the sonar views
     {
         //Compute matrices
@@ -290,25 +268,7 @@ void OpenGLSSS::ComputeOutput(std::vector<Renderable>& objects)
         glDrawBuffer(GL_COLOR_ATTACHMENT0 + (GLuint)i);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         //Draw objects
-        for(size_t h=0; h<objects.size(); ++h)
-        {
-            if(objects[h].type != RenderableType::SOLID)
-                continue;
-            const Object& obj = content->getObject(objects[h].objectId);
-            const Look& look = content->getLook(objects[h].lookId);
-            glm::mat4 M = objects[h].model;
-            Material mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(objects[h].materialName);
-            bool normalMapping = obj.texturable && (look.normalTexture > 0);
-            shader = normalMapping ? sonarInputShader[1] : sonarInputShader[0];
-            shader->Use();
-            shader->SetUniform("MVP", VP * M);
-            shader->SetUniform("M", M);
-            shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-            shader->SetUniform("restitution", (GLfloat)mat.restitution);
-            if(normalMapping)
-                OpenGLState::BindTexture(TEX_MAT_NORMAL, GL_TEXTURE_2D, look.normalTexture);
-            content->DrawObject(objects[h].objectId, objects[h].lookId, objects[h].model);
-        }
+        DrawInputObjects(VP);
     }
     glEnable(GL_DEPTH_CLAMP);
     OpenGLState::UnbindTexture(TEX_MAT_NORMAL);
@@ -399,16 +359,15 @@ void OpenGLSSS::DrawLDR(GLuint destinationFBO, bool updated)
     //Copy texture to sonar buffer
     if(sonar != nullptr && updated)
     {
-        OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, outputTex[pingpong+1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
-        newData = true;
+        if(readback->BeginFrame())
+        {
+            OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, outputTex[pingpong+1]);
+            readback->ReadTexture(1, GL_TEXTURE_2D, GL_RED, GL_UNSIGNED_BYTE);
+            OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex);
+            readback->ReadTexture(0, GL_TEXTURE_2D, GL_RGB, GL_UNSIGNED_BYTE);
+            readback->EndFrame();
+            OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
+        }
     }
 }
    
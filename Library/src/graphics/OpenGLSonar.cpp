@@ -33,11 +33,14 @@
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "graphics/OpenGLCulling.h"
+#include "graphics/OpenGLReadback.h"
 
 namespace sf
 {
 
 GLSLShader* OpenGLSonar::sonarInputShader[2] = {nullptr, nullptr};
+GLSLUniformHandle OpenGLSonar::sonarInputUniforms[2][4];
 GLSLShader* OpenGLSonar::sonarVisualizeShader = nullptr;
 
 OpenGLSonar::OpenGLSonar(glm::vec3 eyePosition, glm::vec3 direction, glm::vec3 sonarUp, glm::uvec2 displayResolution, glm::vec2 range_)
@@ -45,12 +48,10 @@ OpenGLSonar::OpenGLSonar(glm::vec3 eyePosition, glm::vec3 direction, glm::vec3 s
 {
     _needsUpdate = false;
     continuous = false;
-    newData = false;
     range = range_;
     gain = 1.f;
     settingsUpdated = true;
-    outputPBO = 0;
-    displayPBO = 0;
+    readback = nullptr;
     cMap = ColorMap::GREEN_BLUE;
     SetupSonar(eyePosition, direction, sonarUp);
 }
@@ -64,8 +65,7 @@ OpenGLSonar::~OpenGLSonar()
     glDeleteFramebuffers(1, &displayFBO);
     glDeleteVertexArrays(1, &displayVAO);
     glDeleteBuffers(1, &displayVBO);
-    if(outputPBO != 0) glDeleteBuffers(1, &outputPBO);
-    if(displayPBO != 0) glDeleteBuffers(1, &displayPBO);
+    if(readback != nullptr) delete readback;
 }
 
 void OpenGLSonar::SetupSonar(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -144,6 +144,49 @@ ViewType OpenGLSonar::getType()
     return ViewType::SONAR;
 }
 
+void OpenGLSonar::PrepareInputObjects(const RenderSnapshot& objects)
+{
+    OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
+    MaterialManager* mm = SimulationApp::getApp()->getSimulationManager()->getMaterialManager();
+    
+    OpenGLCulling* culling = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getCulling();
+    
+    inputObjects.clear();
+    for(size_t i=0; i<culling->getCount(); ++i)
+    {
+        const Renderable& r = objects[culling->getItem((GLuint)i)];
+        SonarInputObject obj;
+        obj.objectId = r.objectId;
+        obj.normalTexture = 0;
+        if(r.lookId >= 0 && content->getObject(obj.objectId).texturable)
+            obj.normalTexture = content->getLook(r.lookId).normalTexture;
+        obj.M = r.model;
+        obj.N = glm::mat3(glm::transpose(glm::inverse(obj.M)));
+        obj.restitution = (GLfloat)mm->getMaterial(r.materialId).restitution;
+        inputObjects.push_back(obj);
+    }
+}
+
+void OpenGLSonar::DrawInputObjects(const glm::mat4& VP)
+{
+    OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
+    ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getCulling()->CullFrustum(VP, visibleObjects);
+    
+    for(size_t i=0; i<visibleObjects.size(); ++i)
+    {
+        const SonarInputObject& obj = inputObjects[visibleObjects[i]];
+        size_t s = obj.normalTexture > 0 ? 1 : 0;
+        sonarInputShader[s]->Use();
+        sonarInputShader[s]->SetUniform(sonarInputUniforms[s][0], VP * obj.M);
+        sonarInputShader[s]->SetUniform(sonarInputUniforms[s][1], obj.M);
+        sonarInputShader[s]->SetUniform(sonarInputUniforms[s][2], obj.N);
+        sonarInputShader[s]->SetUniform(sonarInputUniforms[s][3], obj.restitution);
+        if(obj.normalTexture > 0)
+            OpenGLState::BindTexture(TEX_MAT_NORMAL, GL_TEXTURE_2D, obj.normalTexture);
+        content->DrawObject(obj.objectId, -1, obj.M);
+    }
+}
+
 ///////////////////////// Static /////////////////////////////
 void OpenGLSonar::Init()
 {
@@ -165,6 +208,14 @@ void OpenGLSonar::Init()
     sonarInputShader[1]->SetUniform("texNormal", TEX_MAT_NORMAL);
     OpenGLState::UseProgram(0);
     
+    for(size_t i=0; i<2; ++i)
+    {
+        sonarInputUniforms[i][0] = sonarInputShader[i]->getUniformHandle("MVP", ParameterType::MAT4);
+        sonarInputUniforms[i][1] = sonarInputShader[i]->getUniformHandle("M", ParameterType::MAT4);
+        sonarInputUniforms[i][2] = sonarInputShader[i]->getUniformHandle("N", ParameterType::MAT3);
+        sonarInputUniforms[i][3] = sonarInputShader[i]->getUniformHandle("restitution", ParameterType::FLOAT);
+    }
+    
     sonarVisualizeShader = new GLSLShader("sonarVisualize.frag", "printer.vert");
     sonarVisualizeShader->AddUniform("texSonarData", ParameterType::INT);
     sonarVisualizeShader->AddUniform("colormap", ParameterType::INT);
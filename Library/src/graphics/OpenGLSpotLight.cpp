@@ -31,6 +31,7 @@
 #include "graphics/GLSLShader.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLPipeline.h"
+#include "graphics/OpenGLCulling.h"
 #include "graphics/OpenGLCamera.h"
 
 namespace sf
@@ -168,7 +169,8 @@ void OpenGLSpotLight::BakeShadowmap(OpenGLPipeline* pipe)
     glClear(GL_DEPTH_BUFFER_BIT);
     //glEnable(GL_POLYGON_OFFSET_FILL);
     //glPolygonOffset(4.0f, 32.0f);
-    pipe->DrawObjects();
+    pipe->getCulling()->CullCone(getPosition(), getDirection(), coneAngle/2.f, zFar, visibleObjects);
+    pipe->DrawObjects(visibleObjects);
     //glDisable(GL_POLYGON_OFFSET_FILL);
     OpenGLState::BindFramebuffer(0);
 }
@@ -195,7 +195,7 @@ void OpenGLTrackball::GlueToMoving(MovingEntity* ent)
     holdingEntity = ent;
 }
 
-void OpenGLTrackball::DrawSelection(const std::vector<Renderable>& r, GLuint destinationFBO)
+void OpenGLTrackball::DrawSelection(const RenderSnapshot& r, GLuint destinationFBO)
 {
     if(r.size() == 0) //No selection
         return;
@@ -82,22 +82,16 @@ JointType FixedJoint::getType()
     return JOINT_FIXED;
 }
     
-std::vector<Renderable> FixedJoint::Render()
+void FixedJoint::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    Renderable item;
-    item.model = glm::mat4(1.f);
-    item.type = RenderableType::JOINT_LINES;
+    snapshot.Add(RenderableType::JOINT_LINES);
     
     btTypedConstraint* revo = getConstraint();
     Vector3 A = revo->getRigidBodyA().getCenterOfMassPosition();
     Vector3 B = revo->getRigidBodyB().getCenterOfMassPosition();
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    items.push_back(item);
-    
-    return items;
+    snapshot.AddPoint(glm::vec3(A.getX(), A.getY(), A.getZ()));
+    snapshot.AddPoint(glm::vec3(B.getX(), B.getY(), B.getZ()));
 }
 
 }
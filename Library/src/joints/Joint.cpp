@@ -129,10 +129,8 @@ bool Joint::SolvePositionIC(Scalar linearTolerance, Scalar angularTolerance)
     return true; //Nothing to solve
 }
 
-std::vector<Renderable> Joint::Render()
+void Joint::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    return items;
 }
     
 }
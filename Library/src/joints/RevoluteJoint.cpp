@@ -150,12 +150,9 @@ bool RevoluteJoint::SolvePositionIC(Scalar linearTolerance, Scalar angularTolera
     return false;
 }
 
-std::vector<Renderable> RevoluteJoint::Render()
+void RevoluteJoint::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    Renderable item;
-    item.model = glm::mat4(1.f);
-    item.type = RenderableType::JOINT_LINES;
+    snapshot.Add(RenderableType::JOINT_LINES);
     
     btTypedConstraint* revo = getConstraint();
     Vector3 A = revo->getRigidBodyA().getCenterOfMassPosition();
@@ -169,17 +166,13 @@ std::vector<Renderable> RevoluteJoint::Render()
     Vector3 C1 = pivot + e1 * axis;
     Vector3 C2 = pivot + e2 * axis;
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    item.points.push_back(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
+    snapshot.AddPoint(glm::vec3(A.getX(), A.getY(), A.getZ()));
+    snapshot.AddPoint(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
+    snapshot.AddPoint(glm::vec3(B.getX(), B.getY(), B.getZ()));
+    snapshot.AddPoint(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
     
-    item.points.push_back(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
-    item.points.push_back(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
-    
-    items.push_back(item);
-    
-    return items;
+    snapshot.AddPoint(glm::vec3(C1.getX(), C1.getY(), C1.getZ()));
+    snapshot.AddPoint(glm::vec3(C2.getX(), C2.getY(), C2.getZ()));
 }
     
 }
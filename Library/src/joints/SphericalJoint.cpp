@@ -95,25 +95,19 @@ void SphericalJoint::ApplyDamping()
     }
 }
 
-std::vector<Renderable> SphericalJoint::Render()
+void SphericalJoint::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
-    Renderable item;
-    item.model = glm::mat4(1.f);
-    item.type = RenderableType::JOINT_LINES;
+    snapshot.Add(RenderableType::JOINT_LINES);
     
     btPoint2PointConstraint* p2p = (btPoint2PointConstraint*)getConstraint();
     Vector3 pivot = p2p->getRigidBodyA().getCenterOfMassTransform()(p2p->getPivotInA());
     Vector3 A = p2p->getRigidBodyA().getCenterOfMassPosition();
     Vector3 B = p2p->getRigidBodyB().getCenterOfMassPosition();
     
-    item.points.push_back(glm::vec3(A.getX(), A.getY(), A.getZ()));
-    item.points.push_back(glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
-    item.points.push_back(glm::vec3(B.getX(), B.getY(), B.getZ()));
-    item.points.push_back(glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
-    
-    items.push_back(item);
-    return items;
+    snapshot.AddPoint(glm::vec3(A.getX(), A.getY(), A.getZ()));
+    snapshot.AddPoint(glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
+    snapshot.AddPoint(glm::vec3(B.getX(), B.getY(), B.getZ()));
+    snapshot.AddPoint(glm::vec3(pivot.getX(), pivot.getY(), pivot.getZ()));
 }
 
 }
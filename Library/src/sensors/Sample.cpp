@@ -43,6 +43,15 @@ Sample::Sample(unsigned short nDimensions, Scalar* values, bool invalid, uint64_
         timestamp = SimulationApp::getApp()->getSimulationManager()->getSimulationTime();
 }
 
+Sample::Sample(Scalar t, unsigned short nDimensions, const Scalar* values, uint64_t index)
+{
+    nDim = nDimensions > 0 ? nDimensions : 1;
+    data = new Scalar[nDim];
+    std::memcpy(data, values, sizeof(Scalar)*nDim);
+    id = index;
+    timestamp = t;
+}
+
 Sample::Sample(const Sample& other, uint64_t index)
 {
     timestamp = other.timestamp;
@@ -0,0 +1,217 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SampleBuffer.cpp
+//  Stonefish
+//
+
+#include "sensors/SampleBuffer.h"
+
+#include <cstring>
+
+//Initial capacity of a buffer with unlimited length
+#define SAMPLE_BUFFER_INITIAL_CAPACITY 1024
+
+namespace sf
+{
+
+SampleBuffer::SampleBuffer() : nCh(0), cap(0), slots(0), unlimited(false), start(0), written(0)
+{
+}
+
+void SampleBuffer::Allocate(unsigned short nChannels, size_t capacity)
+{
+    nCh = nChannels > 0 ? nChannels : 1;
+    unlimited = capacity == 0;
+    cap = unlimited ? SAMPLE_BUFFER_INITIAL_CAPACITY : capacity;
+    //Spare slot for the sample being written, so that the last cap samples can always be read
+    slots = unlimited ? cap : cap + 1;
+    values.assign(slots * nCh, Scalar(0));
+    timestamps.assign(slots, Scalar(0));
+    ids.assign(slots, 0);
+    start.store(0);
+    written.store(0);
+}
+
+void SampleBuffer::Clear()
+{
+    start.store(written.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+uint64_t SampleBuffer::getFirst() const
+{
+    uint64_t w = written.load(std::memory_order_acquire);
+    uint64_t s = start.load(std::memory_order_acquire);
+    uint64_t oldest = w > cap ? w - cap : 0;
+    return s > oldest ? s : oldest;
+}
+
+void SampleBuffer::Grow()
+{
+    uint64_t first = getFirst();
+    uint64_t w = written.load(std::memory_order_relaxed);
+    size_t newCap = cap * 2;
+    std::vector<Scalar> newValues(newCap * nCh);
+    std::vector<Scalar> newTimestamps(newCap);
+    std::vector<uint64_t> newIds(newCap);
+
+    //Samples keep their absolute index
+    for(uint64_t i = first; i < w; ++i)
+    {
+        size_t src = (size_t)(i % slots);
+        size_t dst = (size_t)(i % newCap);
+        std::memcpy(&newValues[dst * nCh], &values[src * nCh], sizeof(Scalar) * nCh);
+        newTimestamps[dst] = timestamps[src];
+        newIds[dst] = ids[src];
+    }
+
+    values.swap(newValues);
+    timestamps.swap(newTimestamps);
+    ids.swap(newIds);
+    cap = newCap;
+    slots = newCap;
+}
+
+Scalar* SampleBuffer::Reserve()
+{
+    if(cap == 0)
+        return nullptr;
+
+    uint64_t w = written.load(std::memory_order_relaxed);
+    if(unlimited && w - getFirst() == cap)
+        Grow();
+    return &values[(size_t)(w % slots) * nCh];
+}
+
+void SampleBuffer::Commit(Scalar timestamp, uint64_t id)
+{
+    uint64_t w = written.load(std::memory_order_relaxed);
+    size_t slot = (size_t)(w % slots);
+    timestamps[slot] = timestamp;
+    ids[slot] = id;
+    written.store(w + 1, std::memory_order_release);
+}
+
+size_t SampleBuffer::Read(uint64_t& cursor, Scalar* outValues, Scalar* outTimestamps, uint64_t* outIds, size_t maxSamples) const
+{
+    if(cap == 0)
+        return 0;
+
+    //The producer writes into the spare slot, so the last cap committed samples are intact
+    uint64_t w = written.load(std::memory_order_acquire);
+    uint64_t first = getFirst();
+    if(cursor < first)
+        cursor = first;
+    if(cursor >= w)
+        return 0;
+
+    size_t n = (size_t)(w - cursor) < maxSamples ? (size_t)(w - cursor) : maxSamples;
+    for(size_t i = 0; i < n; ++i)
+    {
+        size_t slot = (size_t)((cursor + i) % slots);
+        std::memcpy(outValues + i * nCh, &values[slot * nCh], sizeof(Scalar) * nCh);
+        if(outTimestamps != nullptr)
+            outTimestamps[i] = timestamps[slot];
+        if(outIds != nullptr)
+            outIds[i] = ids[slot];
+    }
+
+    //Discard samples overwritten during copying
+    if(!unlimited)
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t w2 = written.load(std::memory_order_relaxed);
+        uint64_t valid = w2 > cap ? w2 - cap : 0;
+        if(cursor < valid)
+        {
+            size_t skip = (size_t)(valid - cursor) < n ? (size_t)(valid - cursor) : n;
+            n -= skip;
+            cursor += skip;
+            std::memmove(outValues, outValues + skip * nCh, sizeof(Scalar) * nCh * n);
+            if(outTimestamps != nullptr)
+                std::memmove(outTimestamps, outTimestamps + skip, sizeof(Scalar) * n);
+            if(outIds != nullptr)
+                std::memmove(outIds, outIds + skip, sizeof(uint64_t) * n);
+        }
+    }
+
+    cursor += n;
+    return n;
+}
+
+unsigned int SampleBuffer::getSpans(size_t count, SampleSpan spans[2]) const
+{
+    size_t size = getSize();
+    if(count > size)
+        count = size;
+    if(count == 0)
+        return 0;
+
+    uint64_t w = written.load(std::memory_order_acquire);
+    size_t slot = (size_t)((w - count) % slots);
+    size_t length = slots - slot < count ? slots - slot : count;
+    spans[0].values = &values[slot * nCh];
+    spans[0].timestamps = &timestamps[slot];
+    spans[0].ids = &ids[slot];
+    spans[0].length = length;
+    if(length == count)
+        return 1;
+
+    spans[1].values = &values[0];
+    spans[1].timestamps = &timestamps[0];
+    spans[1].ids = &ids[0];
+    spans[1].length = count - length;
+    return 2;
+}
+
+const Scalar* SampleBuffer::getValues(size_t index) const
+{
+    return &values[(size_t)((getFirst() + index) % slots) * nCh];
+}
+
+Scalar SampleBuffer::getTimestamp(size_t index) const
+{
+    return timestamps[(size_t)((getFirst() + index) % slots)];
+}
+
+uint64_t SampleBuffer::getId(size_t index) const
+{
+    return ids[(size_t)((getFirst() + index) % slots)];
+}
+
+size_t SampleBuffer::getSize() const
+{
+    return (size_t)(written.load(std::memory_order_acquire) - getFirst());
+}
+
+size_t SampleBuffer::getCapacity() const
+{
+    return cap;
+}
+
+uint64_t SampleBuffer::getWriteCount() const
+{
+    return written.load(std::memory_order_acquire);
+}
+
+unsigned short SampleBuffer::getNumOfChannels() const
+{
+    return nCh;
+}
+
+}
@@ -36,7 +36,6 @@ namespace sf
 ScalarSensor::ScalarSensor(std::string uniqueName, Scalar frequency, int historyLength) : Sensor(uniqueName, frequency)
 {
     historyLen = historyLength;
-    history = std::deque<Sample*>(0);
     sampleCount = 0;
 }
 
@@ -48,8 +47,9 @@ ScalarSensor::~ScalarSensor()
 
 Sample ScalarSensor::getLastSample()
 {
-    if(history.size() > 0)
-        return Sample(*history.back());
+    size_t size = history.getSize();
+    if(size > 0)
+        return Sample(history.getTimestamp(size-1), history.getNumOfChannels(), history.getValues(size-1), history.getId(size-1));
     else
     {
         unsigned short chs = getNumOfChannels();
@@ -59,19 +59,53 @@ Sample ScalarSensor::getLastSample()
     }
 }
 
+uint64_t ScalarSensor::getSampleCount()
+{
+    return sampleCount;
+}
+
 const std::vector<Sample>* ScalarSensor::getHistory()
 {
     SDL_LockMutex(updateMutex);
     
     std::vector<Sample>* historyCopy = new std::vector<Sample>();
-    for(size_t i=0; i<history.size(); ++i)
-        (*historyCopy).push_back(*(history[i]));
+    historyCopy->reserve(history.getSize());
+    for(size_t i=0; i<history.getSize(); ++i)
+        historyCopy->push_back(Sample(history.getTimestamp(i), history.getNumOfChannels(), history.getValues(i), history.getId(i)));
     
     SDL_UnlockMutex(updateMutex);
     
     return historyCopy;
 }
 
+unsigned int ScalarSensor::getRecentSamples(size_t count, SampleSpan spans[2])
+{
+    return history.getSpans(count, spans);
+}
+
+size_t ScalarSensor::ReadSamples(uint64_t& cursor, Scalar* values, Scalar* timestamps, uint64_t* ids, size_t maxSamples)
+{
+    if(historyLen != 0 && history.getCapacity() > 0) //Buffer of fixed capacity
+        return history.Read(cursor, values, timestamps, ids, maxSamples);
+    
+    SDL_LockMutex(updateMutex);
+    size_t n = history.Read(cursor, values, timestamps, ids, maxSamples);
+    SDL_UnlockMutex(updateMutex);
+    return n;
+}
+
+void ScalarSensor::getHistoryValues(unsigned int channel, std::vector<Scalar>& values)
+{
+    SDL_LockMutex(updateMutex);
+    
+    size_t size = channel < history.getNumOfChannels() ? history.getSize() : 0;
+    values.resize(size);
+    for(size_t i=0; i<size; ++i)
+        values[i] = history.getValues(i)[channel];
+    
+    SDL_UnlockMutex(updateMutex);
+}
+
 unsigned short ScalarSensor::getNumOfChannels()
 {
     return channels.size();
@@ -79,19 +113,15 @@ unsigned short ScalarSensor::getNumOfChannels()
 
 Scalar ScalarSensor::getValue(unsigned long int index, unsigned int channel)
 {
-    if(index < history.size() && channel < channels.size())
-    {
-        Sample* s = history[index];
-        Scalar v = s->getValue(channel);
-        return v;
-    }
+    if(index < history.getSize() && channel < history.getNumOfChannels())
+        return history.getValues(index)[channel];
     
     return Scalar(0);
 }
 
 Scalar ScalarSensor::getLastValue(unsigned int channel)
 {
-    return getValue(history.size() - 1, channel);
+    return getValue(history.getSize() - 1, channel);
 }
 
 SensorChannel ScalarSensor::getSensorChannelDescription(unsigned int channel)
@@ -110,24 +140,19 @@ void ScalarSensor::Reset()
 
 void ScalarSensor::AddSampleToHistory(const Sample& s)
 {
-    if(historyLen < 0 && history.size() > 0) //No history
-    {
-        delete history[0];
-        history.pop_front();
-    }
-    else if(historyLen > 0 && (int)history.size() == historyLen) //Specified history length
+    //Memory allocated once, when the number of channels is known
+    if(history.getCapacity() == 0 || history.getNumOfChannels() != s.getNumOfDimensions())
     {
-        delete history[0];
-        history.pop_front();
+        //-1 --> no history (only last sample), 0 --> unlimited history, >0 --> specified history length
+        history.Allocate(s.getNumOfDimensions(), historyLen < 0 ? 1 : (size_t)historyLen);
     }
-    //else == 0 --> unlimited history
     
-    Sample* sample = new Sample(s, sampleCount);
-    ++sampleCount;
-    
-    for(unsigned int i=0; i<sample->getNumOfDimensions(); ++i)
+    Scalar* data = history.Reserve();
+    for(unsigned int i=0; i<s.getNumOfDimensions(); ++i)
     {
-        Scalar* data = sample->getDataPointer();
+        data[i] = s.getValue(i);
+        if(i >= channels.size())
+            continue;
         
         //Add noise
         if(channels[i].stdDev > Scalar(0) && data[i] < channels[i].rangeMax && data[i] > channels[i].rangeMin)
@@ -141,20 +166,18 @@ void ScalarSensor::AddSampleToHistory(const Sample& s)
     }
     
     //Add to history
-    history.push_back(sample);
+    history.Commit(s.getTimestamp(), sampleCount);
+    ++sampleCount;
 }
 
 void ScalarSensor::ClearHistory()
 {
-    for(unsigned int i = 0; i < history.size(); i++)
-        delete history[i];
-    
-    history.clear();
+    history.Clear();
 }
 
 void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool includeTime, unsigned int fixedPrecision)
 {
-    if(history.size() == 0)
+    if(history.getSize() == 0)
         return;
     
     cInfo("Saving %s measurements to: %s", getName().c_str(), path.c_str());
@@ -169,7 +192,7 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
     //Write header
     fprintf(fp, "#Measurements from %s\n", getName().c_str());
     fprintf(fp, "#Number of channels: %ld\n", channels.size());
-    fprintf(fp, "#Number of samples: %ld\n", history.size());
+    fprintf(fp, "#Number of samples: %ld\n", history.getSize());
     if(freq <= Scalar(0.))
         fprintf(fp, "#Frequency: %1.3lf Hz\n", SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond());
     else
@@ -195,19 +218,19 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
     //Write data
     std::string format = "%1." + std::to_string(fixedPrecision) + "lf";
     
-    for(unsigned int i = 0; i < history.size(); i++)
+    for(unsigned int i = 0; i < history.getSize(); i++)
     {
-        Sample* s = history[i];
+        const Scalar* s = history.getValues(i);
         
         if(includeTime)
         {
-            fprintf(fp, format.c_str(), s->getTimestamp());
+            fprintf(fp, format.c_str(), history.getTimestamp(i));
             fprintf(fp, "\t");
         }
         
         for(unsigned int h = 0; h < channels.size(); h++)
         {
-            Scalar v = s->getValue(h);
+            Scalar v = h < history.getNumOfChannels() ? s[h] : Scalar(0);
             
             fprintf(fp, format.c_str(), v);
             
@@ -223,7 +246,7 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
 
 void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool includeTime, bool separateChannels)
 {
-    if(history.size() == 0)
+    if(history.getSize() == 0)
         return;
     
     //build data structure
@@ -237,14 +260,11 @@ void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool in
             it->name = "Time";
             it->type = DATA_VECTOR;
             
-            btVectorXu* vector = new btVectorXu((unsigned int)history.size());
+            btVectorXu* vector = new btVectorXu((unsigned int)history.getSize());
             it->value = vector;
             
-            for(unsigned int i = 0; i < history.size(); ++i)
-            {
-                Sample* s = history[i];
-                (*vector)[i] = s->getTimestamp();
-            }
+            for(unsigned int i = 0; i < history.getSize(); ++i)
+                (*vector)[i] = history.getTimestamp(i);
             
             data.addItem(it);
         }
@@ -256,15 +276,11 @@ void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool in
             it->name = channels[i].name;
             it->type = DATA_VECTOR;
             
-            btVectorXu* vector = new btVectorXu((unsigned int)history.size());
+            btVectorXu* vector = new btVectorXu((unsigned int)history.getSize());
             it->value = vector;
             
-            for(unsigned int h = 0; h < history.size(); ++h)
-            {
-                Sample* s = history[h];
-                Scalar v = s->getValue(i);
-                (*vector)[h] = v;
-            }
+            for(unsigned int h = 0; h < history.getSize(); ++h)
+                (*vector)[h] = i < history.getNumOfChannels() ? history.getValues(h)[i] : Scalar(0);
             
             data.addItem(it);
         }
@@ -275,19 +291,19 @@ void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool in
         it->name = getName();
         it->type = DATA_MATRIX;
         
-        btMatrixXu* matrix = new btMatrixXu((unsigned int)history.size(), (unsigned int)channels.size() + (includeTime ? 1 : 0));
+        btMatrixXu* matrix = new btMatrixXu((unsigned int)history.getSize(), (unsigned int)channels.size() + (includeTime ? 1 : 0));
         it->value = matrix;
         
-        for(unsigned int i = 0; i < history.size(); ++i)
+        for(unsigned int i = 0; i < history.getSize(); ++i)
         {
-            Sample* s = history[i];
+            const Scalar* s = history.getValues(i);
             
             if(includeTime)
-                matrix->setElem(i, 0, s->getTimestamp());
+                matrix->setElem(i, 0, history.getTimestamp(i));
             
             for(unsigned int h = 0; h < channels.size(); ++h)
             {
-                Scalar v = s->getValue(h);
+                Scalar v = h < history.getNumOfChannels() ? s[h] : Scalar(0);
                 matrix->setElem(i, h + (includeTime ? 1 : 0), v);
             }
         }
@@ -34,10 +34,8 @@
 namespace sf
 {
 
-std::random_device Sensor::randomDevice;
-std::mt19937 Sensor::randomGenerator(randomDevice());
-
 Sensor::Sensor(std::string uniqueName, Scalar frequency)
+    : randomGenerator(SimulationApp::getApp()->getSimulationManager()->getRandomGenerator()())
 {
     name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
     setUpdateFrequency(frequency);
@@ -107,19 +105,15 @@ void Sensor::setVisual(const std::string& meshFilename, Scalar scale, const std:
 
 void Sensor::Reset()
 {
+    randomGenerator.seed(SimulationApp::getApp()->getSimulationManager()->getRandomGenerator()()); //Restart noise sequence
     eleapsedTime = Scalar(0.);
     InternalUpdate(1.); //time delta should not affect initial measurement!!!
 }
 
 void Sensor::Update(Scalar dt)
 {
-    SDL_LockMutex(updateMutex);
-    
     if(freq <= Scalar(0)) // Every simulation tick
-    {
-        InternalUpdate(dt);
-        newDataAvailable = true;
-    }
+        ScheduledUpdate(dt);
     else //Fixed rate
     {
         eleapsedTime += dt;
@@ -127,29 +121,33 @@ void Sensor::Update(Scalar dt)
         
         if(eleapsedTime >= invFreq)
         {
-            InternalUpdate(invFreq);
             eleapsedTime -= invFreq;
-            newDataAvailable = true;
+            ScheduledUpdate(invFreq);
         }
     }
-    
+}
+
+void Sensor::ScheduledUpdate(Scalar dt)
+{
+    SDL_LockMutex(updateMutex);
+    InternalUpdate(dt);
+    newDataAvailable = true;
     SDL_UnlockMutex(updateMutex);
 }
 
-std::vector<Renderable> Sensor::Render()
+std::vector<Sensor*> Sensor::ResolveDependencies()
+{
+    return std::vector<Sensor*>(0);
+}
+
+void Sensor::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items(0);
     if(renderable && graObjectId > 0)
     {
-        Renderable item;
-        item.type = RenderableType::SOLID;
-        item.materialName = "";
+        Renderable& item = snapshot.Add(RenderableType::SOLID, glMatrixFromTransform(getSensorFrame()));
         item.objectId = graObjectId;
         item.lookId = lookId;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        items.push_back(item);
     }
-    return items;
 }
     
 }
@@ -0,0 +1,283 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorLogReader.cpp
+//  Stonefish
+//
+
+#include "sensors/SensorLogReader.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sf
+{
+
+SensorLogReader::SensorLogReader() : data(nullptr), size(0)
+{
+}
+
+SensorLogReader::~SensorLogReader()
+{
+    Close();
+}
+
+bool SensorLogReader::Open(const std::string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(ptr == MAP_FAILED)
+        return false;
+    data = (const uint8_t*)ptr;
+    size = (size_t)st.st_size;
+
+    size_t offset = 0;
+    if(!ParseHeader(offset))
+    {
+        Close();
+        return false;
+    }
+
+    //Chunks following a corrupted one (e.g. a log of a crashed simulation) are ignored
+    while(offset + sizeof(SensorLogChunkHeader) <= size)
+        if(!ParseChunk(offset))
+            break;
+    return true;
+}
+
+void SensorLogReader::Close()
+{
+    if(data != nullptr)
+        munmap((void*)data, size);
+    data = nullptr;
+    size = 0;
+    sensors.clear();
+    chunks.clear();
+    decoded.clear();
+}
+
+bool SensorLogReader::ParseHeader(size_t& offset)
+{
+    auto readBytes = [&](void* dst, size_t n) -> bool
+    {
+        if(offset + n > size)
+            return false;
+        memcpy(dst, data + offset, n);
+        offset += n;
+        return true;
+    };
+    auto readU32 = [&](uint32_t& v) -> bool { return readBytes(&v, sizeof(v)); };
+    auto readString = [&](std::string& str) -> bool
+    {
+        uint32_t len;
+        if(!readU32(len) || offset + len > size)
+            return false;
+        str.assign((const char*)data + offset, len);
+        offset += len;
+        return true;
+    };
+
+    char magic[8];
+    uint32_t version, scalarSize, nSensors, flags;
+    if(!readBytes(magic, 8) || memcmp(magic, SENSOR_LOG_MAGIC, 8) != 0
+       || !readU32(version) || version != SENSOR_LOG_VERSION
+       || !readU32(scalarSize) || scalarSize != sizeof(Scalar)
+       || !readU32(nSensors) || !readU32(flags))
+        return false;
+
+    sensors.resize(nSensors);
+    for(uint32_t i=0; i<nSensors; ++i)
+    {
+        uint32_t type, nChannels;
+        if(!readString(sensors[i].name) || !readU32(type) || !readU32(nChannels))
+            return false;
+        sensors[i].type = (ScalarSensorType)type;
+        sensors[i].channels.resize(nChannels);
+        for(uint32_t h=0; h<nChannels; ++h)
+        {
+            SensorLogChannel& ch = sensors[i].channels[h];
+            double params[3];
+            if(!readString(ch.name) || !readU32(type) || !readBytes(params, sizeof(params)))
+                return false;
+            ch.type = (QuantityType)type;
+            ch.stdDev = Scalar(params[0]);
+            ch.rangeMin = Scalar(params[1]);
+            ch.rangeMax = Scalar(params[2]);
+        }
+    }
+    chunks.resize(nSensors);
+
+    offset = (offset + 7) & ~(size_t)7;
+    return offset <= size;
+}
+
+bool SensorLogReader::ParseChunk(size_t& offset)
+{
+    SensorLogChunkHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    if(header.magic != SENSOR_LOG_CHUNK_MAGIC || header.sensorId >= sensors.size()
+       || offset + sizeof(header) + header.dataSize > size)
+        return false;
+
+    const uint8_t* ptr = data + offset + sizeof(header);
+    const uint8_t* end = ptr + header.dataSize;
+    size_t n = header.length;
+    size_t nCh = sensors[header.sensorId].channels.size();
+    size_t nCols = 2 + nCh;
+    auto pad = [](size_t s) { return (s + 7) & ~(size_t)7; };
+
+    SensorLogColumns cols;
+    cols.length = n;
+    cols.dropped = header.dropped;
+    cols.channels.resize(nCh);
+    std::vector<const void*> colPtrs(nCols);
+
+    if(header.encoding == (uint32_t)SensorLogEncoding::RAW) //Columns used in place
+    {
+        for(size_t i=0; i<nCols; ++i)
+        {
+            size_t es = i == 1 ? sizeof(uint64_t) : sizeof(Scalar);
+            if(ptr + es * n > end)
+                return false;
+            colPtrs[i] = ptr;
+            ptr += pad(es * n);
+        }
+    }
+    else if(header.encoding == (uint32_t)SensorLogEncoding::DELTA_RLE) //Columns decoded to memory
+    {
+        decoded.push_back(std::vector<uint8_t>(pad(sizeof(uint64_t) * n) * nCols));
+        uint8_t* out = decoded.back().data();
+        for(size_t i=0; i<nCols; ++i)
+        {
+            size_t es = i == 1 ? sizeof(uint64_t) : sizeof(Scalar);
+            uint64_t len;
+            if(ptr + sizeof(len) > end)
+                return false;
+            memcpy(&len, ptr, sizeof(len));
+            ptr += sizeof(len);
+            if(ptr + len > end || !SensorLogger::DecodeColumn(ptr, (size_t)len, es, n, out))
+                return false;
+            colPtrs[i] = out;
+            out += pad(sizeof(uint64_t) * n);
+            ptr += pad(sizeof(len) + len) - sizeof(len);
+        }
+    }
+    else
+        return false;
+
+    cols.timestamps = (const Scalar*)colPtrs[0];
+    cols.ids = (const uint64_t*)colPtrs[1];
+    for(size_t h=0; h<nCh; ++h)
+        cols.channels[h] = (const Scalar*)colPtrs[2+h];
+    chunks[header.sensorId].push_back(cols);
+
+    offset += sizeof(header) + header.dataSize;
+    return true;
+}
+
+unsigned int SensorLogReader::getNumOfSensors() const
+{
+    return (unsigned int)sensors.size();
+}
+
+const SensorLogSensor& SensorLogReader::getSensor(unsigned int sensorId) const
+{
+    return sensors.at(sensorId);
+}
+
+int SensorLogReader::getSensorId(const std::string& name) const
+{
+    for(size_t i=0; i<sensors.size(); ++i)
+        if(sensors[i].name == name)
+            return (int)i;
+    return -1;
+}
+
+size_t SensorLogReader::getNumOfSamples(unsigned int sensorId) const
+{
+    size_t n = 0;
+    for(size_t i=0; i<chunks.at(sensorId).size(); ++i)
+        n += chunks[sensorId][i].length;
+    return n;
+}
+
+uint64_t SensorLogReader::getNumOfDroppedSamples(unsigned int sensorId) const
+{
+    uint64_t n = 0;
+    for(size_t i=0; i<chunks.at(sensorId).size(); ++i)
+        n += chunks[sensorId][i].dropped;
+    return n;
+}
+
+size_t SensorLogReader::getNumOfChunks(unsigned int sensorId) const
+{
+    return chunks.at(sensorId).size();
+}
+
+const SensorLogColumns& SensorLogReader::getChunk(unsigned int sensorId, size_t chunkId) const
+{
+    return chunks.at(sensorId).at(chunkId);
+}
+
+void SensorLogReader::getTimestamps(unsigned int sensorId, std::vector<Scalar>& timestamps) const
+{
+    timestamps.resize(getNumOfSamples(sensorId));
+    size_t o = 0;
+    for(size_t i=0; i<chunks[sensorId].size(); ++i)
+    {
+        const SensorLogColumns& cols = chunks[sensorId][i];
+        memcpy(&timestamps[o], cols.timestamps, sizeof(Scalar) * cols.length);
+        o += cols.length;
+    }
+}
+
+void SensorLogReader::getChannel(unsigned int sensorId, unsigned int channel, std::vector<Scalar>& values) const
+{
+    if(channel >= sensors.at(sensorId).channels.size())
+    {
+        values.clear();
+        return;
+    }
+
+    values.resize(getNumOfSamples(sensorId));
+    size_t o = 0;
+    for(size_t i=0; i<chunks[sensorId].size(); ++i)
+    {
+        const SensorLogColumns& cols = chunks[sensorId][i];
+        memcpy(&values[o], cols.channels[channel], sizeof(Scalar) * cols.length);
+        o += cols.length;
+    }
+}
+
+}
@@ -0,0 +1,451 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorLogger.cpp
+//  Stonefish
+//
+
+#include "sensors/SensorLogger.h"
+
+#include <cstddef>
+#include <cstring>
+#include "core/SimulationApp.h"
+#include "sensors/ScalarSensor.h"
+
+namespace sf
+{
+
+static void AppendBytes(std::vector<uint8_t>& buf, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    buf.insert(buf.end(), bytes, bytes + size);
+}
+
+static void AppendU32(std::vector<uint8_t>& buf, uint32_t v)
+{
+    AppendBytes(buf, &v, sizeof(v));
+}
+
+static void AppendString(std::vector<uint8_t>& buf, const std::string& str)
+{
+    AppendU32(buf, (uint32_t)str.size());
+    AppendBytes(buf, str.data(), str.size());
+}
+
+static void AppendPadding(std::vector<uint8_t>& buf)
+{
+    while(buf.size() % 8 != 0)
+        buf.push_back(0);
+}
+
+SensorLogger::SensorLogger(const std::string& path, bool compress, unsigned int chunkLength, unsigned int maxQueuedChunks)
+{
+    this->path = path;
+    this->compress = compress;
+    chunkLen = chunkLength > 0 ? chunkLength : 1;
+    maxQueued = maxQueuedChunks > 0 ? maxQueuedChunks : 1;
+    file = NULL;
+    writer = NULL;
+    queueMutex = SDL_CreateMutex();
+    queueCond = SDL_CreateCond();
+    freeCond = SDL_CreateCond();
+    nSamples = 0;
+    nDropped = 0;
+    nBytes = 0;
+    running = false;
+    quit = false;
+}
+
+SensorLogger::~SensorLogger()
+{
+    Stop();
+    for(size_t i=0; i<chunks.size(); ++i)
+        delete chunks[i];
+    SDL_DestroyCond(freeCond);
+    SDL_DestroyCond(queueCond);
+    SDL_DestroyMutex(queueMutex);
+}
+
+void SensorLogger::AddSensor(ScalarSensor* sens)
+{
+    if(running || sens == nullptr)
+        return;
+
+    LoggedSensor ls;
+    ls.sensor = sens;
+    ls.nChannels = sens->getNumOfChannels();
+    ls.cursor = 0;
+    ls.dropped = 0;
+    ls.chunk = nullptr;
+    logged.push_back(ls);
+}
+
+bool SensorLogger::Start()
+{
+    if(running)
+        return true;
+
+    file = fopen(path.c_str(), "wb");
+    if(file == NULL)
+    {
+        cError("Failed to open sensor log file: %s", path.c_str());
+        return false;
+    }
+
+    if(!WriteHeader())
+    {
+        fclose(file);
+        file = NULL;
+        cError("Failed to write sensor log header: %s", path.c_str());
+        return false;
+    }
+
+    //Preallocate chunks (one being filled per sensor + queued ones)
+    if(chunks.empty())
+    {
+        for(size_t i=0; i<logged.size() + maxQueued; ++i)
+        {
+            Chunk* c = new Chunk();
+            c->sensorId = 0;
+            c->length = 0;
+            c->timestamps.resize(chunkLen);
+            c->ids.resize(chunkLen);
+            chunks.push_back(c);
+        }
+    }
+    freeChunks = chunks;
+    queue.clear();
+
+    size_t maxChannels = 0;
+    for(size_t i=0; i<logged.size(); ++i)
+    {
+        logged[i].cursor = logged[i].sensor->getSampleCount();
+        logged[i].dropped = 0;
+        logged[i].chunk = AcquireChunk((uint32_t)i);
+        maxChannels = logged[i].nChannels > maxChannels ? logged[i].nChannels : maxChannels;
+    }
+    readValues.resize((size_t)chunkLen * maxChannels);
+
+    quit = false;
+    running = true;
+    writer = SDL_CreateThread(SensorLogger::WriterLoop, "sensorLogThread", this);
+    cInfo("Logging %ld sensors to: %s", logged.size(), path.c_str());
+    return true;
+}
+
+void SensorLogger::Update()
+{
+    if(!running)
+        return;
+
+    for(size_t i=0; i<logged.size(); ++i)
+    {
+        LoggedSensor& ls = logged[i];
+        while(true)
+        {
+            //Timestamps and ids are copied directly to the chunk
+            Chunk* c = ls.chunk;
+            uint64_t cursor = ls.cursor;
+            size_t n = ls.sensor->ReadSamples(ls.cursor, readValues.data(), &c->timestamps[c->length], &c->ids[c->length], chunkLen - c->length);
+
+            //Samples overwritten before being read are skipped by the cursor
+            uint64_t lost = ls.cursor - n - cursor;
+            if(lost > 0)
+            {
+                if(ls.dropped == 0)
+                    cWarning("Sensor '%s' produces more samples between logger updates than its history can hold!", ls.sensor->getName().c_str());
+                ls.dropped += lost;
+                c->dropped += lost;
+                nDropped += lost;
+            }
+            if(n == 0)
+                break;
+
+            for(size_t h=0; h<n; ++h)
+                for(unsigned short ch=0; ch<ls.nChannels; ++ch)
+                    c->values[ch * chunkLen + c->length + h] = readValues[h * ls.nChannels + ch];
+            c->length += (uint32_t)n;
+            nSamples += n;
+
+            if(c->length == chunkLen)
+                SubmitChunk(ls);
+        }
+    }
+}
+
+void SensorLogger::Stop()
+{
+    if(!running)
+        return;
+
+    //Flush partially filled chunks
+    for(size_t i=0; i<logged.size(); ++i)
+    {
+        if(logged[i].chunk->length > 0)
+            SubmitChunk(logged[i]);
+        SDL_LockMutex(queueMutex);
+        freeChunks.push_back(logged[i].chunk);
+        logged[i].chunk = nullptr;
+        SDL_UnlockMutex(queueMutex);
+    }
+
+    SDL_LockMutex(queueMutex);
+    quit = true;
+    SDL_CondSignal(queueCond);
+    SDL_UnlockMutex(queueMutex);
+    SDL_WaitThread(writer, NULL);
+    writer = NULL;
+
+    fclose(file);
+    file = NULL;
+    running = false;
+    cInfo("Sensor log closed: %s (%ld samples, %ld dropped, %ld bytes)", path.c_str(), nSamples, nDropped, nBytes);
+}
+
+bool SensorLogger::isRunning() const
+{
+    return running;
+}
+
+uint64_t SensorLogger::getNumOfSamples() const
+{
+    return nSamples;
+}
+
+uint64_t SensorLogger::getNumOfDroppedSamples() const
+{
+    return nDropped;
+}
+
+uint64_t SensorLogger::getNumOfBytesWritten()
+{
+    SDL_LockMutex(queueMutex);
+    uint64_t n = nBytes;
+    SDL_UnlockMutex(queueMutex);
+    return n;
+}
+
+SensorLogger::Chunk* SensorLogger::AcquireChunk(uint32_t sensorId)
+{
+    SDL_LockMutex(queueMutex);
+    while(freeChunks.empty()) //Wait for the writer to catch up
+        SDL_CondWait(freeCond, queueMutex);
+    Chunk* c = freeChunks.back();
+    freeChunks.pop_back();
+    SDL_UnlockMutex(queueMutex);
+
+    c->sensorId = sensorId;
+    c->length = 0;
+    c->dropped = 0;
+    c->values.resize((size_t)chunkLen * logged[sensorId].nChannels);
+    return c;
+}
+
+void SensorLogger::SubmitChunk(LoggedSensor& ls)
+{
+    uint32_t sensorId = ls.chunk->sensorId;
+    SDL_LockMutex(queueMutex);
+    queue.push_back(ls.chunk);
+    SDL_CondSignal(queueCond);
+    SDL_UnlockMutex(queueMutex);
+    ls.chunk = AcquireChunk(sensorId);
+}
+
+bool SensorLogger::WriteHeader()
+{
+    std::vector<uint8_t> buf;
+    AppendBytes(buf, SENSOR_LOG_MAGIC, 8);
+    AppendU32(buf, SENSOR_LOG_VERSION);
+    AppendU32(buf, (uint32_t)sizeof(Scalar));
+    AppendU32(buf, (uint32_t)logged.size());
+    AppendU32(buf, (uint32_t)(compress ? SensorLogEncoding::DELTA_RLE : SensorLogEncoding::RAW));
+
+    for(size_t i=0; i<logged.size(); ++i)
+    {
+        ScalarSensor* sens = logged[i].sensor;
+        AppendString(buf, sens->getName());
+        AppendU32(buf, (uint32_t)sens->getScalarSensorType());
+        AppendU32(buf, (uint32_t)logged[i].nChannels);
+        for(unsigned short h=0; h<logged[i].nChannels; ++h)
+        {
+            SensorChannel ch = sens->getSensorChannelDescription(h);
+            double params[3] = {(double)ch.stdDev, (double)ch.rangeMin, (double)ch.rangeMax};
+            AppendString(buf, ch.name);
+            AppendU32(buf, (uint32_t)ch.type);
+            AppendBytes(buf, params, sizeof(params));
+        }
+    }
+    AppendPadding(buf);
+
+    nBytes = buf.size();
+    return fwrite(buf.data(), 1, buf.size(), file) == buf.size();
+}
+
+void SensorLogger::WriteChunk(Chunk* c)
+{
+    std::vector<uint8_t>& buf = c->encoded;
+    unsigned short nCh = logged[c->sensorId].nChannels;
+    buf.clear();
+
+    SensorLogChunkHeader header;
+    header.magic = SENSOR_LOG_CHUNK_MAGIC;
+    header.sensorId = c->sensorId;
+    header.length = c->length;
+    header.encoding = (uint32_t)(compress ? SensorLogEncoding::DELTA_RLE : SensorLogEncoding::RAW);
+    header.dataSize = 0;
+    header.dropped = c->dropped;
+    AppendBytes(buf, &header, sizeof(header));
+
+    const void* columns[2] = {c->timestamps.data(), c->ids.data()};
+    size_t sizes[2] = {sizeof(Scalar), sizeof(uint64_t)};
+    for(size_t i=0; i<2 + (size_t)nCh; ++i)
+    {
+        const void* data = i < 2 ? columns[i] : &c->values[(i-2) * chunkLen];
+        size_t es = i < 2 ? sizes[i] : sizeof(Scalar);
+
+        if(compress)
+        {
+            size_t lenPos = buf.size();
+            uint64_t len = 0;
+            AppendBytes(buf, &len, sizeof(len));
+            EncodeColumn(data, es, c->length, buf);
+            len = buf.size() - lenPos - sizeof(len);
+            memcpy(&buf[lenPos], &len, sizeof(len));
+        }
+        else
+            AppendBytes(buf, data, es * c->length);
+        AppendPadding(buf);
+    }
+
+    uint64_t dataSize = buf.size() - sizeof(header);
+    memcpy(&buf[offsetof(SensorLogChunkHeader, dataSize)], &dataSize, sizeof(dataSize));
+
+    if(fwrite(buf.data(), 1, buf.size(), file) != buf.size())
+        cError("Failed to write sensor log chunk: %s", path.c_str());
+}
+
+int SensorLogger::WriterLoop(void* data)
+{
+    SensorLogger* logger = (SensorLogger*)data;
+
+    SDL_LockMutex(logger->queueMutex);
+    while(true)
+    {
+        while(logger->queue.empty() && !logger->quit)
+            SDL_CondWait(logger->queueCond, logger->queueMutex);
+        if(logger->queue.empty()) //Quit when all chunks written
+            break;
+
+        Chunk* c = logger->queue.front();
+        logger->queue.pop_front();
+        SDL_UnlockMutex(logger->queueMutex);
+
+        logger->WriteChunk(c); //Encoding and I/O without lock
+
+        SDL_LockMutex(logger->queueMutex);
+        logger->nBytes += c->encoded.size();
+        logger->freeChunks.push_back(c);
+        SDL_CondSignal(logger->freeCond);
+    }
+    SDL_UnlockMutex(logger->queueMutex);
+
+    fflush(logger->file);
+    return 0;
+}
+
+void SensorLogger::EncodeColumn(const void* data, size_t elementSize, size_t n, std::vector<uint8_t>& out)
+{
+    //XOR with the previous element and shuffle bytes, so that slowly changing signals give long runs of zeros
+    static thread_local std::vector<uint8_t> shuffled;
+    const uint8_t* in = (const uint8_t*)data;
+    shuffled.resize(elementSize * n);
+    for(size_t i=0; i<n; ++i)
+        for(size_t b=0; b<elementSize; ++b)
+        {
+            uint8_t prev = i > 0 ? in[(i-1) * elementSize + b] : 0;
+            shuffled[b * n + i] = in[i * elementSize + b] ^ prev;
+        }
+
+    //Run-length encode zeros: control byte < 128 -> literal of (c+1) bytes, >= 128 -> (c-127) zero bytes
+    size_t i = 0;
+    size_t size = shuffled.size();
+    while(i < size)
+    {
+        size_t run = 0;
+        while(i + run < size && run < 128 && shuffled[i + run] == 0)
+            ++run;
+
+        if(run >= 2 || (run == 1 && i + 1 == size))
+        {
+            out.push_back((uint8_t)(127 + run));
+            i += run;
+            continue;
+        }
+
+        size_t lit = 0;
+        while(i + lit < size && lit < 128 && !(shuffled[i + lit] == 0 && i + lit + 1 < size && shuffled[i + lit + 1] == 0))
+            ++lit;
+        out.push_back((uint8_t)(lit - 1));
+        out.insert(out.end(), shuffled.begin() + i, shuffled.begin() + i + lit);
+        i += lit;
+    }
+}
+
+bool SensorLogger::DecodeColumn(const uint8_t* in, size_t inSize, size_t elementSize, size_t n, void* data)
+{
+    static thread_local std::vector<uint8_t> shuffled;
+    size_t size = elementSize * n;
+    shuffled.resize(size);
+
+    size_t o = 0;
+    size_t i = 0;
+    while(i < inSize)
+    {
+        uint8_t c = in[i++];
+        if(c >= 128)
+        {
+            size_t run = c - 127;
+            if(o + run > size)
+                return false;
+            memset(&shuffled[o], 0, run);
+            o += run;
+        }
+        else
+        {
+            size_t lit = (size_t)c + 1;
+            if(o + lit > size || i + lit > inSize)
+                return false;
+            memcpy(&shuffled[o], in + i, lit);
+            o += lit;
+            i += lit;
+        }
+    }
+    if(o != size)
+        return false;
+
+    uint8_t* out = (uint8_t*)data;
+    for(size_t i=0; i<n; ++i)
+        for(size_t b=0; b<elementSize; ++b)
+        {
+            uint8_t prev = i > 0 ? out[(i-1) * elementSize + b] : 0;
+            out[i * elementSize + b] = shuffled[b * n + i] ^ prev;
+        }
+    return true;
+}
+
+}
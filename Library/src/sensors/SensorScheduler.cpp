@@ -0,0 +1,218 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorScheduler.cpp
+//  Stonefish
+//
+
+#include "sensors/SensorScheduler.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include "core/ThreadPool.h"
+#include "sensors/Sensor.h"
+
+namespace sf
+{
+
+static thread_local std::vector<std::function<void()>>* postponedCallbacks = nullptr; //Callbacks of the sensor being updated
+
+SensorScheduler::SensorScheduler()
+{
+    time = Scalar(0);
+    valid = false;
+}
+
+void SensorScheduler::Build(const std::vector<Sensor*>& sensors)
+{
+    //Keep the phase of the sensors already scheduled
+    std::unordered_map<Sensor*, Scalar> dues;
+    for(size_t i=0; i<entries.size(); ++i)
+        dues.emplace(entries[i].sensor, entries[i].due);
+    
+    entries.clear();
+    everyStep.clear();
+    queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>();
+    
+    //Resolve dependencies
+    std::unordered_map<Sensor*, size_t> ids;
+    for(size_t i=0; i<sensors.size(); ++i)
+        ids.emplace(sensors[i], i);
+    
+    std::vector<std::vector<size_t>> deps(sensors.size());
+    for(size_t i=0; i<sensors.size(); ++i)
+    {
+        std::vector<Sensor*> sdeps = sensors[i]->ResolveDependencies();
+        for(size_t h=0; h<sdeps.size(); ++h)
+        {
+            auto it = ids.find(sdeps[h]);
+            if(it != ids.end() && it->second != i)
+                deps[i].push_back(it->second);
+        }
+    }
+    
+    //Assign stages and times of the next update
+    std::vector<int> sstages(sensors.size(), -1);
+    unsigned int nStages = 1;
+    for(size_t i=0; i<sensors.size(); ++i)
+    {
+        Entry e;
+        e.sensor = sensors[i];
+        e.stage = ComputeStage(i, deps, sstages);
+        e.due = Scalar(0);
+        nStages = std::max(nStages, e.stage + 1);
+        
+        Scalar f = e.sensor->getUpdateFrequency();
+        if(f <= Scalar(0))
+            everyStep.push_back(i);
+        else
+        {
+            auto it = dues.find(e.sensor);
+            e.due = it != dues.end() ? it->second : time + Scalar(1)/f;
+            queue.push(QueueItem(e.due, i));
+        }
+        entries.push_back(e);
+    }
+    
+    stages.resize(nStages);
+    valid = true;
+}
+
+unsigned int SensorScheduler::ComputeStage(size_t id, const std::vector<std::vector<size_t>>& deps, std::vector<int>& sstages)
+{
+    if(sstages[id] >= 0)
+        return (unsigned int)sstages[id];
+    if(sstages[id] == -2) //Circular dependency
+        return 0;
+    
+    sstages[id] = -2;
+    unsigned int stage = 0;
+    for(size_t i=0; i<deps[id].size(); ++i)
+        stage = std::max(stage, ComputeStage(deps[id][i], deps, sstages) + 1);
+    sstages[id] = (int)stage;
+    return stage;
+}
+
+void SensorScheduler::Update(Scalar dt, ThreadPool* pool)
+{
+    if(!valid)
+        return;
+    
+    time += dt;
+    for(size_t i=0; i<stages.size(); ++i)
+        stages[i].clear();
+    
+    //Sensors updated in every step
+    for(size_t i=0; i<everyStep.size(); ++i)
+    {
+        Entry& e = entries[everyStep[i]];
+        if(e.sensor->getUpdateFrequency() > Scalar(0)) //Rate changed --> reschedule
+        {
+            e.due = time + Scalar(1)/e.sensor->getUpdateFrequency();
+            valid = false;
+        }
+        stages[e.stage].push_back({e.sensor, dt});
+    }
+    
+    //Sensors that are due (tolerance covers the rounding of the accumulated time)
+    static thread_local std::vector<size_t> fired;
+    fired.clear();
+    while(!queue.empty() && queue.top().first <= time + dt * Scalar(1e-6))
+    {
+        fired.push_back(queue.top().second);
+        queue.pop();
+    }
+    
+    for(size_t i=0; i<fired.size(); ++i)
+    {
+        Entry& e = entries[fired[i]];
+        Scalar f = e.sensor->getUpdateFrequency();
+        if(f <= Scalar(0)) //Rate changed --> reschedule
+        {
+            stages[e.stage].push_back({e.sensor, dt});
+            valid = false;
+        }
+        else
+        {
+            Scalar period = Scalar(1)/f;
+            stages[e.stage].push_back({e.sensor, period});
+            e.due += period; //At most one update per step, as with the elapsed time accumulation
+            queue.push(QueueItem(e.due, fired[i]));
+        }
+    }
+    
+    //Stages run in order, independent sensors in parallel
+    for(size_t s=0; s<stages.size(); ++s)
+    {
+        std::vector<DueSensor>& batch = stages[s];
+        if(callbacks.size() < batch.size())
+            callbacks.resize(batch.size());
+        
+        auto update = [this, &batch](size_t i)
+        {
+            postponedCallbacks = &callbacks[i];
+            batch[i].sensor->ScheduledUpdate(batch[i].dt);
+            postponedCallbacks = nullptr;
+        };
+        
+        if(pool != nullptr && batch.size() > 1)
+            pool->ParallelFor(batch.size(), update);
+        else
+            for(size_t i=0; i<batch.size(); ++i)
+                update(i);
+        
+        //User callbacks run on the calling thread, in a fixed order
+        for(size_t i=0; i<batch.size(); ++i)
+        {
+            for(size_t h=0; h<callbacks[i].size(); ++h)
+                callbacks[i][h]();
+            callbacks[i].clear();
+        }
+    }
+}
+
+void SensorScheduler::Notify(const std::function<void()>& callback)
+{
+    if(postponedCallbacks != nullptr)
+        postponedCallbacks->push_back(callback);
+    else
+        callback();
+}
+
+void SensorScheduler::Invalidate()
+{
+    valid = false;
+}
+
+void SensorScheduler::Reset()
+{
+    entries.clear();
+    everyStep.clear();
+    queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>();
+    stages.clear();
+    callbacks.clear();
+    time = Scalar(0);
+    valid = false;
+}
+
+bool SensorScheduler::isValid() const
+{
+    return valid;
+}
+
+}
@@ -34,9 +34,6 @@ namespace sf
 
 VisionSensor::VisionSensor(std::string uniqueName, Scalar frequency) : Sensor(uniqueName, frequency)
 {
-    if(!SimulationApp::getApp()->hasGraphics())
-        cCritical("Not possible to use vision sensors in console simulation! Use graphical simulation if possible.");
-    
     attach = nullptr;
     o2s = Transform::getIdentity();
 }
@@ -88,33 +88,27 @@ void DVL::InternalUpdate(Scalar dt)
     
     Scalar dirFactor = beamPosZ ? Scalar(1) : Scalar(-1);
 
-    unsigned int divs = ceil(channels[3].rangeMax - channels[3].rangeMin);
     Scalar minRange(-1);
+    RayQuery rays[4];
+    RayHit hits[4];
 
+    //Cast all beams as one batch (the closest hit is the first hit along the beam)
     for(unsigned int i=0; i<4; ++i)
     {
         from[i] = dvlTrans.getOrigin() + dirFactor * dir[i] * channels[3].rangeMin;
         to[i] = dvlTrans.getOrigin() + dirFactor * dir[i] * channels[3].rangeMax;
+        rays[i].from = from[i];
+        rays[i].to = to[i];
+        rays[i].group = MASK_DYNAMIC;
+        rays[i].mask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
+    }
+    SimulationApp::getApp()->getSimulationManager()->CastRays(rays, hits, 4);
 
-        Vector3 step = (to[i]-from[i])/Scalar(divs);
+    for(unsigned int i=0; i<4; ++i)
+    {
         range[i] = Scalar(-1);
-
-        for(unsigned int h=0; h<divs; ++h)
-        {
-            Vector3 from_ = from[i] + step*Scalar(h);
-            Vector3 to_ = from[i] + step*Scalar(h+1);
-            btCollisionWorld::ClosestRayResultCallback closest(from_, to_);
-            closest.m_collisionFilterGroup = MASK_DYNAMIC;
-            closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-            SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from_, to_, closest);
-            
-            if(closest.hasHit())
-            {
-                Vector3 p = from_.lerp(to_, closest.m_closestHitFraction);
-                range[i] = (p - dvlTrans.getOrigin()).length();
-                break;
-            }
-        }
+        if(hits[i].object != nullptr)
+            range[i] = (hits[i].point - dvlTrans.getOrigin()).length();
 
         if(range[i] > Scalar(0) && (range[i] < minRange || minRange < Scalar(0)))
                 minRange = range[i];
@@ -131,18 +125,19 @@ void DVL::InternalUpdate(Scalar dt)
     {
         for(unsigned int i=0; i<4; ++i)
         {
-            range[i] = Scalar(-1);
             from[i] = dvlTrans.getOrigin() + dirFactor * dir[i] * channels[3].rangeMin;
             to[i] = dvlTrans.getOrigin();
-            btCollisionWorld::ClosestRayResultCallback closest(from[i], to[i]);
-            closest.m_collisionFilterGroup = MASK_DYNAMIC;
-            closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-            SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from[i], to[i], closest);
-            
-            if(closest.hasHit() && btDot(closest.m_hitNormalWorld, dirFactor * dir[i]) > Scalar(0))
+            rays[i].from = from[i];
+            rays[i].to = to[i];
+        }
+        SimulationApp::getApp()->getSimulationManager()->CastRays(rays, hits, 4);
+        
+        for(unsigned int i=0; i<4; ++i)
+        {
+            range[i] = Scalar(-1);
+            if(hits[i].object != nullptr && btDot(hits[i].normal, dirFactor * dir[i]) > Scalar(0))
             {
-                Vector3 p = from[i].lerp(to[i], closest.m_closestHitFraction);
-                range[i] = (p - dvlTrans.getOrigin()).length();
+                range[i] = (hits[i].point - dvlTrans.getOrigin()).length();
                 if(range[i] < minRange || minRange < Scalar(0)) minRange = range[i];
             }
         }
@@ -204,15 +199,13 @@ void DVL::InternalUpdate(Scalar dt)
     AddSampleToHistory(s);
 }
 
-std::vector<Renderable> DVL::Render()
+void DVL::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = LinkSensor::Render();
+    LinkSensor::Render(snapshot);
     if(isRenderable())
     {
         unsigned short status = (unsigned short)trunc(getLastValue(7));
-        Renderable item;
-        item.type = RenderableType::SENSOR_LINES;
-        item.model = glMatrixFromTransform(getSensorFrame());    
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
         //Bottom ping
         if(status == 0 || status == 2) //Good bottom ping
         {
@@ -235,26 +228,26 @@ std::vector<Renderable> DVL::Render()
 
             if(range[0] > Scalar(0))
             {
-                item.points.push_back(glm::vec3(0,0,0));
-                item.points.push_back(glm::vec3(dir[0].x()*range[0], dir[0].y()*range[0], dir[0].z()*range[0]));
+                snapshot.AddPoint(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(dir[0].x()*range[0], dir[0].y()*range[0], dir[0].z()*range[0]));
             }
             
             if(range[1] > Scalar(0))
             {
-                item.points.push_back(glm::vec3(0,0,0));
-                item.points.push_back(glm::vec3(dir[1].x()*range[1], dir[1].y()*range[1], dir[1].z()*range[1]));
+                snapshot.AddPoint(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(dir[1].x()*range[1], dir[1].y()*range[1], dir[1].z()*range[1]));
             }
             
             if(range[2] > Scalar(0))
             {
-                item.points.push_back(glm::vec3(0,0,0));
-                item.points.push_back(glm::vec3(dir[2].x()*range[2], dir[2].y()*range[2], dir[2].z()*range[2]));
+                snapshot.AddPoint(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(dir[2].x()*range[2], dir[2].y()*range[2], dir[2].z()*range[2]));
             }
             
             if(range[3] > Scalar(0))
             {
-                item.points.push_back(glm::vec3(0,0,0));
-                item.points.push_back(glm::vec3(dir[3].x()*range[3], dir[3].y()*range[3], dir[3].z()*range[3]));
+                snapshot.AddPoint(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(dir[3].x()*range[3], dir[3].y()*range[3], dir[3].z()*range[3]));
             }
         }
         //Water ping
@@ -271,15 +264,13 @@ std::vector<Renderable> DVL::Render()
                 GLfloat ang2 = (GLfloat)(i+1)/2.f * glm::pi<GLfloat>();
                 glm::vec3 d1(glm::sin(ang1), glm::cos(ang1), 0.f);
                 glm::vec3 d2(glm::sin(ang2), glm::cos(ang2), 0.f);
-                item.points.push_back(r1 * d1 + glm::vec3(0.f, 0.f, -a1));
-                item.points.push_back(r1 * d2 + glm::vec3(0.f, 0.f, -a1));
-                item.points.push_back(r2 * d1 + glm::vec3(0.f, 0.f, -a2));
-                item.points.push_back(r2 * d2 + glm::vec3(0.f, 0.f, -a2));
+                snapshot.AddPoint(r1 * d1 + glm::vec3(0.f, 0.f, -a1));
+                snapshot.AddPoint(r1 * d2 + glm::vec3(0.f, 0.f, -a1));
+                snapshot.AddPoint(r2 * d1 + glm::vec3(0.f, 0.f, -a2));
+                snapshot.AddPoint(r2 * d2 + glm::vec3(0.f, 0.f, -a2));
             }
         }
-        items.push_back(item);
     }
-    return items;
 }
 
 void DVL::setRange(const Vector3& velocityMax, Scalar altitudeMin, Scalar altitudeMax)
@@ -122,17 +122,13 @@ void ForceTorque::setNoise(Scalar forceStdDev, Scalar torqueStdDev)
     channels[5].setStdDev(btClamped(torqueStdDev, Scalar(0), Scalar(BT_LARGE_FLOAT)));
 }
     
-std::vector<Renderable> ForceTorque::Render()
+void ForceTorque::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SENSOR_CS;
-        item.model = glMatrixFromTransform(lastFrame);
-        items.push_back(item);
+        snapshot.Add(RenderableType::SENSOR_CS, glMatrixFromTransform(lastFrame));
     }    
-    return items;
 }
 
 ScalarSensorType ForceTorque::getScalarSensorType()
@@ -28,6 +28,7 @@
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 #include "core/NED.h"
+#include "sensors/SensorScheduler.h"
 #include "entities/MovingEntity.h"
 #include "sensors/Sample.h"
 
@@ -58,12 +59,16 @@ INS::INS(std::string uniqueName, Scalar frequency, int historyLength) : LinkSens
     gpsName = "";
     dvlName = "";
     pressName = "";
+    gps = nullptr;
+    dvl = nullptr;
+    press = nullptr;
     imuNoise = false;
     out = I4();
 }
 
 void INS::Reset()
 {
+    ResolveDependencies();
     ScalarSensor::Reset();
     ned = V0();
     velocity = V0();
@@ -101,8 +106,7 @@ void INS::InternalUpdate(Scalar dt)
     velocity += acc * dt; //In body frame
 
     //--- external sensors
-    DVL* dvl;
-    if(dvlName != "" && (dvl = (DVL*)SimulationApp::getApp()->getSimulationManager()->getSensor(dvlName)) != nullptr) //Correct velocities
+    if(dvl != nullptr) //Correct velocities
     {
         Sample s = dvl->getLastSample();
         Scalar ts = s.getTimestamp();
@@ -117,8 +121,7 @@ void INS::InternalUpdate(Scalar dt)
         }
     }
     
-    GPS* gps;
-    if(gpsName != "" && (gps = (GPS*)SimulationApp::getApp()->getSimulationManager()->getSensor(gpsName)) != nullptr) //Correct global position
+    if(gps != nullptr) //Correct global position
     {
         Sample s = gps->getLastSample();
         Scalar ts = s.getTimestamp();
@@ -130,8 +133,7 @@ void INS::InternalUpdate(Scalar dt)
         }
     }
 
-    Pressure* press;
-    if(pressName != "" && (press = (Pressure*)SimulationApp::getApp()->getSimulationManager()->getSensor(pressName)) != nullptr) //Correct depth
+    if(press != nullptr) //Correct depth
     {
         Sample s = press->getLastSample();
         Scalar ts = s.getTimestamp();
@@ -172,16 +174,40 @@ void INS::InternalUpdate(Scalar dt)
 void INS::ConnectGPS(const std::string& name)
 {
     gpsName = name;
+    ConnectionChanged();
 }
 
 void INS::ConnectDVL(const std::string& name)
 {
     dvlName = name;
+    ConnectionChanged();
 }
 
 void INS::ConnectPressure(const std::string& name)
 {
     pressName = name;
+    ConnectionChanged();
+}
+
+void INS::ConnectionChanged()
+{
+    //Sensors may be connected after the simulation started --> resolve now and reorder the update stages
+    ResolveDependencies();
+    SimulationApp::getApp()->getSimulationManager()->getSensorScheduler()->Invalidate();
+}
+
+std::vector<Sensor*> INS::ResolveDependencies()
+{
+    SimulationManager* sm = SimulationApp::getApp()->getSimulationManager();
+    gps = gpsName != "" ? (GPS*)sm->getSensor(gpsName) : nullptr;
+    dvl = dvlName != "" ? (DVL*)sm->getSensor(dvlName) : nullptr;
+    press = pressName != "" ? (Pressure*)sm->getSensor(pressName) : nullptr;
+    
+    std::vector<Sensor*> deps;
+    if(gps != nullptr) deps.push_back(gps);
+    if(dvl != nullptr) deps.push_back(dvl);
+    if(press != nullptr) deps.push_back(press);
+    return deps;
 }
 
 void INS::setLeverArm(const Vector3& l)
@@ -76,17 +76,13 @@ void LinkSensor::AttachToSolid(MovingEntity* solid, const Transform& origin)
     }
 }
 
-std::vector<Renderable> LinkSensor::Render()
+void LinkSensor::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SENSOR_CS;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        items.push_back(item);
+        snapshot.Add(RenderableType::SENSOR_CS, glMatrixFromTransform(getSensorFrame()));
     }
-    return items;
 }
 
 }
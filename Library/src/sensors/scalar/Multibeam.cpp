@@ -57,23 +57,27 @@ void Multibeam::InternalUpdate(Scalar dt)
     //get sensor frame in world
     Transform mbTrans = getSensorFrame();
     
-    //shoot rays
+    //shoot rays (all beams cast as one batch)
+    static thread_local std::vector<RayQuery> rays;
+    static thread_local std::vector<RayHit> hits;
+    rays.resize(angSteps+1);
+    hits.resize(angSteps+1);
+    
     for(unsigned int i=0; i<=angSteps; ++i)
     {
         Vector3 dir = mbTrans.getBasis().getColumn(0) * btCos(angles[i]) + mbTrans.getBasis().getColumn(1) * btSin(angles[i]);
-        Vector3 from = mbTrans.getOrigin() + dir * channels[1].rangeMin;
-        Vector3 to = mbTrans.getOrigin() + dir * channels[1].rangeMax;
+        rays[i].from = mbTrans.getOrigin() + dir * channels[i].rangeMin;
+        rays[i].to = mbTrans.getOrigin() + dir * channels[i].rangeMax;
+        rays[i].group = MASK_DYNAMIC;
+        rays[i].mask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
+    }
     
-        btCollisionWorld::ClosestRayResultCallback closest(from, to);
-        closest.m_collisionFilterGroup = MASK_DYNAMIC;
-        closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-        SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from, to, closest);
-        
-        if(closest.hasHit())
-        {
-            Vector3 p = from.lerp(to, closest.m_closestHitFraction);
-            distances[i] = (p - mbTrans.getOrigin()).length();
-        }
+    SimulationApp::getApp()->getSimulationManager()->CastRays(rays.data(), hits.data(), rays.size());
+    
+    for(unsigned int i=0; i<=angSteps; ++i)
+    {
+        if(hits[i].object != nullptr)
+            distances[i] = (hits[i].point - mbTrans.getOrigin()).length();
         else
             distances[i] = channels[i].rangeMax;
     }
@@ -83,23 +87,19 @@ void Multibeam::InternalUpdate(Scalar dt)
     AddSampleToHistory(s);
 }
 
-std::vector<Renderable> Multibeam::Render()
+void Multibeam::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SENSOR_LINES;
-        item.model = glMatrixFromTransform(getSensorFrame());    
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
         for(unsigned int i=0; i <= angSteps; ++i)
         {
             Vector3 dir = Vector3(1, 0, 0) * btCos(angles[i]) + Vector3(0, 1, 0) * btSin(angles[i]);
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(dir.x() * distances[i], dir.y() * distances[i], dir.z() * distances[i]));
+            snapshot.AddPoint(glm::vec3(0,0,0));
+            snapshot.AddPoint(glm::vec3(dir.x() * distances[i], dir.y() * distances[i], dir.z() * distances[i]));
         }        
-        items.push_back(item);
     }
-    return items;
 }
 
 void Multibeam::setRange(Scalar rangeMin, Scalar rangeMax)
@@ -55,19 +55,17 @@ void Profiler::InternalUpdate(Scalar dt)
     
     //Simulate 1 beam rotating profiler
     Vector3 dir = profTrans.getBasis().getColumn(0) * btCos(currentAngle) + profTrans.getBasis().getColumn(1) * btSin(currentAngle);
-    Vector3 from = profTrans.getOrigin() + dir * channels[1].rangeMin;
-    Vector3 to = profTrans.getOrigin() + dir * channels[1].rangeMax;
+    RayQuery ray;
+    ray.from = profTrans.getOrigin() + dir * channels[1].rangeMin;
+    ray.to = profTrans.getOrigin() + dir * channels[1].rangeMax;
+    ray.group = MASK_DYNAMIC;
+    ray.mask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
     
-    btCollisionWorld::ClosestRayResultCallback closest(from, to);
-    closest.m_collisionFilterGroup = MASK_DYNAMIC;
-    closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-    SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from, to, closest);
+    RayHit hit;
+    SimulationApp::getApp()->getSimulationManager()->CastRays(&ray, &hit, 1);
         
-    if(closest.hasHit())
-    {
-        Vector3 p = from.lerp(to, closest.m_closestHitFraction);
-        distance = (p - profTrans.getOrigin()).length();
-    }
+    if(hit.object != nullptr)
+        distance = (hit.point - profTrans.getOrigin()).length();
     else
         distance = channels[1].rangeMax;
    
@@ -99,22 +97,18 @@ void Profiler::InternalUpdate(Scalar dt)
     }
 }
 
-std::vector<Renderable> Profiler::Render()
+void Profiler::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
         Scalar currentAngle = currentAngStep/(Scalar)angSteps * angRange - Scalar(0.5) * angRange;
         Vector3 dir = Vector3(1, 0, 0) * btCos(currentAngle) + Vector3(0, 1, 0) * btSin(currentAngle);
         
-        Renderable item;
-        item.type = RenderableType::SENSOR_LINES;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(dir.x()*distance, dir.y()*distance, dir.z()*distance));
-        items.push_back(item);
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(dir.x()*distance, dir.y()*distance, dir.z()*distance));
     }
-    return items;
 }
 
 void Profiler::setRange(Scalar rangeMin, Scalar rangeMax)
@@ -78,14 +78,12 @@ void Camera::UpdateTransform()
     SetupCamera(eyePosition, direction, cameraUp);
 }
 
-std::vector<Renderable> Camera::Render()
+void Camera::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        item.type = RenderableType::SENSOR_LINES;
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
         
         //Create camera dummy
         GLfloat iconSize = 0.5f;
@@ -93,32 +91,29 @@ std::vector<Renderable> Camera::Render()
         GLfloat aspect = (GLfloat)resX/(GLfloat)resY;
         GLfloat y = x/aspect;
         
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(x, -y, iconSize));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(x,  y, iconSize));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-x, -y, iconSize));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(-x,  y, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(x,  y, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(-x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(-x,  y, iconSize));
         
-        item.points.push_back(glm::vec3(x, -y, iconSize));
-        item.points.push_back(glm::vec3(x, y, iconSize));
-        item.points.push_back(glm::vec3(x, y, iconSize));
-        item.points.push_back(glm::vec3(-x, y, iconSize));
-        item.points.push_back(glm::vec3(-x, y, iconSize));
-        item.points.push_back(glm::vec3(-x, -y, iconSize));
-        item.points.push_back(glm::vec3(-x, -y, iconSize));
-        item.points.push_back(glm::vec3(x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(x, y, iconSize));
+        snapshot.AddPoint(glm::vec3(x, y, iconSize));
+        snapshot.AddPoint(glm::vec3(-x, y, iconSize));
+        snapshot.AddPoint(glm::vec3(-x, y, iconSize));
+        snapshot.AddPoint(glm::vec3(-x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(-x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(x, -y, iconSize));
         
-        item.points.push_back(glm::vec3(-0.5f*x, -y, iconSize));
-        item.points.push_back(glm::vec3(0.f, -1.5f*y, iconSize));
-        item.points.push_back(glm::vec3(0.f, -1.5f*y, iconSize));
-        item.points.push_back(glm::vec3(0.5f*x, -y, iconSize));
-        
-        items.push_back(item);
+        snapshot.AddPoint(glm::vec3(-0.5f*x, -y, iconSize));
+        snapshot.AddPoint(glm::vec3(0.f, -1.5f*y, iconSize));
+        snapshot.AddPoint(glm::vec3(0.f, -1.5f*y, iconSize));
+        snapshot.AddPoint(glm::vec3(0.5f*x, -y, iconSize));
     }
-    return items;
 }
 
 }
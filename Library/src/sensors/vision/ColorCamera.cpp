@@ -36,6 +36,9 @@ namespace sf
 ColorCamera::ColorCamera(std::string uniqueName, unsigned int resolutionX, unsigned int resolutionY, Scalar horizFOVDeg, Scalar frequency, 
     Scalar minDistance, Scalar maxDistance) : Camera(uniqueName, resolutionX, resolutionY, horizFOVDeg, frequency)
 {
+    if(!SimulationApp::getApp()->hasGraphics())
+        cCritical("Not possible to use color cameras in console simulation! Use graphical simulation if possible.");
+    
     depthRange = glm::vec2((GLfloat)minDistance, (GLfloat)maxDistance);
     newDataCallback = NULL;
     imageData = NULL;
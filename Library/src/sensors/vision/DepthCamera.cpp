@@ -29,6 +29,8 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLDepthCamera.h"
+#include "sensors/SensorScheduler.h"
+#include "sensors/vision/RaycastImager.h"
 
 namespace sf
 {
@@ -42,10 +44,12 @@ DepthCamera::DepthCamera(std::string uniqueName, unsigned int resolutionX, unsig
     newDataCallback = nullptr;
     imageData = nullptr;
     glCamera = nullptr;
+    rcCamera = nullptr;
 }
 
 DepthCamera::~DepthCamera()
 {
+    if(rcCamera != nullptr) delete rcCamera;
     glCamera = nullptr;
 }
 
@@ -76,6 +80,12 @@ VisionSensorType DepthCamera::getVisionSensorType()
 
 void DepthCamera::InitGraphics()
 {
+    if(!SimulationApp::getApp()->hasGraphics())
+    {
+        InitRaycasting();
+        return;
+    }
+
     glCamera = new OpenGLDepthCamera(glm::vec3(0,0,0), glm::vec3(0,0,1.f), glm::vec3(0,-1.f,0), 0, 0, resX, resY, (GLfloat)fovH, depthRange.x, depthRange.y, freq < Scalar(0));
     glCamera->setNoise(noiseStdDev);
     glCamera->setCamera(this);
@@ -85,8 +95,50 @@ void DepthCamera::InitGraphics()
     ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->AddView(glCamera);
 }
 
+void DepthCamera::InitRaycasting()
+{
+    //One ray through the center of each pixel of the pinhole camera (top row first)
+    Scalar tanH = btTan(btRadians(fovH)/Scalar(2));
+    Scalar tanV = tanH * Scalar(resY)/Scalar(resX);
+    std::vector<Vector3> dirs(resX * resY);
+    rcDepth.resize(resX * resY);
+    for(unsigned int v=0; v<resY; ++v)
+        for(unsigned int u=0; u<resX; ++u)
+        {
+            Vector3 dir(((u + Scalar(0.5))/Scalar(resX) * Scalar(2) - Scalar(1)) * tanH,
+                        ((v + Scalar(0.5))/Scalar(resY) * Scalar(2) - Scalar(1)) * tanV,
+                        Scalar(1));
+            dir.normalize();
+            dirs[v * resX + u] = dir;
+            rcDepth[v * resX + u] = (GLfloat)dir.z(); //Conversion of range to depth
+        }
+    rcCamera = new RaycastImager(randomGenerator);
+    rcCamera->setRays(dirs);
+    rcData.resize(resX * resY);
+    InternalUpdate(0);
+}
+
+void DepthCamera::UpdateRaycasting()
+{
+    //Rays long enough to reach the far plane in the corners of the image
+    GLfloat minDirZ = rcDepth[0];
+    rcCamera->Cast(getSensorFrame(), depthRange.x, depthRange.y/minDirZ);
+    const GLfloat* ranges = rcCamera->getRanges();
+    for(size_t i=0; i<rcData.size(); ++i)
+    {
+        GLfloat depth = ranges[i] * rcDepth[i];
+        if(ranges[i] <= 0.f || depth >= depthRange.y) //Check if out of range
+            rcData[i] = 0.f;
+        else
+            rcData[i] = depth + rcCamera->Gaussian(0.f, depth*depth*noiseStdDev);
+    }
+    NewDataReady(rcData.data());
+}
+
 void DepthCamera::SetupCamera(const Vector3& eye, const Vector3& dir, const Vector3& up)
 {
+    if(glCamera == nullptr)
+        return;
     glm::vec3 eye_ = glm::vec3((GLfloat)eye.x(), (GLfloat)eye.y(), (GLfloat)eye.z());
     glm::vec3 dir_ = glm::vec3((GLfloat)dir.x(), (GLfloat)dir.y(), (GLfloat)dir.z());
     glm::vec3 up_ = glm::vec3((GLfloat)up.x(), (GLfloat)up.y(), (GLfloat)up.z());
@@ -102,15 +154,21 @@ void DepthCamera::NewDataReady(void* data, unsigned int index)
 {
     if(newDataCallback != nullptr)
     {
-        imageData = (GLfloat*)data;
-        newDataCallback(this);
-        imageData = nullptr;
+        SensorScheduler::Notify([this, data]()
+        {
+            imageData = (GLfloat*)data;
+            newDataCallback(this);
+            imageData = nullptr;
+        });
     }
 }
 
 void DepthCamera::InternalUpdate(Scalar dt)
 {
-    glCamera->Update();
+    if(glCamera != nullptr)
+        glCamera->Update();
+    else if(rcCamera != nullptr)
+        UpdateRaycasting();
 }
 
 }
@@ -29,6 +29,11 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLFLS.h"
+#include "sensors/SensorScheduler.h"
+#include "sensors/vision/RaycastImager.h"
+
+//Vertical beam sampling (same as in the OpenGL implementation)
+#define FLS_VRES_FACTOR 0.1
 
 namespace sf
 {
@@ -49,11 +54,14 @@ FLS::FLS(std::string uniqueName, unsigned int numOfBeams, unsigned int numOfBins
     displayData = NULL;
     newDataCallback = NULL;
     glFLS = nullptr;
+    rcFLS = nullptr;
+    nBeamSamples = 0;
 }
 
 FLS::~FLS()
 {
     if(displayData != NULL) delete [] displayData;
+    if(rcFLS != nullptr) delete rcFLS;
     glFLS = nullptr;
 }
 
@@ -123,6 +131,12 @@ VisionSensorType FLS::getVisionSensorType()
 
 void FLS::InitGraphics()
 {
+    if(!SimulationApp::getApp()->hasGraphics())
+    {
+        InitRaycasting();
+        return;
+    }
+
     glFLS = new OpenGLFLS(glm::vec3(0,0,0), glm::vec3(0,0,1.f), glm::vec3(0,-1.f,0), 
                           (GLfloat)fovH, (GLfloat)fovV, (GLint)resX, (GLint)resY, range);
     glFLS->setNoise(noise);
@@ -138,8 +152,111 @@ void FLS::InitGraphics()
     displayData = new GLubyte[w*h*3];
 }
 
+void FLS::InitRaycasting()
+{
+    //Rays distributed evenly in each beam, beams distributed evenly in the field of view
+    nBeamSamples = (unsigned int)ceil(fovV * Scalar(resY) * Scalar(FLS_VRES_FACTOR));
+    nBeamSamples = nBeamSamples < 2 ? 2 : (nBeamSamples > 2048 ? 2048 : nBeamSamples);
+    Scalar hFov = btRadians(fovH);
+    Scalar vFov = btRadians(fovV);
+    std::vector<Vector3> dirs(resX * nBeamSamples);
+    for(unsigned int i=0; i<resX; ++i)
+    {
+        Scalar az = -hFov/Scalar(2) + (Scalar(i) + Scalar(0.5))/Scalar(resX) * hFov;
+        for(unsigned int h=0; h<nBeamSamples; ++h)
+        {
+            Scalar el = -vFov/Scalar(2) + Scalar(h)/Scalar(nBeamSamples-1) * vFov;
+            dirs[i * nBeamSamples + h] = Vector3(btSin(az) * btCos(el), btSin(el), btCos(az) * btCos(el));
+        }
+    }
+    rcFLS = new RaycastImager(randomGenerator);
+    rcFLS->setRays(dirs);
+    rcOutput.resize(resX * resY);
+    rcData.resize(resX * resY);
+
+    unsigned int w, h;
+    getDisplayResolution(w, h);
+    displayData = new GLubyte[w*h*3];
+    InternalUpdate(0);
+}
+
+void FLS::UpdateRaycasting()
+{
+    rcFLS->Cast(getSensorFrame(), range.x, range.y);
+    const GLfloat* ranges = rcFLS->getRanges();
+    const GLfloat* intensities = rcFLS->getIntensities();
+
+    //Noise is drawn sequentially, before the beams are processed in parallel
+    static thread_local std::vector<GLfloat> mulNoise;
+    static thread_local std::vector<GLfloat> addNoise;
+    mulNoise.resize(resX);
+    addNoise.resize(resX * resY);
+    for(unsigned int i=0; i<resX; ++i)
+        mulNoise[i] = rcFLS->Gaussian(1.f, noise.x);
+    for(size_t i=0; i<addNoise.size(); ++i)
+        addNoise[i] = rcFLS->Gaussian(0.f, noise.y);
+
+    //Histogram of each beam (as in the sonar output shader)
+    GLfloat step = (range.y - range.x)/(GLfloat)resY;
+    GLfloat g = (GLfloat)gain;
+    RaycastImager::ParallelFor(resX, [&](size_t i)
+    {
+        static thread_local std::vector<glm::vec2> hist;
+        hist.assign(resY, glm::vec2(0.f));
+        for(unsigned int h=0; h<nBeamSamples; ++h)
+        {
+            GLfloat r = ranges[i * nBeamSamples + h];
+            if(r < range.x || r >= range.y)
+                continue;
+            unsigned int bin = (unsigned int)floorf((r - range.x)/step);
+            bin = bin < resY ? bin : resY-1;
+            GLfloat factor = h/(GLfloat)(nBeamSamples-1);
+            hist[bin].x += intensities[i * nBeamSamples + h] * glm::smoothstep(0.f, 0.2f, factor) * (1.f - glm::smoothstep(0.8f, 1.f, factor));
+            hist[bin].y += 1.f;
+        }
+        for(unsigned int h=0; h<resY; ++h)
+        {
+            GLfloat data = g * addNoise[i * resY + h];
+            if(hist[h].y > 0.f)
+                data += g * hist[h].x/hist[h].y * mulNoise[i];
+            rcOutput[(resY-1-h) * resX + i] = data;
+        }
+    });
+    RaycastImager::Blur(rcOutput.data(), resX, resY, rcData.data());
+
+    if(newDataCallback == NULL)
+        return;
+
+    //Display image (as the fan drawn by the OpenGL implementation)
+    unsigned int w, h;
+    getDisplayResolution(w, h);
+    GLfloat hFov = glm::radians((GLfloat)fovH);
+    GLfloat hFactor = sinf(hFov/2.f);
+    GLfloat Rmin = range.x/range.y;
+    RaycastImager::ParallelFor(h, [&](size_t y)
+    {
+        GLfloat ndcY = (y + 0.5f)/(GLfloat)h * 2.f - 1.f;
+        for(unsigned int x=0; x<w; ++x)
+        {
+            GLfloat ndcX = (x + 0.5f)/(GLfloat)w * 2.f - 1.f;
+            GLfloat c = (1.f - ndcY)/2.f;
+            GLfloat s = -ndcX * hFactor;
+            GLfloat R = sqrtf(c*c + s*s);
+            GLfloat alpha = atan2f(s, c);
+            GLubyte* rgb = &displayData[(y * w + x) * 3];
+            if(R < Rmin || R > 1.f || fabsf(alpha) > hFov/2.f)
+                rgb[0] = rgb[1] = rgb[2] = 0;
+            else
+                RaycastImager::MapColor(RaycastImager::Sample(rcData.data(), resX, resY, (hFov/2.f - alpha)/hFov, (1.f - R)/(1.f - Rmin)), cMap, rgb);
+        }
+    });
+    NewDataReady(rcData.data(), 1);
+}
+
 void FLS::SetupCamera(const Vector3& eye, const Vector3& dir, const Vector3& up)
 {
+    if(glFLS == nullptr)
+        return;
     glm::vec3 eye_ = glm::vec3((GLfloat)eye.x(), (GLfloat)eye.y(), (GLfloat)eye.z());
     glm::vec3 dir_ = glm::vec3((GLfloat)dir.x(), (GLfloat)dir.y(), (GLfloat)dir.z());
     glm::vec3 up_ = glm::vec3((GLfloat)up.x(), (GLfloat)up.y(), (GLfloat)up.z());
@@ -163,9 +280,12 @@ void FLS::NewDataReady(void* data, unsigned int index)
         }
         else
         {
-            sonarData = (GLubyte*)data;
-            newDataCallback(this);
-            sonarData = NULL;
+            SensorScheduler::Notify([this, data]()
+            {
+                sonarData = (GLubyte*)data;
+                newDataCallback(this);
+                sonarData = NULL;
+            });
         }
     }
 }
@@ -174,16 +294,16 @@ void FLS::InternalUpdate(Scalar dt)
 {
     if(glFLS != nullptr)
         glFLS->Update();
+    else if(rcFLS != nullptr)
+        UpdateRaycasting();
 }
 
-std::vector<Renderable> FLS::Render()
+void FLS::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        item.type = RenderableType::SENSOR_LINES;    
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
         
         //Create sonar dummy
         GLfloat iconSize = range.y;
@@ -197,9 +317,9 @@ std::vector<Renderable> FLS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             hAngle += fovStep;
         }
         hAngle = -fovStep*(div/2);
@@ -207,9 +327,9 @@ std::vector<Renderable> FLS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, -sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             hAngle += fovStep;
         }
         //Max Arcs
@@ -220,9 +340,9 @@ std::vector<Renderable> FLS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             hAngle += fovStep;
         }
         hAngle = -fovStep*(div/2);
@@ -230,35 +350,32 @@ std::vector<Renderable> FLS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, -sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             hAngle += fovStep;
         }
         //Ends
         hAngle = -fovStep*(div/2);
         GLfloat zs = cosf(hAngle) * cosVAngle;
         GLfloat xs = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-        item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(xs, sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(xs, -sinVAngle, zs));
         hAngle = fovStep*(div/2);
         GLfloat ze = cosf(hAngle) * cosVAngle;
         GLfloat xe = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-        item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(xe, sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(xe, -sinVAngle, ze));
         //Pyramid
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
-
-        items.push_back(item);
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xs, sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xs, -sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xe, sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xe, -sinVAngle, ze));
     }
-    return items;
 }
 
 }
@@ -29,6 +29,11 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLMSIS.h"
+#include "sensors/SensorScheduler.h"
+#include "sensors/vision/RaycastImager.h"
+
+//Beam sampling (same as in the OpenGL implementation)
+#define MSIS_RES_FACTOR 0.1
 
 namespace sf
 {
@@ -52,11 +57,13 @@ MSIS::MSIS(std::string uniqueName, Scalar stepAngleDeg, unsigned int numOfBins,
     displayData = NULL;
     newDataCallback = NULL;
     glMSIS = nullptr;
+    rcMSIS = nullptr;
 }
 
 MSIS::~MSIS()
 {
     if(displayData != NULL) delete [] displayData;
+    if(rcMSIS != nullptr) delete rcMSIS;
     glMSIS = nullptr;
 }
 
@@ -165,6 +172,12 @@ VisionSensorType MSIS::getVisionSensorType()
 
 void MSIS::InitGraphics()
 {
+    if(!SimulationApp::getApp()->hasGraphics())
+    {
+        InitRaycasting();
+        return;
+    }
+
     glMSIS = new OpenGLMSIS(glm::vec3(0,0,0), glm::vec3(0,0,1.f), glm::vec3(0,-1.f,0),
                            (GLfloat)fovH, (GLfloat)fovV, (GLint)resX, (GLint)resY, range);
     glMSIS->setNoise(noise);
@@ -180,8 +193,115 @@ void MSIS::InitGraphics()
     displayData = new GLubyte[w*h*3];
 }
 
+void MSIS::InitRaycasting()
+{
+    //Rays of the beam pointing along the sonar axis, rotated to the current step when cast
+    nBeamSamples.x = (unsigned int)ceil(fovH * Scalar(resY) * Scalar(MSIS_RES_FACTOR));
+    nBeamSamples.y = (unsigned int)ceil(fovV * Scalar(resY) * Scalar(MSIS_RES_FACTOR));
+    nBeamSamples = glm::clamp(nBeamSamples, glm::uvec2(2), glm::uvec2(2048));
+    Scalar hFov = btRadians(fovH);
+    Scalar vFov = btRadians(fovV);
+    std::vector<Vector3> dirs(nBeamSamples.x * nBeamSamples.y);
+    for(unsigned int h=0; h<nBeamSamples.y; ++h)
+    {
+        Scalar el = (Scalar(h)/Scalar(nBeamSamples.y-1) - Scalar(0.5)) * vFov;
+        for(unsigned int i=0; i<nBeamSamples.x; ++i)
+        {
+            Scalar az = (Scalar(i)/Scalar(nBeamSamples.x-1) - Scalar(0.5)) * hFov;
+            dirs[h * nBeamSamples.x + i] = Vector3(btSin(az) * btCos(el), btSin(el), btCos(az) * btCos(el));
+        }
+    }
+    rcMSIS = new RaycastImager(randomGenerator);
+    rcMSIS->setRays(dirs);
+    rcRange = range;
+    rcData.assign(resX * resY, 0);
+
+    unsigned int w, h;
+    getDisplayResolution(w, h);
+    displayData = new GLubyte[w*h*3];
+    InternalUpdate(0);
+}
+
+void MSIS::UpdateRaycasting()
+{
+    //Clear image when settings changed
+    if(rcRange != range)
+    {
+        std::fill(rcData.begin(), rcData.end(), 0);
+        rcRange = range;
+    }
+
+    Transform beamFrame = getSensorFrame() * Transform(Quaternion(Vector3(0,1,0), Scalar(currentStep) * stepSize), Vector3(0,0,0));
+    rcMSIS->Cast(beamFrame, range.x, range.y);
+    const GLfloat* ranges = rcMSIS->getRanges();
+    const GLfloat* intensities = rcMSIS->getIntensities();
+    GLfloat step = (range.y - range.x)/(GLfloat)resY;
+
+    //Histogram of the beam (as in the third sonar output shader)
+    static thread_local std::vector<glm::vec2> hist;
+    hist.assign(resY, glm::vec2(0.f));
+    for(unsigned int h=0; h<nBeamSamples.y; ++h)
+    {
+        GLfloat vFrac2 = (h/(GLfloat)(nBeamSamples.y-1) - 0.5f) * 2.f;
+        vFrac2 *= vFrac2;
+        for(unsigned int i=0; i<nBeamSamples.x; ++i)
+        {
+            GLfloat r = ranges[h * nBeamSamples.x + i];
+            if(r < range.x || r >= range.y)
+                continue;
+            unsigned int bin = (unsigned int)floorf((r - range.x)/step);
+            bin = bin < resY ? bin : resY-1;
+            GLfloat hFrac2 = (i/(GLfloat)(nBeamSamples.x-1) - 0.5f) * 2.f;
+            hFrac2 *= hFrac2;
+            hist[bin].x += intensities[h * nBeamSamples.x + i] * glm::clamp(1.f - (hFrac2 + vFrac2)/2.f, 0.f, 1.f);
+            hist[bin].y += 1.f;
+        }
+    }
+
+    //Update the column of the current rotation step (as in the sonar update shader)
+    GLfloat g = (GLfloat)gain;
+    GLfloat mulNoise = rcMSIS->Gaussian(1.f, noise.x);
+    unsigned int rotationStep = (unsigned int)(currentStep + (int)(resX/2));
+    for(unsigned int i=0; i<resY; ++i)
+    {
+        GLfloat value = g * (i/(GLfloat)(resY-1)*0.5f + 0.5f) * rcMSIS->Gaussian(0.f, noise.y); //Distance dependent amount of noise
+        if(hist[i].y > 0.f)
+            value += hist[i].x/hist[i].y * g * mulNoise;
+        rcData[(resY-1-i) * resX + rotationStep] = (GLubyte)roundf(glm::clamp(value, 0.f, 1.f) * 255.f);
+    }
+
+    if(newDataCallback != NULL)
+    {
+        //Display image (as the circular fan drawn by the OpenGL implementation)
+        unsigned int w, h;
+        getDisplayResolution(w, h);
+        GLfloat Rmin = range.x/range.y;
+        RaycastImager::ParallelFor(h, [&](size_t y)
+        {
+            GLfloat ndcY = (y + 0.5f)/(GLfloat)h * 2.f - 1.f;
+            for(unsigned int x=0; x<w; ++x)
+            {
+                GLfloat ndcX = (x + 0.5f)/(GLfloat)w * 2.f - 1.f;
+                GLfloat R = sqrtf(ndcX*ndcX + ndcY*ndcY);
+                GLubyte* rgb = &displayData[(y * w + x) * 3];
+                if(R < Rmin || R > 1.f)
+                    rgb[0] = rgb[1] = rgb[2] = 0;
+                else
+                {
+                    GLfloat alpha = atan2f(-ndcX, -ndcY);
+                    GLfloat u = ((GLfloat)M_PI - alpha)/(2.f*(GLfloat)M_PI);
+                    RaycastImager::MapColor(RaycastImager::Sample(rcData.data(), resX, resY, u, (1.f - R)/(1.f - Rmin)), cMap, rgb);
+                }
+            }
+        });
+    }
+    NewDataReady(rcData.data(), 1);
+}
+
 void MSIS::SetupCamera(const Vector3& eye, const Vector3& dir, const Vector3& up)
 {
+    if(glMSIS == nullptr)
+        return;
     glm::vec3 eye_ = glm::vec3((GLfloat)eye.x(), (GLfloat)eye.y(), (GLfloat)eye.z());
     glm::vec3 dir_ = glm::vec3((GLfloat)dir.x(), (GLfloat)dir.y(), (GLfloat)dir.z());
     glm::vec3 up_ = glm::vec3((GLfloat)up.x(), (GLfloat)up.y(), (GLfloat)up.z());
@@ -205,9 +325,12 @@ void MSIS::NewDataReady(void* data, unsigned int index)
         }
         else
         {
-            sonarData = (GLubyte*)data;
-            newDataCallback(this);
-            sonarData = NULL;
+            SensorScheduler::Notify([this, data]()
+            {
+                sonarData = (GLubyte*)data;
+                newDataCallback(this);
+                sonarData = NULL;
+            });
         }
     }
 
@@ -236,16 +359,16 @@ void MSIS::InternalUpdate(Scalar dt)
 {
     if(glMSIS != nullptr)
         glMSIS->Update();
+    else if(rcMSIS != nullptr)
+        UpdateRaycasting();
 }
 
-std::vector<Renderable> MSIS::Render()
+void MSIS::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        item.type = RenderableType::SENSOR_LINES;    
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
         
         //Create sonar dummy
         int div = 24;
@@ -260,9 +383,9 @@ std::vector<Renderable> MSIS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             hAngle += fovStep;
         }
         hAngle = glm::radians(l1Deg);
@@ -270,9 +393,9 @@ std::vector<Renderable> MSIS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, -sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             hAngle += fovStep;
         }
         //Arcs max
@@ -283,9 +406,9 @@ std::vector<Renderable> MSIS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             hAngle += fovStep;
         }
         hAngle = glm::radians(l1Deg);
@@ -293,21 +416,21 @@ std::vector<Renderable> MSIS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, -sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             hAngle += fovStep;
         }
         //Current beam position
         hAngle = currentStep * stepSize;
         GLfloat zc = cosf(hAngle) * cosVAngle;
         GLfloat xc = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xc, sinVAngle, zc));
-        item.points.push_back(glm::vec3(xc, sinVAngle, zc));
-        item.points.push_back(glm::vec3(xc, -sinVAngle, zc));
-        item.points.push_back(glm::vec3(xc, -sinVAngle, zc));
-        item.points.push_back(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xc, sinVAngle, zc));
+        snapshot.AddPoint(glm::vec3(xc, sinVAngle, zc));
+        snapshot.AddPoint(glm::vec3(xc, -sinVAngle, zc));
+        snapshot.AddPoint(glm::vec3(xc, -sinVAngle, zc));
+        snapshot.AddPoint(glm::vec3(0,0,0));
         
         if(!fullRotation)
         {
@@ -315,27 +438,24 @@ std::vector<Renderable> MSIS::Render()
             hAngle = glm::radians(l1Deg);
             GLfloat zs = cosf(hAngle) * cosVAngle;
             GLfloat xs = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-            item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
+            snapshot.AddPoint(glm::vec3(xs, sinVAngle, zs));
+            snapshot.AddPoint(glm::vec3(xs, -sinVAngle, zs));
             hAngle = glm::radians(l2Deg);
             GLfloat ze = cosf(hAngle) * cosVAngle;
             GLfloat xe = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-            item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+            snapshot.AddPoint(glm::vec3(xe, sinVAngle, ze));
+            snapshot.AddPoint(glm::vec3(xe, -sinVAngle, ze));
             //Pyramid
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-            item.points.push_back(glm::vec3(0,0,0));
-            item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+            snapshot.AddPoint(glm::vec3(0,0,0));
+            snapshot.AddPoint(glm::vec3(xs, sinVAngle, zs));
+            snapshot.AddPoint(glm::vec3(0,0,0));
+            snapshot.AddPoint(glm::vec3(xs, -sinVAngle, zs));
+            snapshot.AddPoint(glm::vec3(0,0,0));
+            snapshot.AddPoint(glm::vec3(xe, sinVAngle, ze));
+            snapshot.AddPoint(glm::vec3(0,0,0));
+            snapshot.AddPoint(glm::vec3(xe, -sinVAngle, ze));
         }
-
-        items.push_back(item);
     }
-    return items;
 }
 
 }
@@ -29,6 +29,8 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLDepthCamera.h"
+#include "sensors/SensorScheduler.h"
+#include "sensors/vision/RaycastImager.h"
 
 namespace sf
 {
@@ -45,6 +47,7 @@ Multibeam2::Multibeam2(std::string uniqueName, unsigned int horizontalRes, unsig
     memset(imageData, 0, resX*resY*sizeof(GLfloat));
     rangeData = new GLfloat[resX*resY]; // Buffer for storing final data
     memset(rangeData, 0, resX*resY*sizeof(GLfloat));
+    rcMultibeam = nullptr;
 }
 
 Multibeam2::~Multibeam2()
@@ -53,6 +56,8 @@ Multibeam2::~Multibeam2()
         delete [] imageData;
     if(rangeData != NULL)
         delete [] rangeData;
+    if(rcMultibeam != nullptr)
+        delete rcMultibeam;
     cameras.clear();
 }
     
@@ -137,6 +142,12 @@ void Multibeam2::InitGraphics()
         }
     }
     
+    if(!SimulationApp::getApp()->hasGraphics())
+    {
+        InitRaycasting();
+        return;
+    }
+    
     //Create depth cameras
     GLint accResX = 0;
     for(size_t i=0; i<cameras.size(); ++i)
@@ -159,8 +170,73 @@ void Multibeam2::InitGraphics()
     }
 }
 
+void Multibeam2::InitRaycasting()
+{
+    //One ray through the center of each pixel of each of the pinhole cameras
+    std::vector<Vector3> dirs(resX * resY);
+    rcDepth.resize(resX * resY);
+    Scalar tanV = btTan(btRadians(fovV)/Scalar(2));
+    Scalar accFov(0);
+    Scalar offset = btRadians(fovH)/Scalar(2);
+    unsigned int accResX = 0;
+    
+    for(size_t i=0; i<cameras.size(); ++i)
+    {
+        //Same orientation as the i-th camera in UpdateTransform()
+        Scalar halfFov = btRadians(Scalar(cameras[i].fovH))/Scalar(2);
+        Scalar yaw = offset - accFov - halfFov;
+        accFov += Scalar(2)*halfFov;
+        Vector3 forward(-btSin(yaw), Scalar(0), btCos(yaw));
+        Vector3 right(btCos(yaw), Scalar(0), btSin(yaw));
+        Scalar tanH = btTan(halfFov);
+        
+        for(unsigned int v=0; v<resY; ++v)
+            for(int u=0; u<cameras[i].width; ++u)
+            {
+                Vector3 dir = forward
+                              + right * ((u + Scalar(0.5))/Scalar(cameras[i].width) * Scalar(2) - Scalar(1)) * tanH
+                              + Vector3(0,1,0) * ((v + Scalar(0.5))/Scalar(resY) * Scalar(2) - Scalar(1)) * tanV;
+                dir.normalize();
+                size_t index = v * resX + accResX + u;
+                dirs[index] = dir;
+                rcDepth[index] = (GLfloat)dir.dot(forward); //Conversion of range to depth
+            }
+        cameras[i].dataOffset = accResX*resY;
+        accResX += cameras[i].width;
+    }
+    
+    rcMultibeam = new RaycastImager(randomGenerator);
+    rcMultibeam->setRays(dirs);
+    InternalUpdate(0);
+}
+
+void Multibeam2::UpdateRaycasting()
+{
+    //Rays long enough to reach the far plane in the corners of the images
+    GLfloat minDepth = 1.f;
+    for(size_t i=0; i<rcDepth.size(); ++i)
+        minDepth = rcDepth[i] < minDepth ? rcDepth[i] : minDepth;
+    rcMultibeam->Cast(getSensorFrame(), range.x, range.y/minDepth);
+    const GLfloat* ranges = rcMultibeam->getRanges();
+    for(size_t i=0; i<rcDepth.size(); ++i)
+    {
+        if(ranges[i] <= 0.f || ranges[i] * rcDepth[i] >= range.y) //Nothing hit within the far plane
+            rangeData[i] = range.y;
+        else
+            rangeData[i] = glm::clamp(ranges[i], range.x, range.y);
+    }
+    
+    if(newDataCallback != NULL)
+        SensorScheduler::Notify([this](){ newDataCallback(this); });
+}
+
 void Multibeam2::InternalUpdate(Scalar dt)
 {
+    if(rcMultibeam != nullptr)
+    {
+        UpdateRaycasting();
+        return;
+    }
     for(size_t i=0; i<cameras.size(); ++i)
         cameras[i].cam->Update();
 }
@@ -174,6 +250,9 @@ void Multibeam2::UpdateTransform()
     Scalar accFov(0);
     Scalar offset = fovH/Scalar(360)*M_PI;
    
+    if(rcMultibeam != nullptr)
+        return;
+    
     for(size_t i=0; i<cameras.size(); ++i)
     {
         //Calculate i-th camera transform
@@ -232,18 +311,16 @@ void Multibeam2::NewDataReady(void* data, unsigned int index)
         
         //Call callback
         if(newDataCallback != NULL)
-            newDataCallback(this);
+            SensorScheduler::Notify([this](){ newDataCallback(this); });
     }
 }
     
-std::vector<Renderable> Multibeam2::Render()
+void Multibeam2::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.model = glMatrixFromTransform(getSensorFrame());
-        item.type = RenderableType::SENSOR_LINES;
+        snapshot.Add(RenderableType::SENSOR_LINES, glMatrixFromTransform(getSensorFrame()));
         
         unsigned int div = (unsigned int)ceil(fovH/5.0);
         GLfloat iconSize = 0.5f;
@@ -265,34 +342,31 @@ std::vector<Renderable> Multibeam2::Render()
             GLfloat x1 = sinf(theta1) * r;
             GLfloat x2 = sinf(theta2) * r;
             
-            item.points.push_back(glm::vec3(x1,y,z1));
-            item.points.push_back(glm::vec3(x2,y,z2));
-            item.points.push_back(glm::vec3(x1,-y,z1));
-            item.points.push_back(glm::vec3(x2,-y,z2));
+            snapshot.AddPoint(glm::vec3(x1,y,z1));
+            snapshot.AddPoint(glm::vec3(x2,y,z2));
+            snapshot.AddPoint(glm::vec3(x1,-y,z1));
+            snapshot.AddPoint(glm::vec3(x2,-y,z2));
             
             if(i == 0) //End 1
             {
-                item.points.push_back(glm::vec3(x1,y,z1));
-                item.points.push_back(glm::vec3(x1,-y,z1));
-                item.points.push_back(glm::vec3(x1,y,z1));
-                item.points.push_back(glm::vec3(0,0,0));
-                item.points.push_back(glm::vec3(x1,-y,z1));
-                item.points.push_back(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(x1,y,z1));
+                snapshot.AddPoint(glm::vec3(x1,-y,z1));
+                snapshot.AddPoint(glm::vec3(x1,y,z1));
+                snapshot.AddPoint(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(x1,-y,z1));
+                snapshot.AddPoint(glm::vec3(0,0,0));
             }
             else if(i == div-1) //End 2
             {
-                item.points.push_back(glm::vec3(x2,y,z2));
-                item.points.push_back(glm::vec3(x2,-y,z2));
-                item.points.push_back(glm::vec3(x2,y,z2));
-                item.points.push_back(glm::vec3(0,0,0));
-                item.points.push_back(glm::vec3(x2,-y,z2));
-                item.points.push_back(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(x2,y,z2));
+                snapshot.AddPoint(glm::vec3(x2,-y,z2));
+                snapshot.AddPoint(glm::vec3(x2,y,z2));
+                snapshot.AddPoint(glm::vec3(0,0,0));
+                snapshot.AddPoint(glm::vec3(x2,-y,z2));
+                snapshot.AddPoint(glm::vec3(0,0,0));
             }
         }
-        
-        items.push_back(item);
     }
-    return items;
 }
     
 }
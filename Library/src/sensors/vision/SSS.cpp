@@ -29,6 +29,12 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLSSS.h"
+#include "sensors/SensorScheduler.h"
+#include "sensors/vision/RaycastImager.h"
+
+//Beam sampling (same as in the OpenGL implementation)
+#define SSS_VRES_FACTOR 0.2
+#define SSS_HRES_FACTOR 100.0
 
 namespace sf
 {
@@ -50,11 +56,13 @@ SSS::SSS(std::string uniqueName, unsigned int numOfBins, unsigned int numOfLines
     displayData = NULL;
     newDataCallback = NULL;
     glSSS = nullptr;
+    rcSSS = nullptr;
 }
 
 SSS::~SSS()
 {
     if(displayData != NULL) delete [] displayData;
+    if(rcSSS != nullptr) delete rcSSS;
     glSSS = nullptr;
 }
 
@@ -122,6 +130,12 @@ VisionSensorType SSS::getVisionSensorType()
 
 void SSS::InitGraphics()
 {
+    if(!SimulationApp::getApp()->hasGraphics())
+    {
+        InitRaycasting();
+        return;
+    }
+
     glSSS = new OpenGLSSS(glm::vec3(0,0,0), glm::vec3(0,0,1.f), glm::vec3(0,-1.f,0),
                           (GLfloat)fovH, (GLfloat)fovV, (GLint)resX, (GLint)resY, (GLfloat)tilt, range);
     glSSS->setNoise(noise);
@@ -137,8 +151,110 @@ void SSS::InitGraphics()
     displayData = new GLubyte[w*h*3];
 }
 
+void SSS::InitRaycasting()
+{
+    //Two transducers looking to the sides, tilted down by the same angle
+    nBeamSamples.x = (unsigned int)ceil(fovH * Scalar(resX/2) * Scalar(SSS_VRES_FACTOR));
+    nBeamSamples.y = (unsigned int)ceil(fovV * Scalar(SSS_HRES_FACTOR));
+    nBeamSamples = glm::clamp(nBeamSamples, glm::uvec2(2), glm::uvec2(2048));
+    Scalar vFov = btRadians(fovH);
+    Scalar hFov = btRadians(fovV);
+    std::vector<Vector3> dirs(2 * nBeamSamples.x * nBeamSamples.y);
+    for(unsigned int k=0; k<2; ++k)
+    {
+        Scalar side = k == 0 ? Scalar(-1) : Scalar(1);
+        for(unsigned int i=0; i<nBeamSamples.x; ++i)
+        {
+            Scalar theta = btRadians(tilt) + (Scalar(i)/Scalar(nBeamSamples.x-1) - Scalar(0.5)) * vFov;
+            for(unsigned int h=0; h<nBeamSamples.y; ++h)
+            {
+                Scalar psi = (Scalar(h)/Scalar(nBeamSamples.y-1) - Scalar(0.5)) * hFov;
+                dirs[(k * nBeamSamples.x + i) * nBeamSamples.y + h] = Vector3(side * btCos(theta) * btCos(psi), btSin(psi), btSin(theta) * btCos(psi));
+            }
+        }
+    }
+    rcSSS = new RaycastImager(randomGenerator);
+    rcSSS->setRays(dirs);
+    rcHist.resize(2 * nBeamSamples.x * (resX/2));
+    rcData.assign(resX * resY, 0);
+
+    unsigned int w, h;
+    getDisplayResolution(w, h);
+    displayData = new GLubyte[w*h*3];
+    InternalUpdate(0);
+}
+
+void SSS::UpdateRaycasting()
+{
+    rcSSS->Cast(getSensorFrame(), range.x, range.y);
+    const GLfloat* ranges = rcSSS->getRanges();
+    const GLfloat* intensities = rcSSS->getIntensities();
+    unsigned int nHalfBins = resX/2;
+    GLfloat step = 2.f*(range.y - range.x)/(GLfloat)resX;
+
+    //Histograms of each across-track beam sample (as in the second sonar output shader)
+    RaycastImager::ParallelFor(2 * nBeamSamples.x, [&](size_t i)
+    {
+        glm::vec2* hist = &rcHist[i * nHalfBins];
+        for(unsigned int h=0; h<nHalfBins; ++h)
+            hist[h] = glm::vec2(0.f);
+        for(unsigned int h=0; h<nBeamSamples.y; ++h)
+        {
+            GLfloat r = ranges[i * nBeamSamples.y + h];
+            if(r < range.x || r >= range.y)
+                continue;
+            unsigned int bin = (unsigned int)floorf((r - range.x)/step);
+            bin = bin < nHalfBins ? bin : nHalfBins-1;
+            GLfloat hFrac2 = (h/(GLfloat)(nBeamSamples.y-1) - 0.5f) * 2.f;
+            hFrac2 *= hFrac2;
+            hist[bin].x += intensities[i * nBeamSamples.y + h] * glm::clamp(1.f - hFrac2/2.f, 0.f, 1.f);
+            hist[bin].y += 1.f;
+        }
+    });
+
+    //Shift the waterfall image by one line
+    memmove(&rcData[resX], &rcData[0], resX * (resY-1));
+
+    //Compute the new line (as in the sonar line shader)
+    GLfloat g = (GLfloat)gain;
+    GLfloat vFov = glm::radians((GLfloat)fovH);
+    GLfloat t = glm::radians((GLfloat)tilt);
+    for(unsigned int k=0; k<2; ++k)
+    {
+        GLfloat mulNoise = rcSSS->Gaussian(1.f, noise.x);
+        for(unsigned int x=0; x<nHalfBins; ++x)
+        {
+            glm::vec2 data(0.f);
+            for(unsigned int i=0; i<nBeamSamples.x; ++i)
+            {
+                GLfloat factor = i/(GLfloat)(nBeamSamples.x-1);
+                GLfloat theta = t + (factor - 0.5f) * vFov;
+                glm::vec2 bs = rcHist[(k * nBeamSamples.x + i) * nHalfBins + x];
+                bs.x *= glm::smoothstep(0.f, 0.2f, factor) * (1.f - glm::smoothstep(0.8f, 1.f, factor));
+                bs.x /= glm::max(sinf(theta), 1e-3f); //Intensity compensation based on flat bottom model
+                data += bs;
+            }
+            GLfloat value = g * (x/(GLfloat)(nHalfBins-1)*0.5f + 0.5f) * rcSSS->Gaussian(0.f, noise.y); //Distance dependent amount of noise
+            if(data.y > 0.f)
+                value += 0.7f * data.x/data.y * g * mulNoise;
+            unsigned int bin = k == 0 ? nHalfBins - 1 - x : nHalfBins + x;
+            rcData[bin] = (GLubyte)roundf(glm::clamp(value, 0.f, 1.f) * 255.f);
+        }
+    }
+
+    if(newDataCallback == NULL)
+        return;
+
+    //Display image (color mapped waterfall)
+    for(size_t i=0; i<rcData.size(); ++i)
+        RaycastImager::MapColor(rcData[i]/255.f, cMap, &displayData[i*3]);
+    NewDataReady(rcData.data(), 1);
+}
+
 void SSS::SetupCamera(const Vector3& eye, const Vector3& dir, const Vector3& up)
 {
+    if(glSSS == nullptr)
+        return;
     glm::vec3 eye_ = glm::vec3((GLfloat)eye.x(), (GLfloat)eye.y(), (GLfloat)eye.z());
     glm::vec3 dir_ = glm::vec3((GLfloat)dir.x(), (GLfloat)dir.y(), (GLfloat)dir.z());
     glm::vec3 up_ = glm::vec3((GLfloat)up.x(), (GLfloat)up.y(), (GLfloat)up.z());
@@ -162,9 +278,12 @@ void SSS::NewDataReady(void* data, unsigned int index)
         }
         else
         {
-            sonarData = (GLubyte*)data;
-            newDataCallback(this);
-            sonarData = NULL;
+            SensorScheduler::Notify([this, data]()
+            {
+                sonarData = (GLubyte*)data;
+                newDataCallback(this);
+                sonarData = NULL;
+            });
         }
     }
 }
@@ -173,15 +292,16 @@ void SSS::InternalUpdate(Scalar dt)
 {
     if(glSSS != nullptr)
         glSSS->Update();
+    else if(rcSSS != nullptr)
+        UpdateRaycasting();
 }
 
-std::vector<Renderable> SSS::Render()
+void SSS::Render(RenderSnapshot& snapshot)
 {
-    std::vector<Renderable> items = Sensor::Render();
+    Sensor::Render(snapshot);
     if(isRenderable())
     {
-        Renderable item;
-        item.type = RenderableType::SENSOR_LINES;    
+        Renderable& item = snapshot.Add(RenderableType::SENSOR_LINES);
         
         //Create single transducer dummy
         int div = 12;
@@ -194,9 +314,9 @@ std::vector<Renderable> SSS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             hAngle += fovStep;
         }
         hAngle = -fovStep*(div/2);
@@ -204,9 +324,9 @@ std::vector<Renderable> SSS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, -sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             hAngle += fovStep;
         }
         //Arcs max
@@ -217,9 +337,9 @@ std::vector<Renderable> SSS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, sinVAngle, z));
             hAngle += fovStep;
         }
         hAngle = -fovStep*(div/2);
@@ -227,31 +347,31 @@ std::vector<Renderable> SSS::Render()
         {
             GLfloat z = cosf(hAngle) * cosVAngle;
             GLfloat x = sinf(hAngle) * cosVAngle;
-            item.points.push_back(glm::vec3(x, -sinVAngle, z));
+            snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             if(i > 0 && i < div)
-                item.points.push_back(glm::vec3(x, -sinVAngle, z));
+                snapshot.AddPoint(glm::vec3(x, -sinVAngle, z));
             hAngle += fovStep;
         }
         //Ends
         hAngle = -fovStep*(div/2);
         GLfloat zs = cosf(hAngle) * cosVAngle;
         GLfloat xs = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-        item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(xs, sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(xs, -sinVAngle, zs));
         hAngle = fovStep*(div/2);
         GLfloat ze = cosf(hAngle) * cosVAngle;
         GLfloat xe = sinf(hAngle) * cosVAngle;
-        item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-        item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(xe, sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(xe, -sinVAngle, ze));
         //Pyramid
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xs, sinVAngle, zs));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xs, -sinVAngle, zs));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xe, sinVAngle, ze));
-        item.points.push_back(glm::vec3(0,0,0));
-        item.points.push_back(glm::vec3(xe, -sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xs, sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xs, -sinVAngle, zs));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xe, sinVAngle, ze));
+        snapshot.AddPoint(glm::vec3(0,0,0));
+        snapshot.AddPoint(glm::vec3(xe, -sinVAngle, ze));
 
         //Add two transducer dummies
         GLfloat offsetAngle = M_PI_2 - glm::radians(tilt);
@@ -259,11 +379,8 @@ std::vector<Renderable> SSS::Render()
         views[0] = glm::rotate(-offsetAngle, glm::vec3(0.f,1.f,0.f));
         views[1] = glm::rotate(offsetAngle, glm::vec3(0.f,1.f,0.f));
         item.model = glMatrixFromTransform(getSensorFrame()) * views[0];
-        items.push_back(item);
-        item.model = glMatrixFromTransform(getSensorFrame()) * views[1];
-        items.push_back(item);
+        snapshot.AddInstance(glMatrixFromTransform(getSensorFrame()) * views[1]);
     }
-    return items;
 }
 
 }
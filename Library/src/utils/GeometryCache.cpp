@@ -0,0 +1,495 @@
+/*
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  GeometryCache.cpp
+//  Stonefish
+//
+
+#include "utils/GeometryCache.h"
+
+#include <cstring>
+#include <climits>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "core/SimulationApp.h"
+#include "graphics/OpenGLContent.h"
+
+#define GEOMETRY_CACHE_MAGIC "SFGCACHE"
+#define GEOMETRY_CACHE_VERSION 1
+#define GEOMETRY_CACHE_MESH 1
+#define GEOMETRY_CACHE_PROPERTIES 2
+#define GEOMETRY_CACHE_HULLS 3
+
+namespace sf
+{
+
+std::unordered_map<std::string, Mesh*> GeometryCache::meshes;
+std::unordered_map<std::string, DerivedMeshProperties> GeometryCache::properties;
+std::unordered_map<std::string, std::vector<std::vector<Vector3>>> GeometryCache::hulls;
+std::string GeometryCache::directory = "";
+bool GeometryCache::directoryInitialized = false;
+
+//Helpers for building and parsing the binary payloads
+static void append(std::vector<uint8_t>& buf, const void* data, size_t size)
+{
+    buf.insert(buf.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+static bool extract(const std::vector<uint8_t>& buf, size_t& offset, void* data, size_t size)
+{
+    if(offset > buf.size() || size > buf.size() - offset)
+        return false;
+    memcpy(data, buf.data() + offset, size);
+    offset += size;
+    return true;
+}
+
+//Checks if a number of elements read from a payload fits in its remaining part, before allocating memory
+static bool fits(const std::vector<uint8_t>& buf, size_t offset, uint64_t count, size_t elementSize)
+{
+    return offset <= buf.size() && count <= (buf.size() - offset)/elementSize;
+}
+
+static uint64_t fnv1a(const std::string& str)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i=0; i<str.size(); ++i)
+    {
+        h ^= (uint8_t)str[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+SDL_mutex* GeometryCache::getMutex()
+{
+    static SDL_mutex* mutex = SDL_CreateMutex();
+    return mutex;
+}
+
+Mesh* GeometryCache::LoadMesh(const std::string& path, GLfloat scale, bool smooth, GLfloat refineThreshold)
+{
+    std::string key = getMeshKey(path, scale, smooth, refineThreshold);
+    if(key == "")
+        return LoadGeometryFromFile(path, scale); //Reports the missing file
+
+    SDL_LockMutex(getMutex());
+    Mesh* mesh = nullptr;
+    auto it = meshes.find(key);
+    if(it != meshes.end())
+        mesh = it->second;
+    else
+    {
+        mesh = ReadMesh(key);
+        if(mesh == nullptr)
+        {
+            mesh = LoadGeometryFromFile(path, scale);
+            if(mesh != nullptr)
+            {
+                if(smooth)
+                    OpenGLContent::SmoothNormals(mesh);
+                if(mesh->isTexturable())
+                    OpenGLContent::ComputeTangents((TexturableMesh*)mesh);
+                if(refineThreshold > 0.f)
+                    OpenGLContent::Refine(mesh, refineThreshold);
+                WriteMesh(key, mesh);
+            }
+        }
+        if(mesh != nullptr)
+            meshes[key] = mesh;
+    }
+    Mesh* copy = mesh != nullptr ? CopyMesh(mesh) : nullptr;
+    SDL_UnlockMutex(getMutex());
+    return copy;
+}
+
+std::string GeometryCache::getMeshKey(const std::string& path, GLfloat scale, bool smooth, GLfloat refineThreshold)
+{
+    char canonical[PATH_MAX];
+    struct stat st;
+    if(realpath(path.c_str(), canonical) == NULL || stat(canonical, &st) != 0)
+        return "";
+
+    char params[128];
+    snprintf(params, sizeof(params), "|%lld|%lld|%a|%d|%a", (long long)st.st_mtime, (long long)st.st_size,
+             (double)scale, smooth ? 1 : 0, (double)refineThreshold);
+    return std::string(canonical) + std::string(params);
+}
+
+std::string GeometryCache::MakeKey(const std::string& meshKey, const std::vector<Scalar>& params)
+{
+    if(meshKey == "")
+        return "";
+
+    std::string key = meshKey;
+    char value[64];
+    for(size_t i=0; i<params.size(); ++i)
+    {
+        snprintf(value, sizeof(value), "|%a", (double)params[i]);
+        key += value;
+    }
+    return key;
+}
+
+bool GeometryCache::getProperties(const std::string& key, DerivedMeshProperties& props)
+{
+    if(key == "")
+        return false;
+
+    SDL_LockMutex(getMutex());
+    auto it = properties.find(key);
+    if(it != properties.end())
+    {
+        props = it->second;
+        SDL_UnlockMutex(getMutex());
+        return true;
+    }
+
+    std::vector<uint8_t> payload;
+    bool found = false;
+    if(ReadFile(key, "prop", GEOMETRY_CACHE_PROPERTIES, payload))
+    {
+        size_t o = 0;
+        uint32_t nParams;
+        Scalar basis[9];
+        Vector3 origin;
+        found = extract(payload, o, &props.physical.mass, sizeof(Scalar))
+                && extract(payload, o, props.physical.CG.m_floats, sizeof(Scalar)*3)
+                && extract(payload, o, &props.physical.volume, sizeof(Scalar))
+                && extract(payload, o, props.physical.Ipri.m_floats, sizeof(Scalar)*3)
+                && extract(payload, o, basis, sizeof(basis))
+                && extract(payload, o, &props.approxType, sizeof(uint32_t))
+                && extract(payload, o, &nParams, sizeof(uint32_t));
+        found = found && fits(payload, o, nParams, sizeof(Scalar));
+        if(found)
+        {
+            props.physical.Irot.setValue(basis[0], basis[1], basis[2], basis[3], basis[4], basis[5], basis[6], basis[7], basis[8]);
+            props.approxParams.resize(nParams);
+            found = extract(payload, o, props.approxParams.data(), sizeof(Scalar)*nParams)
+                    && extract(payload, o, origin.m_floats, sizeof(Scalar)*3)
+                    && extract(payload, o, basis, sizeof(basis))
+                    && extract(payload, o, props.addedMass.m_floats, sizeof(Scalar)*3)
+                    && extract(payload, o, props.addedInertia.m_floats, sizeof(Scalar)*3);
+        }
+        if(found)
+        {
+            props.T_CG2H.setOrigin(origin);
+            props.T_CG2H.getBasis().setValue(basis[0], basis[1], basis[2], basis[3], basis[4], basis[5], basis[6], basis[7], basis[8]);
+            properties[key] = props;
+        }
+    }
+    SDL_UnlockMutex(getMutex());
+    return found;
+}
+
+void GeometryCache::setProperties(const std::string& key, const DerivedMeshProperties& props)
+{
+    if(key == "")
+        return;
+
+    auto appendMatrix = [](std::vector<uint8_t>& buf, const Matrix3& M)
+    {
+        for(int i=0; i<3; ++i)
+            for(int h=0; h<3; ++h)
+            {
+                Scalar v = M[i][h];
+                append(buf, &v, sizeof(Scalar));
+            }
+    };
+
+    std::vector<uint8_t> payload;
+    uint32_t nParams = (uint32_t)props.approxParams.size();
+    append(payload, &props.physical.mass, sizeof(Scalar));
+    append(payload, props.physical.CG.m_floats, sizeof(Scalar)*3);
+    append(payload, &props.physical.volume, sizeof(Scalar));
+    append(payload, props.physical.Ipri.m_floats, sizeof(Scalar)*3);
+    appendMatrix(payload, props.physical.Irot);
+    append(payload, &props.approxType, sizeof(uint32_t));
+    append(payload, &nParams, sizeof(uint32_t));
+    append(payload, props.approxParams.data(), sizeof(Scalar)*nParams);
+    append(payload, props.T_CG2H.getOrigin().m_floats, sizeof(Scalar)*3);
+    appendMatrix(payload, props.T_CG2H.getBasis());
+    append(payload, props.addedMass.m_floats, sizeof(Scalar)*3);
+    append(payload, props.addedInertia.m_floats, sizeof(Scalar)*3);
+
+    SDL_LockMutex(getMutex());
+    properties[key] = props;
+    WriteFile(key, "prop", GEOMETRY_CACHE_PROPERTIES, payload);
+    SDL_UnlockMutex(getMutex());
+}
+
+bool GeometryCache::getHulls(const std::string& key, std::vector<std::vector<Vector3>>& hullSet)
+{
+    if(key == "")
+        return false;
+
+    SDL_LockMutex(getMutex());
+    auto it = hulls.find(key);
+    if(it != hulls.end())
+    {
+        hullSet = it->second;
+        SDL_UnlockMutex(getMutex());
+        return true;
+    }
+
+    std::vector<uint8_t> payload;
+    bool found = false;
+    if(ReadFile(key, "hull", GEOMETRY_CACHE_HULLS, payload))
+    {
+        size_t o = 0;
+        uint32_t nHulls, nPoints;
+        found = extract(payload, o, &nHulls, sizeof(uint32_t)) && fits(payload, o, nHulls, sizeof(uint32_t));
+        if(found)
+            hullSet.resize(nHulls);
+        for(uint32_t i=0; found && i<nHulls; ++i)
+        {
+            found = extract(payload, o, &nPoints, sizeof(uint32_t)) && fits(payload, o, nPoints, sizeof(Scalar)*3);
+            if(!found)
+                break;
+            hullSet[i].resize(nPoints);
+            for(uint32_t h=0; found && h<nPoints; ++h)
+                found = extract(payload, o, hullSet[i][h].m_floats, sizeof(Scalar)*3);
+        }
+        if(found)
+            hulls[key] = hullSet;
+    }
+    SDL_UnlockMutex(getMutex());
+    return found;
+}
+
+void GeometryCache::setHulls(const std::string& key, const std::vector<std::vector<Vector3>>& hullSet)
+{
+    if(key == "")
+        return;
+
+    std::vector<uint8_t> payload;
+    uint32_t nHulls = (uint32_t)hullSet.size();
+    append(payload, &nHulls, sizeof(uint32_t));
+    for(size_t i=0; i<hullSet.size(); ++i)
+    {
+        uint32_t nPoints = (uint32_t)hullSet[i].size();
+        append(payload, &nPoints, sizeof(uint32_t));
+        for(size_t h=0; h<hullSet[i].size(); ++h)
+            append(payload, hullSet[i][h].m_floats, sizeof(Scalar)*3);
+    }
+
+    SDL_LockMutex(getMutex());
+    hulls[key] = hullSet;
+    WriteFile(key, "hull", GEOMETRY_CACHE_HULLS, payload);
+    SDL_UnlockMutex(getMutex());
+}
+
+void GeometryCache::setDirectory(const std::string& path)
+{
+    SDL_LockMutex(getMutex());
+    directory = path;
+    directoryInitialized = true;
+    SDL_UnlockMutex(getMutex());
+}
+
+std::string GeometryCache::getDirectory()
+{
+    SDL_LockMutex(getMutex());
+    if(!directoryInitialized)
+    {
+        const char* env;
+        if((env = getenv("STONEFISH_CACHE_DIR")) != NULL)
+            directory = std::string(env);
+        else if((env = getenv("XDG_CACHE_HOME")) != NULL)
+            directory = std::string(env) + "/stonefish";
+        else if((env = getenv("HOME")) != NULL)
+            directory = std::string(env) + "/.cache/stonefish";
+        directoryInitialized = true;
+    }
+    std::string dir = directory;
+    SDL_UnlockMutex(getMutex());
+    return dir;
+}
+
+void GeometryCache::Clear()
+{
+    SDL_LockMutex(getMutex());
+    for(auto it = meshes.begin(); it != meshes.end(); ++it)
+        delete it->second;
+    meshes.clear();
+    properties.clear();
+    hulls.clear();
+    SDL_UnlockMutex(getMutex());
+}
+
+std::string GeometryCache::FilePath(const std::string& key, const char* extension)
+{
+    std::string dir = getDirectory();
+    if(dir == "")
+        return "";
+
+    char name[64];
+    snprintf(name, sizeof(name), "/%016llx.%s", (unsigned long long)fnv1a(key), extension);
+    return dir + std::string(name);
+}
+
+bool GeometryCache::ReadFile(const std::string& key, const char* extension, uint32_t kind, std::vector<uint8_t>& payload)
+{
+    std::string path = FilePath(key, extension);
+    if(path == "")
+        return false;
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL)
+        return false;
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    //Header: magic, version, size of scalar, kind of entry and the full key (to detect hash collisions)
+    char magic[8];
+    uint32_t header[4];
+    bool valid = fread(magic, 1, 8, file) == 8 && memcmp(magic, GEOMETRY_CACHE_MAGIC, 8) == 0
+                 && fread(header, sizeof(uint32_t), 4, file) == 4
+                 && header[0] == GEOMETRY_CACHE_VERSION && header[1] == sizeof(Scalar) && header[2] == kind;
+    if(valid) //Key length taken from a truncated or corrupted file must not exceed the file
+    {
+        valid = header[3] == key.size() && (long)header[3] <= fileSize - ftell(file);
+        if(valid)
+        {
+            std::string storedKey(header[3], '\0');
+            valid = fread(&storedKey[0], 1, header[3], file) == header[3] && storedKey == key;
+        }
+    }
+    if(valid)
+    {
+        long start = ftell(file);
+        valid = start >= 0 && fileSize >= start;
+        if(valid)
+        {
+            payload.resize((size_t)(fileSize - start));
+            valid = fread(payload.data(), 1, payload.size(), file) == payload.size();
+        }
+    }
+    fclose(file);
+    return valid;
+}
+
+void GeometryCache::WriteFile(const std::string& key, const char* extension, uint32_t kind, const std::vector<uint8_t>& payload)
+{
+    std::string path = FilePath(key, extension);
+    if(path == "")
+        return;
+
+    //Create the directory tree
+    std::string dir = getDirectory();
+    for(size_t p = dir.find('/', 1); ; p = dir.find('/', p+1))
+    {
+        mkdir(dir.substr(0, p).c_str(), 0755);
+        if(p == std::string::npos)
+            break;
+    }
+
+    //Written to a temporary file and renamed, so that other processes never read partial entries
+    std::string tmpPath = path + "." + std::to_string(getpid());
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if(file == NULL)
+        return;
+
+    uint32_t header[4] = {GEOMETRY_CACHE_VERSION, sizeof(Scalar), kind, (uint32_t)key.size()};
+    bool ok = fwrite(GEOMETRY_CACHE_MAGIC, 1, 8, file) == 8
+              && fwrite(header, sizeof(uint32_t), 4, file) == 4
+              && fwrite(key.data(), 1, key.size(), file) == key.size()
+              && fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    ok = fclose(file) == 0 && ok;
+
+    if(!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        cWarning("Failed to write geometry cache entry: %s", path.c_str());
+    }
+}
+
+Mesh* GeometryCache::ReadMesh(const std::string& key)
+{
+    std::vector<uint8_t> payload;
+    if(!ReadFile(key, "mesh", GEOMETRY_CACHE_MESH, payload))
+        return nullptr;
+
+    size_t o = 0;
+    uint32_t texturable;
+    uint64_t nVertices, nFaces;
+    if(!extract(payload, o, &texturable, sizeof(uint32_t))
+       || !extract(payload, o, &nVertices, sizeof(uint64_t))
+       || !extract(payload, o, &nFaces, sizeof(uint64_t)))
+        return nullptr;
+    
+    //Reject entries declaring more data than stored
+    size_t vertexSize = texturable ? sizeof(TexturableVertex) : sizeof(Vertex);
+    if(!fits(payload, o, nVertices, vertexSize) || !fits(payload, o + vertexSize * nVertices, nFaces, sizeof(Face)))
+        return nullptr;
+
+    Mesh* mesh;
+    void* vertices;
+    if(texturable)
+    {
+        TexturableMesh* m = new TexturableMesh();
+        m->vertices.resize(nVertices);
+        vertices = m->vertices.data();
+        mesh = m;
+    }
+    else
+    {
+        PlainMesh* m = new PlainMesh();
+        m->vertices.resize(nVertices);
+        vertices = m->vertices.data();
+        mesh = m;
+    }
+    mesh->faces.resize(nFaces);
+
+    if(!extract(payload, o, vertices, vertexSize * nVertices)
+       || !extract(payload, o, mesh->faces.data(), sizeof(Face) * nFaces))
+    {
+        delete mesh;
+        return nullptr;
+    }
+    return mesh;
+}
+
+void GeometryCache::WriteMesh(const std::string& key, const Mesh* mesh)
+{
+    std::vector<uint8_t> payload;
+    uint32_t texturable = mesh->isTexturable() ? 1 : 0;
+    uint64_t nVertices = mesh->getNumOfVertices();
+    uint64_t nFaces = mesh->faces.size();
+    payload.reserve(sizeof(uint32_t) + 2*sizeof(uint64_t) + mesh->getVertexSize() * nVertices + sizeof(Face) * nFaces);
+    append(payload, &texturable, sizeof(uint32_t));
+    append(payload, &nVertices, sizeof(uint64_t));
+    append(payload, &nFaces, sizeof(uint64_t));
+    if(nVertices > 0)
+        append(payload, mesh->getVertexDataPointer(), mesh->getVertexSize() * nVertices);
+    if(nFaces > 0)
+        append(payload, mesh->getFaceDataPointer(), sizeof(Face) * nFaces);
+    WriteFile(key, "mesh", GEOMETRY_CACHE_MESH, payload);
+}
+
+Mesh* GeometryCache::CopyMesh(const Mesh* mesh)
+{
+    if(mesh->isTexturable())
+        return new TexturableMesh(*(const TexturableMesh*)mesh);
+    else
+        return new PlainMesh(*(const PlainMesh*)mesh);
+}
+
+}
@@ -26,7 +26,16 @@
 #include "utils/GeometryFileUtil.h"
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LinearMath/btConvexHullComputer.h"
 #include "core/SimulationApp.h"
+#include "core/ThreadPool.h"
 #include "utils/SystemUtil.hpp"
 
 namespace sf
@@ -47,198 +56,496 @@ Mesh* LoadGeometryFromFile(const std::string& path, GLfloat scale)
     return mesh;
 }
 
-Mesh* LoadOBJ(const std::string& path, GLfloat scale)
+//Helpers of the geometry file parsers
+namespace
 {
-    //Read OBJ data
-    FILE* file = fopen(path.c_str(), "rb");
-    
-    if(file == NULL)
+
+//A read-only memory mapping of a file
+struct MappedFile
+{
+    const char* data;
+    size_t size;
+
+    MappedFile(const std::string& path) : data(nullptr), size(0)
     {
-        cCritical("Failed to open geometry file: %s", path.c_str());
-        return nullptr;
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return;
+        struct stat st;
+        if(fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(ptr != MAP_FAILED)
+            {
+                data = (const char*)ptr;
+                size = (size_t)st.st_size;
+            }
+        }
+        close(fd);
     }
-    
-    cInfo("Loading geometry from: %s", path.c_str());
-    
-    char line[1024];
+
+    ~MappedFile()
+    {
+        if(data != nullptr)
+            munmap((void*)data, size);
+    }
+};
+
+//Files larger than this are parsed in parallel
+const size_t parallelParseSize = 1 << 20;
+
+//Splits text into chunks ending at line boundaries
+std::vector<std::pair<const char*, const char*>> SplitLines(const char* data, size_t size, size_t n)
+{
+    std::vector<std::pair<const char*, const char*>> chunks;
+    const char* end = data + size;
+    const char* begin = data;
+    for(size_t i=1; i<=n && begin < end; ++i)
+    {
+        const char* cut = i == n ? end : data + size * i / n;
+        if(cut < begin)
+            cut = begin;
+        if(cut < end)
+        {
+            cut = (const char*)memchr(cut, '\n', end - cut);
+            cut = cut == nullptr ? end : cut + 1;
+        }
+        chunks.push_back(std::make_pair(begin, cut));
+        begin = cut;
+    }
+    return chunks;
+}
+
+void RunChunks(size_t count, const std::function<void(size_t)>& task, ThreadPool* pool)
+{
+    if(pool != nullptr)
+        pool->ParallelFor(count, task);
+    else
+        for(size_t i=0; i<count; ++i)
+            task(i);
+}
+
+inline bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline void SkipBlanks(const char*& p, const char* end)
+{
+    while(p < end && IsBlank(*p)) ++p;
+}
+
+inline bool ParseInt(const char*& p, const char* end, int64_t& value)
+{
+    //The position is left unchanged on failure, also when the value does not fit in 64 bits
+    const char* q = p;
+    SkipBlanks(q, end);
+    bool neg = false;
+    if(q < end && (*q == '-' || *q == '+'))
+        neg = *q++ == '-';
+    if(q >= end || *q < '0' || *q > '9')
+        return false;
+    int64_t v = 0;
+    while(q < end && *q >= '0' && *q <= '9')
+    {
+        int64_t d = *q++ - '0';
+        if(v > (INT64_MAX - d) / 10)
+            return false;
+        v = v * 10 + d;
+    }
+    value = neg ? -v : v;
+    p = q;
+    return true;
+}
+
+inline bool ParseFloat(const char*& p, const char* end, float& value)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    SkipBlanks(p, end);
+    const char* start = p;
+    bool neg = false;
+    if(p < end && (*p == '-' || *p == '+'))
+        neg = *p++ == '-';
+
+    double mantissa = 0.0;
+    int exponent = 0;
+    bool digits = false;
+    while(p < end && *p >= '0' && *p <= '9')
+    {
+        mantissa = mantissa * 10.0 + (*p++ - '0');
+        digits = true;
+    }
+    if(p < end && *p == '.')
+    {
+        ++p;
+        while(p < end && *p >= '0' && *p <= '9')
+        {
+            mantissa = mantissa * 10.0 + (*p++ - '0');
+            --exponent;
+            digits = true;
+        }
+    }
+    if(!digits) //Special values (nan, inf) are left to the standard library
+    {
+        char buffer[32];
+        size_t len = 0;
+        for(p = start; p < end && len < sizeof(buffer)-1 && !IsBlank(*p) && *p != '\n'; ++p)
+            buffer[len++] = *p;
+        buffer[len] = '\0';
+        char* parsed;
+        value = strtof(buffer, &parsed);
+        p = start + (parsed - buffer);
+        return parsed != buffer;
+    }
+    if(p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* e = ++p;
+        int64_t exp;
+        if(ParseInt(e, end, exp))
+        {
+            exponent += (int)(exp > 1000 ? 1000 : (exp < -1000 ? -1000 : exp)); //Far beyond the range of float
+            p = e;
+        }
+        else
+        {
+            const char* d = e < end && (*e == '-' || *e == '+') ? e + 1 : e;
+            if(d < end && *d >= '0' && *d <= '9') //Exponent does not fit in 64 bits
+                return false;
+        }
+    }
+
+    if(exponent >= 0)
+        mantissa *= exponent <= 22 ? pow10[exponent] : std::pow(10.0, exponent);
+    else
+        mantissa /= -exponent <= 22 ? pow10[-exponent] : std::pow(10.0, -exponent);
+    value = (float)(neg ? -mantissa : mantissa);
+    return true;
+}
+
+//Face corners store absolute indices (>= 0), indices relative to the chunk (< 0, biased) or nothing
+const int64_t cornerNone = INT64_MIN;
+const int64_t cornerRelBias = (int64_t)1 << 40;
+
+struct OBJChunk
+{
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> uvs;
-    Mesh* mesh_ = nullptr;
-    int64_t start = GetTimeInMicroseconds();
-    
-    //Read vertices
-    while(fgets(line, 1024, file))
+    std::vector<int64_t> corners; //Triangulated, 3 indices (position, uv, normal) per corner
+    bool valid = true;
+};
+
+inline int64_t EncodeIndex(int64_t index, size_t count)
+{
+    if(index > 0)
+        return index - 1;
+    else if(index < 0)
+        return (int64_t)count + index - cornerRelBias;
+    else
+        return cornerNone;
+}
+
+inline int64_t DecodeIndex(int64_t index, size_t offset)
+{
+    if(index == cornerNone || index >= 0)
+        return index;
+    return index + cornerRelBias + (int64_t)offset;
+}
+
+void ParseOBJChunk(const char* p, const char* end, GLfloat scale, OBJChunk& chunk)
+{
+    std::vector<int64_t> polygon;
+
+    while(p < end)
     {
-        if(line[0] == 'v')
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if(eol == nullptr)
+            eol = end;
+        SkipBlanks(p, eol);
+
+        if(eol - p > 2 && p[0] == 'v')
         {
-            if(line[1] == ' ')
+            if(IsBlank(p[1]))
             {
                 glm::vec3 v;
-                sscanf(line, "v %f %f %f\n", &v.x, &v.y, &v.z);
-                v *= scale; //Scaling
-                positions.push_back(v);
+                p += 2;
+                if(ParseFloat(p, eol, v.x) && ParseFloat(p, eol, v.y) && ParseFloat(p, eol, v.z))
+                    chunk.positions.push_back(v * scale);
+                else
+                    chunk.valid = false;
             }
-            else if(line[1] == 'n')
+            else if(p[1] == 'n' && IsBlank(p[2]))
             {
                 glm::vec3 n;
-                sscanf(line, "vn %f %f %f\n", &n.x, &n.y, &n.z);
-                normals.push_back(n);
+                p += 3;
+                if(ParseFloat(p, eol, n.x) && ParseFloat(p, eol, n.y) && ParseFloat(p, eol, n.z))
+                    chunk.normals.push_back(n);
+                else
+                    chunk.valid = false;
             }
-            else if(line[1] == 't')
+            else if(p[1] == 't' && IsBlank(p[2]))
             {
                 glm::vec2 uv;
-                sscanf(line, "vt %f %f\n", &uv.x, &uv.y);
-                uvs.push_back(uv);
+                p += 3;
+                if(ParseFloat(p, eol, uv.x) && ParseFloat(p, eol, uv.y))
+                    chunk.uvs.push_back(uv);
+                else
+                    chunk.valid = false;
             }
         }
-    }
-    fseek(file, 0, SEEK_SET); //Go back to beginning of file
-    
-    size_t genVStart = positions.size();
-    bool hasNormals = normals.size() > 0;
-    bool hasUVs = uvs.size() > 0;
-
-#ifdef DEBUG
-    printf("Vertices: %ld Normals: %ld\n", genVStart, normals.size());
-#endif
-    
-    if(hasUVs)
-    {
-        TexturableMesh* mesh = new TexturableMesh;
-
-        //Initialize positions
-        for(size_t i=0; i<positions.size(); ++i)
-        {
-            TexturableVertex v;
-            v.pos = positions[i];
-            mesh->vertices.push_back(v);
-        }
-
-        //Read faces
-        while(fgets(line, 1024, file))
+        else if(eol - p > 2 && p[0] == 'f' && IsBlank(p[1]))
         {
-            if(line[0] != 'f')
-                continue;
-        
-            Face face;
-            unsigned int vID[3];
-            unsigned int uvID[3];
-            unsigned int nID[3];
-            sscanf(line, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", &vID[0], &uvID[0], &nID[0], &vID[1], &uvID[1], &nID[1], &vID[2], &uvID[2], &nID[2]);
-        
-            for(short unsigned int i=0; i<3; ++i)
+            //Polygon of arbitrary size, corners in form v, v/vt, v//vn or v/vt/vn
+            polygon.clear();
+            p += 2;
+            int64_t v, t, n;
+            while(ParseInt(p, eol, v))
             {
-                TexturableVertex v = mesh->vertices[vID[i]-1]; //Vertex from previously read pool
-            
-                if(glm::length2(v.normal) == 0.f) //Is it a fresh vertex?
-                {
-                    mesh->vertices[vID[i]-1].normal = normals[nID[i]-1];
-                    mesh->vertices[vID[i]-1].uv = uvs[uvID[i]-1];
-                    face.vertexID[i] = vID[i]-1;
-                }
-                else if((v.normal == normals[nID[i]-1]) && (v.uv == uvs[uvID[i]-1])) //Does it have the same normal and UV?
-                {
-                    face.vertexID[i] = vID[i]-1;
-                }
-                else //Otherwise search the generated pool
+                t = n = 0;
+                if(p < eol && *p == '/')
                 {
-                    v.normal = normals[nID[i]-1];
-                    v.uv = uvs[uvID[i]-1];
-                
-                    std::vector<TexturableVertex>::iterator it;
-                    if((it = std::find(mesh->vertices.begin()+genVStart, mesh->vertices.end(), v)) != mesh->vertices.end()) //If vertex exists
-                    {
-                        face.vertexID[i] = (GLuint)(it - mesh->vertices.begin());
-                    }
-                    else
+                    ++p;
+                    if(p < eol && *p != '/' && !ParseInt(p, eol, t))
+                        chunk.valid = false;
+                    if(p < eol && *p == '/')
                     {
-                        mesh->vertices.push_back(v);
-                        face.vertexID[i] = (GLuint)mesh->vertices.size()-1;
+                        ++p;
+                        if(!ParseInt(p, eol, n))
+                            chunk.valid = false;
                     }
                 }
+                polygon.push_back(EncodeIndex(v, chunk.positions.size()));
+                polygon.push_back(EncodeIndex(t, chunk.uvs.size()));
+                polygon.push_back(EncodeIndex(n, chunk.normals.size()));
             }
+            SkipBlanks(p, eol);
+            if(p < eol) //Corner that could not be parsed, e.g., index out of range
+                chunk.valid = false;
 
-            mesh->faces.push_back(face);
+            //Triangle fan
+            size_t nCorners = polygon.size()/3;
+            if(nCorners < 3)
+                chunk.valid = false;
+            for(size_t i=1; i+1<nCorners; ++i)
+            {
+                chunk.corners.insert(chunk.corners.end(), polygon.data(), polygon.data() + 3);
+                chunk.corners.insert(chunk.corners.end(), polygon.data() + i*3, polygon.data() + i*3 + 6);
+            }
         }
-        mesh_ = mesh;
+        p = eol + 1;
     }
-    else    
+}
+
+inline void SetUV(Vertex& v, const glm::vec2& uv)
+{
+}
+
+inline void SetUV(TexturableVertex& v, const glm::vec2& uv)
+{
+    v.uv = uv;
+}
+
+struct CornerKey
+{
+    int64_t v, t, n;
+
+    bool operator==(const CornerKey& other) const
     {
-        PlainMesh* mesh = new PlainMesh;
+        return v == other.v && t == other.t && n == other.n;
+    }
+};
+
+struct CornerKeyHash
+{
+    size_t operator()(const CornerKey& k) const
+    {
+        return std::hash<int64_t>()(k.v) ^ (std::hash<int64_t>()(k.t) * 31) ^ (std::hash<int64_t>()(k.n) * 131);
+    }
+};
 
-        //Initialize positions
-        for(size_t i=0; i<positions.size(); ++i)
+//Builds mesh vertices from the corners, reusing the vertex of a position while its attributes do not change
+template<class MeshType, class VertexType>
+bool AssembleOBJMesh(MeshType* mesh, const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+                     const std::vector<glm::vec2>& uvs, const std::vector<int64_t>& corners)
+{
+    size_t nPositions = positions.size();
+    mesh->vertices.resize(nPositions);
+    mesh->faces.resize(corners.size()/9);
+    for(size_t i=0; i<nPositions; ++i)
+        mesh->vertices[i].pos = positions[i];
+
+    std::vector<uint8_t> assigned(nPositions, 0);
+    std::unordered_map<CornerKey, GLuint, CornerKeyHash> generated;
+
+    for(size_t i=0; i<corners.size()/3; ++i)
+    {
+        CornerKey c = {corners[i*3], corners[i*3+1], corners[i*3+2]};
+        if(c.v < 0 || c.v >= (int64_t)nPositions
+           || (c.t != cornerNone && (c.t < 0 || c.t >= (int64_t)uvs.size()))
+           || (c.n != cornerNone && (c.n < 0 || c.n >= (int64_t)normals.size())))
+            return false;
+
+        VertexType v = mesh->vertices[c.v];
+        v.normal = c.n != cornerNone ? normals[c.n] : glm::vec3(0.f);
+        SetUV(v, c.t != cornerNone ? uvs[c.t] : glm::vec2(0.f));
+
+        GLuint id;
+        if(!assigned[c.v]) //Fresh vertex
         {
-            Vertex v;
-            v.pos = positions[i];
-            mesh->vertices.push_back(v);
+            mesh->vertices[c.v] = v;
+            assigned[c.v] = 1;
+            id = (GLuint)c.v;
         }
-
-        //Read faces
-        while(fgets(line, 1024, file))
+        else if(mesh->vertices[c.v] == v) //Same attributes
+            id = (GLuint)c.v;
+        else //Otherwise search the generated pool
         {
-            if(line[0] != 'f')
-                continue;
-        
-            Face face;
+            auto it = generated.find(c);
+            if(it != generated.end())
+                id = it->second;
+            else
+            {
+                mesh->vertices.push_back(v);
+                id = (GLuint)mesh->vertices.size()-1;
+                generated[c] = id;
+            }
+        }
+        mesh->faces[i/3].vertexID[i%3] = id;
+    }
+    return true;
+}
 
-            if(hasNormals)
+struct STLChunk
+{
+    std::vector<Vertex> vertices;
+    size_t leading = 0; //Number of vertices preceding the first facet of the chunk
+    bool hasNormal = false;
+    glm::vec3 normal;
+};
+
+void ParseSTLChunk(const char* p, const char* end, GLfloat scale, STLChunk& chunk)
+{
+    glm::vec3 normal(0.f);
+
+    while(p < end)
+    {
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if(eol == nullptr)
+            eol = end;
+        SkipBlanks(p, eol);
+
+        if(eol - p > 6 && strncmp(p, "vertex", 6) == 0)
+        {
+            Vertex v;
+            p += 6;
+            if(ParseFloat(p, eol, v.pos.x) && ParseFloat(p, eol, v.pos.y) && ParseFloat(p, eol, v.pos.z))
             {
-                unsigned int vID[3];
-                unsigned int nID[3];
-                sscanf(line, "f %u//%u %u//%u %u//%u\n", &vID[0], &nID[0], &vID[1], &nID[1], &vID[2], &nID[2]);
-                
-                for(short unsigned int i=0; i<3; ++i)
-                {
-                    Vertex v = mesh->vertices[vID[i]-1]; //Vertex from previously read pool
-                    
-                    if(glm::length2(v.normal) == 0.f) //Is it a fresh vertex?
-                    {
-                        mesh->vertices[vID[i]-1].normal = normals[nID[i]-1];
-                        face.vertexID[i] = vID[i]-1;
-                    }
-                    else if(v.normal == normals[nID[i]-1]) //Does it have the same normal?
-                    {
-                        face.vertexID[i] = vID[i]-1;
-                    }
-                    else //Otherwise search the generated pool
-                    {
-                        v.normal = normals[nID[i]-1];
-                        
-                        std::vector<Vertex>::iterator it;
-                        if((it = std::find(mesh->vertices.begin()+genVStart, mesh->vertices.end(), v)) != mesh->vertices.end()) //If vertex exists
-                        {
-                            face.vertexID[i] = (GLuint)(it - mesh->vertices.begin());
-                        }
-                        else
-                        {
-                            mesh->vertices.push_back(v);
-                            face.vertexID[i] = (GLuint)mesh->vertices.size()-1;
-                        }
-                    }
-                }
+                v.pos *= scale;
+                v.normal = normal;
+                chunk.vertices.push_back(v);
+                if(!chunk.hasNormal)
+                    ++chunk.leading;
             }
-            else
+        }
+        else if(eol - p > 5 && strncmp(p, "facet", 5) == 0)
+        {
+            p += 5;
+            SkipBlanks(p, eol);
+            if(eol - p > 6 && strncmp(p, "normal", 6) == 0)
             {
-                unsigned int vID[3];
-                sscanf(line, "f %u %u %u\n", &vID[0], &vID[1], &vID[2]);
-                
-                face.vertexID[0] = vID[0]-1;
-                face.vertexID[1] = vID[1]-1;
-                face.vertexID[2] = vID[2]-1;
+                p += 6;
+                if(!ParseFloat(p, eol, normal.x) || !ParseFloat(p, eol, normal.y) || !ParseFloat(p, eol, normal.z))
+                    normal = glm::vec3(0.f);
             }
-        
-            mesh->faces.push_back(face);
+            chunk.hasNormal = true;
         }
+        p = eol + 1;
+    }
+    chunk.normal = normal;
+}
+
+}
+
+Mesh* LoadOBJ(const std::string& path, GLfloat scale)
+{
+    //Map OBJ data
+    MappedFile file(path);
+    
+    if(file.data == nullptr)
+    {
+        cCritical("Failed to open geometry file: %s", path.c_str());
+        return nullptr;
+    }
+    
+    cInfo("Loading geometry from: %s", path.c_str());
+    int64_t start = GetTimeInMicroseconds();
+    
+    //Parse chunks of lines in parallel
+    ThreadPool* pool = file.size >= parallelParseSize ? new ThreadPool() : nullptr;
+    std::vector<std::pair<const char*, const char*>> ranges = SplitLines(file.data, file.size, pool != nullptr ? pool->getNumOfThreads() * 2 : 1);
+    std::vector<OBJChunk> chunks(ranges.size());
+    RunChunks(chunks.size(), [&](size_t i) { ParseOBJChunk(ranges[i].first, ranges[i].second, scale, chunks[i]); }, pool);
+    
+    //Merge attribute arrays and resolve indices
+    std::vector<size_t> pOffset(chunks.size()+1, 0), nOffset(chunks.size()+1, 0), tOffset(chunks.size()+1, 0), cOffset(chunks.size()+1, 0);
+    bool valid = true;
+    for(size_t i=0; i<chunks.size(); ++i)
+    {
+        pOffset[i+1] = pOffset[i] + chunks[i].positions.size();
+        nOffset[i+1] = nOffset[i] + chunks[i].normals.size();
+        tOffset[i+1] = tOffset[i] + chunks[i].uvs.size();
+        cOffset[i+1] = cOffset[i] + chunks[i].corners.size();
+        valid &= chunks[i].valid;
+    }
+    
+    std::vector<glm::vec3> positions(pOffset.back());
+    std::vector<glm::vec3> normals(nOffset.back());
+    std::vector<glm::vec2> uvs(tOffset.back());
+    std::vector<int64_t> corners(cOffset.back());
+    RunChunks(chunks.size(), [&](size_t i)
+    {
+        OBJChunk& c = chunks[i];
+        std::copy(c.positions.begin(), c.positions.end(), positions.begin() + pOffset[i]);
+        std::copy(c.normals.begin(), c.normals.end(), normals.begin() + nOffset[i]);
+        std::copy(c.uvs.begin(), c.uvs.end(), uvs.begin() + tOffset[i]);
+        for(size_t h=0; h<c.corners.size(); h+=3)
+        {
+            corners[cOffset[i]+h] = DecodeIndex(c.corners[h], pOffset[i]);
+            corners[cOffset[i]+h+1] = DecodeIndex(c.corners[h+1], tOffset[i]);
+            corners[cOffset[i]+h+2] = DecodeIndex(c.corners[h+2], nOffset[i]);
+        }
+        c = OBJChunk();
+    }, pool);
+    if(pool != nullptr)
+        delete pool;
+    
+    //Build mesh
+    Mesh* mesh_;
+    if(uvs.size() > 0)
+    {
+        TexturableMesh* mesh = new TexturableMesh;
+        valid &= AssembleOBJMesh<TexturableMesh, TexturableVertex>(mesh, positions, normals, uvs, corners);
         mesh_ = mesh;
     }
-    fclose(file);
+    else
+    {
+        PlainMesh* mesh = new PlainMesh;
+        valid &= AssembleOBJMesh<PlainMesh, Vertex>(mesh, positions, normals, uvs, corners);
+        mesh_ = mesh;
+    }
+    
+    if(!valid)
+    {
+        cError("Geometry file corrupted: %s", path.c_str());
+        delete mesh_;
+        return nullptr;
+    }
     
     int64_t end = GetTimeInMicroseconds();
     
 #ifdef DEBUG
-    printf("Loaded: %ld Generated: %ld\n", genVStart, mesh_->getNumOfVertices()-genVStart);
+    printf("Loaded: %ld Generated: %ld\n", positions.size(), mesh_->getNumOfVertices()-positions.size());
     printf("Total time: %ld\n", (long int)(end-start));
 #endif
     cInfo("Loaded mesh with %ld faces in %ld ms.", mesh_->faces.size(), (end-start)/1000);
@@ -247,52 +554,83 @@ Mesh* LoadOBJ(const std::string& path, GLfloat scale)
 
 Mesh* LoadSTL(const std::string& path, GLfloat scale)
 {
-    //Read STL data
-    FILE* file = fopen(path.c_str(), "rb");   
+    //Map STL data
+    MappedFile file(path);
     
-    if(file == NULL)
+    if(file.data == nullptr)
     {
         cCritical("Failed to open geometry file: %s", path.c_str());
         return nullptr;
     }
     
     cInfo("Loading geometry from: %s", path.c_str());
+    int64_t start = GetTimeInMicroseconds();
     
-    char line[128];
-    char keyword[10];
     PlainMesh* mesh = new PlainMesh;
-    Vertex v;
+    ThreadPool* pool = file.size >= parallelParseSize ? new ThreadPool() : nullptr;
+    
+    //Binary files have a 80 byte header, the number of triangles and 50 bytes per triangle
+    uint32_t nTriangles = 0;
+    if(file.size >= 84)
+        memcpy(&nTriangles, file.data + 80, sizeof(uint32_t));
+    bool binary = file.size >= 84 && file.size == 84 + (size_t)nTriangles * 50;
     
-    while(fgets(line, 128, file))
+    if(binary)
     {
-        sscanf(line, "%s", keyword);
-        
-        if(strcmp(keyword, "facet")==0)
+        mesh->vertices.resize((size_t)nTriangles * 3);
+        size_t nChunks = pool != nullptr ? pool->getNumOfThreads() * 2 : 1;
+        RunChunks(nChunks, [&](size_t c)
         {
-            sscanf(line, " facet normal %f %f %f\n", &v.normal.x, &v.normal.y, &v.normal.z);
-        }
-        else if(strcmp(keyword, "vertex")==0)
+            for(size_t i = nTriangles * c / nChunks; i < nTriangles * (c+1) / nChunks; ++i)
+            {
+                float data[12];
+                memcpy(data, file.data + 84 + i * 50, sizeof(data));
+                for(size_t h=0; h<3; ++h)
+                {
+                    Vertex& v = mesh->vertices[i*3+h];
+                    v.normal = glm::vec3(data[0], data[1], data[2]);
+                    v.pos = glm::vec3(data[3+h*3], data[4+h*3], data[5+h*3]) * scale;
+                }
+            }
+        }, pool);
+    }
+    else
+    {
+        std::vector<std::pair<const char*, const char*>> ranges = SplitLines(file.data, file.size, pool != nullptr ? pool->getNumOfThreads() * 2 : 1);
+        std::vector<STLChunk> chunks(ranges.size());
+        RunChunks(chunks.size(), [&](size_t i) { ParseSTLChunk(ranges[i].first, ranges[i].second, scale, chunks[i]); }, pool);
+        
+        //Vertices at the beginning of a chunk belong to a facet started in one of the previous chunks
+        std::vector<size_t> offset(chunks.size()+1, 0);
+        glm::vec3 normal(0.f);
+        for(size_t i=0; i<chunks.size(); ++i)
         {
-            sscanf(line, " vertex %f %f %f\n", &v.pos.x, &v.pos.y, &v.pos.z);
-            v.pos *= scale;
-            mesh->vertices.push_back(v);
+            offset[i+1] = offset[i] + chunks[i].vertices.size();
+            for(size_t h=0; h<chunks[i].leading; ++h)
+                chunks[i].vertices[h].normal = normal;
+            if(chunks[i].hasNormal)
+                normal = chunks[i].normal;
         }
-        else if(strcmp(keyword, "endfacet")==0)
+        
+        mesh->vertices.resize(offset.back());
+        RunChunks(chunks.size(), [&](size_t i)
         {
-            unsigned int lastVertexID = (GLuint)mesh->vertices.size()-1;
-            
-            Face f;
-            f.vertexID[0] = lastVertexID-2;
-            f.vertexID[1] = lastVertexID-1;
-            f.vertexID[2] = lastVertexID;
-            mesh->faces.push_back(f);
-        }
+            std::copy(chunks[i].vertices.begin(), chunks[i].vertices.end(), mesh->vertices.begin() + offset[i]);
+        }, pool);
     }
+    if(pool != nullptr)
+        delete pool;
     
-    fclose(file);
-    
-    //Remove duplicates (so that it becomes equivalent to OBJ file representation)
+    mesh->faces.resize(mesh->vertices.size()/3);
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        mesh->faces[i].vertexID[0] = (GLuint)(i*3);
+        mesh->faces[i].vertexID[1] = (GLuint)(i*3+1);
+        mesh->faces[i].vertexID[2] = (GLuint)(i*3+2);
+    }
     
+    int64_t end = GetTimeInMicroseconds();
+    cInfo("Loaded mesh with %ld faces in %ld ms.", mesh->faces.size(), (end-start)/1000);
     return mesh;
 }
 
@@ -573,4 +911,357 @@ Vector3 FindInertialAxis(Matrix3 I, Scalar value)
     return axis;
 }
 
+//Helpers of the convex hull computation
+namespace
+{
+
+struct HullData
+{
+    std::vector<Vector3> vertices;
+    std::vector<Vector3> normals;
+    std::vector<Scalar> offsets;
+    Scalar volume;
+
+    void getAabb(Vector3& aabbMin, Vector3& aabbMax) const
+    {
+        aabbMin = aabbMax = vertices.empty() ? Vector3(0,0,0) : vertices[0];
+        for(size_t i=1; i<vertices.size(); ++i)
+        {
+            aabbMin.setMin(vertices[i]);
+            aabbMax.setMax(vertices[i]);
+        }
+    }
+};
+
+//Computes the exact hull with its face planes (outward normals) and volume
+void BuildHull(const std::vector<Vector3>& points, HullData& hull)
+{
+    hull.vertices.clear();
+    hull.normals.clear();
+    hull.offsets.clear();
+    hull.volume = Scalar(0);
+    if(points.empty())
+        return;
+
+    btConvexHullComputer computer;
+    computer.compute(points[0].m_floats, sizeof(Vector3), (int)points.size(), Scalar(0), Scalar(0));
+    if(computer.vertices.size() == 0)
+        return;
+
+    //The hull computer quantizes the coordinates, so the vertices are snapped back to the nearest input points
+    Vector3 aabbMin = points[0];
+    Vector3 aabbMax = points[0];
+    for(size_t i=1; i<points.size(); ++i)
+    {
+        aabbMin.setMin(points[i]);
+        aabbMax.setMax(points[i]);
+    }
+    Scalar cell = (aabbMax - aabbMin)[(aabbMax - aabbMin).maxAxis()]/Scalar(4096);
+    if(cell <= Scalar(0))
+        cell = Scalar(1);
+    auto cellKey = [&](const Vector3& p, int dx, int dy, int dz)
+    {
+        int64_t x = (int64_t)std::floor((p.x() - aabbMin.x())/cell) + dx;
+        int64_t y = (int64_t)std::floor((p.y() - aabbMin.y())/cell) + dy;
+        int64_t z = (int64_t)std::floor((p.z() - aabbMin.z())/cell) + dz;
+        return (x << 42) ^ (y << 21) ^ z;
+    };
+    std::unordered_multimap<int64_t, size_t> grid(points.size());
+    for(size_t i=0; i<points.size(); ++i)
+        grid.emplace(cellKey(points[i], 0, 0, 0), i);
+
+    std::vector<Vector3> snapped(computer.vertices.size());
+    Vector3 centre(0,0,0);
+    for(int i=0; i<computer.vertices.size(); ++i)
+    {
+        const Vector3& v = computer.vertices[i];
+        snapped[i] = v;
+        Scalar best = BT_LARGE_FLOAT;
+        for(int dx=-1; dx<=1; ++dx)
+            for(int dy=-1; dy<=1; ++dy)
+                for(int dz=-1; dz<=1; ++dz)
+                {
+                    auto range = grid.equal_range(cellKey(v, dx, dy, dz));
+                    for(auto it = range.first; it != range.second; ++it)
+                    {
+                        Scalar d = (points[it->second] - v).length2();
+                        if(d < best)
+                        {
+                            best = d;
+                            snapped[i] = points[it->second];
+                        }
+                    }
+                }
+        hull.vertices.push_back(snapped[i]);
+        centre += snapped[i];
+    }
+    centre /= Scalar(hull.vertices.size());
+
+    for(int i=0; i<computer.faces.size(); ++i)
+    {
+        const btConvexHullComputer::Edge* e0 = &computer.edges[computer.faces[i]];
+        const btConvexHullComputer::Edge* e = e0;
+        const Vector3& p0 = snapped[e0->getSourceVertex()];
+        Vector3 n(0,0,0);
+        Vector3 c(0,0,0);
+        unsigned int count = 0;
+        do
+        {
+            const Vector3& a = snapped[e->getSourceVertex()];
+            const Vector3& b = snapped[e->getTargetVertex()];
+            n += (a - p0).cross(b - p0);
+            c += a;
+            ++count;
+            e = e->getNextEdgeOfFace();
+        }
+        while(e != e0);
+
+        Scalar area2 = n.length();
+        if(area2 < SIMD_EPSILON)
+            continue;
+        n /= area2;
+        c /= Scalar(count);
+        if(n.dot(centre - c) > Scalar(0)) //Make sure the normal points outwards
+            n = -n;
+        hull.normals.push_back(n);
+        hull.offsets.push_back(n.dot(c));
+        hull.volume += area2/Scalar(2) * n.dot(c - centre)/Scalar(3);
+    }
+}
+
+//Signed distance of a point from the boundary of the hull (positive outside)
+Scalar HullDistance(const HullData& hull, const Vector3& p)
+{
+    Scalar d = -BT_LARGE_FLOAT;
+    for(size_t i=0; i<hull.normals.size(); ++i)
+        d = btMax(d, hull.normals[i].dot(p) - hull.offsets[i]);
+    return d;
+}
+
+//Maximum depth of the surface below the hull, measured along the normals of the triangles
+Scalar HullConcavity(const HullData& hull, const std::vector<Vector3>& triangles)
+{
+    Scalar c(0);
+    for(size_t i=0; i<triangles.size(); i+=3)
+    {
+        Vector3 n = (triangles[i+1] - triangles[i]).cross(triangles[i+2] - triangles[i]);
+        if(n.length2() < SIMD_EPSILON)
+            continue;
+        n.normalize();
+        Vector3 centre = (triangles[i] + triangles[i+1] + triangles[i+2])/Scalar(3);
+
+        //Distance along the normal to the boundary of the hull
+        Scalar depth = BT_LARGE_FLOAT;
+        for(size_t h=0; h<hull.normals.size(); ++h)
+        {
+            Scalar cosine = hull.normals[h].dot(n);
+            if(cosine > SIMD_EPSILON)
+                depth = btMin(depth, (hull.offsets[h] - hull.normals[h].dot(centre))/cosine);
+        }
+        if(depth < BT_LARGE_FLOAT)
+            c = btMax(c, depth);
+    }
+    return c;
+}
+
+//Part of the decomposed surface, stored as a list of triangles (3 points each)
+struct HullPart
+{
+    std::vector<Vector3> triangles;
+    HullData hull;
+    Scalar concavity;
+};
+
+void BuildPart(HullPart& part)
+{
+    BuildHull(part.triangles, part.hull);
+    part.concavity = HullConcavity(part.hull, part.triangles);
+}
+
+//Clips the triangles of a part with an axis-aligned plane (the hulls of the halves include the cut)
+void SplitPart(const HullPart& part, int axis, Scalar cut, HullPart& below, HullPart& above)
+{
+    for(size_t i=0; i<part.triangles.size(); i+=3)
+    {
+        const Vector3* tri = &part.triangles[i];
+        Scalar d[3] = {tri[0][axis] - cut, tri[1][axis] - cut, tri[2][axis] - cut};
+        if(d[0] <= Scalar(0) && d[1] <= Scalar(0) && d[2] <= Scalar(0))
+            below.triangles.insert(below.triangles.end(), tri, tri+3);
+        else if(d[0] >= Scalar(0) && d[1] >= Scalar(0) && d[2] >= Scalar(0))
+            above.triangles.insert(above.triangles.end(), tri, tri+3);
+        else
+        {
+            Vector3 polyBelow[4], polyAbove[4];
+            unsigned int nBelow = 0, nAbove = 0;
+            for(unsigned int h=0; h<3; ++h)
+            {
+                unsigned int k = (h+1) % 3;
+                if(d[h] <= Scalar(0)) polyBelow[nBelow++] = tri[h];
+                if(d[h] >= Scalar(0)) polyAbove[nAbove++] = tri[h];
+                if((d[h] < Scalar(0) && d[k] > Scalar(0)) || (d[h] > Scalar(0) && d[k] < Scalar(0)))
+                {
+                    Vector3 x = tri[h] + (tri[k] - tri[h]) * (d[h]/(d[h] - d[k]));
+                    polyBelow[nBelow++] = x;
+                    polyAbove[nAbove++] = x;
+                }
+            }
+            for(unsigned int h=1; h+1<nBelow; ++h)
+            {
+                below.triangles.push_back(polyBelow[0]);
+                below.triangles.push_back(polyBelow[h]);
+                below.triangles.push_back(polyBelow[h+1]);
+            }
+            for(unsigned int h=1; h+1<nAbove; ++h)
+            {
+                above.triangles.push_back(polyAbove[0]);
+                above.triangles.push_back(polyAbove[h]);
+                above.triangles.push_back(polyAbove[h+1]);
+            }
+        }
+    }
+}
+
+}
+
+std::vector<Vector3> ComputeConvexHull(const std::vector<Vector3>& points, unsigned int maxVertices)
+{
+    HullData hull;
+    BuildHull(points, hull);
+    std::vector<Vector3>& candidates = hull.vertices;
+    if(maxVertices == 0 || candidates.size() <= maxVertices)
+        return candidates;
+
+    maxVertices = std::max(maxVertices, 4u);
+    std::vector<bool> used(candidates.size(), false);
+    std::vector<Vector3> selected;
+    auto select = [&](size_t id) { used[id] = true; selected.push_back(candidates[id]); };
+    auto farthest = [&](const std::function<Scalar(const Vector3&)>& measure, Scalar& best)
+    {
+        size_t id = 0;
+        best = -BT_LARGE_FLOAT;
+        for(size_t i=0; i<candidates.size(); ++i)
+        {
+            if(used[i]) continue;
+            Scalar m = measure(candidates[i]);
+            if(m > best) { best = m; id = i; }
+        }
+        return id;
+    };
+
+    //Initial tetrahedron spanned by the extreme points
+    Scalar best;
+    Vector3 centre(0,0,0);
+    for(size_t i=0; i<candidates.size(); ++i)
+        centre += candidates[i];
+    centre /= Scalar(candidates.size());
+    select(farthest([&](const Vector3& p) { return (p - centre).length2(); }, best));
+    select(farthest([&](const Vector3& p) { return (p - selected[0]).length2(); }, best));
+    Scalar size = (selected[1] - selected[0]).length();
+    Vector3 axis = (selected[1] - selected[0]).normalized();
+    select(farthest([&](const Vector3& p) { return (p - selected[0]).cross(axis).length2(); }, best));
+    Vector3 normal = (selected[1] - selected[0]).cross(selected[2] - selected[0]).safeNormalize();
+    select(farthest([&](const Vector3& p) { return btFabs((p - selected[0]).dot(normal)); }, best));
+
+    if(best < size * Scalar(1e-6)) //Flat geometry: spread the vertices evenly
+    {
+        std::vector<Scalar> dist(candidates.size(), BT_LARGE_FLOAT);
+        for(size_t h=0; h<selected.size(); ++h)
+            for(size_t i=0; i<candidates.size(); ++i)
+                dist[i] = btMin(dist[i], (candidates[i] - selected[h]).length2());
+        while(selected.size() < maxVertices)
+        {
+            size_t id = 0;
+            best = Scalar(0);
+            for(size_t i=0; i<candidates.size(); ++i)
+                if(!used[i] && dist[i] > best) { best = dist[i]; id = i; }
+            if(best <= Scalar(0))
+                break;
+            select(id);
+            for(size_t i=0; i<candidates.size(); ++i)
+                dist[i] = btMin(dist[i], (candidates[i] - selected.back()).length2());
+        }
+        return selected;
+    }
+
+    //Greedy refinement: add the vertex lying farthest outside the current hull
+    HullData current;
+    while(selected.size() < maxVertices)
+    {
+        BuildHull(selected, current);
+        size_t id = farthest([&](const Vector3& p) { return HullDistance(current, p); }, best);
+        if(best <= size * Scalar(1e-6))
+            break;
+        select(id);
+    }
+    return selected;
+}
+
+std::vector<std::vector<Vector3>> ComputeConvexDecomposition(const Mesh* mesh, unsigned int maxParts, Scalar maxConcavity, unsigned int maxVertices)
+{
+    std::vector<std::vector<Vector3>> hulls;
+    if(mesh->faces.empty())
+        return hulls;
+
+    std::vector<HullPart> parts(1);
+    parts[0].triangles.resize(mesh->faces.size() * 3);
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+        for(unsigned short h=0; h<3; ++h)
+        {
+            glm::vec3 pos = mesh->getVertexPos(i, h);
+            parts[0].triangles[i*3+h] = Vector3(pos.x, pos.y, pos.z);
+        }
+    BuildPart(parts[0]);
+
+    Vector3 aabbMin, aabbMax;
+    parts[0].hull.getAabb(aabbMin, aabbMax);
+    Scalar threshold = maxConcavity * (aabbMax - aabbMin).length();
+
+    //Split the most concave part until all parts are close to convex or the budget is used
+    while(parts.size() < maxParts)
+    {
+        size_t worst = 0;
+        for(size_t i=1; i<parts.size(); ++i)
+            if(parts[i].concavity > parts[worst].concavity)
+                worst = i;
+        if(parts[worst].concavity <= threshold)
+            break;
+
+        //Choose the axis-aligned cut minimizing the total volume of the hulls of the halves
+        HullPart& part = parts[worst];
+        Vector3 pMin, pMax;
+        part.hull.getAabb(pMin, pMax);
+        HullPart bestBelow, bestAbove;
+        Scalar bestVolume = part.hull.volume;
+        for(int axis=0; axis<3; ++axis)
+            for(int k=1; k<4; ++k)
+            {
+                Scalar cut = pMin[axis] + (pMax[axis] - pMin[axis]) * Scalar(k)/Scalar(4);
+                HullPart below, above;
+                SplitPart(part, axis, cut, below, above);
+                if(below.triangles.empty() || above.triangles.empty())
+                    continue;
+                BuildPart(below);
+                BuildPart(above);
+                if(below.hull.volume + above.hull.volume < bestVolume)
+                {
+                    bestVolume = below.hull.volume + above.hull.volume;
+                    bestBelow = std::move(below);
+                    bestAbove = std::move(above);
+                }
+            }
+
+        if(bestBelow.triangles.empty()) //No cut reduces the volume of the part
+        {
+            part.concavity = Scalar(0);
+            continue;
+        }
+        parts[worst] = std::move(bestBelow);
+        parts.push_back(std::move(bestAbove));
+    }
+
+    for(size_t i=0; i<parts.size(); ++i)
+        hulls.push_back(ComputeConvexHull(parts[i].hull.vertices, maxVertices));
+    return hulls;
+}
+
 }